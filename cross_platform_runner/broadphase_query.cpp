@@ -0,0 +1,296 @@
+#include "broadphase_query.h"
+
+#include <algorithm>
+#include <cstdint>
+
+// SIMD 指令集選擇
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BROADPHASE_QUERY_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define BROADPHASE_QUERY_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// 射線方向分量為 0 時的倒數，避免 0 * inf 產生 NaN
+constexpr btScalar LARGE_INVERSE = BT_LARGE_FLOAT;
+
+btScalar SafeInverse(btScalar value) {
+    return value != btScalar(0) ? btScalar(1) / value : LARGE_INVERSE;
+}
+
+// 四條射線的 SoA 資料；未使用的通道 maxFraction 為 -1，永遠不會命中
+struct RayPacket {
+    alignas(16) float origin[3][4];
+    alignas(16) float inverseDirection[3][4];
+    alignas(16) float maxFraction[4];
+};
+
+// 回傳與節點包圍盒相交的射線通道位元
+#if defined(BROADPHASE_QUERY_SIMD_SSE2)
+
+uint32_t IntersectPacket(const RayPacket& packet, const btDbvtVolume& volume) {
+    __m128 tEntry = _mm_setzero_ps();
+    __m128 tExit = _mm_load_ps(packet.maxFraction);
+    for (int axis = 0; axis < 3; ++axis) {
+        const __m128 origin = _mm_load_ps(packet.origin[axis]);
+        const __m128 inverse = _mm_load_ps(packet.inverseDirection[axis]);
+        const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(float(volume.Mins()[axis])), origin), inverse);
+        const __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(float(volume.Maxs()[axis])), origin), inverse);
+        tEntry = _mm_max_ps(tEntry, _mm_min_ps(t1, t2));
+        tExit = _mm_min_ps(tExit, _mm_max_ps(t1, t2));
+    }
+    return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(tEntry, tExit)));
+}
+
+#elif defined(BROADPHASE_QUERY_SIMD_NEON)
+
+uint32_t IntersectPacket(const RayPacket& packet, const btDbvtVolume& volume) {
+    float32x4_t tEntry = vdupq_n_f32(0.0f);
+    float32x4_t tExit = vld1q_f32(packet.maxFraction);
+    for (int axis = 0; axis < 3; ++axis) {
+        const float32x4_t origin = vld1q_f32(packet.origin[axis]);
+        const float32x4_t inverse = vld1q_f32(packet.inverseDirection[axis]);
+        const float32x4_t t1 = vmulq_f32(vsubq_f32(vdupq_n_f32(float(volume.Mins()[axis])), origin), inverse);
+        const float32x4_t t2 = vmulq_f32(vsubq_f32(vdupq_n_f32(float(volume.Maxs()[axis])), origin), inverse);
+        tEntry = vmaxq_f32(tEntry, vminq_f32(t1, t2));
+        tExit = vminq_f32(tExit, vmaxq_f32(t1, t2));
+    }
+    static const uint32_t laneBits[4] = {1u, 2u, 4u, 8u};
+    const uint32x4_t bits = vandq_u32(vcleq_f32(tEntry, tExit), vld1q_u32(laneBits));
+    return vaddvq_u32(bits);
+}
+
+#else
+
+uint32_t IntersectPacket(const RayPacket& packet, const btDbvtVolume& volume) {
+    uint32_t mask = 0;
+    for (int lane = 0; lane < 4; ++lane) {
+        float tEntry = 0.0f;
+        float tExit = packet.maxFraction[lane];
+        for (int axis = 0; axis < 3; ++axis) {
+            const float origin = packet.origin[axis][lane];
+            const float inverse = packet.inverseDirection[axis][lane];
+            const float t1 = (float(volume.Mins()[axis]) - origin) * inverse;
+            const float t2 = (float(volume.Maxs()[axis]) - origin) * inverse;
+            tEntry = std::max(tEntry, std::min(t1, t2));
+            tExit = std::min(tExit, std::max(t1, t2));
+        }
+        if (tEntry <= tExit) mask |= 1u << lane;
+    }
+    return mask;
+}
+
+#endif
+
+btTransform MakeTranslation(const btVector3& origin) {
+    btTransform transform;
+    transform.setIdentity();
+    transform.setOrigin(origin);
+    return transform;
+}
+
+// 射線與單一物件的窄相位測試；只接受比 hit 目前更近的命中
+void RayTestObject(const btCollisionObject* object, const btVector3& from, const btVector3& to,
+                   BroadphaseQuery::Hit& hit) {
+    btCollisionWorld::ClosestRayResultCallback callback(from, to);
+    callback.m_closestHitFraction = hit.fraction;
+
+    btCollisionWorld::rayTestSingle(MakeTranslation(from), MakeTranslation(to),
+                                    const_cast<btCollisionObject*>(object),
+                                    object->getCollisionShape(), object->getWorldTransform(), callback);
+    if (callback.hasHit()) {
+        hit.object = object;
+        hit.point = callback.m_hitPointWorld;
+        hit.normal = callback.m_hitNormalWorld;
+        hit.fraction = callback.m_closestHitFraction;
+    }
+}
+
+} // namespace
+
+BroadphaseQuery::BroadphaseQuery(const btDbvtBroadphase* broadphase)
+    : m_broadphase(broadphase)
+{
+    m_stack.reserve(128);
+}
+
+const char* BroadphaseQuery::GetSimdName() {
+#if defined(BROADPHASE_QUERY_SIMD_SSE2)
+    return "SSE2";
+#elif defined(BROADPHASE_QUERY_SIMD_NEON)
+    return "NEON";
+#else
+    return "Scalar";
+#endif
+}
+
+BroadphaseQuery::RaySegment BroadphaseQuery::MakeSegment(const btVector3& from, const btVector3& to, btScalar extent) {
+    const btVector3 direction = to - from;
+    RaySegment segment;
+    segment.origin = from;
+    segment.inverseDirection = btVector3(SafeInverse(direction.getX()),
+                                         SafeInverse(direction.getY()),
+                                         SafeInverse(direction.getZ()));
+    segment.extent = btVector3(extent, extent, extent);
+    return segment;
+}
+
+bool BroadphaseQuery::IntersectsRay(const btDbvtVolume& volume, const RaySegment& segment, btScalar maxFraction) {
+    const btVector3 lower = volume.Mins() - segment.extent;
+    const btVector3 upper = volume.Maxs() + segment.extent;
+
+    btScalar tEntry = 0;
+    btScalar tExit = maxFraction;
+    for (int axis = 0; axis < 3; ++axis) {
+        const btScalar t1 = (lower[axis] - segment.origin[axis]) * segment.inverseDirection[axis];
+        const btScalar t2 = (upper[axis] - segment.origin[axis]) * segment.inverseDirection[axis];
+        tEntry = std::max(tEntry, std::min(t1, t2));
+        tExit = std::min(tExit, std::max(t1, t2));
+    }
+    return tEntry <= tExit;
+}
+
+bool BroadphaseQuery::PassesFilter(const btDbvtNode* leaf, int collisionMask) {
+    const auto* proxy = static_cast<const btBroadphaseProxy*>(leaf->data);
+    return (proxy->m_collisionFilterGroup & collisionMask) != 0;
+}
+
+/**
+ * 依序遍歷兩棵樹；maxFraction 由 leafFunction 在找到更近的命中時縮小，
+ * 之後的節點即以新的上限剔除。
+ */
+template<typename LeafFunction>
+void BroadphaseQuery::TraverseRay(const RaySegment& segment, const btScalar& maxFraction, LeafFunction&& leafFunction) {
+    for (const btDbvt& tree : m_broadphase->m_sets) {
+        if (!tree.m_root) continue;
+
+        m_stack.resize(0);
+        m_stack.push_back(tree.m_root);
+        while (m_stack.size() > 0) {
+            const btDbvtNode* node = m_stack[m_stack.size() - 1];
+            m_stack.pop_back();
+            if (!IntersectsRay(node->volume, segment, maxFraction)) continue;
+
+            if (node->isleaf()) {
+                leafFunction(node);
+            } else {
+                m_stack.push_back(node->childs[0]);
+                m_stack.push_back(node->childs[1]);
+            }
+        }
+    }
+}
+
+void BroadphaseQuery::Raycast(const Ray& ray, Hit& hit) {
+    hit = Hit();
+    const RaySegment segment = MakeSegment(ray.from, ray.to, 0);
+
+    TraverseRay(segment, hit.fraction, [&](const btDbvtNode* leaf) {
+        if (!PassesFilter(leaf, ray.collisionMask)) return;
+        const auto* proxy = static_cast<const btBroadphaseProxy*>(leaf->data);
+        RayTestObject(static_cast<const btCollisionObject*>(proxy->m_clientObject), ray.from, ray.to, hit);
+    });
+}
+
+void BroadphaseQuery::RaycastPacket(const Ray* rays, size_t count, Hit* hits) {
+    count = std::min(count, PACKET_SIZE);
+
+    RayPacket packet;
+    for (size_t lane = 0; lane < PACKET_SIZE; ++lane) {
+        const bool active = lane < count;
+        const btVector3 from = active ? rays[lane].from : btVector3(0, 0, 0);
+        const btVector3 direction = active ? rays[lane].to - from : btVector3(0, 0, 0);
+        for (int axis = 0; axis < 3; ++axis) {
+            packet.origin[axis][lane] = float(from[axis]);
+            packet.inverseDirection[axis][lane] = float(SafeInverse(direction[axis]));
+        }
+        packet.maxFraction[lane] = active ? 1.0f : -1.0f;
+        if (active) hits[lane] = Hit();
+    }
+
+    for (const btDbvt& tree : m_broadphase->m_sets) {
+        if (!tree.m_root) continue;
+
+        m_stack.resize(0);
+        m_stack.push_back(tree.m_root);
+        while (m_stack.size() > 0) {
+            const btDbvtNode* node = m_stack[m_stack.size() - 1];
+            m_stack.pop_back();
+
+            uint32_t mask = IntersectPacket(packet, node->volume);
+            if (mask == 0) continue;
+
+            if (!node->isleaf()) {
+                m_stack.push_back(node->childs[0]);
+                m_stack.push_back(node->childs[1]);
+                continue;
+            }
+
+            const auto* proxy = static_cast<const btBroadphaseProxy*>(node->data);
+            const auto* object = static_cast<const btCollisionObject*>(proxy->m_clientObject);
+            for (size_t lane = 0; lane < count; ++lane) {
+                if (!(mask & (1u << lane)) || !PassesFilter(node, rays[lane].collisionMask)) continue;
+                RayTestObject(object, rays[lane].from, rays[lane].to, hits[lane]);
+                packet.maxFraction[lane] = float(hits[lane].fraction);
+            }
+        }
+    }
+}
+
+void BroadphaseQuery::SphereSweep(const btVector3& from, const btVector3& to, btScalar radius, int collisionMask, Hit& hit) {
+    hit = Hit();
+    const btSphereShape sphere(radius);
+    const btTransform fromTransform = MakeTranslation(from);
+    const btTransform toTransform = MakeTranslation(to);
+    const RaySegment segment = MakeSegment(from, to, radius);
+
+    TraverseRay(segment, hit.fraction, [&](const btDbvtNode* leaf) {
+        if (!PassesFilter(leaf, collisionMask)) return;
+        const auto* proxy = static_cast<const btBroadphaseProxy*>(leaf->data);
+        auto* object = static_cast<btCollisionObject*>(proxy->m_clientObject);
+
+        btCollisionWorld::ClosestConvexResultCallback callback(from, to);
+        callback.m_closestHitFraction = hit.fraction;
+        btCollisionWorld::objectQuerySingle(&sphere, fromTransform, toTransform, object,
+                                            object->getCollisionShape(), object->getWorldTransform(),
+                                            callback, 0);
+        // hasHit() 只比較 m_closestHitFraction，這裡以命中物件判斷本次是否更近
+        if (callback.m_hitCollisionObject) {
+            hit.object = object;
+            hit.point = callback.m_hitPointWorld;
+            hit.normal = callback.m_hitNormalWorld;
+            hit.fraction = callback.m_closestHitFraction;
+        }
+    });
+}
+
+void BroadphaseQuery::Overlap(const btVector3& aabbMin, const btVector3& aabbMax, int collisionMask,
+                              std::vector<const btCollisionObject*>& objects) {
+    objects.clear();
+    const btDbvtVolume bounds = btDbvtVolume::FromMM(aabbMin, aabbMax);
+
+    for (const btDbvt& tree : m_broadphase->m_sets) {
+        if (!tree.m_root) continue;
+
+        m_stack.resize(0);
+        m_stack.push_back(tree.m_root);
+        while (m_stack.size() > 0) {
+            const btDbvtNode* node = m_stack[m_stack.size() - 1];
+            m_stack.pop_back();
+            if (!Intersect(node->volume, bounds)) continue;
+
+            if (node->isleaf()) {
+                if (PassesFilter(node, collisionMask)) {
+                    const auto* proxy = static_cast<const btBroadphaseProxy*>(node->data);
+                    objects.push_back(static_cast<const btCollisionObject*>(proxy->m_clientObject));
+                }
+            } else {
+                m_stack.push_back(node->childs[0]);
+                m_stack.push_back(node->childs[1]);
+            }
+        }
+    }
+}
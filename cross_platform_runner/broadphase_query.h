@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Bullet Physics
+#include <btBulletDynamicsCommon.h>
+
+/**
+ * @file broadphase_query.h
+ * @brief 可平行的寬相位查詢
+ *
+ * 直接遍歷 btDbvtBroadphase 的兩棵動態包圍體樹（動態與靜態集合），
+ * 再以 btCollisionWorld 的靜態窄相位函數測試葉節點。Bullet 的
+ * btCollisionWorld::rayTest 共用寬相位內的遍歷堆疊，無法同時由多個執行緒
+ * 呼叫；此類別的遍歷堆疊屬於實例本身，每個執行緒各自建立一個即可對同一個
+ * 唯讀的世界平行查詢。查詢期間不可推進模擬。
+ *
+ * 射線可四條一組以 SIMD 同時對節點包圍盒做 slab 測試，適合同一原點發出的
+ * 密集射線（光達）；射線方向分散時逐條查詢較省。
+ */
+
+class BroadphaseQuery {
+public:
+    static constexpr size_t PACKET_SIZE = 4;
+
+    struct Ray {
+        btVector3 from;
+        btVector3 to;
+        int collisionMask = -1;
+    };
+
+    struct Hit {
+        const btCollisionObject* object = nullptr;
+        btVector3 point = btVector3(0, 0, 0);
+        btVector3 normal = btVector3(0, 0, 0);
+        btScalar fraction = 1.0f;
+    };
+
+    explicit BroadphaseQuery(const btDbvtBroadphase* broadphase);
+
+    // 最近的射線命中
+    void Raycast(const Ray& ray, Hit& hit);
+
+    // 最多 PACKET_SIZE 條射線一起遍歷，結果與逐條 Raycast 相同
+    void RaycastPacket(const Ray* rays, size_t count, Hit* hits);
+
+    // 球體沿線段掃掠的最近命中
+    void SphereSweep(const btVector3& from, const btVector3& to, btScalar radius, int collisionMask, Hit& hit);
+
+    // 包圍盒與 aabbMin/aabbMax 重疊的物件（只做寬相位測試）
+    void Overlap(const btVector3& aabbMin, const btVector3& aabbMax, int collisionMask,
+                 std::vector<const btCollisionObject*>& objects);
+
+    static const char* GetSimdName();
+
+private:
+    // 以倒數方向表示的射線，供 slab 測試
+    struct RaySegment {
+        btVector3 origin;
+        btVector3 inverseDirection;
+        btVector3 extent;   // 包圍盒外擴量（球體掃掠半徑）
+    };
+
+    static RaySegment MakeSegment(const btVector3& from, const btVector3& to, btScalar extent);
+    static bool IntersectsRay(const btDbvtVolume& volume, const RaySegment& segment, btScalar maxFraction);
+    static bool PassesFilter(const btDbvtNode* leaf, int collisionMask);
+
+    template<typename LeafFunction>
+    void TraverseRay(const RaySegment& segment, const btScalar& maxFraction, LeafFunction&& leafFunction);
+
+    const btDbvtBroadphase* m_broadphase;
+    btAlignedObjectArray<const btDbvtNode*> m_stack;
+};
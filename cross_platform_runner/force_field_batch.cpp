@@ -0,0 +1,393 @@
+#include "force_field_batch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// SIMD 指令集選擇
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FORCE_FIELD_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define FORCE_FIELD_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+using PhysicsScene::ForceField;
+using PhysicsScene::ForceFieldType;
+using PhysicsScene::Vector3;
+
+namespace {
+
+constexpr float MIN_DISTANCE = 1e-6f;
+constexpr float MIN_DISTANCE_SQ = MIN_DISTANCE * MIN_DISTANCE;
+
+// 四路浮點向量與遮罩操作；遮罩以全 1 / 全 0 的位元表示
+#if defined(FORCE_FIELD_SIMD_SSE2)
+
+using Float4 = __m128;
+
+inline Float4 Load(const float* p) { return _mm_loadu_ps(p); }
+inline void Store(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+inline Float4 Splat(float s) { return _mm_set1_ps(s); }
+inline Float4 Add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 Sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 Mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 Div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+inline Float4 Sqrt(Float4 a) { return _mm_sqrt_ps(a); }
+inline Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+inline Float4 Less(Float4 a, Float4 b) { return _mm_cmplt_ps(a, b); }
+inline Float4 Greater(Float4 a, Float4 b) { return _mm_cmpgt_ps(a, b); }
+inline Float4 And(Float4 mask, Float4 v) { return _mm_and_ps(mask, v); }
+
+// (group & groups) != 0
+inline Float4 GroupMask(const int32_t* group, int32_t groups) {
+    __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    __m128i zero = _mm_cmpeq_epi32(_mm_and_si128(g, _mm_set1_epi32(groups)), _mm_setzero_si128());
+    return _mm_castsi128_ps(_mm_xor_si128(zero, _mm_set1_epi32(-1)));
+}
+
+#elif defined(FORCE_FIELD_SIMD_NEON)
+
+using Float4 = float32x4_t;
+
+inline Float4 Load(const float* p) { return vld1q_f32(p); }
+inline void Store(float* p, Float4 v) { vst1q_f32(p, v); }
+inline Float4 Splat(float s) { return vdupq_n_f32(s); }
+inline Float4 Add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 Sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+inline Float4 Mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+inline Float4 Div(Float4 a, Float4 b) { return vdivq_f32(a, b); }
+inline Float4 Sqrt(Float4 a) { return vsqrtq_f32(a); }
+inline Float4 Max(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+inline Float4 Less(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+inline Float4 Greater(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+inline Float4 And(Float4 mask, Float4 v) {
+    return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(mask), vreinterpretq_u32_f32(v)));
+}
+
+inline Float4 GroupMask(const int32_t* group, int32_t groups) {
+    return vreinterpretq_f32_u32(vtstq_s32(vld1q_s32(group), vdupq_n_s32(groups)));
+}
+
+#else
+
+// 純量退回實作，介面與 SIMD 版本相同
+struct Float4 {
+    float v[4];
+};
+
+template<typename Op>
+inline Float4 Map(Float4 a, Float4 b, Op op) {
+    Float4 r;
+    for (int i = 0; i < 4; ++i) r.v[i] = op(a.v[i], b.v[i]);
+    return r;
+}
+
+inline float MaskBits(bool condition) {
+    uint32_t bits = condition ? 0xFFFFFFFFu : 0u;
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+inline Float4 Load(const float* p) { Float4 r; std::memcpy(r.v, p, sizeof(r.v)); return r; }
+inline void Store(float* p, Float4 v) { std::memcpy(p, v.v, sizeof(v.v)); }
+inline Float4 Splat(float s) { return Float4{{s, s, s, s}}; }
+inline Float4 Add(Float4 a, Float4 b) { return Map(a, b, [](float x, float y) { return x + y; }); }
+inline Float4 Sub(Float4 a, Float4 b) { return Map(a, b, [](float x, float y) { return x - y; }); }
+inline Float4 Mul(Float4 a, Float4 b) { return Map(a, b, [](float x, float y) { return x * y; }); }
+inline Float4 Div(Float4 a, Float4 b) { return Map(a, b, [](float x, float y) { return x / y; }); }
+inline Float4 Sqrt(Float4 a) { return Map(a, a, [](float x, float) { return std::sqrt(x); }); }
+inline Float4 Max(Float4 a, Float4 b) { return Map(a, b, [](float x, float y) { return x > y ? x : y; }); }
+inline Float4 Less(Float4 a, Float4 b) { return Map(a, b, [](float x, float y) { return MaskBits(x < y); }); }
+inline Float4 Greater(Float4 a, Float4 b) { return Map(a, b, [](float x, float y) { return MaskBits(x > y); }); }
+inline Float4 And(Float4 mask, Float4 v) {
+    Float4 r;
+    for (int i = 0; i < 4; ++i) {
+        uint32_t m, x;
+        std::memcpy(&m, &mask.v[i], sizeof(m));
+        std::memcpy(&x, &v.v[i], sizeof(x));
+        x &= m;
+        std::memcpy(&r.v[i], &x, sizeof(x));
+    }
+    return r;
+}
+
+inline Float4 GroupMask(const int32_t* group, int32_t groups) {
+    Float4 r;
+    for (int i = 0; i < 4; ++i) r.v[i] = MaskBits((group[i] & groups) != 0);
+    return r;
+}
+
+#endif
+
+// 衰減：t 為 1 - r / radius，falloff 為衰減指數
+float Attenuation(float t, float falloff) {
+    return falloff > 0.0f ? std::pow(t, falloff) : 1.0f;
+}
+
+// 整數衰減指數以連乘計算，其餘交由 std::pow；回傳 -1 表示非整數
+int IntegerFalloff(float falloff) {
+    if (falloff <= 0.0f) return 0;
+    float rounded = std::round(falloff);
+    if (rounded == falloff && rounded <= 4.0f) return static_cast<int>(rounded);
+    return -1;
+}
+
+Vector3 Normalized(const Vector3& v) {
+    float length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+    if (length < MIN_DISTANCE) return Vector3(0.0f, 0.0f, 0.0f);
+    return Vector3(v.x / length, v.y / length, v.z / length);
+}
+
+} // namespace
+
+void ForceFieldBatch::Lanes::Resize(size_t count) {
+    const size_t padded = (count + LANE_COUNT - 1) / LANE_COUNT * LANE_COUNT;
+
+    for (auto* array : {&positionX, &positionY, &positionZ, &velocityX, &velocityY, &velocityZ, &mass}) {
+        array->resize(padded);
+    }
+    group.resize(padded);
+
+    // 補齊的元素不受任何力場影響
+    std::fill(group.begin() + count, group.end(), 0);
+
+    for (auto* array : {&forceX, &forceY, &forceZ}) {
+        array->assign(padded, 0.0f);
+    }
+}
+
+void ForceFieldBatch::Resize(size_t count) {
+    m_count = count;
+    m_bodies.Resize(count);
+}
+
+void ForceFieldBatch::Evaluate(const ForceField& forceField) {
+    if (!forceField.enabled || m_count == 0 || forceField.affectedGroups == 0) return;
+    EvaluateLanes(m_bodies, forceField);
+}
+
+void ForceFieldBatch::Evaluate(const ForceField& forceField, const std::vector<uint32_t>& bodyIndices) {
+    if (!forceField.enabled || bodyIndices.empty() || forceField.affectedGroups == 0) return;
+
+    // 收集
+    const size_t count = bodyIndices.size();
+    m_subset.Resize(count);
+    for (size_t k = 0; k < count; ++k) {
+        const uint32_t i = bodyIndices[k];
+        m_subset.positionX[k] = m_bodies.positionX[i];
+        m_subset.positionY[k] = m_bodies.positionY[i];
+        m_subset.positionZ[k] = m_bodies.positionZ[i];
+        m_subset.velocityX[k] = m_bodies.velocityX[i];
+        m_subset.velocityY[k] = m_bodies.velocityY[i];
+        m_subset.velocityZ[k] = m_bodies.velocityZ[i];
+        m_subset.mass[k] = m_bodies.mass[i];
+        m_subset.group[k] = m_bodies.group[i];
+    }
+
+    EvaluateLanes(m_subset, forceField);
+
+    // 累加回對應剛體
+    for (size_t k = 0; k < count; ++k) {
+        const uint32_t i = bodyIndices[k];
+        m_bodies.forceX[i] += m_subset.forceX[k];
+        m_bodies.forceY[i] += m_subset.forceY[k];
+        m_bodies.forceZ[i] += m_subset.forceZ[k];
+    }
+}
+
+void ForceFieldBatch::EvaluateLanes(Lanes& lanes, const ForceField& forceField) {
+    const Vector3& direction = forceField.direction;
+    const float strength = forceField.strength;
+
+    switch (forceField.type) {
+        case ForceFieldType::Gravity:
+            EvaluateUniform(lanes, direction.x * strength, direction.y * strength, direction.z * strength,
+                            true, forceField.affectedGroups);
+            break;
+        case ForceFieldType::Uniform:
+            EvaluateUniform(lanes, direction.x * strength, direction.y * strength, direction.z * strength,
+                            false, forceField.affectedGroups);
+            break;
+        case ForceFieldType::Drag:
+            EvaluateDrag(lanes, strength, forceField.affectedGroups);
+            break;
+        case ForceFieldType::Radial:
+        case ForceFieldType::Vortex:
+        case ForceFieldType::Spring:
+            EvaluateLocalized(lanes, forceField);
+            break;
+    }
+}
+
+void ForceFieldBatch::EvaluateUniform(Lanes& lanes, float forceX, float forceY, float forceZ, bool scaleByMass, int32_t groups) {
+    const Float4 fx = Splat(forceX);
+    const Float4 fy = Splat(forceY);
+    const Float4 fz = Splat(forceZ);
+    const Float4 one = Splat(1.0f);
+
+    for (size_t i = 0; i < lanes.group.size(); i += LANE_COUNT) {
+        Float4 mask = GroupMask(&lanes.group[i], groups);
+        Float4 scale = And(mask, scaleByMass ? Load(&lanes.mass[i]) : one);
+
+        Store(&lanes.forceX[i], Add(Load(&lanes.forceX[i]), Mul(fx, scale)));
+        Store(&lanes.forceY[i], Add(Load(&lanes.forceY[i]), Mul(fy, scale)));
+        Store(&lanes.forceZ[i], Add(Load(&lanes.forceZ[i]), Mul(fz, scale)));
+    }
+}
+
+void ForceFieldBatch::EvaluateDrag(Lanes& lanes, float strength, int32_t groups) {
+    const Float4 coefficient = Splat(-strength);
+
+    for (size_t i = 0; i < lanes.group.size(); i += LANE_COUNT) {
+        Float4 scale = And(GroupMask(&lanes.group[i], groups), coefficient);
+
+        Store(&lanes.forceX[i], Add(Load(&lanes.forceX[i]), Mul(Load(&lanes.velocityX[i]), scale)));
+        Store(&lanes.forceY[i], Add(Load(&lanes.forceY[i]), Mul(Load(&lanes.velocityY[i]), scale)));
+        Store(&lanes.forceZ[i], Add(Load(&lanes.forceZ[i]), Mul(Load(&lanes.velocityZ[i]), scale)));
+    }
+}
+
+/**
+ * 半徑內的力場：Radial 沿中心向外（strength 為負時吸引），
+ * Vortex 繞 direction 軸切向旋轉，Spring 以 Hooke 定律拉回中心。
+ * 強度乘上 (1 - r / radius)^falloff。
+ */
+void ForceFieldBatch::EvaluateLocalized(Lanes& lanes, const ForceField& forceField) {
+    if (forceField.radius <= 0.0f) return;
+
+    const ForceFieldType type = forceField.type;
+    const Vector3 axis = Normalized(forceField.direction);
+    if (type == ForceFieldType::Vortex && axis.x == 0.0f && axis.y == 0.0f && axis.z == 0.0f) return;
+
+    const int integerFalloff = IntegerFalloff(forceField.falloff);
+    const int32_t groups = forceField.affectedGroups;
+
+    const Float4 centerX = Splat(forceField.position.x);
+    const Float4 centerY = Splat(forceField.position.y);
+    const Float4 centerZ = Splat(forceField.position.z);
+    const Float4 radiusSq = Splat(forceField.radius * forceField.radius);
+    const Float4 invRadius = Splat(1.0f / forceField.radius);
+    const Float4 one = Splat(1.0f);
+    const Float4 zero = Splat(0.0f);
+    const Float4 minDistance = Splat(MIN_DISTANCE);
+    const Float4 minDistanceSq = Splat(MIN_DISTANCE_SQ);
+    const Float4 strength = Splat(type == ForceFieldType::Spring ? -forceField.strength : forceField.strength);
+    const Float4 axisX = Splat(axis.x);
+    const Float4 axisY = Splat(axis.y);
+    const Float4 axisZ = Splat(axis.z);
+
+    for (size_t i = 0; i < lanes.group.size(); i += LANE_COUNT) {
+        Float4 mask = GroupMask(&lanes.group[i], groups);
+
+        Float4 dx = Sub(Load(&lanes.positionX[i]), centerX);
+        Float4 dy = Sub(Load(&lanes.positionY[i]), centerY);
+        Float4 dz = Sub(Load(&lanes.positionZ[i]), centerZ);
+        Float4 distanceSq = Add(Add(Mul(dx, dx), Mul(dy, dy)), Mul(dz, dz));
+        mask = And(mask, Less(distanceSq, radiusSq));
+
+        // 衰減
+        Float4 distance = Sqrt(distanceSq);
+        Float4 t = Max(Sub(one, Mul(distance, invRadius)), zero);
+        Float4 attenuation;
+        if (integerFalloff >= 0) {
+            attenuation = one;
+            for (int k = 0; k < integerFalloff; ++k) {
+                attenuation = Mul(attenuation, t);
+            }
+        } else {
+            float falloff[LANE_COUNT];
+            Store(falloff, t);
+            for (float& lane : falloff) {
+                lane = std::pow(lane, forceField.falloff);
+            }
+            attenuation = Load(falloff);
+        }
+        Float4 magnitude = Mul(strength, attenuation);
+
+        // 方向向量（未正規化）與其長度
+        Float4 vx = dx, vy = dy, vz = dz;
+        Float4 scale;
+        if (type == ForceFieldType::Radial) {
+            mask = And(mask, Greater(distanceSq, minDistanceSq));
+            scale = Div(magnitude, Max(distance, minDistance));
+        } else if (type == ForceFieldType::Vortex) {
+            vx = Sub(Mul(axisY, dz), Mul(axisZ, dy));
+            vy = Sub(Mul(axisZ, dx), Mul(axisX, dz));
+            vz = Sub(Mul(axisX, dy), Mul(axisY, dx));
+            Float4 tangentSq = Add(Add(Mul(vx, vx), Mul(vy, vy)), Mul(vz, vz));
+            mask = And(mask, Greater(tangentSq, minDistanceSq));
+            scale = Div(magnitude, Max(Sqrt(tangentSq), minDistance));
+        } else {
+            scale = magnitude;
+        }
+        scale = And(mask, scale);
+
+        Store(&lanes.forceX[i], Add(Load(&lanes.forceX[i]), Mul(vx, scale)));
+        Store(&lanes.forceY[i], Add(Load(&lanes.forceY[i]), Mul(vy, scale)));
+        Store(&lanes.forceZ[i], Add(Load(&lanes.forceZ[i]), Mul(vz, scale)));
+    }
+}
+
+Vector3 ForceFieldBatch::EvaluatePoint(const ForceField& forceField, const Vector3& position,
+                                       const Vector3& velocity, float mass) {
+    const Vector3 zero(0.0f, 0.0f, 0.0f);
+    if (!forceField.enabled) return zero;
+
+    const Vector3& direction = forceField.direction;
+    const float strength = forceField.strength;
+
+    switch (forceField.type) {
+        case ForceFieldType::Gravity:
+            return Vector3(direction.x * strength * mass, direction.y * strength * mass, direction.z * strength * mass);
+        case ForceFieldType::Uniform:
+            return Vector3(direction.x * strength, direction.y * strength, direction.z * strength);
+        case ForceFieldType::Drag:
+            return Vector3(-strength * velocity.x, -strength * velocity.y, -strength * velocity.z);
+        default:
+            break;
+    }
+
+    if (forceField.radius <= 0.0f) return zero;
+
+    Vector3 d(position.x - forceField.position.x, position.y - forceField.position.y, position.z - forceField.position.z);
+    float distanceSq = d.x * d.x + d.y * d.y + d.z * d.z;
+    if (distanceSq >= forceField.radius * forceField.radius) return zero;
+
+    float distance = std::sqrt(distanceSq);
+    float magnitude = strength * Attenuation(std::max(1.0f - distance / forceField.radius, 0.0f), forceField.falloff);
+
+    if (forceField.type == ForceFieldType::Radial) {
+        if (distanceSq <= MIN_DISTANCE_SQ) return zero;
+        float scale = magnitude / distance;
+        return Vector3(d.x * scale, d.y * scale, d.z * scale);
+    }
+
+    if (forceField.type == ForceFieldType::Vortex) {
+        Vector3 axis = Normalized(direction);
+        Vector3 tangent(axis.y * d.z - axis.z * d.y, axis.z * d.x - axis.x * d.z, axis.x * d.y - axis.y * d.x);
+        float tangentSq = tangent.x * tangent.x + tangent.y * tangent.y + tangent.z * tangent.z;
+        if (tangentSq <= MIN_DISTANCE_SQ) return zero;
+        float scale = magnitude / std::sqrt(tangentSq);
+        return Vector3(tangent.x * scale, tangent.y * scale, tangent.z * scale);
+    }
+
+    // Spring
+    return Vector3(-d.x * magnitude, -d.y * magnitude, -d.z * magnitude);
+}
+
+bool ForceFieldBatch::IsLocalized(ForceFieldType type) {
+    return type == ForceFieldType::Radial || type == ForceFieldType::Vortex || type == ForceFieldType::Spring;
+}
+
+const char* ForceFieldBatch::GetSimdName() {
+#if defined(FORCE_FIELD_SIMD_SSE2)
+    return "SSE2";
+#elif defined(FORCE_FIELD_SIMD_NEON)
+    return "NEON";
+#else
+    return "Scalar";
+#endif
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// 場景格式
+#include "../scene_format/physics_scene_format.h"
+
+/**
+ * @file force_field_batch.h
+ * @brief 以 SoA 配置批次計算力場
+ *
+ * PhysicsEngine 每一步將所有剛體的位置、速度、質量與碰撞群組收集成
+ * 結構陣列（SoA），每個力場以 4 路 SIMD（SSE2 / NEON，其餘平台退回純量）
+ * 一次處理四個剛體，依 affectedGroups 以遮罩排除不受影響的剛體，
+ * 累積完所有力場後再一次寫回 Bullet。
+ *
+ * 具半徑的力場（Radial / Vortex / Spring）可只傳入與其半徑重疊的剛體索引，
+ * 此時先將這些剛體收集到小型暫存陣列計算，再累加回對應剛體。
+ */
+
+/**
+ * @class ForceFieldBatch
+ * @brief 力場批次計算的 SoA 緩衝區
+ *
+ * 群組為 0 的剛體不受任何力場影響；靜態、運動學與休眠中的剛體
+ * 在收集時即以群組 0 標記。陣列長度補齊到 LANE_COUNT 的倍數，
+ * 補齊的元素群組為 0。
+ */
+class ForceFieldBatch {
+public:
+    static constexpr size_t LANE_COUNT = 4;
+
+    // 設定剛體數量並清除累積的力
+    void Resize(size_t count);
+    size_t GetCount() const { return m_count; }
+
+    // 收集剛體狀態
+    void SetBody(size_t index, const PhysicsScene::Vector3& position,
+                 const PhysicsScene::Vector3& velocity, float mass, int32_t group) {
+        m_bodies.positionX[index] = position.x;
+        m_bodies.positionY[index] = position.y;
+        m_bodies.positionZ[index] = position.z;
+        m_bodies.velocityX[index] = velocity.x;
+        m_bodies.velocityY[index] = velocity.y;
+        m_bodies.velocityZ[index] = velocity.z;
+        m_bodies.mass[index] = mass;
+        m_bodies.group[index] = group;
+    }
+
+    // 對所有剛體累加單一力場的作用力
+    void Evaluate(const PhysicsScene::ForceField& forceField);
+
+    // 只對指定索引的剛體累加單一力場的作用力（索引不可重複）
+    void Evaluate(const PhysicsScene::ForceField& forceField, const std::vector<uint32_t>& bodyIndices);
+
+    // 讀回累積的力
+    PhysicsScene::Vector3 GetForce(size_t index) const {
+        return PhysicsScene::Vector3(m_bodies.forceX[index], m_bodies.forceY[index], m_bodies.forceZ[index]);
+    }
+    bool HasForce(size_t index) const {
+        return m_bodies.forceX[index] != 0.0f || m_bodies.forceY[index] != 0.0f || m_bodies.forceZ[index] != 0.0f;
+    }
+
+    // 單點純量計算（參考實作，供查詢與測試使用）
+    static PhysicsScene::Vector3 EvaluatePoint(const PhysicsScene::ForceField& forceField,
+                                               const PhysicsScene::Vector3& position,
+                                               const PhysicsScene::Vector3& velocity,
+                                               float mass);
+
+    // 是否只影響半徑內的剛體
+    static bool IsLocalized(PhysicsScene::ForceFieldType type);
+
+    // 編譯時選用的 SIMD 指令集名稱
+    static const char* GetSimdName();
+
+private:
+    // 結構陣列，長度補齊到 LANE_COUNT 的倍數
+    struct Lanes {
+        std::vector<float> positionX, positionY, positionZ;
+        std::vector<float> velocityX, velocityY, velocityZ;
+        std::vector<float> mass;
+        std::vector<int32_t> group;
+        std::vector<float> forceX, forceY, forceZ;
+
+        void Resize(size_t count);
+    };
+
+    static void EvaluateLanes(Lanes& lanes, const PhysicsScene::ForceField& forceField);
+    static void EvaluateUniform(Lanes& lanes, float forceX, float forceY, float forceZ, bool scaleByMass, int32_t groups);
+    static void EvaluateDrag(Lanes& lanes, float strength, int32_t groups);
+    static void EvaluateLocalized(Lanes& lanes, const PhysicsScene::ForceField& forceField);
+
+    size_t m_count = 0;
+    Lanes m_bodies;
+
+    // 依索引計算時的暫存
+    Lanes m_subset;
+};
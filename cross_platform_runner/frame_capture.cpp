@@ -0,0 +1,377 @@
+/**
+ * @file frame_capture.cpp
+ * @brief 非同步截圖與連續影格擷取實現
+ */
+
+#include "frame_capture.h"
+#include "image_encoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+constexpr size_t BYTES_PER_PIXEL = 4;
+constexpr size_t DEFAULT_MAX_QUEUED_JOBS = 4;
+constexpr GLuint64 READBACK_TIMEOUT_NS = 1000000000ull;
+constexpr size_t MAX_SEQUENCE_DIGITS = 20;
+
+/**
+ * @brief 解析連續擷取的檔名格式
+ *
+ * 只接受恰好一個 %d 或 %0Nd 與任意個 %%；格式字串來自命令列，
+ * 因此不交給 printf，而是拆成前後文字與補零位數，之後以字串代換產生檔名。
+ */
+bool ParseSequencePattern(const std::string& pattern, std::string& prefix, std::string& suffix, size_t& digits) {
+    prefix.clear();
+    suffix.clear();
+    digits = 0;
+    bool found = false;
+
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        std::string& text = found ? suffix : prefix;
+        if (pattern[i] != '%') {
+            text += pattern[i];
+            continue;
+        }
+        if (i + 1 < pattern.size() && pattern[i + 1] == '%') {
+            text += '%';
+            ++i;
+            continue;
+        }
+        if (found) return false;
+
+        size_t j = i + 1;
+        if (j < pattern.size() && pattern[j] == '0') {
+            const size_t first = ++j;
+            while (j < pattern.size() && pattern[j] >= '0' && pattern[j] <= '9') ++j;
+            if (j == first || j - first > 2) return false;
+            digits = static_cast<size_t>(std::stoul(pattern.substr(first, j - first)));
+            if (digits > MAX_SEQUENCE_DIGITS) return false;
+        }
+        if (j >= pattern.size() || pattern[j] != 'd') return false;
+        found = true;
+        i = j;
+    }
+    return found;
+}
+
+} // namespace
+
+FrameCapture::FrameCapture()
+    : m_nextSlot(0)
+    , m_sequenceActive(false)
+    , m_sequenceFormat(Format::Png)
+    , m_sequenceDigits(0)
+    , m_sequenceFrame(0)
+    , m_maxQueuedJobs(DEFAULT_MAX_QUEUED_JOBS)
+    , m_writerBusy(false)
+    , m_stopping(false)
+    , m_rawWidth(0)
+    , m_rawHeight(0)
+{
+}
+
+FrameCapture::~FrameCapture() {
+    // 尚未收取的讀取直接捨棄；已排入佇列的影格仍會寫完
+    StopWriterThread();
+    Cleanup();
+}
+
+bool FrameCapture::StartSequence(const std::string& path, Format format) {
+    if (m_sequenceActive) {
+        StopSequence();
+    }
+    const bool valid = format == Format::Png
+        ? ParseSequencePattern(path, m_sequencePrefix, m_sequenceSuffix, m_sequenceDigits)
+        : !path.empty();
+    if (!valid) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lastError = "Invalid capture path (PNG sequences need exactly one %d or %0Nd): " + path;
+        return false;
+    }
+
+    m_sequencePath = path;
+    m_sequenceFormat = format;
+    m_sequenceFrame = 0;
+    m_sequenceActive = true;
+    return true;
+}
+
+void FrameCapture::StopSequence() {
+    if (!m_sequenceActive) return;
+    m_sequenceActive = false;
+
+    // 先收取所有讀取，關閉串流的工作才會排在最後一個影格之後
+    CollectCompleted(true);
+    if (m_sequenceFormat == Format::RawRgb) {
+        WriteJob job;
+        job.kind = JobKind::CloseRawStream;
+        job.filename = m_sequencePath;
+        Enqueue(std::move(job));
+    }
+    Flush();
+}
+
+void FrameCapture::RequestScreenshot(const std::string& filename, int width, int height) {
+    m_screenshotRequests.push_back({filename, width, height});
+}
+
+void FrameCapture::Capture(int width, int height) {
+    const auto start = std::chrono::steady_clock::now();
+
+    CollectCompleted(false);
+    if (width <= 0 || height <= 0) return;
+    if (!m_sequenceActive && m_screenshotRequests.empty()) return;
+
+    if (!m_screenshotRequests.empty()) {
+        const ScreenshotRequest request = m_screenshotRequests.front();
+        m_screenshotRequests.pop_front();
+        const int shotWidth = request.width > 0 ? std::min(request.width, width) : width;
+        const int shotHeight = request.height > 0 ? std::min(request.height, height) : height;
+        Issue(JobKind::Png, shotWidth, shotHeight, request.filename);
+    }
+
+    if (m_sequenceActive) {
+        if (m_sequenceFormat == Format::Png) {
+            const std::string number = std::to_string(m_sequenceFrame);
+            std::string filename = m_sequencePrefix;
+            if (number.size() < m_sequenceDigits) {
+                filename.append(m_sequenceDigits - number.size(), '0');
+            }
+            filename += number;
+            filename += m_sequenceSuffix;
+            Issue(JobKind::Png, width, height, filename);
+        } else {
+            Issue(JobKind::RawFrame, width, height, m_sequencePath);
+        }
+        ++m_sequenceFrame;
+    }
+
+    const double elapsed = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_statistics.lastCaptureMilliseconds = elapsed;
+}
+
+void FrameCapture::Flush() {
+    CollectCompleted(true);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCondition.wait(lock, [this]() { return m_jobs.empty() && !m_writerBusy; });
+}
+
+void FrameCapture::Cleanup() {
+    for (auto& slot : m_slots) {
+        if (slot.fence) {
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+        if (slot.buffer) {
+            glDeleteBuffers(1, &slot.buffer);
+            slot.buffer = 0;
+        }
+        slot.capacity = 0;
+        slot.pending = false;
+    }
+    m_nextSlot = 0;
+}
+
+FrameCapture::Statistics FrameCapture::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+std::string FrameCapture::GetLastError() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastError;
+}
+
+/**
+ * @brief 把目前的讀取 framebuffer 讀進下一個 PBO 並放置 fence
+ *
+ * 環狀緩衝區已滿時先等待最舊的讀取，影格順序因此保持不變。
+ */
+void FrameCapture::Issue(JobKind kind, int width, int height, const std::string& filename) {
+    ReadbackSlot& slot = m_slots[m_nextSlot];
+    if (slot.pending) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_statistics.readbackStalls;
+        }
+        CollectSlot(slot, true);
+    }
+
+    const size_t size = static_cast<size_t>(width) * static_cast<size_t>(height) * BYTES_PER_PIXEL;
+    if (!slot.buffer) {
+        glGenBuffers(1, &slot.buffer);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    if (slot.capacity < size) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_READ);
+        slot.capacity = size;
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.pending = true;
+    slot.kind = kind;
+    slot.width = width;
+    slot.height = height;
+    slot.filename = filename;
+    m_nextSlot = (m_nextSlot + 1) % READBACK_SLOTS;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_statistics.framesCaptured;
+}
+
+void FrameCapture::CollectSlot(ReadbackSlot& slot, bool wait) {
+    if (!slot.pending) return;
+
+    if (slot.fence) {
+        const GLenum status = wait
+            ? glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, READBACK_TIMEOUT_NS)
+            : glClientWaitSync(slot.fence, 0, 0);
+        if (!wait && status == GL_TIMEOUT_EXPIRED) return;
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+    }
+    slot.pending = false;
+
+    WriteJob job;
+    job.kind = slot.kind;
+    job.width = slot.width;
+    job.height = slot.height;
+    job.filename = std::move(slot.filename);
+
+    const size_t size = static_cast<size_t>(slot.width) * static_cast<size_t>(slot.height) * BYTES_PER_PIXEL;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    const auto* mapped = static_cast<const uint8_t*>(
+        glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(size), GL_MAP_READ_BIT));
+    if (mapped) {
+        job.pixels.assign(mapped, mapped + size);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (!mapped) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lastError = "Failed to map capture buffer for " + job.filename;
+        return;
+    }
+    Enqueue(std::move(job));
+}
+
+// 由最舊的讀取開始收取；不等待時遇到未完成的就停止，保持寫檔順序
+void FrameCapture::CollectCompleted(bool wait) {
+    for (size_t i = 0; i < READBACK_SLOTS; ++i) {
+        ReadbackSlot& slot = m_slots[(m_nextSlot + i) % READBACK_SLOTS];
+        if (!slot.pending) continue;
+        CollectSlot(slot, wait);
+        if (slot.pending) return;
+    }
+}
+
+void FrameCapture::Enqueue(WriteJob&& job) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_writerThread.joinable()) {
+        m_stopping = false;
+        m_writerThread = std::thread(&FrameCapture::WriterThreadLoop, this);
+    }
+    if (m_jobs.size() >= m_maxQueuedJobs) {
+        ++m_statistics.writerStalls;
+        m_idleCondition.wait(lock, [this]() { return m_jobs.size() < m_maxQueuedJobs; });
+    }
+    m_jobs.push_back(std::move(job));
+    lock.unlock();
+    m_jobCondition.notify_one();
+}
+
+void FrameCapture::WriterThreadLoop() {
+    for (;;) {
+        WriteJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobCondition.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+            // 停止前先寫完佇列中的影格
+            if (m_jobs.empty()) return;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_writerBusy = true;
+        }
+        m_idleCondition.notify_all();
+
+        WriteJobToDisk(job);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_writerBusy = false;
+        }
+        m_idleCondition.notify_all();
+    }
+}
+
+void FrameCapture::StopWriterThread() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_jobCondition.notify_all();
+    if (m_writerThread.joinable()) {
+        m_writerThread.join();
+    }
+    if (m_rawStream.is_open()) {
+        m_rawStream.close();
+    }
+}
+
+void FrameCapture::WriteJobToDisk(WriteJob& job) {
+    std::string error;
+    bool written = false;
+    bool skipped = false;
+
+    switch (job.kind) {
+    case JobKind::Png:
+        written = ImageEncoder::WritePng(job.filename, job.width, job.height, job.pixels.data(), error);
+        break;
+
+    case JobKind::RawFrame:
+        if (!m_rawStream.is_open() || m_rawStreamPath != job.filename) {
+            if (m_rawStream.is_open()) m_rawStream.close();
+            m_rawStream.clear();
+            m_rawStream.open(job.filename, std::ios::binary | std::ios::trunc);
+            m_rawStreamPath = job.filename;
+            m_rawWidth = job.width;
+            m_rawHeight = job.height;
+        }
+        if (job.width != m_rawWidth || job.height != m_rawHeight) {
+            skipped = true;
+            break;
+        }
+        ImageEncoder::ConvertToRgbTopDown(job.width, job.height, job.pixels.data(), m_rgbScratch);
+        written = static_cast<bool>(m_rawStream.write(reinterpret_cast<const char*>(m_rgbScratch.data()),
+                                                      static_cast<std::streamsize>(m_rgbScratch.size())));
+        if (!written) {
+            error = "Cannot write capture stream: " + job.filename;
+        }
+        break;
+
+    case JobKind::CloseRawStream:
+        if (m_rawStream.is_open() && m_rawStreamPath == job.filename) {
+            m_rawStream.close();
+            m_rawStreamPath.clear();
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (skipped) {
+        ++m_statistics.framesSkipped;
+    } else if (written) {
+        ++m_statistics.framesWritten;
+    } else {
+        m_lastError = error;
+    }
+}
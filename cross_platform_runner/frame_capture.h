@@ -0,0 +1,158 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// OpenGL
+#include <GL/glew.h>
+
+/**
+ * @file frame_capture.h
+ * @brief 非同步截圖與連續影格擷取
+ *
+ * glReadPixels 讀進 pixel buffer object 的環狀緩衝區並放置 fence，不等待 GPU；
+ * 之後的影格在 fence 完成時才映射 PBO、複製像素，交給寫檔執行緒編碼與寫檔。
+ * 渲染執行緒的成本只有送出讀取命令與一次記憶體複製。
+ *
+ * 連續擷取可輸出為逐張 PNG（pattern 須恰好含一個 %d 或 %0Nd 代入影格編號，
+ * % 本身寫成 %%，其餘 printf 格式一律拒絕），
+ * 或單一原始 RGB24 串流（由上而下），可以
+ *   ffmpeg -f rawvideo -pixel_format rgb24 -video_size WxH -framerate 60 -i capture.rgb out.mp4
+ * 轉成影片。原始串流的解析度固定為第一個影格的大小，之後大小不同的影格會被略過。
+ *
+ * 錄影不丟影格：GPU 落後超過環狀緩衝區長度時等待最舊的讀取完成，
+ * 寫檔佇列已滿時等待寫檔執行緒，兩者都記錄在統計資訊中。
+ */
+
+class FrameCapture {
+public:
+    enum class Format {
+        Png,        // 每個影格一個 PNG 檔
+        RawRgb      // 所有影格接在同一個檔案
+    };
+
+    struct Statistics {
+        uint64_t framesCaptured = 0;    // 已送出讀取的影格（含截圖）
+        uint64_t framesWritten = 0;     // 已寫入檔案的影格
+        uint64_t framesSkipped = 0;     // 原始串流中大小不符而略過的影格
+        uint64_t readbackStalls = 0;    // 等待 GPU 讀取完成的次數
+        uint64_t writerStalls = 0;      // 等待寫檔佇列的次數
+        double lastCaptureMilliseconds = 0.0;   // 最近一次 Capture 在渲染執行緒花費的時間
+    };
+
+    static constexpr size_t READBACK_SLOTS = 3;
+
+    FrameCapture();
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    /**
+     * @brief 開始連續擷取；之後每次 Capture 都會讀取一個影格
+     * @param path Png 時為檔名格式（例如 "capture/frame_%06d.png"），須恰好含一個 %d 或 %0Nd，
+     *             % 本身寫成 %%，其餘格式一律拒絕；RawRgb 時為輸出檔名
+     */
+    bool StartSequence(const std::string& path, Format format);
+    // 等待所有讀取與寫檔完成後結束連續擷取
+    void StopSequence();
+    bool IsCapturingSequence() const { return m_sequenceActive; }
+
+    // 下一次 Capture 時擷取一張 PNG 截圖；寬高為 0 或超出畫面時使用整個畫面
+    void RequestScreenshot(const std::string& filename, int width = 0, int height = 0);
+
+    /**
+     * @brief 每個影格在繪製完成後、交換緩衝區前呼叫
+     *
+     * 收取已完成的讀取，再為本影格的連續擷取或截圖請求送出讀取。
+     * 讀取目前綁定的讀取 framebuffer 左下角 width x height 的範圍。
+     */
+    void Capture(int width, int height);
+
+    // 等待所有讀取與寫檔完成（結束程式或需要確保檔案已寫出時）；需要 OpenGL 上下文
+    void Flush();
+    // 刪除 PBO；需要 OpenGL 上下文
+    void Cleanup();
+
+    Statistics GetStatistics() const;
+    std::string GetLastError() const;
+
+private:
+    enum class JobKind {
+        Png,
+        RawFrame,           // 接在 filename 指定的原始串流之後
+        CloseRawStream
+    };
+
+    struct ReadbackSlot {
+        GLuint buffer = 0;
+        size_t capacity = 0;
+        GLsync fence = nullptr;
+        bool pending = false;           // 已送出讀取，尚未交給寫檔執行緒
+        JobKind kind = JobKind::Png;
+        int width = 0;
+        int height = 0;
+        std::string filename;
+    };
+
+    struct WriteJob {
+        JobKind kind = JobKind::Png;
+        int width = 0;
+        int height = 0;
+        std::string filename;
+        std::vector<uint8_t> pixels;    // RGBA8，由下而上
+    };
+
+    struct ScreenshotRequest {
+        std::string filename;
+        int width;
+        int height;
+    };
+
+    void Issue(JobKind kind, int width, int height, const std::string& filename);
+    void CollectSlot(ReadbackSlot& slot, bool wait);
+    void CollectCompleted(bool wait);
+    void Enqueue(WriteJob&& job);
+
+    void WriterThreadLoop();
+    void StopWriterThread();
+    void WriteJobToDisk(WriteJob& job);
+
+    // 只由渲染執行緒存取
+    ReadbackSlot m_slots[READBACK_SLOTS];
+    size_t m_nextSlot;
+    bool m_sequenceActive;
+    Format m_sequenceFormat;
+    std::string m_sequencePath;
+    std::string m_sequencePrefix;       // Png 檔名格式中影格編號前後的文字（%% 已還原為 %）
+    std::string m_sequenceSuffix;
+    size_t m_sequenceDigits;            // 影格編號補零後的最少位數
+    uint64_t m_sequenceFrame;
+    std::deque<ScreenshotRequest> m_screenshotRequests;
+
+    // 寫檔執行緒；佇列、統計資訊與錯誤訊息由 m_mutex 保護
+    std::thread m_writerThread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_jobCondition;     // 有新工作或要求停止
+    std::condition_variable m_idleCondition;    // 佇列有空位或已清空
+    std::deque<WriteJob> m_jobs;
+    size_t m_maxQueuedJobs;
+    bool m_writerBusy;
+    bool m_stopping;
+    Statistics m_statistics;
+    std::string m_lastError;
+
+    // 只由寫檔執行緒存取
+    std::ofstream m_rawStream;
+    std::string m_rawStreamPath;
+    int m_rawWidth;
+    int m_rawHeight;
+    std::vector<uint8_t> m_rgbScratch;
+};
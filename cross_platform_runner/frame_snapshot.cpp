@@ -0,0 +1,172 @@
+#include "frame_snapshot.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// FrameSnapshot 實現
+int FrameSnapshot::FindBody(const std::string& name) const {
+    if (!bodyNames) {
+        return -1;
+    }
+
+    auto it = std::find(bodyNames->begin(), bodyNames->end(), name);
+    return it != bodyNames->end() ? static_cast<int>(it - bodyNames->begin()) : -1;
+}
+
+const std::string& FrameSnapshot::GetBodyName(size_t index) const {
+    static const std::string empty;
+    if (!bodyNames || index >= bodyNames->size()) {
+        return empty;
+    }
+    return (*bodyNames)[index];
+}
+
+// SnapshotRing 實現
+SnapshotRing::SnapshotRing(size_t capacity)
+    : m_slots(nullptr)
+    , m_capacity(capacity)
+{
+    // 至少需要兩個槽位：一個保存最新影格，一個供生產者寫入
+    if (m_capacity < 2 || m_capacity > MAX_CAPACITY) {
+        throw std::invalid_argument("SnapshotRing capacity must be between 2 and 256");
+    }
+    m_slots.reset(new Slot[m_capacity]);
+}
+
+SnapshotRing::~SnapshotRing() = default;
+
+FrameSnapshot* SnapshotRing::BeginWrite() {
+    const uint64_t latest = m_latest.load(std::memory_order_acquire);
+    const size_t latestSlot = latest != 0 ? static_cast<size_t>(latest & SLOT_INDEX_MASK) : MAX_CAPACITY;
+
+    for (size_t i = 0; i < m_capacity; ++i) {
+        size_t index = (m_writeCursor + i) % m_capacity;
+        if (index == latestSlot) {
+            continue;
+        }
+
+        // 只有沒有讀者的槽位可以被取得寫入權
+        uint32_t expected = 0;
+        if (m_slots[index].state.compare_exchange_strong(expected, WRITER_FLAG,
+                                                         std::memory_order_acquire,
+                                                         std::memory_order_relaxed)) {
+            m_writeSlot = index;
+            return &m_slots[index].snapshot;
+        }
+    }
+
+    // 所有槽位都被消費者占用，丟棄這一影格
+    m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+void SnapshotRing::EndWrite() {
+    if (m_writeSlot >= m_capacity) {
+        return;
+    }
+
+    Slot& slot = m_slots[m_writeSlot];
+    const uint64_t frameIndex = m_nextFrameIndex++;
+    slot.snapshot.frameIndex = frameIndex;
+    slot.frameIndex.store(frameIndex, std::memory_order_relaxed);
+
+    // 釋放寫入旗標後，快照內容對之後釘住此槽位的讀者可見
+    slot.state.store(0, std::memory_order_release);
+    m_latest.store((frameIndex << SLOT_INDEX_BITS) | m_writeSlot, std::memory_order_release);
+
+    m_writeCursor = (m_writeSlot + 1) % m_capacity;
+    m_writeSlot = MAX_CAPACITY;
+}
+
+void SnapshotRing::CancelWrite() {
+    if (m_writeSlot >= m_capacity) {
+        return;
+    }
+
+    // 內容可能已被部分覆寫，清除序號使任何讀者都無法釘住舊影格
+    Slot& slot = m_slots[m_writeSlot];
+    slot.frameIndex.store(0, std::memory_order_relaxed);
+    slot.state.store(0, std::memory_order_release);
+    m_writeSlot = MAX_CAPACITY;
+}
+
+bool SnapshotRing::TryPin(Slot& slot, uint64_t frameIndex) const {
+    uint32_t state = slot.state.load(std::memory_order_relaxed);
+    do {
+        if (state & WRITER_FLAG) {
+            return false;
+        }
+    } while (!slot.state.compare_exchange_weak(state, state + 1,
+                                               std::memory_order_acquire,
+                                               std::memory_order_relaxed));
+
+    // 釘住後再次確認槽位仍是要求的影格，避免讀到已被覆寫的內容
+    if (slot.frameIndex.load(std::memory_order_relaxed) != frameIndex) {
+        slot.state.fetch_sub(1, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
+
+SnapshotRing::ReadHandle SnapshotRing::AcquireLatest() const {
+    for (;;) {
+        const uint64_t latest = m_latest.load(std::memory_order_acquire);
+        if (latest == 0) {
+            return ReadHandle();
+        }
+
+        Slot& slot = m_slots[latest & SLOT_INDEX_MASK];
+        if (TryPin(slot, latest >> SLOT_INDEX_BITS)) {
+            return ReadHandle(&slot, &slot.snapshot);
+        }
+        // 生產者已發佈更新的影格，重新讀取最新位置
+    }
+}
+
+SnapshotRing::ReadHandle SnapshotRing::Acquire(uint64_t frameIndex) const {
+    if (frameIndex == 0) {
+        return ReadHandle();
+    }
+
+    for (size_t i = 0; i < m_capacity; ++i) {
+        Slot& slot = m_slots[i];
+        if (slot.frameIndex.load(std::memory_order_relaxed) == frameIndex && TryPin(slot, frameIndex)) {
+            return ReadHandle(&slot, &slot.snapshot);
+        }
+    }
+
+    // 影格尚未發佈或已被覆寫
+    return ReadHandle();
+}
+
+uint64_t SnapshotRing::GetLatestFrameIndex() const {
+    return m_latest.load(std::memory_order_acquire) >> SLOT_INDEX_BITS;
+}
+
+// ReadHandle 實現
+SnapshotRing::ReadHandle::ReadHandle(ReadHandle&& other) noexcept
+    : m_slot(other.m_slot)
+    , m_snapshot(other.m_snapshot)
+{
+    other.m_slot = nullptr;
+    other.m_snapshot = nullptr;
+}
+
+SnapshotRing::ReadHandle& SnapshotRing::ReadHandle::operator=(ReadHandle&& other) noexcept {
+    if (this != &other) {
+        Release();
+        m_slot = other.m_slot;
+        m_snapshot = other.m_snapshot;
+        other.m_slot = nullptr;
+        other.m_snapshot = nullptr;
+    }
+    return *this;
+}
+
+void SnapshotRing::ReadHandle::Release() {
+    if (m_slot) {
+        m_slot->state.fetch_sub(1, std::memory_order_release);
+        m_slot = nullptr;
+        m_snapshot = nullptr;
+    }
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 場景格式
+#include "../scene_format/physics_scene_format.h"
+
+/**
+ * @file frame_snapshot.h
+ * @brief 模擬影格快照與無鎖環形緩衝區
+ *
+ * PhysicsEngine 在每個模擬步驟結束後發佈一份不可變的影格快照
+ * （剛體變換、接觸點、統計資訊）。渲染器、錄製器與 UI 面板
+ * 從環形緩衝區讀取快照，不需要鎖，也不會阻塞物理求解器。
+ */
+
+/**
+ * @struct FrameSnapshot
+ * @brief 單一模擬影格的不可變狀態
+ *
+ * bodies[i] 對應 (*bodyNames)[i]。名稱表只在剛體增減時重建，
+ * 各影格之間共用同一份，避免每一步複製字串。
+ */
+struct FrameSnapshot {
+    struct BodyState {
+        PhysicsScene::Transform transform;
+        PhysicsScene::Vector3 linearVelocity;
+        PhysicsScene::Vector3 angularVelocity;
+        bool active = false;
+    };
+
+    struct ContactState {
+        uint32_t bodyA = 0;
+        uint32_t bodyB = 0;
+        PhysicsScene::Vector3 point;
+        PhysicsScene::Vector3 normal;
+        float distance = 0.0f;
+        float impulse = 0.0f;
+    };
+
+    struct StepStatistics {
+        int rigidBodyCount = 0;
+        int activeBodyCount = 0;
+        int contactPointCount = 0;
+        float stepTime = 0.0f;
+        float ogcSolveTime = 0.0f;
+        float bulletSolveTime = 0.0f;
+    };
+
+    uint64_t frameIndex = 0;        // 由 SnapshotRing 在發佈時指定，從 1 開始遞增
+    double simulationTime = 0.0;
+    std::shared_ptr<const std::vector<std::string>> bodyNames;
+    std::vector<BodyState> bodies;
+    std::vector<ContactState> contacts;
+    StepStatistics statistics;
+
+    // 依名稱查找剛體索引，找不到時回傳 -1
+    int FindBody(const std::string& name) const;
+    const std::string& GetBodyName(size_t index) const;
+};
+
+/**
+ * @class SnapshotRing
+ * @brief 單一生產者 / 多消費者的無鎖快照環形緩衝區
+ *
+ * 生產者（模擬執行緒）以 BeginWrite/EndWrite 填寫一個空閒槽位，
+ * 永遠不會覆寫最新影格或仍被讀取中的槽位；若所有槽位都被占用，
+ * 該影格會被丟棄並計入 GetDroppedFrameCount()。
+ *
+ * 消費者透過 ReadHandle 釘住槽位，在 handle 存活期間快照內容保證不變。
+ * 每個槽位的狀態字組同時記錄讀者數與寫入旗標，讀者在釘住後會再次
+ * 驗證序號，確保讀到的是自己要求的那一影格。
+ */
+class SnapshotRing {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 8;
+    static constexpr size_t MAX_CAPACITY = 256;
+
+    explicit SnapshotRing(size_t capacity = DEFAULT_CAPACITY);
+    ~SnapshotRing();
+
+    SnapshotRing(const SnapshotRing&) = delete;
+    SnapshotRing& operator=(const SnapshotRing&) = delete;
+
+    // 生產者介面（僅限單一執行緒呼叫）
+    FrameSnapshot* BeginWrite();
+    void EndWrite();
+    void CancelWrite();
+
+private:
+    struct Slot;
+
+public:
+    // 消費者介面
+    class ReadHandle {
+    public:
+        ReadHandle() = default;
+        ~ReadHandle() { Release(); }
+
+        ReadHandle(ReadHandle&& other) noexcept;
+        ReadHandle& operator=(ReadHandle&& other) noexcept;
+        ReadHandle(const ReadHandle&) = delete;
+        ReadHandle& operator=(const ReadHandle&) = delete;
+
+        const FrameSnapshot* Get() const { return m_snapshot; }
+        const FrameSnapshot* operator->() const { return m_snapshot; }
+        const FrameSnapshot& operator*() const { return *m_snapshot; }
+        explicit operator bool() const { return m_snapshot != nullptr; }
+
+        void Release();
+
+    private:
+        friend class SnapshotRing;
+        ReadHandle(Slot* slot, const FrameSnapshot* snapshot) : m_slot(slot), m_snapshot(snapshot) {}
+
+        Slot* m_slot = nullptr;
+        const FrameSnapshot* m_snapshot = nullptr;
+    };
+
+    ReadHandle AcquireLatest() const;
+    ReadHandle Acquire(uint64_t frameIndex) const;
+
+    uint64_t GetLatestFrameIndex() const;
+    uint64_t GetDroppedFrameCount() const { return m_droppedFrames.load(std::memory_order_relaxed); }
+    size_t GetCapacity() const { return m_capacity; }
+
+private:
+    // 槽位狀態：低 31 位元為讀者數，最高位元為寫入旗標
+    static constexpr uint32_t WRITER_FLAG = 0x80000000u;
+    static constexpr int SLOT_INDEX_BITS = 8;
+    static constexpr uint64_t SLOT_INDEX_MASK = (uint64_t(1) << SLOT_INDEX_BITS) - 1;
+
+    struct alignas(64) Slot {
+        std::atomic<uint32_t> state{0};
+        std::atomic<uint64_t> frameIndex{0};
+        FrameSnapshot snapshot;
+    };
+
+    bool TryPin(Slot& slot, uint64_t frameIndex) const;
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_capacity;
+
+    // 最新影格：高位為影格序號，低 SLOT_INDEX_BITS 位元為槽位索引
+    alignas(64) std::atomic<uint64_t> m_latest{0};
+    std::atomic<uint64_t> m_droppedFrames{0};
+
+    // 生產者私有狀態
+    size_t m_writeCursor = 0;
+    size_t m_writeSlot = MAX_CAPACITY;
+    uint64_t m_nextFrameIndex = 1;
+};
@@ -0,0 +1,170 @@
+/**
+ * @file frustum_culler.cpp
+ * @brief 以動態包圍體樹進行視錐剔除的實現
+ */
+
+#include "frustum_culler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 葉節點的 data 欄位直接存物件索引
+void* ToLeafData(uint32_t object) {
+    return reinterpret_cast<void*>(static_cast<uintptr_t>(object));
+}
+
+uint32_t FromLeafData(const btDbvtNode* leaf) {
+    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(leaf->data));
+}
+
+} // namespace
+
+FrustumCuller::FrustumCuller(btScalar margin)
+    : m_margin(margin)
+    , m_updatedLeaves(0)
+{
+    m_stack.reserve(64);
+    m_leafStack.reserve(64);
+}
+
+FrustumCuller::~FrustumCuller() {
+    Clear();
+}
+
+/**
+ * @brief Gribb–Hartmann 平面提取；m[col * 4 + row]，深度範圍 [-1, 1]
+ */
+FrustumCuller::Frustum FrustumCuller::ExtractFrustum(const float* m) {
+    Frustum frustum;
+    for (int plane = 0; plane < PLANE_COUNT; ++plane) {
+        const int axis = plane / 2;                         // x: 左右，y: 下上，z: 近遠
+        const btScalar sign = (plane % 2 == 0) ? btScalar(1) : btScalar(-1);
+        btVector3 normal(m[3] + sign * m[axis],
+                         m[7] + sign * m[4 + axis],
+                         m[11] + sign * m[8 + axis]);
+        btScalar offset = m[15] + sign * m[12 + axis];
+
+        const btScalar length = normal.length();
+        if (length > SIMD_EPSILON) {
+            normal /= length;
+            offset /= length;
+        }
+        frustum.normals[plane] = normal;
+        frustum.offsets[plane] = offset;
+    }
+    return frustum;
+}
+
+void FrustumCuller::Resize(size_t objectCount) {
+    for (size_t i = objectCount; i < m_leaves.size(); ++i) {
+        if (m_leaves[i]) {
+            m_tree.remove(m_leaves[i]);
+        }
+    }
+    m_leaves.resize(objectCount, nullptr);
+}
+
+void FrustumCuller::Clear() {
+    m_tree.clear();
+    m_leaves.clear();
+    m_updatedLeaves = 0;
+}
+
+void FrustumCuller::SetBounds(uint32_t object, const btVector3& aabbMin, const btVector3& aabbMax) {
+    if (object >= m_leaves.size()) {
+        m_leaves.resize(object + 1, nullptr);
+    }
+
+    btDbvtVolume volume = btDbvtVolume::FromMM(aabbMin, aabbMax);
+    btDbvtNode*& leaf = m_leaves[object];
+    if (!leaf) {
+        volume.Expand(btVector3(m_margin, m_margin, m_margin));
+        leaf = m_tree.insert(volume, ToLeafData(object));
+        ++m_updatedLeaves;
+    } else if (m_tree.update(leaf, volume, m_margin)) {
+        // 超出外擴範圍才會重新插入
+        ++m_updatedLeaves;
+    }
+}
+
+void FrustumCuller::RemoveBounds(uint32_t object) {
+    if (object < m_leaves.size() && m_leaves[object]) {
+        m_tree.remove(m_leaves[object]);
+        m_leaves[object] = nullptr;
+    }
+}
+
+/**
+ * @brief 包圍盒相對平面的位置：-1 完全在外側，+1 完全在內側，0 跨越平面
+ */
+int FrustumCuller::Classify(const btDbvtVolume& volume, const btVector3& normal, btScalar offset) {
+    const btVector3 center = volume.Center();
+    const btVector3 extent = volume.Extents();
+    const btScalar distance = normal.dot(center) + offset;
+    const btScalar radius = std::fabs(normal.getX()) * extent.getX() +
+                            std::fabs(normal.getY()) * extent.getY() +
+                            std::fabs(normal.getZ()) * extent.getZ();
+    if (distance + radius < 0) return -1;
+    if (distance - radius >= 0) return 1;
+    return 0;
+}
+
+void FrustumCuller::CollectLeaves(const btDbvtNode* node, std::vector<uint32_t>& visible) {
+    m_leafStack.clear();
+    m_leafStack.push_back(node);
+    while (!m_leafStack.empty()) {
+        const btDbvtNode* current = m_leafStack.back();
+        m_leafStack.pop_back();
+        if (current->isleaf()) {
+            visible.push_back(FromLeafData(current));
+        } else {
+            m_leafStack.push_back(current->childs[0]);
+            m_leafStack.push_back(current->childs[1]);
+        }
+    }
+}
+
+void FrustumCuller::Cull(const Frustum& frustum, std::vector<uint32_t>& visible) {
+    visible.clear();
+    if (m_updatedLeaves > 0) {
+        // 與 btDbvtBroadphase 相同，每次少量重新平衡，避免樹隨移動逐漸退化
+        m_tree.optimizeIncremental(1);
+        m_updatedLeaves = 0;
+    }
+    if (!m_tree.m_root) return;
+
+    constexpr uint32_t ALL_INSIDE = (1u << PLANE_COUNT) - 1;
+
+    m_stack.clear();
+    m_stack.push_back({m_tree.m_root, 0u});
+    while (!m_stack.empty()) {
+        StackEntry entry = m_stack.back();
+        m_stack.pop_back();
+
+        bool outside = false;
+        for (int plane = 0; plane < PLANE_COUNT && !outside; ++plane) {
+            const uint32_t bit = 1u << plane;
+            if (entry.insideMask & bit) continue;
+
+            const int side = Classify(entry.node->volume, frustum.normals[plane], frustum.offsets[plane]);
+            if (side < 0) {
+                outside = true;
+            } else if (side > 0) {
+                entry.insideMask |= bit;
+            }
+        }
+        if (outside) continue;
+
+        if (entry.insideMask == ALL_INSIDE || entry.node->isleaf()) {
+            CollectLeaves(entry.node, visible);
+        } else {
+            m_stack.push_back({entry.node->childs[0], entry.insideMask});
+            m_stack.push_back({entry.node->childs[1], entry.insideMask});
+        }
+    }
+
+    // 遍歷順序取決於樹的形狀，排序後繪製順序才會在各影格間穩定
+    std::sort(visible.begin(), visible.end());
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bullet Physics
+#include <btBulletDynamicsCommon.h>
+
+/**
+ * @file frustum_culler.h
+ * @brief 以動態包圍體樹進行視錐剔除
+ *
+ * 每個繪製物件在 btDbvt（與 btDbvtBroadphase 相同的動態 AABB 樹）中佔一個葉節點，
+ * 葉節點的包圍盒外擴一段邊界，物件在邊界內移動時不需更新樹。剔除時自根節點
+ * 以六個平面測試，節點完全在某平面內側後，其子樹不再測試該平面；完全在視錐內
+ * 的子樹直接收集所有葉節點。
+ *
+ * 渲染用的樹與物理世界的寬相位分開：回放模式下物理世界不會更新，而且渲染只
+ * 需要繪製形狀的包圍盒。
+ */
+
+class FrustumCuller {
+public:
+    static constexpr int PLANE_COUNT = 6;
+
+    // 平面方程式 dot(normal, p) + offset >= 0 為內側
+    struct Frustum {
+        btVector3 normals[PLANE_COUNT];
+        btScalar offsets[PLANE_COUNT];
+    };
+
+    // 由行主序（OpenGL / glm）的 projection * view 矩陣取出六個平面
+    static Frustum ExtractFrustum(const float* viewProjection);
+
+    explicit FrustumCuller(btScalar margin = btScalar(0.1));
+    ~FrustumCuller();
+
+    FrustumCuller(const FrustumCuller&) = delete;
+    FrustumCuller& operator=(const FrustumCuller&) = delete;
+
+    // 物件數量改變時呼叫；多出的物件自樹中移除
+    void Resize(size_t objectCount);
+    void Clear();
+
+    // 設定物件的世界座標包圍盒；仍在外擴的葉節點內時不改動樹
+    void SetBounds(uint32_t object, const btVector3& aabbMin, const btVector3& aabbMax);
+    // 物件沒有包圍盒時移除其葉節點；Cull 不會回傳沒有葉節點的物件
+    void RemoveBounds(uint32_t object);
+    bool HasBounds(uint32_t object) const { return object < m_leaves.size() && m_leaves[object] != nullptr; }
+
+    // 依物件索引遞增順序回傳與視錐相交的物件
+    void Cull(const Frustum& frustum, std::vector<uint32_t>& visible);
+
+    size_t GetObjectCount() const { return m_leaves.size(); }
+    // 上一次 Cull 以來插入或移動的葉節點數
+    size_t GetUpdatedLeafCount() const { return m_updatedLeaves; }
+
+private:
+    struct StackEntry {
+        const btDbvtNode* node;
+        uint32_t insideMask;    // 已確定完全在內側的平面
+    };
+
+    static int Classify(const btDbvtVolume& volume, const btVector3& normal, btScalar offset);
+    void CollectLeaves(const btDbvtNode* node, std::vector<uint32_t>& visible);
+
+    btDbvt m_tree;
+    btScalar m_margin;
+    std::vector<btDbvtNode*> m_leaves;     // 物件索引 -> 葉節點，nullptr 表示沒有包圍盒
+    std::vector<StackEntry> m_stack;
+    std::vector<const btDbvtNode*> m_leafStack;
+    size_t m_updatedLeaves;
+};
@@ -0,0 +1,101 @@
+/**
+ * @file gpu_profiler.cpp
+ * @brief 渲染 pass 的 GPU 計時實現
+ */
+
+#include "gpu_profiler.h"
+
+namespace {
+
+const char* const PASS_NAMES[GpuProfiler::PASS_COUNT] = {"shadow", "opaque", "debug", "ui"};
+
+} // namespace
+
+bool GpuProfiler::Initialize() {
+    Cleanup();
+    for (auto& frame : m_slots) {
+        for (auto& slot : frame) {
+            glGenQueries(1, &slot.query);
+            if (slot.query == 0) {
+                Cleanup();
+                return false;
+            }
+        }
+    }
+    m_initialized = true;
+    return true;
+}
+
+void GpuProfiler::Cleanup() {
+    if (m_activePass != NO_ACTIVE_PASS) {
+        glEndQuery(GL_TIME_ELAPSED);
+        m_activePass = NO_ACTIVE_PASS;
+    }
+    for (auto& frame : m_slots) {
+        for (auto& slot : frame) {
+            if (slot.query != 0) {
+                glDeleteQueries(1, &slot.query);
+            }
+            slot = QuerySlot();
+        }
+    }
+    m_passTimes.fill(0.0f);
+    m_frame = 0;
+    m_initialized = false;
+}
+
+void GpuProfiler::BeginFrame() {
+    if (!m_initialized) return;
+    if (m_activePass != NO_ACTIVE_PASS) {
+        EndPass(static_cast<Pass>(m_activePass));
+    }
+    // 下一組是最舊的一組，FRAME_LATENCY - 1 個影格前送出
+    m_frame = (m_frame + 1) % FRAME_LATENCY;
+    ResolveSlot(m_frame);
+}
+
+void GpuProfiler::BeginPass(Pass pass) {
+    if (!m_initialized || m_activePass != NO_ACTIVE_PASS) return;
+    QuerySlot& slot = m_slots[m_frame][static_cast<size_t>(pass)];
+    // 同一影格重複執行的 pass 只量測第一次；舊結果尚未讀取時本影格不量測
+    if (slot.pending) return;
+
+    glBeginQuery(GL_TIME_ELAPSED, slot.query);
+    slot.pending = true;
+    m_activePass = static_cast<size_t>(pass);
+}
+
+void GpuProfiler::EndPass(Pass pass) {
+    if (m_activePass != static_cast<size_t>(pass)) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    m_activePass = NO_ACTIVE_PASS;
+}
+
+const char* GpuProfiler::GetPassName(Pass pass) {
+    const size_t index = static_cast<size_t>(pass);
+    return index < PASS_COUNT ? PASS_NAMES[index] : "unknown";
+}
+
+/**
+ * @brief 讀取一組查詢的結果，讀到結果的查詢物件才可重新使用
+ *
+ * 結果尚未就緒（GPU 落後超過 FRAME_LATENCY 個影格）時不等待，保留上一次的數值，
+ * 查詢物件維持送出狀態，下一輪再讀取。
+ */
+void GpuProfiler::ResolveSlot(size_t frame) {
+    for (size_t pass = 0; pass < PASS_COUNT; ++pass) {
+        QuerySlot& slot = m_slots[frame][pass];
+        if (!slot.pending) {
+            m_passTimes[pass] = 0.0f;
+            continue;
+        }
+
+        GLint available = 0;
+        glGetQueryObjectiv(slot.query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(slot.query, GL_QUERY_RESULT, &elapsed);
+        m_passTimes[pass] = static_cast<float>(static_cast<double>(elapsed) * 1e-6);
+        slot.pending = false;
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <GL/glew.h>
+
+/**
+ * @file gpu_profiler.h
+ * @brief 以 GL_TIME_ELAPSED 查詢量測各渲染 pass 的 GPU 時間
+ *
+ * 每個 pass 有 FRAME_LATENCY 組查詢物件組成的環狀緩衝區。查詢結果在數個
+ * 影格後才讀取，且只在 GL_QUERY_RESULT_AVAILABLE 為真時讀取，因此不會讓 CPU
+ * 等待 GPU；結果尚未就緒時保留上一次的數值，該查詢物件在讀到結果前不會
+ * 重新送出，輪到它的影格不量測這個 pass。
+ *
+ * GL_TIME_ELAPSED 查詢不能巢狀，同一時間只能有一個 pass 在量測。
+ */
+
+class GpuProfiler {
+public:
+    enum class Pass : uint8_t {
+        Shadow = 0,
+        Opaque,
+        Debug,
+        UI,
+        Count
+    };
+
+    static constexpr size_t PASS_COUNT = static_cast<size_t>(Pass::Count);
+    static constexpr size_t FRAME_LATENCY = 4;      // 環狀緩衝區的影格數，需大於驅動程式允許的預先排入影格數
+
+    GpuProfiler() = default;
+    ~GpuProfiler() { Cleanup(); }
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    // 建立查詢物件；需要有效的 OpenGL 3.3 上下文
+    bool Initialize();
+    void Cleanup();
+    bool IsInitialized() const { return m_initialized; }
+
+    /**
+     * @brief 開始新的影格：讀取已完成的舊查詢結果，並切換到下一組查詢物件
+     *
+     * 尚未結束的 pass 會在此先結束。
+     */
+    void BeginFrame();
+
+    // 開始或結束一個 pass 的量測；另一個 pass 量測中時 BeginPass 會被忽略
+    void BeginPass(Pass pass);
+    void EndPass(Pass pass);
+
+    // 最近一次完成的量測（毫秒）；本影格沒有執行的 pass 為 0
+    float GetPassTime(Pass pass) const { return m_passTimes[static_cast<size_t>(pass)]; }
+
+    // 效能記錄的欄位名稱，例如 "shadow"
+    static const char* GetPassName(Pass pass);
+
+    // 在作用域內量測一個 pass
+    class Scope {
+    public:
+        Scope(GpuProfiler& profiler, Pass pass) : m_profiler(profiler), m_pass(pass) { m_profiler.BeginPass(m_pass); }
+        ~Scope() { m_profiler.EndPass(m_pass); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        GpuProfiler& m_profiler;
+        Pass m_pass;
+    };
+
+private:
+    static constexpr size_t NO_ACTIVE_PASS = PASS_COUNT;
+
+    struct QuerySlot {
+        GLuint query = 0;
+        bool pending = false;   // 已送出且尚未讀取結果；此時不可再對它呼叫 glBeginQuery
+    };
+
+    void ResolveSlot(size_t frame);
+
+    std::array<std::array<QuerySlot, PASS_COUNT>, FRAME_LATENCY> m_slots;
+    std::array<float, PASS_COUNT> m_passTimes{};
+    size_t m_frame = 0;
+    size_t m_activePass = NO_ACTIVE_PASS;
+    bool m_initialized = false;
+};
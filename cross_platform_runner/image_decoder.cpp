@@ -0,0 +1,228 @@
+/**
+ * @file image_decoder.cpp
+ * @brief TGA 與 PPM/PGM 解碼實現
+ */
+
+#include "image_decoder.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+constexpr size_t TGA_HEADER_SIZE = 18;
+
+uint16_t ReadLE16(const uint8_t* data) {
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+bool CheckDimensions(int width, int height, std::string& error) {
+    if (width <= 0 || height <= 0 || width > ImageDecoder::MAX_DIMENSION || height > ImageDecoder::MAX_DIMENSION) {
+        error = "Unsupported image size " + std::to_string(width) + "x" + std::to_string(height);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 讀取 PNM 檔頭的下一個十進位整數，略過空白與 # 註解
+ */
+bool ReadPnmValue(const uint8_t* data, size_t size, size_t& position, int& value) {
+    for (;;) {
+        while (position < size && std::isspace(data[position])) {
+            ++position;
+        }
+        if (position < size && data[position] == '#') {
+            while (position < size && data[position] != '\n') {
+                ++position;
+            }
+            continue;
+        }
+        break;
+    }
+    if (position >= size || !std::isdigit(data[position])) return false;
+
+    long long result = 0;
+    while (position < size && std::isdigit(data[position])) {
+        result = result * 10 + (data[position] - '0');
+        if (result > (1 << 30)) return false;
+        ++position;
+    }
+    value = static_cast<int>(result);
+    return true;
+}
+
+} // namespace
+
+bool ImageDecoder::DecodeFile(const std::string& filename, Image& image, std::string& error) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        error = "Cannot open image file: " + filename;
+        return false;
+    }
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!DecodeMemory(data.data(), data.size(), image, error)) {
+        error = filename + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+bool ImageDecoder::DecodeMemory(const uint8_t* data, size_t size, Image& image, std::string& error) {
+    image = Image();
+    if (!data || size == 0) {
+        error = "Empty image data";
+        return false;
+    }
+    if (size >= 2 && data[0] == 'P' && (data[1] == '5' || data[1] == '6')) {
+        return DecodePnm(data, size, image, error);
+    }
+    return DecodeTga(data, size, image, error);
+}
+
+/**
+ * @brief 解碼 TGA；影像類型 2、3 為未壓縮，10、11 為 RLE
+ *
+ * 檔頭描述子第 5 位元表示原點在左上（需上下翻轉），第 4 位元表示由右到左。
+ */
+bool ImageDecoder::DecodeTga(const uint8_t* data, size_t size, Image& image, std::string& error) {
+    if (size < TGA_HEADER_SIZE) {
+        error = "Truncated TGA header";
+        return false;
+    }
+
+    const uint8_t idLength = data[0];
+    const uint8_t colorMapType = data[1];
+    const uint8_t imageType = data[2];
+    const int width = ReadLE16(data + 12);
+    const int height = ReadLE16(data + 14);
+    const uint8_t pixelDepth = data[16];
+    const uint8_t descriptor = data[17];
+
+    const bool grayscale = imageType == 3 || imageType == 11;
+    const bool rle = imageType == 10 || imageType == 11;
+    if (colorMapType != 0 || (imageType != 2 && imageType != 3 && imageType != 10 && imageType != 11)) {
+        error = "Unsupported TGA image type " + std::to_string(imageType);
+        return false;
+    }
+    if (grayscale ? pixelDepth != 8 : (pixelDepth != 24 && pixelDepth != 32)) {
+        error = "Unsupported TGA pixel depth " + std::to_string(pixelDepth);
+        return false;
+    }
+    if (!CheckDimensions(width, height, error)) return false;
+
+    const size_t bytesPerPixel = pixelDepth / 8;
+    const size_t pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height);
+    size_t position = TGA_HEADER_SIZE + idLength;
+
+    // 先依檔案順序展開成 RGBA，再依原點放到正確的列
+    std::vector<uint8_t> pixels(pixelCount * 4);
+    const auto readPixel = [&](const uint8_t* source, uint8_t* destination) {
+        if (grayscale) {
+            destination[0] = destination[1] = destination[2] = source[0];
+            destination[3] = 255;
+        } else {
+            destination[0] = source[2];
+            destination[1] = source[1];
+            destination[2] = source[0];
+            destination[3] = bytesPerPixel == 4 ? source[3] : 255;
+        }
+    };
+
+    size_t decoded = 0;
+    while (decoded < pixelCount) {
+        size_t count = 1;
+        bool repeat = false;
+        if (rle) {
+            if (position >= size) break;
+            const uint8_t packet = data[position++];
+            count = std::min<size_t>((packet & 0x7F) + 1, pixelCount - decoded);
+            repeat = (packet & 0x80) != 0;
+        } else {
+            count = pixelCount;
+        }
+
+        const size_t needed = (repeat ? 1 : count) * bytesPerPixel;
+        if (position + needed > size) break;
+        for (size_t i = 0; i < count; ++i) {
+            readPixel(data + position + (repeat ? 0 : i * bytesPerPixel), pixels.data() + (decoded + i) * 4);
+        }
+        position += needed;
+        decoded += count;
+    }
+    if (decoded < pixelCount) {
+        error = "Truncated TGA pixel data";
+        return false;
+    }
+
+    const bool topOrigin = (descriptor & 0x20) != 0;
+    const bool rightToLeft = (descriptor & 0x10) != 0;
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(pixels.size());
+    const size_t rowBytes = static_cast<size_t>(width) * 4;
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* source = pixels.data() + static_cast<size_t>(row) * rowBytes;
+        uint8_t* destination = image.pixels.data() + static_cast<size_t>(topOrigin ? height - 1 - row : row) * rowBytes;
+        for (int x = 0; x < width; ++x) {
+            const int targetX = rightToLeft ? width - 1 - x : x;
+            for (int c = 0; c < 4; ++c) {
+                destination[targetX * 4 + c] = source[x * 4 + c];
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 解碼二進位 PPM（P6）與 PGM（P5）；列由上而下儲存
+ */
+bool ImageDecoder::DecodePnm(const uint8_t* data, size_t size, Image& image, std::string& error) {
+    const bool grayscale = data[1] == '5';
+    size_t position = 2;
+    int width = 0;
+    int height = 0;
+    int maxValue = 0;
+    if (!ReadPnmValue(data, size, position, width) || !ReadPnmValue(data, size, position, height) ||
+        !ReadPnmValue(data, size, position, maxValue)) {
+        error = "Malformed PNM header";
+        return false;
+    }
+    if (maxValue <= 0 || maxValue > 255) {
+        error = "Unsupported PNM maximum value " + std::to_string(maxValue);
+        return false;
+    }
+    if (!CheckDimensions(width, height, error)) return false;
+
+    // 最大值之後恰好一個空白字元
+    if (position >= size || !std::isspace(data[position])) {
+        error = "Malformed PNM header";
+        return false;
+    }
+    ++position;
+
+    const size_t channels = grayscale ? 1 : 3;
+    const size_t sourceRowBytes = static_cast<size_t>(width) * channels;
+    if (size - position < sourceRowBytes * static_cast<size_t>(height)) {
+        error = "Truncated PNM pixel data";
+        return false;
+    }
+
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* source = data + position + static_cast<size_t>(row) * sourceRowBytes;
+        uint8_t* destination = image.pixels.data() + static_cast<size_t>(height - 1 - row) * width * 4;
+        for (int x = 0; x < width; ++x) {
+            for (int c = 0; c < 3; ++c) {
+                const int value = source[x * channels + (grayscale ? 0 : c)];
+                destination[x * 4 + c] = static_cast<uint8_t>((value * 255 + maxValue / 2) / maxValue);
+            }
+            destination[x * 4 + 3] = 255;
+        }
+    }
+    return true;
+}
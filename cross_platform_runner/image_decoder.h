@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file image_decoder.h
+ * @brief 不依賴外部函式庫的影像解碼器
+ *
+ * 支援 TGA（未壓縮與 RLE；8 位元灰階、24 與 32 位元色彩，不支援色盤）與
+ * 二進位 PPM/PGM（P6、P5，每通道 8 位元）。輸出一律為 RGBA8，
+ * 第一列為影像底部，可直接上傳為 OpenGL 紋理（t = 0 在底部）。
+ * 所有函數皆可在多個執行緒同時呼叫。
+ */
+
+class ImageDecoder {
+public:
+    static constexpr int MAX_DIMENSION = 16384;
+
+    struct Image {
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> pixels;    // width * height * 4 位元組，列由下而上
+    };
+
+    static bool DecodeFile(const std::string& filename, Image& image, std::string& error);
+    // 依檔頭判斷格式：以 "P5"/"P6" 開頭為 PNM，其餘視為 TGA
+    static bool DecodeMemory(const uint8_t* data, size_t size, Image& image, std::string& error);
+
+private:
+    static bool DecodeTga(const uint8_t* data, size_t size, Image& image, std::string& error);
+    static bool DecodePnm(const uint8_t* data, size_t size, Image& image, std::string& error);
+};
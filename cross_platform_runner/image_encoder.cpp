@@ -0,0 +1,151 @@
+/**
+ * @file image_encoder.cpp
+ * @brief PNG 與原始 RGB 影格編碼實現
+ */
+
+#include "image_encoder.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+
+namespace {
+
+constexpr size_t MAX_STORED_BLOCK = 65535;
+
+const std::array<uint32_t, 256>& CrcTable() {
+    static const std::array<uint32_t, 256> table = []() {
+        std::array<uint32_t, 256> result{};
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            result[n] = c;
+        }
+        return result;
+    }();
+    return table;
+}
+
+void AppendBE32(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// 長度、類型、資料、CRC（涵蓋類型與資料）
+void AppendChunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data) {
+    AppendBE32(out, static_cast<uint32_t>(data.size()));
+    const size_t typeOffset = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    AppendBE32(out, ImageEncoder::Crc32(out.data() + typeOffset, out.size() - typeOffset));
+}
+
+} // namespace
+
+uint32_t ImageEncoder::Crc32(const uint8_t* data, size_t size, uint32_t crc) {
+    const auto& table = CrcTable();
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint32_t ImageEncoder::Adler32(const uint8_t* data, size_t size, uint32_t adler) {
+    constexpr uint32_t MOD = 65521;
+    // 5552 為 s2 不會溢位的最大區段長度
+    constexpr size_t BLOCK = 5552;
+    uint32_t s1 = adler & 0xFFFF;
+    uint32_t s2 = adler >> 16;
+    while (size > 0) {
+        const size_t length = std::min(size, BLOCK);
+        for (size_t i = 0; i < length; ++i) {
+            s1 += data[i];
+            s2 += s1;
+        }
+        s1 %= MOD;
+        s2 %= MOD;
+        data += length;
+        size -= length;
+    }
+    return (s2 << 16) | s1;
+}
+
+void ImageEncoder::ConvertToRgbTopDown(int width, int height, const uint8_t* rgba, std::vector<uint8_t>& rgb) {
+    const size_t rowPixels = static_cast<size_t>(width);
+    rgb.resize(rowPixels * static_cast<size_t>(height) * 3);
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* source = rgba + static_cast<size_t>(height - 1 - row) * rowPixels * 4;
+        uint8_t* destination = rgb.data() + static_cast<size_t>(row) * rowPixels * 3;
+        for (size_t x = 0; x < rowPixels; ++x) {
+            destination[x * 3 + 0] = source[x * 4 + 0];
+            destination[x * 3 + 1] = source[x * 4 + 1];
+            destination[x * 3 + 2] = source[x * 4 + 2];
+        }
+    }
+}
+
+/**
+ * @brief 編碼為 8 位元 RGB PNG，掃描線不使用濾波，zlib 串流只含 stored block
+ */
+std::vector<uint8_t> ImageEncoder::EncodePng(int width, int height, const uint8_t* rgba) {
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (width <= 0 || height <= 0 || !rgba) return {};
+
+    std::vector<uint8_t> header;
+    AppendBE32(header, static_cast<uint32_t>(width));
+    AppendBE32(header, static_cast<uint32_t>(height));
+    header.insert(header.end(), {8, 2, 0, 0, 0});   // 位元深度、RGB、deflate、無濾波選項、不交錯
+    AppendChunk(png, "IHDR", header);
+
+    // 每列前加上濾波類型 0
+    std::vector<uint8_t> rgb;
+    ConvertToRgbTopDown(width, height, rgba, rgb);
+    const size_t rowBytes = static_cast<size_t>(width) * 3;
+    std::vector<uint8_t> scanlines;
+    scanlines.reserve((rowBytes + 1) * static_cast<size_t>(height));
+    for (int row = 0; row < height; ++row) {
+        scanlines.push_back(0);
+        const auto begin = rgb.begin() + static_cast<std::ptrdiff_t>(static_cast<size_t>(row) * rowBytes);
+        scanlines.insert(scanlines.end(), begin, begin + static_cast<std::ptrdiff_t>(rowBytes));
+    }
+
+    std::vector<uint8_t> zlib;
+    const size_t blockCount = std::max<size_t>(1, (scanlines.size() + MAX_STORED_BLOCK - 1) / MAX_STORED_BLOCK);
+    zlib.reserve(scanlines.size() + blockCount * 5 + 6);
+    zlib.push_back(0x78);   // deflate，32K 視窗
+    zlib.push_back(0x01);   // 使 CMF*256+FLG 為 31 的倍數
+    for (size_t offset = 0, block = 0; block < blockCount; ++block, offset += MAX_STORED_BLOCK) {
+        const size_t length = std::min(MAX_STORED_BLOCK, scanlines.size() - offset);
+        zlib.push_back(block + 1 == blockCount ? 1 : 0);
+        zlib.push_back(static_cast<uint8_t>(length & 0xFF));
+        zlib.push_back(static_cast<uint8_t>(length >> 8));
+        zlib.push_back(static_cast<uint8_t>(~length & 0xFF));
+        zlib.push_back(static_cast<uint8_t>((~length >> 8) & 0xFF));
+        zlib.insert(zlib.end(), scanlines.begin() + static_cast<std::ptrdiff_t>(offset),
+                    scanlines.begin() + static_cast<std::ptrdiff_t>(offset + length));
+    }
+    AppendBE32(zlib, Adler32(scanlines.data(), scanlines.size()));
+    AppendChunk(png, "IDAT", zlib);
+    AppendChunk(png, "IEND", {});
+    return png;
+}
+
+bool ImageEncoder::WritePng(const std::string& filename, int width, int height, const uint8_t* rgba,
+                            std::string& error) {
+    const std::vector<uint8_t> png = EncodePng(width, height, rgba);
+    if (png.empty()) {
+        error = "Invalid image for " + filename;
+        return false;
+    }
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()))) {
+        error = "Cannot write image file: " + filename;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file image_encoder.h
+ * @brief 截圖與錄影用的影像編碼
+ *
+ * 輸入為 glReadPixels 讀回的 RGBA8，第一列為畫面底部。PNG 以未壓縮的
+ * deflate 區塊（stored block）寫出：不需要 zlib，編碼成本只有複製與校驗和，
+ * 適合每個影格擷取；檔案較大，需要時可再以外部工具壓縮。
+ * 所有函數皆可在多個執行緒同時呼叫。
+ */
+
+class ImageEncoder {
+public:
+    // RGB8 PNG（捨棄 alpha）
+    static std::vector<uint8_t> EncodePng(int width, int height, const uint8_t* rgba);
+    static bool WritePng(const std::string& filename, int width, int height, const uint8_t* rgba, std::string& error);
+
+    // 轉成由上而下的 RGB24 列，可直接接到原始影片串流
+    static void ConvertToRgbTopDown(int width, int height, const uint8_t* rgba, std::vector<uint8_t>& rgb);
+
+    static uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0);
+    static uint32_t Adler32(const uint8_t* data, size_t size, uint32_t adler = 1);
+};
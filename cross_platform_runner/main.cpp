@@ -18,10 +18,12 @@
  * - 效能監控和統計
  */
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <chrono>
 #include <thread>
+#include <filesystem>
 
 // 跨平台標頭檔
 #ifdef _WIN32
@@ -46,6 +48,8 @@
 #include "input_manager.h"
 #include "scene_loader.h"
 #include "performance_monitor.h"
+#include "physics_recording.h"
+#include "scene_streamer.h"
 #include "../scene_format/physics_scene_format.h"
 
 /**
@@ -72,6 +76,10 @@ public:
     void ResetScene();
     void SaveScreenshot(const std::string& filename);
 
+    // 檢查點（模擬中途儲存與回溯）
+    bool SaveCheckpoint();
+    bool RestoreCheckpoint();
+
     // 模擬控制
     void PlaySimulation();
     void PauseSimulation();
@@ -79,6 +87,14 @@ public:
     void StepSimulation();
     bool IsSimulationRunning() const { return m_simulationState == SimulationState::Playing; }
 
+    // 錄製與回放
+    bool StartRecording(const std::string& filename);
+    void StopRecording();
+    bool LoadPlayback(const std::string& filename);
+    void SeekPlayback(double simulationTime);
+    void StepPlayback(int frameDelta);
+    bool IsPlaybackMode() const { return m_playback && m_playback->IsOpen(); }
+
 private:
     // 模擬狀態
     enum class SimulationState {
@@ -93,6 +109,11 @@ private:
     std::unique_ptr<InputManager> m_inputManager;
     std::unique_ptr<SceneLoader> m_sceneLoader;
     std::unique_ptr<PerformanceMonitor> m_performanceMonitor;
+    std::unique_ptr<PhysicsRecorder> m_recorder;
+    std::unique_ptr<PhysicsPlayback> m_playback;
+    std::unique_ptr<SceneStreamer> m_sceneStreamer;
+    std::unique_ptr<PhysicsDebugDrawer> m_debugDrawer;
+    SimulationCheckpoint m_checkpoint;
 
     // GLFW 視窗
     GLFWwindow* m_window;
@@ -105,6 +126,18 @@ private:
     std::string m_currentSceneFile;
     bool m_sceneLoaded;
 
+    // 快照到場景剛體的索引對應（名稱表變更時重建）
+    std::shared_ptr<const std::vector<std::string>> m_snapshotBodyNames;
+    std::vector<int> m_snapshotToSceneIndex;
+    uint64_t m_lastSnapshotFrame;
+
+    // 套用到場景的上一個影格：休眠中的剛體不會移動，只需寫入活動中或剛進入休眠的剛體
+    std::vector<uint8_t> m_snapshotWasActive;
+    std::vector<uint32_t> m_movedSceneBodies;
+    double m_lastAppliedTime;
+    bool m_fullSceneSync;               // 下一次套用寫入所有剛體（載入、重置、檢查點還原後）
+    double m_playbackTime;
+
     // 模擬狀態
     SimulationState m_simulationState;
     double m_simulationTime;
@@ -139,6 +172,9 @@ private:
 
     // 主迴圈函數
     void Update(double deltaTime);
+    void SyncSceneFromSnapshot();
+    void UpdatePlayback(double deltaTime);
+    void ApplyFrameToScene(const FrameSnapshot& frame);
     void Render();
     void UpdateUI();
     void UpdateStatistics(double deltaTime);
@@ -188,6 +224,10 @@ PhysicsSceneRunner::PhysicsSceneRunner()
     , m_windowHeight(720)
     , m_windowTitle("Physics Scene Runner")
     , m_sceneLoaded(false)
+    , m_lastSnapshotFrame(0)
+    , m_lastAppliedTime(0.0)
+    , m_fullSceneSync(true)
+    , m_playbackTime(0.0)
     , m_simulationState(SimulationState::Stopped)
     , m_simulationTime(0.0)
     , m_lastFrameTime(0.0)
@@ -218,6 +258,9 @@ bool PhysicsSceneRunner::Initialize(int argc, char* argv[]) {
 
     // 解析命令列參數
     std::string sceneFile;
+    std::string recordFile;
+    std::string playbackFile;
+    std::string captureFile;
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
         if (arg == "--help" || arg == "-h") {
@@ -231,6 +274,12 @@ bool PhysicsSceneRunner::Initialize(int argc, char* argv[]) {
             m_windowWidth = std::atoi(argv[++i]);
         } else if (arg == "--height" && i + 1 < argc) {
             m_windowHeight = std::atoi(argv[++i]);
+        } else if (arg == "--record" && i + 1 < argc) {
+            recordFile = argv[++i];
+        } else if (arg == "--playback" && i + 1 < argc) {
+            playbackFile = argv[++i];
+        } else if (arg == "--capture" && i + 1 < argc) {
+            captureFile = argv[++i];
         } else if (arg.find(".pscene") != std::string::npos) {
             sceneFile = arg;
         }
@@ -251,6 +300,10 @@ bool PhysicsSceneRunner::Initialize(int argc, char* argv[]) {
         return false;
     }
 
+    // Bullet 除錯繪製經由渲染器的除錯圖元批次
+    m_debugDrawer = std::make_unique<PhysicsDebugDrawer>(m_renderer.get());
+    m_physicsEngine->SetDebugDrawer(m_debugDrawer.get());
+
     // 設定回調函數
     SetupCallbacks();
 
@@ -261,6 +314,25 @@ bool PhysicsSceneRunner::Initialize(int argc, char* argv[]) {
         }
     }
 
+    // 錄製或回放（回放需要場景提供剛體形狀與材質）
+    if (!playbackFile.empty()) {
+        if (!LoadPlayback(playbackFile)) {
+            std::cerr << "Warning: Failed to load playback cache: " << playbackFile << std::endl;
+        }
+    } else if (!recordFile.empty()) {
+        if (!StartRecording(recordFile)) {
+            std::cerr << "Warning: Failed to start recording: " << recordFile << std::endl;
+        }
+    }
+
+    // 擷取每個影格：.rgb 為單一原始 RGB24 串流，其他視為 PNG 檔名格式（例如 frames/%06d.png）
+    if (!captureFile.empty()) {
+        const bool raw = captureFile.size() >= 4 && captureFile.compare(captureFile.size() - 4, 4, ".rgb") == 0;
+        if (!m_renderer->StartFrameCapture(captureFile, raw ? FrameCapture::Format::RawRgb : FrameCapture::Format::Png)) {
+            std::cerr << "Warning: Failed to start frame capture: " << captureFile << std::endl;
+        }
+    }
+
     // 列印系統資訊
     PrintSystemInfo();
     PrintControls();
@@ -276,9 +348,20 @@ void PhysicsSceneRunner::Cleanup() {
     std::cout << "Cleaning up Physics Scene Runner..." << std::endl;
 
     // 清理子系統
+    StopRecording();
+    // 寫完已擷取的影格；需要在 OpenGL 上下文銷毀前
+    if (m_renderer) {
+        m_renderer->StopFrameCapture();
+    }
+    m_playback.reset();
+    m_sceneStreamer.reset();
     m_performanceMonitor.reset();
     m_sceneLoader.reset();
     m_inputManager.reset();
+    if (m_physicsEngine) {
+        m_physicsEngine->SetDebugDrawer(nullptr);
+    }
+    m_debugDrawer.reset();
     m_renderer.reset();
     m_physicsEngine.reset();
 
@@ -309,11 +392,31 @@ int PhysicsSceneRunner::Run() {
         // 處理輸入
         ProcessInput();
 
-        // 更新模擬
-        Update(deltaTime);
+        // 更新模擬；回放模式下改由回放快取驅動場景
+        if (IsPlaybackMode()) {
+            UpdatePlayback(deltaTime);
+        } else {
+            // 依相機位置串流分塊，必須在物理步進前加入或移除剛體
+            if (m_sceneStreamer) {
+                const glm::vec3& eye = m_renderer->GetCamera().position;
+                m_sceneStreamer->Update(PhysicsScene::Vector3(eye.x, eye.y, eye.z));
+            }
 
-        // 渲染場景
+            Update(deltaTime);
+
+            // 以最新的物理快照更新渲染用場景資料
+            SyncSceneFromSnapshot();
+
+            if (m_recorder) {
+                m_recorder->Poll(m_physicsEngine->GetSnapshotRing());
+            }
+        }
+
+        // 渲染場景；先切換 GPU 計時查詢（取得數個影格前各 pass 的 GPU 時間）並推進紋理串流
+        m_renderer->BeginGpuTimingFrame();
+        m_renderer->UpdateTextureStreaming();
         Render();
+        m_renderer->CaptureFrame();
 
         // 更新統計
         UpdateStatistics(deltaTime);
@@ -338,17 +441,38 @@ bool PhysicsSceneRunner::LoadScene(const std::string& filename) {
         return false;
     }
 
+    // 舊場景的串流剛體要在重建物理世界前移除
+    m_sceneStreamer.reset();
+
     // 初始化物理引擎
     if (!m_physicsEngine->InitializeScene(m_scene)) {
         std::cerr << "Failed to initialize physics engine with scene" << std::endl;
         return false;
     }
+    m_physicsEngine->SetCollisionFiltering(m_scene.simulationSettings);
 
     // 初始化渲染器
     if (!m_renderer->InitializeScene(m_scene)) {
         std::cerr << "Failed to initialize renderer with scene" << std::endl;
         return false;
     }
+    // 新場景的剛體索引與舊場景無關，包圍盒全部重建
+    m_renderer->InvalidateCulling();
+    m_fullSceneSync = true;
+
+    // 同名的 .ptiles 分塊檔案存在時，靜態剛體依相機位置串流載入
+    std::filesystem::path tileFile(filename);
+    tileFile.replace_extension(PhysicsScene::TILE_FILE_EXTENSION);
+    std::error_code fileError;
+    if (std::filesystem::exists(tileFile, fileError)) {
+        m_sceneStreamer = std::make_unique<SceneStreamer>(m_physicsEngine.get());
+        if (m_sceneStreamer->Open(tileFile.string())) {
+            std::cout << "Streaming tiles from: " << tileFile.string() << std::endl;
+        } else {
+            std::cerr << "Failed to open tile file: " << m_sceneStreamer->GetLastError() << std::endl;
+            m_sceneStreamer.reset();
+        }
+    }
 
     m_currentSceneFile = filename;
     m_sceneLoaded = true;
@@ -371,12 +495,234 @@ void PhysicsSceneRunner::ResetScene() {
     std::cout << "Resetting scene..." << std::endl;
 
     StopSimulation();
+    // 串流剛體先移除，分塊標回未載入，重置後依相機位置重新串流
+    if (m_sceneStreamer) {
+        m_sceneStreamer->Reset();
+    }
     m_physicsEngine->ResetScene();
     m_simulationTime = 0.0;
+    m_fullSceneSync = true;
 
     std::cout << "Scene reset complete." << std::endl;
 }
 
+/**
+ * @brief 截圖；在目前影格繪製後非同步讀回，不阻塞主迴圈
+ */
+void PhysicsSceneRunner::SaveScreenshot(const std::string& filename) {
+    if (m_renderer->SaveScreenshot(filename)) {
+        std::cout << "Screenshot queued: " << filename << std::endl;
+    }
+}
+
+/**
+ * @brief 儲存目前的模擬狀態
+ */
+bool PhysicsSceneRunner::SaveCheckpoint() {
+    if (!m_sceneLoaded || IsPlaybackMode()) return false;
+
+    if (!m_physicsEngine->SaveCheckpoint(m_checkpoint)) {
+        HandleError("Failed to save simulation checkpoint");
+        return false;
+    }
+
+    std::cout << "Checkpoint saved at t=" << m_checkpoint.simulationTime << "s ("
+              << m_checkpoint.GetMemorySize() / 1024 << " KB)" << std::endl;
+    return true;
+}
+
+/**
+ * @brief 回溯到上次儲存的模擬狀態
+ */
+bool PhysicsSceneRunner::RestoreCheckpoint() {
+    if (!m_sceneLoaded || IsPlaybackMode() || !m_checkpoint.IsValid()) return false;
+
+    if (!m_physicsEngine->RestoreCheckpoint(m_checkpoint)) {
+        HandleError("Failed to restore simulation checkpoint");
+        return false;
+    }
+
+    m_simulationTime = m_checkpoint.simulationTime;
+    m_fullSceneSync = true;
+    SyncSceneFromSnapshot();
+
+    std::cout << "Checkpoint restored to t=" << m_simulationTime << "s" << std::endl;
+    return true;
+}
+
+/**
+ * @brief 將最新的物理影格快照套用到渲染用的場景資料
+ *
+ * 從 PhysicsEngine 的快照環形緩衝區讀取，不直接查詢模擬中的剛體，
+ * 因此不會與物理步驟互相等待。
+ */
+void PhysicsSceneRunner::SyncSceneFromSnapshot() {
+    if (!m_sceneLoaded) return;
+
+    auto snapshot = m_physicsEngine->GetSnapshotRing().AcquireLatest();
+    if (!snapshot || snapshot->frameIndex == m_lastSnapshotFrame) return;
+
+    ApplyFrameToScene(*snapshot);
+    m_lastSnapshotFrame = snapshot->frameIndex;
+}
+
+/**
+ * @brief 將影格（即時快照或回放影格）的剛體變換寫入場景資料
+ *
+ * 只寫入本影格或上一個套用的影格中活動的剛體，並把它們交給渲染器更新包圍盒。
+ * 剛體從開始移動到進入休眠至少經過 Bullet 的休眠時間，因此兩個影格相隔
+ * 不超過 FULL_SYNC_GAP 時，兩者皆休眠的剛體之間不會移動；相隔更久、時間倒退
+ * （回放拖曳）或名稱表改變時寫入全部剛體。
+ */
+void PhysicsSceneRunner::ApplyFrameToScene(const FrameSnapshot& frame) {
+    static constexpr double FULL_SYNC_GAP = 1.0;
+
+    // 名稱表只在剛體增減時改變，此時才重建索引對應
+    if (frame.bodyNames != m_snapshotBodyNames) {
+        m_snapshotBodyNames = frame.bodyNames;
+        m_snapshotToSceneIndex.assign(frame.bodies.size(), -1);
+        for (size_t i = 0; i < m_scene.rigidBodies.size(); ++i) {
+            int index = frame.FindBody(m_scene.rigidBodies[i].name);
+            if (index >= 0) {
+                m_snapshotToSceneIndex[index] = static_cast<int>(i);
+            }
+        }
+        m_fullSceneSync = true;
+    }
+
+    const double gap = frame.simulationTime - m_lastAppliedTime;
+    const bool fullSync = m_fullSceneSync || gap < 0.0 || gap > FULL_SYNC_GAP;
+    m_snapshotWasActive.resize(m_snapshotToSceneIndex.size(), 0);
+    m_movedSceneBodies.clear();
+
+    for (size_t i = 0; i < frame.bodies.size() && i < m_snapshotToSceneIndex.size(); ++i) {
+        int sceneIndex = m_snapshotToSceneIndex[i];
+        const bool active = frame.bodies[i].active;
+        if (sceneIndex >= 0 && (fullSync || active || m_snapshotWasActive[i])) {
+            m_scene.rigidBodies[sceneIndex].transform = frame.bodies[i].transform;
+            m_movedSceneBodies.push_back(static_cast<uint32_t>(sceneIndex));
+        }
+        m_snapshotWasActive[i] = active ? 1 : 0;
+    }
+
+    m_renderer->MarkBodiesMoved(m_movedSceneBodies);
+    m_lastAppliedTime = frame.simulationTime;
+    m_fullSceneSync = false;
+}
+
+/**
+ * @brief 開始將模擬錄製到回放快取
+ */
+bool PhysicsSceneRunner::StartRecording(const std::string& filename) {
+    m_recorder = std::make_unique<PhysicsRecorder>();
+    if (!m_recorder->Open(filename)) {
+        std::cerr << "Recording error: " << m_recorder->GetLastError() << std::endl;
+        m_recorder.reset();
+        return false;
+    }
+
+    std::cout << "Recording simulation to: " << filename << std::endl;
+    return true;
+}
+
+/**
+ * @brief 停止錄製並寫入關鍵影格索引
+ */
+void PhysicsSceneRunner::StopRecording() {
+    if (!m_recorder) return;
+
+    m_recorder->Poll(m_physicsEngine->GetSnapshotRing());
+    if (!m_recorder->Close()) {
+        std::cerr << "Recording error: " << m_recorder->GetLastError() << std::endl;
+    }
+
+    std::cout << "Recorded " << m_recorder->GetRecordedFrameCount() << " frames ("
+              << m_recorder->GetBytesWritten() / 1024 << " KB, "
+              << m_recorder->GetMissedFrameCount() << " missed)" << std::endl;
+    m_recorder.reset();
+}
+
+/**
+ * @brief 載入回放快取，進入回放模式
+ */
+bool PhysicsSceneRunner::LoadPlayback(const std::string& filename) {
+    m_playback = std::make_unique<PhysicsPlayback>();
+    if (!m_playback->Open(filename)) {
+        std::cerr << "Playback error: " << m_playback->GetLastError() << std::endl;
+        m_playback.reset();
+        return false;
+    }
+
+    m_playbackTime = 0.0;
+    m_fullSceneSync = true;
+    ApplyFrameToScene(m_playback->GetCurrentFrame());
+
+    std::cout << "Playback loaded: " << m_playback->GetFrameCount() << " frames, "
+              << m_playback->GetDuration() << " s" << std::endl;
+    return true;
+}
+
+/**
+ * @brief 回放模式下依播放狀態推進時間軸
+ */
+void PhysicsSceneRunner::UpdatePlayback(double deltaTime) {
+    if (m_simulationState != SimulationState::Playing) return;
+
+    double nextTime = m_playbackTime + deltaTime * m_timeScale;
+    if (nextTime >= m_playback->GetDuration()) {
+        nextTime = m_playback->GetDuration();
+        m_simulationState = SimulationState::Paused;
+    }
+    SeekPlayback(nextTime);
+}
+
+/**
+ * @brief 拖曳回放時間軸到指定模擬時間
+ */
+void PhysicsSceneRunner::SeekPlayback(double simulationTime) {
+    if (!IsPlaybackMode()) return;
+
+    simulationTime = std::max(0.0, std::min(simulationTime, m_playback->GetDuration()));
+    if (m_playback->SeekTime(simulationTime)) {
+        m_playbackTime = simulationTime;
+        m_simulationTime = m_playback->GetCurrentFrame().simulationTime;
+        ApplyFrameToScene(m_playback->GetCurrentFrame());
+    }
+}
+
+/**
+ * @brief 回放模式下逐格前進或後退
+ */
+void PhysicsSceneRunner::StepPlayback(int frameDelta) {
+    if (!IsPlaybackMode()) return;
+
+    int64_t target = static_cast<int64_t>(m_playback->GetCurrentFrameNumber()) + frameDelta;
+    target = std::max<int64_t>(0, std::min<int64_t>(target, static_cast<int64_t>(m_playback->GetFrameCount()) - 1));
+    if (m_playback->SeekFrame(static_cast<uint64_t>(target))) {
+        m_playbackTime = m_playback->GetCurrentFrame().simulationTime;
+        m_simulationTime = m_playbackTime;
+        ApplyFrameToScene(m_playback->GetCurrentFrame());
+    }
+}
+
+/**
+ * @brief 渲染場景與介面；UI pass 在此標記 GPU 計時
+ */
+void PhysicsSceneRunner::Render() {
+    m_renderer->BeginFrame();
+    // 物理除錯線段先累積到渲染器的批次，在除錯 pass 中繪製；回放時世界不代表畫面上的狀態
+    if (!IsPlaybackMode()) {
+        m_physicsEngine->DebugDrawWorld();
+    }
+    m_renderer->Render(m_scene);
+
+    m_renderer->BeginGpuPass(GpuProfiler::Pass::UI);
+    UpdateUI();
+    m_renderer->EndGpuPass(GpuProfiler::Pass::UI);
+
+    m_renderer->EndFrame();
+}
+
 /**
  * @brief 主程式進入點
  */
@@ -0,0 +1,230 @@
+/**
+ * @file mesh_lod.cpp
+ * @brief 網格細節層級（LOD）實現
+ */
+
+#include "mesh_lod.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+
+#include "mesh_optimizer.h"
+
+const float MeshLod::SCREEN_SIZE_THRESHOLDS[MeshLod::MAX_LEVELS - 1] = {0.25f, 0.1f, 0.04f};
+
+namespace {
+
+// 簡化後三角形數沒有減少到上一級的這個比例以下時停止產生更多層級
+constexpr float MIN_LEVEL_REDUCTION = 0.85f;
+
+/**
+ * @brief 原網格頂點的均勻格點索引，用來替簡化後的頂點找回紋理座標
+ */
+class VertexGrid {
+public:
+    VertexGrid(const std::vector<glm::vec3>& vertices, const std::vector<glm::vec3>* normals)
+        : m_vertices(vertices)
+        , m_normals(normals)
+    {
+        glm::vec3 minimum(std::numeric_limits<float>::max());
+        glm::vec3 maximum(-std::numeric_limits<float>::max());
+        for (const auto& v : vertices) {
+            minimum = glm::min(minimum, v);
+            maximum = glm::max(maximum, v);
+        }
+        const glm::vec3 size = maximum - minimum;
+        const float extent = std::max(std::max(size.x, size.y), std::max(size.z, 1e-6f));
+        // 平均每格約一個頂點
+        m_cellsPerAxis = std::max(1, static_cast<int>(std::cbrt(static_cast<float>(vertices.size()))));
+        m_cellSize = extent / static_cast<float>(m_cellsPerAxis);
+        m_origin = minimum;
+
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            m_cells[Key(Cell(vertices[i]))].push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    /**
+     * @brief 位置最近的頂點；距離相同（接縫上的分裂頂點）時取法向最接近 normal 者
+     *
+     * 由查詢點所在的格向外逐圈搜尋。第 ring 圈找到的頂點距離不超過
+     * (ring + 1)·√3 格，因此只需再搜尋到該圈數為止。
+     */
+    uint32_t FindNearest(const glm::vec3& position, const glm::vec3& normal) const {
+        const CellCoord center = Cell(position);
+        uint32_t best = 0;
+        float bestDistance = std::numeric_limits<float>::max();
+        float bestAlignment = -std::numeric_limits<float>::max();
+        int lastRing = m_cellsPerAxis;
+
+        for (int ring = 0; ring <= lastRing; ++ring) {
+            const bool found = bestDistance < std::numeric_limits<float>::max();
+            ForEachInRing(center, ring, [&](uint32_t index) {
+                const glm::vec3 offset = m_vertices[index] - position;
+                const float distance = glm::dot(offset, offset);
+                const float tolerance = 1e-12f + bestDistance * 1e-6f;
+                if (distance < bestDistance - tolerance) {
+                    best = index;
+                    bestDistance = distance;
+                    bestAlignment = Alignment(index, normal);
+                } else if (distance <= bestDistance + tolerance) {
+                    const float alignment = Alignment(index, normal);
+                    if (alignment > bestAlignment) {
+                        best = index;
+                        bestAlignment = alignment;
+                    }
+                }
+            });
+            if (!found && bestDistance < std::numeric_limits<float>::max()) {
+                lastRing = std::min(lastRing, static_cast<int>(std::ceil(static_cast<float>(ring + 1) * 1.7320508f)));
+            }
+        }
+        return best;
+    }
+
+private:
+    struct CellCoord {
+        int x, y, z;
+    };
+
+    // 範圍外的點夾到邊界格，落在範圍外時結果為近似的最近點
+    CellCoord Cell(const glm::vec3& position) const {
+        const glm::vec3 cell = (position - m_origin) / m_cellSize;
+        const auto clampAxis = [this](float value) {
+            return std::min(std::max(static_cast<int>(std::floor(value)), 0), m_cellsPerAxis);
+        };
+        return {clampAxis(cell.x), clampAxis(cell.y), clampAxis(cell.z)};
+    }
+
+    static uint64_t Key(const CellCoord& cell) {
+        const auto pack = [](int value) { return static_cast<uint64_t>(static_cast<uint32_t>(value) & 0x1FFFFFu); };
+        return (pack(cell.x) << 42) | (pack(cell.y) << 21) | pack(cell.z);
+    }
+
+    float Alignment(uint32_t index, const glm::vec3& normal) const {
+        return m_normals ? glm::dot((*m_normals)[index], normal) : 0.0f;
+    }
+
+    template <typename Function>
+    void ForEachInRing(const CellCoord& center, int ring, Function&& function) const {
+        for (int x = -ring; x <= ring; ++x) {
+            for (int y = -ring; y <= ring; ++y) {
+                for (int z = -ring; z <= ring; ++z) {
+                    // 只走外殼，內部的格已在較小的圈搜尋過
+                    if (std::max(std::abs(x), std::max(std::abs(y), std::abs(z))) != ring) continue;
+                    auto it = m_cells.find(Key({center.x + x, center.y + y, center.z + z}));
+                    if (it == m_cells.end()) continue;
+                    for (uint32_t index : it->second) {
+                        function(index);
+                    }
+                }
+            }
+        }
+    }
+
+    const std::vector<glm::vec3>& m_vertices;
+    const std::vector<glm::vec3>* m_normals;    // 與 m_vertices 等長，或為 nullptr
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells;
+    glm::vec3 m_origin;
+    float m_cellSize = 1.0f;
+    int m_cellsPerAxis = 1;
+};
+
+// 以面積加權的面法向平均出頂點法向
+std::vector<glm::vec3> ComputeVertexNormals(const MeshOptimizer::Mesh& mesh) {
+    std::vector<glm::vec3> normals(mesh.vertices.size(), glm::vec3(0.0f));
+    for (const auto& triangle : mesh.triangles) {
+        const auto& a = mesh.vertices[triangle[0]];
+        const auto& b = mesh.vertices[triangle[1]];
+        const auto& c = mesh.vertices[triangle[2]];
+        const glm::vec3 faceNormal = glm::cross(glm::vec3(b.x - a.x, b.y - a.y, b.z - a.z),
+                                                glm::vec3(c.x - a.x, c.y - a.y, c.z - a.z));
+        for (int corner = 0; corner < 3; ++corner) {
+            normals[triangle[corner]] += faceNormal;
+        }
+    }
+    for (auto& normal : normals) {
+        const float length = glm::length(normal);
+        normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+    }
+    return normals;
+}
+
+} // namespace
+
+std::vector<MeshLod::MeshData> MeshLod::BuildChain(const MeshData& source, size_t maxLevels, float reduction,
+                                                   size_t minTriangles) {
+    std::vector<MeshData> levels;
+    if (source.indices.size() < 3 || source.indices.size() % 3 != 0 || maxLevels < 2) return levels;
+    for (unsigned int index : source.indices) {
+        if (index >= source.vertices.size()) return levels;
+    }
+
+    MeshOptimizer::Mesh mesh;
+    mesh.vertices.reserve(source.vertices.size());
+    for (const auto& v : source.vertices) {
+        mesh.vertices.emplace_back(v.x, v.y, v.z);
+    }
+    mesh.triangles.reserve(source.indices.size() / 3);
+    for (size_t i = 0; i + 2 < source.indices.size(); i += 3) {
+        mesh.triangles.push_back({static_cast<int>(source.indices[i]),
+                                  static_cast<int>(source.indices[i + 1]),
+                                  static_cast<int>(source.indices[i + 2])});
+    }
+
+    VertexGrid grid(source.vertices, source.normals.size() == source.vertices.size() ? &source.normals : nullptr);
+    const bool transferTexCoords = source.texCoords.size() == source.vertices.size();
+
+    // 每級由上一級繼續簡化，總成本約為一次完整簡化
+    for (size_t level = 1; level < maxLevels; ++level) {
+        const size_t previousTriangles = mesh.triangles.size();
+        const size_t target = static_cast<size_t>(static_cast<float>(previousTriangles) * reduction);
+        if (target < minTriangles) break;
+
+        MeshOptimizer::Decimate(mesh, target);
+        if (mesh.triangles.empty() ||
+            static_cast<float>(mesh.triangles.size()) > static_cast<float>(previousTriangles) * MIN_LEVEL_REDUCTION) {
+            break;
+        }
+
+        MeshData data;
+        data.normals = ComputeVertexNormals(mesh);
+        data.vertices.reserve(mesh.vertices.size());
+        for (const auto& v : mesh.vertices) {
+            data.vertices.emplace_back(v.x, v.y, v.z);
+        }
+        if (transferTexCoords) {
+            data.texCoords.reserve(data.vertices.size());
+            for (size_t i = 0; i < data.vertices.size(); ++i) {
+                data.texCoords.push_back(source.texCoords[grid.FindNearest(data.vertices[i], data.normals[i])]);
+            }
+        }
+        data.indices.reserve(mesh.triangles.size() * 3);
+        for (const auto& triangle : mesh.triangles) {
+            for (int corner = 0; corner < 3; ++corner) {
+                data.indices.push_back(static_cast<unsigned int>(triangle[corner]));
+            }
+        }
+        levels.push_back(std::move(data));
+    }
+    return levels;
+}
+
+size_t MeshLod::SelectLevel(float screenSize, size_t levelCount) {
+    size_t level = 0;
+    while (level + 1 < levelCount && level < MAX_LEVELS - 1 && screenSize < SCREEN_SIZE_THRESHOLDS[level]) {
+        ++level;
+    }
+    return level;
+}
+
+float MeshLod::ComputeBoundingRadius(const std::vector<glm::vec3>& vertices) {
+    float radiusSquared = 0.0f;
+    for (const auto& v : vertices) {
+        radiusSquared = std::max(radiusSquared, glm::dot(v, v));
+    }
+    return std::sqrt(radiusSquared);
+}
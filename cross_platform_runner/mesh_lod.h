@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/**
+ * @file mesh_lod.h
+ * @brief 網格細節層級（LOD）
+ *
+ * 匯入的網格以 MeshOptimizer::Decimate 逐級簡化（每級約為上一級的一半），
+ * 簡化後重新計算頂點法向，紋理座標取自原網格中位置最近且法向最接近的頂點。
+ * 基本形狀則由渲染器以較少的分段數直接重新產生。
+ *
+ * 層級依投影到螢幕上的大小選擇：包圍球投影半徑除以視口半高，1 表示填滿
+ * 整個畫面高度。
+ */
+
+class MeshLod {
+public:
+    static constexpr size_t MAX_LEVELS = 4;     // 含原始網格（LOD 0）
+
+    // 與 Renderer::CreateMeshFromVertices 相同的頂點資料
+    struct MeshData {
+        std::vector<glm::vec3> vertices;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec2> texCoords;       // 可為空
+        std::vector<unsigned int> indices;      // 三角形串列
+    };
+
+    /**
+     * @brief 產生 LOD 1 以後的層級（不含 source 本身）
+     *
+     * 每級的目標三角形數為上一級乘以 reduction，少於 minTriangles 或簡化效果
+     * 不明顯時停止，因此回傳的層級數可能少於 maxLevels - 1。
+     */
+    static std::vector<MeshData> BuildChain(const MeshData& source, size_t maxLevels = MAX_LEVELS,
+                                            float reduction = 0.5f, size_t minTriangles = 16);
+
+    // 依螢幕大小選擇層級，levelCount 含 LOD 0；結果在 [0, levelCount - 1]
+    static size_t SelectLevel(float screenSize, size_t levelCount);
+
+    // 以原點為中心的包圍球半徑
+    static float ComputeBoundingRadius(const std::vector<glm::vec3>& vertices);
+
+    // 各層級的最小螢幕大小：screenSize 低於 SCREEN_SIZE_THRESHOLDS[i] 時至少使用 LOD i + 1
+    static const float SCREEN_SIZE_THRESHOLDS[MAX_LEVELS - 1];
+};
@@ -0,0 +1,748 @@
+/**
+ * @file mesh_optimizer.cpp
+ * @brief 碰撞網格最佳化實現
+ */
+
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <set>
+#include <unordered_map>
+
+// Eigen
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/LU>
+
+using Eigen::Matrix3d;
+using Eigen::Matrix4d;
+using Eigen::Vector3d;
+using Eigen::Vector4d;
+using PhysicsScene::Vector3;
+
+namespace {
+
+Vector3d ToEigen(const Vector3& v) {
+    return Vector3d(v.x, v.y, v.z);
+}
+
+Vector3 FromEigen(const Vector3d& v) {
+    return Vector3(static_cast<float>(v.x()), static_cast<float>(v.y()), static_cast<float>(v.z()));
+}
+
+uint64_t MakeEdgeKey(int a, int b) {
+    if (a > b) std::swap(a, b);
+    return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+}
+
+// ---------------------------------------------------------------------------
+// 凸包（Quickhull）
+// ---------------------------------------------------------------------------
+
+struct Hull {
+    std::vector<int> vertices;                 // 輸入點索引，遞增排序
+    std::vector<std::array<int, 3>> faces;     // 外法向逆時針
+    double volume = 0.0;
+};
+
+struct HullFace {
+    std::array<int, 3> vertex;
+    Vector3d normal;
+    double offset;
+    std::vector<int> outside;   // 位於此面外側的點
+    int furthest = -1;
+    double furthestDistance = 0.0;
+    bool alive = true;
+};
+
+/**
+ * @brief 以 Quickhull 建立凸包
+ *
+ * 每次加入距離目前凸包最遠的點，因此 maxVertices 截斷時保留的是形狀
+ * 最主要的頂點（結果是原凸包的內接近似）。點集退化時回傳 false。
+ */
+bool BuildHull(const std::vector<Vector3d>& points, size_t maxVertices, Hull& hull) {
+    hull = Hull();
+    if (points.size() < 4) return false;
+
+    // 初始四面體：軸向極值點中最遠的一對，再取離直線與平面最遠的點
+    std::array<int, 6> extremes = {0, 0, 0, 0, 0, 0};
+    for (int i = 0; i < static_cast<int>(points.size()); ++i) {
+        for (int axis = 0; axis < 3; ++axis) {
+            if (points[i][axis] < points[extremes[axis * 2]][axis]) extremes[axis * 2] = i;
+            if (points[i][axis] > points[extremes[axis * 2 + 1]][axis]) extremes[axis * 2 + 1] = i;
+        }
+    }
+
+    int i0 = extremes[0], i1 = extremes[1];
+    for (int a = 0; a < 6; ++a) {
+        for (int b = a + 1; b < 6; ++b) {
+            if ((points[extremes[a]] - points[extremes[b]]).squaredNorm() >
+                (points[i0] - points[i1]).squaredNorm()) {
+                i0 = extremes[a];
+                i1 = extremes[b];
+            }
+        }
+    }
+
+    const double scale = (points[i1] - points[i0]).norm();
+    const double epsilon = scale * 1e-9;
+    if (scale <= 0.0) return false;
+
+    const Vector3d lineDirection = (points[i1] - points[i0]) / scale;
+    int i2 = -1;
+    double lineDistance = epsilon;
+    for (int i = 0; i < static_cast<int>(points.size()); ++i) {
+        const double distance = (points[i] - points[i0]).cross(lineDirection).norm();
+        if (distance > lineDistance) {
+            lineDistance = distance;
+            i2 = i;
+        }
+    }
+    if (i2 < 0) return false;
+
+    const Vector3d planeNormal = (points[i1] - points[i0]).cross(points[i2] - points[i0]).normalized();
+    int i3 = -1;
+    double planeDistance = epsilon;
+    for (int i = 0; i < static_cast<int>(points.size()); ++i) {
+        const double distance = std::abs(planeNormal.dot(points[i] - points[i0]));
+        if (distance > planeDistance) {
+            planeDistance = distance;
+            i3 = i;
+        }
+    }
+    if (i3 < 0) return false;
+
+    // 凸包內部的固定點，用來決定新面的方向
+    const Vector3d interior = (points[i0] + points[i1] + points[i2] + points[i3]) * 0.25;
+
+    std::vector<HullFace> faces;
+    auto addFace = [&](int a, int b, int c) {
+        HullFace face;
+        Vector3d normal = (points[b] - points[a]).cross(points[c] - points[a]);
+        if (normal.dot(interior - points[a]) > 0.0) {
+            std::swap(b, c);
+            normal = -normal;
+        }
+        face.vertex = {a, b, c};
+        face.normal = normal.normalized();
+        face.offset = face.normal.dot(points[a]);
+        faces.push_back(std::move(face));
+    };
+    auto assign = [&](int point, size_t firstFace) {
+        for (size_t f = firstFace; f < faces.size(); ++f) {
+            const double distance = faces[f].normal.dot(points[point]) - faces[f].offset;
+            if (distance > epsilon) {
+                faces[f].outside.push_back(point);
+                if (distance > faces[f].furthestDistance) {
+                    faces[f].furthestDistance = distance;
+                    faces[f].furthest = point;
+                }
+                return;
+            }
+        }
+    };
+
+    addFace(i0, i1, i2);
+    addFace(i0, i1, i3);
+    addFace(i0, i2, i3);
+    addFace(i1, i2, i3);
+    for (int i = 0; i < static_cast<int>(points.size()); ++i) {
+        if (i != i0 && i != i1 && i != i2 && i != i3) assign(i, 0);
+    }
+
+    size_t vertexCount = 4;
+    std::set<std::pair<int, int>> visibleEdges;
+    std::vector<int> orphans;
+    while (maxVertices == 0 || vertexCount < maxVertices) {
+        // 移除已刪除的面，再找全域最遠的外側點
+        faces.erase(std::remove_if(faces.begin(), faces.end(), [](const HullFace& f) { return !f.alive; }),
+                    faces.end());
+
+        int eye = -1;
+        double eyeDistance = 0.0;
+        for (const HullFace& face : faces) {
+            if (face.furthest >= 0 && face.furthestDistance > eyeDistance) {
+                eyeDistance = face.furthestDistance;
+                eye = face.furthest;
+            }
+        }
+        if (eye < 0) break;
+
+        // 可見面與地平線
+        visibleEdges.clear();
+        orphans.clear();
+        for (HullFace& face : faces) {
+            if (face.normal.dot(points[eye]) - face.offset <= epsilon) continue;
+            face.alive = false;
+            for (int e = 0; e < 3; ++e) {
+                visibleEdges.emplace(face.vertex[e], face.vertex[(e + 1) % 3]);
+            }
+            for (int point : face.outside) {
+                if (point != eye) orphans.push_back(point);
+            }
+        }
+
+        const size_t firstNewFace = faces.size();
+        for (const auto& [a, b] : visibleEdges) {
+            if (!visibleEdges.count({b, a})) addFace(a, b, eye);
+        }
+        for (int point : orphans) {
+            assign(point, firstNewFace);
+        }
+        ++vertexCount;
+    }
+
+    std::vector<bool> onHull(points.size(), false);
+    for (const HullFace& face : faces) {
+        if (!face.alive) continue;
+        hull.faces.push_back(face.vertex);
+        const Vector3d& a = points[face.vertex[0]];
+        const Vector3d& b = points[face.vertex[1]];
+        const Vector3d& c = points[face.vertex[2]];
+        hull.volume += (a - interior).dot((b - interior).cross(c - interior)) / 6.0;
+        for (int v : face.vertex) onHull[v] = true;
+    }
+    for (int i = 0; i < static_cast<int>(points.size()); ++i) {
+        if (onHull[i]) hull.vertices.push_back(i);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 體素化與凸分解
+// ---------------------------------------------------------------------------
+
+using Voxel = std::array<int, 3>;
+
+// 以 21 位元打包格點座標（體素解析度遠小於 2^21）
+uint64_t PackLattice(int x, int y, int z) {
+    return (static_cast<uint64_t>(x) << 42) | (static_cast<uint64_t>(y) << 21) | static_cast<uint64_t>(z);
+}
+
+struct VoxelPart {
+    std::vector<Voxel> voxels;
+    std::vector<Vector3d> points;   // 凸包候選點（體素格點座標）
+    Hull hull;
+    double concavity = 0.0;
+};
+
+/**
+ * @brief 計算一塊體素的凸包與凹度
+ *
+ * 凸包頂點必然是某一列（沿 X 軸）首尾體素的角點，因此只取這些體素的
+ * 角點建立凸包，點數從體素數的八倍降為截面積的十六倍。
+ */
+void EvaluatePart(VoxelPart& part) {
+    std::unordered_map<uint64_t, std::pair<int, int>> rows;
+    for (const Voxel& voxel : part.voxels) {
+        const uint64_t key = PackLattice(0, voxel[1], voxel[2]);
+        auto it = rows.find(key);
+        if (it == rows.end()) {
+            rows.emplace(key, std::make_pair(voxel[0], voxel[0]));
+        } else {
+            it->second.first = std::min(it->second.first, voxel[0]);
+            it->second.second = std::max(it->second.second, voxel[0]);
+        }
+    }
+
+    std::vector<uint64_t> corners;
+    corners.reserve(rows.size() * 16);
+    for (const auto& [key, range] : rows) {
+        const int y = static_cast<int>((key >> 21) & 0x1FFFFF);
+        const int z = static_cast<int>(key & 0x1FFFFF);
+        for (int x : {range.first, range.second + 1}) {
+            for (int dy = 0; dy <= 1; ++dy) {
+                for (int dz = 0; dz <= 1; ++dz) {
+                    corners.push_back(PackLattice(x, y + dy, z + dz));
+                }
+            }
+        }
+    }
+    std::sort(corners.begin(), corners.end());
+    corners.erase(std::unique(corners.begin(), corners.end()), corners.end());
+
+    part.points.clear();
+    part.points.reserve(corners.size());
+    for (uint64_t corner : corners) {
+        part.points.emplace_back(static_cast<double>(corner >> 42),
+                                 static_cast<double>((corner >> 21) & 0x1FFFFF),
+                                 static_cast<double>(corner & 0x1FFFFF));
+    }
+
+    BuildHull(part.points, 0, part.hull);
+    part.concavity = std::max(0.0, part.hull.volume - static_cast<double>(part.voxels.size()));
+}
+
+} // namespace
+
+/**
+ * @brief 焊接頂點
+ *
+ * 頂點以 tolerance 為格距量化，落在同一格的頂點合併為最先出現者；
+ * tolerance 不大於 0 時只合併座標完全相同的頂點。
+ */
+size_t MeshOptimizer::WeldVertices(Mesh& mesh, float tolerance) {
+    const float cell = tolerance > 0.0f ? tolerance : 0.0f;
+    std::map<std::array<int64_t, 3>, int> lookup;
+    std::map<std::array<float, 3>, int> exactLookup;
+    std::vector<int> remap(mesh.vertices.size());
+    std::vector<Vector3> vertices;
+
+    for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+        const Vector3& v = mesh.vertices[i];
+        const int next = static_cast<int>(vertices.size());
+        int index;
+        if (cell > 0.0f) {
+            const std::array<int64_t, 3> key = {std::llround(v.x / cell), std::llround(v.y / cell),
+                                                std::llround(v.z / cell)};
+            index = lookup.emplace(key, next).first->second;
+        } else {
+            index = exactLookup.emplace(std::array<float, 3>{v.x, v.y, v.z}, next).first->second;
+        }
+        if (index == next) vertices.push_back(v);
+        remap[i] = index;
+    }
+
+    for (std::array<int, 3>& triangle : mesh.triangles) {
+        for (int& index : triangle) {
+            if (index >= 0 && index < static_cast<int>(remap.size())) index = remap[index];
+        }
+    }
+
+    // 移除未被三角形引用的頂點
+    std::vector<int> used(vertices.size(), -1);
+    std::vector<Vector3> compacted;
+    for (std::array<int, 3>& triangle : mesh.triangles) {
+        for (int& index : triangle) {
+            if (index < 0 || index >= static_cast<int>(used.size())) continue;
+            if (used[index] < 0) {
+                used[index] = static_cast<int>(compacted.size());
+                compacted.push_back(vertices[index]);
+            }
+            index = used[index];
+        }
+    }
+
+    const size_t removed = mesh.vertices.size() - compacted.size();
+    mesh.vertices = std::move(compacted);
+    return removed;
+}
+
+size_t MeshOptimizer::RemoveDegenerateTriangles(Mesh& mesh, float areaEpsilon) {
+    const int vertexCount = static_cast<int>(mesh.vertices.size());
+    std::set<std::array<int, 3>> seen;
+    std::vector<std::array<int, 3>> triangles;
+    triangles.reserve(mesh.triangles.size());
+
+    for (const std::array<int, 3>& triangle : mesh.triangles) {
+        const int a = triangle[0], b = triangle[1], c = triangle[2];
+        if (a < 0 || b < 0 || c < 0 || a >= vertexCount || b >= vertexCount || c >= vertexCount) continue;
+        if (a == b || b == c || a == c) continue;
+
+        const Vector3d pa = ToEigen(mesh.vertices[a]);
+        const double area = 0.5 * (ToEigen(mesh.vertices[b]) - pa).cross(ToEigen(mesh.vertices[c]) - pa).norm();
+        if (area <= areaEpsilon) continue;
+
+        // 相同頂點組成的三角形（不論繞序）只保留第一個
+        std::array<int, 3> key = triangle;
+        std::sort(key.begin(), key.end());
+        if (!seen.insert(key).second) continue;
+
+        triangles.push_back(triangle);
+    }
+
+    const size_t removed = mesh.triangles.size() - triangles.size();
+    mesh.triangles = std::move(triangles);
+    return removed;
+}
+
+/**
+ * @brief 二次誤差度量簡化
+ *
+ * 每個頂點累積相鄰三角形平面的二次誤差（以面積加權），邊界邊再加上
+ * 通過該邊且垂直於三角形的約束平面。候選邊依收縮誤差放入最小堆，頂點
+ * 變動後以版本號使舊的候選失效。收縮位置取二次誤差的極小點，矩陣奇異
+ * 或極小點離邊太遠時改從兩端點與中點擇一。
+ */
+size_t MeshOptimizer::Decimate(Mesh& mesh, size_t targetTriangles) {
+    if (mesh.triangles.size() <= targetTriangles) return 0;
+
+    static constexpr double BOUNDARY_WEIGHT = 100.0;
+
+    const size_t vertexCount = mesh.vertices.size();
+    std::vector<Vector3d> positions(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i) positions[i] = ToEigen(mesh.vertices[i]);
+
+    std::vector<std::array<int, 3>> triangles = mesh.triangles;
+    std::vector<bool> triangleAlive(triangles.size(), true);
+    std::vector<std::vector<int>> vertexTriangles(vertexCount);
+    std::vector<Matrix4d> quadrics(vertexCount, Matrix4d::Zero());
+    std::vector<uint32_t> versions(vertexCount, 0);
+
+    auto addPlane = [&](int vertex, const Vector3d& normal, const Vector3d& point, double weight) {
+        const Vector4d plane(normal.x(), normal.y(), normal.z(), -normal.dot(point));
+        quadrics[vertex] += plane * plane.transpose() * weight;
+    };
+
+    std::unordered_map<uint64_t, int> edgeUse;
+    for (int t = 0; t < static_cast<int>(triangles.size()); ++t) {
+        const std::array<int, 3>& tri = triangles[t];
+        const Vector3d cross = (positions[tri[1]] - positions[tri[0]]).cross(positions[tri[2]] - positions[tri[0]]);
+        const double area = 0.5 * cross.norm();
+        for (int e = 0; e < 3; ++e) {
+            vertexTriangles[tri[e]].push_back(t);
+            ++edgeUse[MakeEdgeKey(tri[e], tri[(e + 1) % 3])];
+            if (area > 0.0) addPlane(tri[e], cross.normalized(), positions[tri[0]], area);
+        }
+    }
+
+    for (const std::array<int, 3>& tri : triangles) {
+        const Vector3d normal = (positions[tri[1]] - positions[tri[0]]).cross(positions[tri[2]] - positions[tri[0]]);
+        if (normal.squaredNorm() <= 0.0) continue;
+        for (int e = 0; e < 3; ++e) {
+            const int a = tri[e], b = tri[(e + 1) % 3];
+            if (edgeUse[MakeEdgeKey(a, b)] != 1) continue;
+            const Vector3d edge = positions[b] - positions[a];
+            const Vector3d constraint = edge.cross(normal);
+            if (constraint.squaredNorm() <= 0.0) continue;
+            const double weight = BOUNDARY_WEIGHT * edge.squaredNorm();
+            addPlane(a, constraint.normalized(), positions[a], weight);
+            addPlane(b, constraint.normalized(), positions[a], weight);
+        }
+    }
+
+    struct Candidate {
+        double cost;
+        int u;
+        int v;
+        uint32_t versionU;
+        uint32_t versionV;
+        Vector3d position;
+
+        bool operator>(const Candidate& other) const { return cost > other.cost; }
+    };
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> heap;
+
+    auto pushCandidate = [&](int u, int v) {
+        const Matrix4d q = quadrics[u] + quadrics[v];
+        auto error = [&q](const Vector3d& p) {
+            const Vector4d h(p.x(), p.y(), p.z(), 1.0);
+            return h.dot(q * h);
+        };
+
+        const Vector3d midpoint = (positions[u] + positions[v]) * 0.5;
+        Vector3d best = midpoint;
+        double bestError = error(midpoint);
+        for (const Vector3d& p : {positions[u], positions[v]}) {
+            const double e = error(p);
+            if (e < bestError) {
+                bestError = e;
+                best = p;
+            }
+        }
+
+        Eigen::FullPivLU<Matrix3d> lu(q.topLeftCorner<3, 3>());
+        if (lu.isInvertible()) {
+            const Vector3d optimal = lu.solve(-q.topRightCorner<3, 1>());
+            const double edgeLength = (positions[v] - positions[u]).norm();
+            const double e = error(optimal);
+            if ((optimal - midpoint).norm() <= edgeLength && e < bestError) {
+                bestError = e;
+                best = optimal;
+            }
+        }
+
+        heap.push(Candidate{std::max(bestError, 0.0), u, v, versions[u], versions[v], best});
+    };
+
+    for (const std::array<int, 3>& tri : triangles) {
+        for (int e = 0; e < 3; ++e) {
+            pushCandidate(std::min(tri[e], tri[(e + 1) % 3]), std::max(tri[e], tri[(e + 1) % 3]));
+        }
+    }
+
+    auto contains = [&](int t, int vertex) {
+        const std::array<int, 3>& tri = triangles[t];
+        return tri[0] == vertex || tri[1] == vertex || tri[2] == vertex;
+    };
+
+    // 收縮後的三角形不可翻轉法向，共同鄰點數不可超過共用三角形數（保持流形）
+    std::vector<int> neighborsU, neighborsV;
+    auto collectNeighbors = [&](int vertex, std::vector<int>& neighbors) {
+        neighbors.clear();
+        for (int t : vertexTriangles[vertex]) {
+            if (!triangleAlive[t]) continue;
+            for (int w : triangles[t]) {
+                if (w != vertex) neighbors.push_back(w);
+            }
+        }
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+    };
+    auto canCollapse = [&](int u, int v, const Vector3d& position) {
+        collectNeighbors(u, neighborsU);
+        collectNeighbors(v, neighborsV);
+        size_t common = 0;
+        for (int w : neighborsU) {
+            if (std::binary_search(neighborsV.begin(), neighborsV.end(), w)) ++common;
+        }
+        size_t shared = 0;
+        for (int t : vertexTriangles[u]) {
+            if (triangleAlive[t] && contains(t, v)) ++shared;
+        }
+        if (shared == 0 || common > shared) return false;
+
+        for (int vertex : {u, v}) {
+            for (int t : vertexTriangles[vertex]) {
+                if (!triangleAlive[t] || (contains(t, u) && contains(t, v))) continue;
+                std::array<Vector3d, 3> corners;
+                std::array<Vector3d, 3> moved;
+                for (int k = 0; k < 3; ++k) {
+                    corners[k] = positions[triangles[t][k]];
+                    moved[k] = triangles[t][k] == vertex ? position : corners[k];
+                }
+                const Vector3d before = (corners[1] - corners[0]).cross(corners[2] - corners[0]);
+                const Vector3d after = (moved[1] - moved[0]).cross(moved[2] - moved[0]);
+                if (before.dot(after) <= 0.0) return false;
+            }
+        }
+        return true;
+    };
+
+    size_t liveTriangles = triangles.size();
+    while (liveTriangles > targetTriangles && !heap.empty()) {
+        const Candidate candidate = heap.top();
+        heap.pop();
+        const int u = candidate.u, v = candidate.v;
+        if (versions[u] != candidate.versionU || versions[v] != candidate.versionV) continue;
+        if (!canCollapse(u, v, candidate.position)) continue;
+
+        // v 併入 u
+        positions[u] = candidate.position;
+        quadrics[u] += quadrics[v];
+        for (int t : vertexTriangles[v]) {
+            if (!triangleAlive[t]) continue;
+            if (contains(t, u)) {
+                triangleAlive[t] = false;
+                --liveTriangles;
+            } else {
+                for (int& index : triangles[t]) {
+                    if (index == v) index = u;
+                }
+                vertexTriangles[u].push_back(t);
+            }
+        }
+        vertexTriangles[v].clear();
+        std::vector<int>& adjacent = vertexTriangles[u];
+        adjacent.erase(std::remove_if(adjacent.begin(), adjacent.end(), [&](int t) { return !triangleAlive[t]; }),
+                       adjacent.end());
+        ++versions[u];
+        ++versions[v];
+
+        collectNeighbors(u, neighborsU);
+        for (int w : neighborsU) {
+            pushCandidate(std::min(u, w), std::max(u, w));
+        }
+    }
+
+    // 壓縮頂點與三角形
+    std::vector<int> remap(vertexCount, -1);
+    Mesh result;
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        if (!triangleAlive[t]) continue;
+        std::array<int, 3> tri = triangles[t];
+        for (int& index : tri) {
+            if (remap[index] < 0) {
+                remap[index] = static_cast<int>(result.vertices.size());
+                result.vertices.push_back(FromEigen(positions[index]));
+            }
+            index = remap[index];
+        }
+        result.triangles.push_back(tri);
+    }
+
+    const size_t removed = mesh.triangles.size() - result.triangles.size();
+    mesh = std::move(result);
+    return removed;
+}
+
+/**
+ * @brief 近似凸分解
+ *
+ * 體素化：三角形以半個體素的間距取樣標記表面體素，再從外圍（預留一層
+ * 空體素）泛洪標記外部，其餘即為實心體素；網格不封閉時外部會漏進內部，
+ * 結果只剩表面體素，仍可分解。
+ *
+ * 分解：每次取凹度最大的一塊，在三個軸上各嘗試 planeSamples 個切割
+ * 位置，選擇兩半凹度總和最小者；切不開的塊直接輸出。
+ */
+std::vector<std::vector<Vector3>> MeshOptimizer::DecomposeConvex(const Mesh& mesh,
+                                                                  const DecompositionSettings& settings) {
+    std::vector<std::vector<Vector3>> hulls;
+    if (mesh.vertices.empty() || mesh.triangles.empty()) return hulls;
+
+    Vector3d minimum = ToEigen(mesh.vertices[0]);
+    Vector3d maximum = minimum;
+    for (const Vector3& vertex : mesh.vertices) {
+        minimum = minimum.cwiseMin(ToEigen(vertex));
+        maximum = maximum.cwiseMax(ToEigen(vertex));
+    }
+    const double longest = (maximum - minimum).maxCoeff();
+    if (longest <= 0.0) return hulls;
+
+    const int resolution = std::clamp(settings.resolution, 4, 256);
+    const double voxelSize = longest / resolution;
+    const Vector3d origin = minimum - Vector3d::Constant(voxelSize);
+    std::array<int, 3> dims;
+    for (int axis = 0; axis < 3; ++axis) {
+        dims[axis] = static_cast<int>(std::floor((maximum[axis] - minimum[axis]) / voxelSize)) + 3;
+    }
+    auto cellIndex = [&](int x, int y, int z) {
+        return (static_cast<size_t>(z) * dims[1] + y) * dims[0] + x;
+    };
+
+    enum : uint8_t { EMPTY = 0, SURFACE = 1, OUTSIDE = 2 };
+    std::vector<uint8_t> cells(static_cast<size_t>(dims[0]) * dims[1] * dims[2], EMPTY);
+
+    for (const std::array<int, 3>& tri : mesh.triangles) {
+        const Vector3d a = ToEigen(mesh.vertices[tri[0]]);
+        const Vector3d b = ToEigen(mesh.vertices[tri[1]]);
+        const Vector3d c = ToEigen(mesh.vertices[tri[2]]);
+        const double maxEdge = std::max({(b - a).norm(), (c - b).norm(), (a - c).norm()});
+        const int steps = std::max(1, static_cast<int>(std::ceil(maxEdge / (voxelSize * 0.5))));
+        for (int i = 0; i <= steps; ++i) {
+            for (int j = 0; i + j <= steps; ++j) {
+                const Vector3d p = a + (b - a) * (static_cast<double>(i) / steps) + (c - a) * (static_cast<double>(j) / steps);
+                std::array<int, 3> cell;
+                for (int axis = 0; axis < 3; ++axis) {
+                    cell[axis] = std::clamp(static_cast<int>(std::floor((p[axis] - origin[axis]) / voxelSize)),
+                                            1, dims[axis] - 2);
+                }
+                cells[cellIndex(cell[0], cell[1], cell[2])] = SURFACE;
+            }
+        }
+    }
+
+    std::vector<Voxel> stack = {{0, 0, 0}};
+    cells[0] = OUTSIDE;
+    while (!stack.empty()) {
+        const Voxel voxel = stack.back();
+        stack.pop_back();
+        for (int axis = 0; axis < 3; ++axis) {
+            for (int step : {-1, 1}) {
+                Voxel next = voxel;
+                next[axis] += step;
+                if (next[axis] < 0 || next[axis] >= dims[axis]) continue;
+                uint8_t& cell = cells[cellIndex(next[0], next[1], next[2])];
+                if (cell != EMPTY) continue;
+                cell = OUTSIDE;
+                stack.push_back(next);
+            }
+        }
+    }
+
+    VoxelPart root;
+    for (int z = 0; z < dims[2]; ++z) {
+        for (int y = 0; y < dims[1]; ++y) {
+            for (int x = 0; x < dims[0]; ++x) {
+                if (cells[cellIndex(x, y, z)] != OUTSIDE) root.voxels.push_back({x, y, z});
+            }
+        }
+    }
+    EvaluatePart(root);
+
+    const double concavityLimit = std::max(0.0f, settings.maxConcavity) * root.hull.volume;
+    const size_t maxHulls = static_cast<size_t>(std::max(settings.maxHulls, 1));
+    const int planeSamples = std::max(settings.planeSamples, 1);
+
+    std::vector<VoxelPart> pending;
+    std::vector<VoxelPart> finished;
+    pending.push_back(std::move(root));
+
+    while (!pending.empty() && pending.size() + finished.size() < maxHulls) {
+        auto worst = std::max_element(pending.begin(), pending.end(), [](const VoxelPart& a, const VoxelPart& b) {
+            return a.concavity < b.concavity;
+        });
+        if (worst->concavity <= concavityLimit) break;
+
+        VoxelPart part = std::move(*worst);
+        pending.erase(worst);
+
+        VoxelPart bestLeft, bestRight;
+        double bestScore = std::numeric_limits<double>::max();
+        for (int axis = 0; axis < 3; ++axis) {
+            int low = part.voxels.front()[axis], high = low;
+            for (const Voxel& voxel : part.voxels) {
+                low = std::min(low, voxel[axis]);
+                high = std::max(high, voxel[axis]);
+            }
+            const int layers = high - low + 1;
+            if (layers < 2) continue;
+
+            const int samples = std::min(planeSamples, layers - 1);
+            int previousCut = low;
+            for (int k = 1; k <= samples; ++k) {
+                const int cut = low + (layers * k) / (samples + 1);
+                if (cut <= previousCut || cut > high) continue;
+                previousCut = cut;
+
+                VoxelPart left, right;
+                for (const Voxel& voxel : part.voxels) {
+                    (voxel[axis] < cut ? left : right).voxels.push_back(voxel);
+                }
+                if (left.voxels.empty() || right.voxels.empty()) continue;
+                EvaluatePart(left);
+                EvaluatePart(right);
+
+                const double score = left.concavity + right.concavity;
+                if (score < bestScore) {
+                    bestScore = score;
+                    bestLeft = std::move(left);
+                    bestRight = std::move(right);
+                }
+            }
+        }
+
+        if (bestLeft.voxels.empty()) {
+            finished.push_back(std::move(part));
+            continue;
+        }
+        pending.push_back(std::move(bestLeft));
+        pending.push_back(std::move(bestRight));
+    }
+
+    for (std::vector<VoxelPart>* parts : {&finished, &pending}) {
+        for (const VoxelPart& part : *parts) {
+            Hull hull;
+            if (!BuildHull(part.points, static_cast<size_t>(std::max(settings.maxHullVertices, 4)), hull)) continue;
+            std::vector<Vector3> vertices;
+            vertices.reserve(hull.vertices.size());
+            for (int index : hull.vertices) {
+                vertices.push_back(FromEigen(origin + part.points[index] * voxelSize));
+            }
+            hulls.push_back(std::move(vertices));
+        }
+    }
+    return hulls;
+}
+
+std::vector<Vector3> MeshOptimizer::ComputeConvexHull(const std::vector<Vector3>& points, size_t maxVertices) {
+    std::vector<Vector3d> input;
+    input.reserve(points.size());
+    for (const Vector3& point : points) input.push_back(ToEigen(point));
+
+    std::vector<Vector3> result;
+    Hull hull;
+    if (!BuildHull(input, maxVertices, hull)) return result;
+
+    result.reserve(hull.vertices.size());
+    for (int index : hull.vertices) result.push_back(points[index]);
+    return result;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// 場景格式
+#include "../scene_format/physics_scene_format.h"
+
+/**
+ * @file mesh_optimizer.h
+ * @brief 碰撞網格最佳化
+ *
+ * 場景載入器在 optimizeMeshes 時對內嵌頂點的三角網格依序做頂點焊接、
+ * 退化三角形移除與簡化，動態剛體的三角網格再分解成數個凸包，讓 Bullet
+ * 以凸形狀的碰撞演算法處理，而不必使用凹三角網格（btBvhTriangleMeshShape
+ * 只能用於靜態剛體，GImpact 則代價高）。
+ *
+ * 簡化使用二次誤差度量（QEM）邊收縮，邊界邊加上垂直約束平面以保留開放
+ * 網格的輪廓，並拒絕會翻轉三角形法向或產生非流形的收縮。
+ *
+ * 凸分解採用與 V-HACD 相同的思路：先將網格體素化（表面取樣後由外部
+ * 泛洪填滿內部），再反覆以軸對齊平面切割凹度最大的一塊，凹度定義為
+ * 凸包體積減去體素體積，直到凹度低於門檻或達到凸包數上限。凸包頂點取自
+ * 體素角點，因此結果最多比原網格外擴一個體素。
+ */
+
+class MeshOptimizer {
+public:
+    struct Mesh {
+        std::vector<PhysicsScene::Vector3> vertices;
+        std::vector<std::array<int, 3>> triangles;
+    };
+
+    struct DecompositionSettings {
+        int resolution = 32;          // 最長軸的體素數
+        int maxHulls = 16;            // 凸包數上限
+        int maxHullVertices = 32;     // 每個凸包的頂點上限
+        float maxConcavity = 0.01f;   // 可接受的凹度，相對於整體凸包體積
+        int planeSamples = 7;         // 每個軸嘗試的切割平面數
+    };
+
+    // 焊接距離小於 tolerance 的頂點並移除未引用的頂點，回傳移除的頂點數
+    static size_t WeldVertices(Mesh& mesh, float tolerance);
+
+    // 移除索引重複、面積近零或重複出現的三角形，回傳移除的三角形數
+    static size_t RemoveDegenerateTriangles(Mesh& mesh, float areaEpsilon = 1e-12f);
+
+    // 以邊收縮簡化到最多 targetTriangles 個三角形，回傳移除的三角形數；
+    // 沒有可收縮的邊時可能停在目標之上
+    static size_t Decimate(Mesh& mesh, size_t targetTriangles);
+
+    // 近似凸分解，每個元素為一個凸包的頂點（與輸入相同的座標系）
+    static std::vector<std::vector<PhysicsScene::Vector3>> DecomposeConvex(const Mesh& mesh,
+                                                                            const DecompositionSettings& settings);
+
+    // 點集的凸包頂點；maxVertices 大於 0 時依距離由遠到近保留，退化（共面）時回傳空陣列
+    static std::vector<PhysicsScene::Vector3> ComputeConvexHull(const std::vector<PhysicsScene::Vector3>& points,
+                                                                 size_t maxVertices = 0);
+};
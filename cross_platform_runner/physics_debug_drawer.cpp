@@ -0,0 +1,68 @@
+/**
+ * @file physics_debug_drawer.cpp
+ * @brief Bullet 除錯繪製器實現：線段與接觸點交給渲染器的除錯批次
+ */
+
+#include "physics_engine.h"
+#include "renderer.h"
+
+#include <iostream>
+
+namespace {
+
+// 接觸點法線的繪製長度
+constexpr float CONTACT_NORMAL_LENGTH = 0.25f;
+
+glm::vec3 ToGLMVec3(const btVector3& v) {
+    return glm::vec3(static_cast<float>(v.x()), static_cast<float>(v.y()), static_cast<float>(v.z()));
+}
+
+} // namespace
+
+PhysicsDebugDrawer::PhysicsDebugDrawer(Renderer* renderer)
+    : m_renderer(renderer)
+    , m_debugMode(DBG_DrawWireframe | DBG_DrawContactPoints)
+    , m_lineWidth(1.0f)
+    , m_pointSize(5.0f)
+    , m_depthTestEnabled(true)
+{
+}
+
+PhysicsDebugDrawer::~PhysicsDebugDrawer() = default;
+
+/**
+ * @brief 每條線只在渲染器的除錯批次中附加兩個頂點，由除錯 pass 一次繪製
+ */
+void PhysicsDebugDrawer::drawLine(const btVector3& from, const btVector3& to, const btVector3& color) {
+    if (!m_renderer) return;
+    m_renderer->DrawLine(ToGLMVec3(from), ToGLMVec3(to), ToGLMVec3(color));
+}
+
+void PhysicsDebugDrawer::drawContactPoint(const btVector3& PointOnB, const btVector3& normalOnB,
+                                          btScalar distance, int lifeTime, const btVector3& color) {
+    (void)distance;
+    (void)lifeTime;
+    if (!m_renderer) return;
+    const glm::vec3 point = ToGLMVec3(PointOnB);
+    const glm::vec3 rgb = ToGLMVec3(color);
+    m_renderer->DrawPoint(point, rgb, m_pointSize);
+    m_renderer->DrawLine(point, point + ToGLMVec3(normalOnB) * CONTACT_NORMAL_LENGTH, rgb);
+}
+
+void PhysicsDebugDrawer::reportErrorWarning(const char* warningString) {
+    std::cerr << "Bullet warning: " << warningString << std::endl;
+}
+
+void PhysicsDebugDrawer::draw3dText(const btVector3& location, const char* textString) {
+    // 渲染器的文字只支援螢幕座標，世界座標文字不繪製
+    (void)location;
+    (void)textString;
+}
+
+void PhysicsDebugDrawer::setDebugMode(int debugMode) {
+    m_debugMode = debugMode;
+}
+
+int PhysicsDebugDrawer::getDebugMode() const {
+    return m_debugMode;
+}
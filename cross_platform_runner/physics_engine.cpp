@@ -0,0 +1,1586 @@
+/**
+ * @file physics_engine.cpp
+ * @brief 跨平台物理引擎實現
+ */
+
+#include "physics_engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+// 檢查點中單一剛體的狀態；變換以 OpenGL 矩陣形式保存以確保逐位元還原
+struct BodyCheckpoint {
+    btScalar worldTransform[16];
+    btScalar interpolationWorldTransform[16];
+    btScalar linearVelocity[3];
+    btScalar angularVelocity[3];
+    btScalar interpolationLinearVelocity[3];
+    btScalar interpolationAngularVelocity[3];
+    btScalar deactivationTime;
+    int32_t activationState;
+};
+
+// 檢查點中力場的可變參數
+struct ForceFieldCheckpoint {
+    PhysicsScene::Vector3 position;
+    PhysicsScene::Vector3 direction;
+    float strength;
+    float radius;
+    float falloff;
+    int32_t affectedGroups;
+    uint8_t enabled;
+};
+
+// 接觸流形標頭，其後接 contactCount 個 btManifoldPoint
+struct ManifoldCheckpoint {
+    uint32_t bodyA;
+    uint32_t bodyB;
+    int32_t contactCount;
+};
+
+constexpr uint32_t INVALID_BODY = 0xFFFFFFFFu;
+
+// 收集與力場包圍盒重疊、且會受力場影響的剛體密集索引
+struct ForceFieldOverlapCallback : public btBroadphaseAabbCallback {
+    explicit ForceFieldOverlapCallback(std::vector<uint32_t>& bodyIndices) : indices(bodyIndices) {}
+
+    bool process(const btBroadphaseProxy* proxy) override {
+        const auto* object = static_cast<const btCollisionObject*>(proxy->m_clientObject);
+        const int index = object->getUserIndex();
+        if (index >= 0 && !object->isStaticOrKinematicObject() && object->isActive()) {
+            indices.push_back(static_cast<uint32_t>(index));
+        }
+        return true;
+    }
+
+    std::vector<uint32_t>& indices;
+};
+
+void StoreVector(const btVector3& v, btScalar* out) {
+    out[0] = v.getX();
+    out[1] = v.getY();
+    out[2] = v.getZ();
+}
+
+btVector3 LoadVector(const btScalar* in) {
+    return btVector3(in[0], in[1], in[2]);
+}
+
+btTransform LoadTransform(const btScalar* in) {
+    btTransform transform;
+    transform.setFromOpenGLMatrix(in);
+    return transform;
+}
+
+// 固定步長累積的剩餘時間沒有公開存取函數；以成員指標讀寫，不需要繼承世界類別
+struct DynamicsWorldAccess : public btDiscreteDynamicsWorld {
+    using btDiscreteDynamicsWorld::m_localTime;
+};
+
+btScalar& LocalTime(btDiscreteDynamicsWorld& world) {
+    return world.*(&DynamicsWorldAccess::m_localTime);
+}
+
+// 流形的兩個剛體互換時，接觸點的 A/B 資料與法線方向也要互換；累積衝量不變
+void SwapManifoldPointBodies(btManifoldPoint& point) {
+    std::swap(point.m_localPointA, point.m_localPointB);
+    std::swap(point.m_positionWorldOnA, point.m_positionWorldOnB);
+    std::swap(point.m_partId0, point.m_partId1);
+    std::swap(point.m_index0, point.m_index1);
+    point.m_normalWorldOnB = -point.m_normalWorldOnB;
+    point.m_lateralFrictionDir1 = -point.m_lateralFrictionDir1;
+    point.m_lateralFrictionDir2 = -point.m_lateralFrictionDir2;
+}
+
+// 混合模式的成本模型參數
+constexpr btScalar HYBRID_THIN_EXTENT = 0.05f;        // 凸形狀最小半邊長低於此值視為薄物體（公尺）
+constexpr btScalar HYBRID_TUNNELING_RATIO = 0.5f;     // 單步接近距離超過最小半邊長的此比例視為高速
+constexpr btScalar HYBRID_RESTING_SPEED = 0.2f;       // 接近速度低於此值視為靜置（公尺/秒）
+constexpr int HYBRID_RESTING_CONTACTS = 3;            // 靜置堆疊的最少接觸點數
+constexpr int HYBRID_SWITCH_FRAMES = 10;              // 連續偏好另一路徑多少影格後才切換
+constexpr uint32_t HYBRID_PAIR_EXPIRY_FRAMES = 60;    // 超過此影格數未出現的剛體對自快取移除
+
+// 形狀局部包圍盒的最小半邊長；凹形狀與平面沒有厚度概念，視為無限厚
+btScalar MinimumHalfExtent(const btCollisionObject* object) {
+    const btCollisionShape* shape = object->getCollisionShape();
+    if (!shape->isConvex() && !shape->isCompound()) return BT_LARGE_FLOAT;
+
+    btVector3 aabbMin, aabbMax;
+    btTransform identity;
+    identity.setIdentity();
+    shape->getAabb(identity, aabbMin, aabbMax);
+    const btVector3 halfExtents = (aabbMax - aabbMin) * btScalar(0.5f);
+    return halfExtents[halfExtents.minAxis()];
+}
+
+uint64_t MakeBodyPairKey(int indexA, int indexB) {
+    const uint32_t low = static_cast<uint32_t>(std::min(indexA, indexB));
+    const uint32_t high = static_cast<uint32_t>(std::max(indexA, indexB));
+    return (static_cast<uint64_t>(high) << 32) | low;
+}
+
+PhysicsEngine::CollisionPair UnpackBodyPairKey(uint64_t key) {
+    return PhysicsEngine::CollisionPair{static_cast<uint32_t>(key & 0xFFFFFFFFu), static_cast<uint32_t>(key >> 32)};
+}
+
+} // namespace
+
+/**
+ * @class PhysicsEngine::CollisionPairFilter
+ * @brief 寬相位剛體對過濾
+ *
+ * 在寬相位建立剛體對之前判斷，被拒絕的剛體對不會進入窄相位，也不會
+ * 佔用重疊對快取。除了群組遮罩外，也捨棄永遠不會產生回應的組合：
+ * 兩個靜態剛體，以及兩個觸發器（都沒有接觸回應）。
+ */
+class PhysicsEngine::CollisionPairFilter : public btOverlapFilterCallback {
+public:
+    bool needBroadphaseCollision(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1) const override {
+        if (!(proxy0->m_collisionFilterGroup & proxy1->m_collisionFilterMask) ||
+            !(proxy1->m_collisionFilterGroup & proxy0->m_collisionFilterMask)) {
+            ++rejectionCount;
+            return false;
+        }
+
+        const auto* objectA = static_cast<const btCollisionObject*>(proxy0->m_clientObject);
+        const auto* objectB = static_cast<const btCollisionObject*>(proxy1->m_clientObject);
+        if ((rejectStaticPairs && objectA->isStaticObject() && objectB->isStaticObject()) ||
+            (rejectTriggerPairs && !objectA->hasContactResponse() && !objectB->hasContactResponse())) {
+            ++rejectionCount;
+            return false;
+        }
+        return true;
+    }
+
+    bool rejectStaticPairs = true;
+    bool rejectTriggerPairs = true;
+    // 拒絕次數；同一剛體對在寬相位每次重新測試時都會再計入一次
+    mutable int rejectionCount = 0;
+};
+
+/**
+ * @brief 設定除錯繪製器；nullptr 表示停用
+ */
+void PhysicsEngine::SetDebugDrawer(btIDebugDraw* debugDrawer) {
+    m_debugDrawer = debugDrawer;
+    if (m_dynamicsWorld) {
+        m_dynamicsWorld->setDebugDrawer(debugDrawer);
+    }
+}
+
+void PhysicsEngine::EnableDebugDraw(bool enable) {
+    m_debugDrawEnabled = enable;
+}
+
+/**
+ * @brief 以除錯繪製器繪製目前的物理世界；不可與 StepSimulation 同時呼叫
+ */
+void PhysicsEngine::DebugDrawWorld() {
+    if (!m_debugDrawEnabled || !m_debugDrawer || !m_dynamicsWorld) return;
+    // 場景重新初始化時世界可能重建，每次都重新指定
+    m_dynamicsWorld->setDebugDrawer(m_debugDrawer);
+    m_dynamicsWorld->debugDrawWorld();
+}
+
+/**
+ * @brief 建立 Bullet 世界、剛體對過濾器、每個固定子步的回調與工作執行緒池
+ */
+bool PhysicsEngine::Initialize() {
+    InitializeBulletPhysics();
+    if (!m_dynamicsWorld) {
+        HandlePhysicsError("Failed to create dynamics world");
+        return false;
+    }
+
+    SetupCollisionFiltering();
+    m_dynamicsWorld->setInternalTickCallback(&PhysicsEngine::InternalTickCallback, this);
+
+    // 批次查詢與 OGC 求解共用，與是否啟用 OGC 無關
+    if (!m_workerPool) {
+        m_workerPool = std::make_unique<WorkerPool>();
+    }
+    return true;
+}
+
+/**
+ * @brief 清理所有物理資源
+ */
+void PhysicsEngine::Cleanup() {
+    if (m_dynamicsWorld) {
+        for (auto& [name, data] : m_constraints) {
+            m_dynamicsWorld->removeConstraint(data->bulletConstraint.get());
+        }
+        for (auto& [name, data] : m_rigidBodies) {
+            m_dynamicsWorld->removeRigidBody(data->bulletBody.get());
+        }
+    }
+
+    m_constraints.clear();
+    m_forceFields.clear();
+    m_bodyList.clear();
+    m_rigidBodies.clear();
+    m_hybridPairs.clear();
+    m_contactPairs.clear();
+    m_previousContactPairs.clear();
+    RebuildBodyNameTable();
+
+    m_dynamicsWorld.reset();
+    m_solver.reset();
+    m_broadphase.reset();
+    m_dispatcher.reset();
+    m_collisionConfig.reset();
+    m_overlapFilter.reset();
+    m_ogcSolver.reset();
+}
+
+/**
+ * @brief 推進物理模擬一個影格
+ */
+void PhysicsEngine::StepSimulation(float deltaTime) {
+    if (!m_dynamicsWorld) return;
+
+    auto stepStart = std::chrono::high_resolution_clock::now();
+
+    UpdateForceFields();
+
+    if (m_useOGCContact) {
+        if (m_hybridMode) {
+            UpdateHybridMode(deltaTime);
+        }
+        UpdateOGCContacts();
+    }
+
+    // OGC 求解在每個固定子步的回調中累計；沒有子步的影格不施加衝量
+    m_statistics.ogcSolveTime = 0.0f;
+    m_statistics.ogcIterations = 0;
+    m_statistics.ogcContactCount = 0;
+
+    auto bulletStart = std::chrono::high_resolution_clock::now();
+    m_dynamicsWorld->stepSimulation(deltaTime, MAX_SUB_STEPS, m_timeStep);
+    auto bulletEnd = std::chrono::high_resolution_clock::now();
+    m_statistics.bulletSolveTime = std::chrono::duration<float, std::milli>(bulletEnd - bulletStart).count() -
+                                   m_statistics.ogcSolveTime;
+    m_statistics.filterRejectionCount = m_overlapFilter ? m_overlapFilter->rejectionCount : 0;
+
+    ProcessCollisionCallbacks();
+
+    m_simulationTime += deltaTime;
+    UpdateStatistics();
+
+    auto stepEnd = std::chrono::high_resolution_clock::now();
+    m_statistics.simulationTime = std::chrono::duration<float, std::milli>(stepEnd - stepStart).count();
+
+    PublishSnapshot();
+}
+
+/**
+ * @brief 新增剛體
+ */
+void PhysicsEngine::AddRigidBody(const std::string& name, const PhysicsScene::RigidBody& rigidBody) {
+    if (!m_dynamicsWorld) {
+        HandlePhysicsError("AddRigidBody called before Initialize: " + name);
+        return;
+    }
+    if (m_rigidBodies.count(name)) {
+        RemoveRigidBody(name);
+    }
+
+    if (InsertRigidBody(name, rigidBody)) {
+        RebuildBodyNameTable();
+    }
+}
+
+/**
+ * @brief 批次新增剛體，名稱取自 RigidBody::name
+ *
+ * 與逐一呼叫 AddRigidBody 結果相同，但名稱表只在整批完成後重建一次；
+ * 已存在的同名剛體先以一次 RemoveRigidBodies 移除。
+ */
+void PhysicsEngine::AddRigidBodies(const PhysicsScene::RigidBody* rigidBodies, size_t count) {
+    if (count == 0) return;
+    if (!m_dynamicsWorld) {
+        HandlePhysicsError("AddRigidBodies called before Initialize");
+        return;
+    }
+
+    std::vector<std::string> replaced;
+    for (size_t i = 0; i < count; ++i) {
+        if (m_rigidBodies.count(rigidBodies[i].name)) {
+            replaced.push_back(rigidBodies[i].name);
+        }
+    }
+    if (!replaced.empty()) {
+        RemoveRigidBodies(replaced);
+    }
+
+    bool added = false;
+    for (size_t i = 0; i < count; ++i) {
+        const PhysicsScene::RigidBody& rigidBody = rigidBodies[i];
+        // 同一批內名稱重複時以後者為準
+        if (m_rigidBodies.count(rigidBody.name)) {
+            RemoveRigidBody(rigidBody.name);
+        }
+        added = InsertRigidBody(rigidBody.name, rigidBody) != nullptr || added;
+    }
+    if (added) {
+        RebuildBodyNameTable();
+    }
+}
+
+/**
+ * @brief 移除剛體
+ */
+void PhysicsEngine::RemoveRigidBody(const std::string& name) {
+    RemoveRigidBodies({name});
+}
+
+/**
+ * @brief 批次移除剛體
+ *
+ * 被移除的剛體自密集剛體表刪去，其餘剛體向前壓縮並保持相對順序，
+ * 再以同一張新舊索引對照表一次更新上一步的剛體對與混合模式快取。
+ */
+void PhysicsEngine::RemoveRigidBodies(const std::vector<std::string>& names) {
+    bool removed = false;
+    for (const std::string& name : names) {
+        auto it = m_rigidBodies.find(name);
+        if (it == m_rigidBodies.end()) continue;
+
+        RigidBodyData* data = it->second.get();
+        if (m_dynamicsWorld) {
+            m_dynamicsWorld->removeRigidBody(data->bulletBody.get());
+        }
+        if (data->bodyIndex < m_bodyList.size() && m_bodyList[data->bodyIndex] == data) {
+            m_bodyList[data->bodyIndex] = nullptr;
+        }
+        m_rigidBodies.erase(it);
+        removed = true;
+    }
+    if (!removed) return;
+
+    std::vector<uint32_t> newIndices(m_bodyList.size(), INVALID_BODY_INDEX);
+    uint32_t count = 0;
+    for (size_t i = 0; i < m_bodyList.size(); ++i) {
+        RigidBodyData* data = m_bodyList[i];
+        if (!data) continue;
+        newIndices[i] = count;
+        data->bodyIndex = count;
+        data->bulletBody->setUserIndex(static_cast<int>(count));
+        m_bodyList[count++] = data;
+    }
+    m_bodyList.resize(count);
+
+    RebuildBodyNameTable();
+    RemapBodyIndices(newIndices);
+}
+
+/**
+ * @brief 建立剛體並加入物理世界與密集剛體表，不重建名稱表
+ *
+ * 呼叫者須確認名稱尚未使用，並在整批新增後呼叫 RebuildBodyNameTable。
+ */
+PhysicsEngine::RigidBodyData* PhysicsEngine::InsertRigidBody(const std::string& name,
+                                                             const PhysicsScene::RigidBody& rigidBody) {
+    auto data = std::make_unique<RigidBodyData>();
+    data->sceneData = rigidBody;
+    data->shape.reset(CreateCollisionShape(rigidBody));
+    if (!data->shape) {
+        HandlePhysicsError("Failed to create collision shape for rigid body: " + name);
+        return nullptr;
+    }
+
+    btRigidBody* body = CreateBulletRigidBody(rigidBody, data->shape.get());
+    if (!body) {
+        HandlePhysicsError("Failed to create rigid body: " + name);
+        return nullptr;
+    }
+    data->motionState.reset(body->getMotionState());
+    data->bulletBody.reset(body);
+    if (rigidBody.isTrigger) {
+        body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_NO_CONTACT_RESPONSE);
+    }
+
+    m_dynamicsWorld->addRigidBody(body, rigidBody.collisionGroup, GetBodyCollisionMask(rigidBody));
+
+    RigidBodyData* raw = data.get();
+    m_rigidBodies[name] = std::move(data);
+    RegisterBody(raw);
+    return raw;
+}
+
+/**
+ * @brief 安裝寬相位剛體對過濾器
+ */
+void PhysicsEngine::SetupCollisionFiltering() {
+    if (!m_broadphase) return;
+    if (!m_overlapFilter) {
+        m_overlapFilter = std::make_unique<CollisionPairFilter>();
+    }
+    m_broadphase->getOverlappingPairCache()->setOverlapFilterCallback(m_overlapFilter.get());
+}
+
+/**
+ * @brief 套用碰撞層矩陣與剔除規則
+ *
+ * 剛體的遮罩為自身 collisionMask 與所屬各層遮罩的交集。寬相位代理
+ * 重新建立後，既有的剛體對會依新規則重新產生。
+ */
+void PhysicsEngine::SetCollisionFiltering(const PhysicsScene::SimulationSettings& settings) {
+    if (!m_dynamicsWorld) return;
+
+    m_collisionLayers = settings.collisionLayers;
+    SetupCollisionFiltering();
+    m_overlapFilter->rejectStaticPairs = settings.rejectStaticPairs;
+    m_overlapFilter->rejectTriggerPairs = settings.rejectTriggerPairs;
+
+    for (RigidBodyData* data : m_bodyList) {
+        btRigidBody* body = data->bulletBody.get();
+        btBroadphaseProxy* proxy = body->getBroadphaseHandle();
+        if (!proxy) continue;
+        proxy->m_collisionFilterMask = GetBodyCollisionMask(data->sceneData);
+        m_dynamicsWorld->refreshBroadphaseProxy(body);
+    }
+}
+
+/**
+ * @brief 剛體的寬相位遮罩：自身遮罩與碰撞層矩陣的交集
+ */
+int PhysicsEngine::GetBodyCollisionMask(const PhysicsScene::RigidBody& rigidBody) const {
+    return static_cast<int>(static_cast<uint32_t>(rigidBody.collisionMask) &
+                            m_collisionLayers.getCollisionMask(rigidBody.collisionGroup));
+}
+
+/**
+ * @brief 新增力場
+ */
+void PhysicsEngine::AddForceField(const std::string& name, const PhysicsScene::ForceField& forceField) {
+    auto data = std::make_unique<ForceFieldData>();
+    data->sceneData = forceField;
+    m_forceFields[name] = std::move(data);
+}
+
+/**
+ * @brief 移除力場
+ */
+void PhysicsEngine::RemoveForceField(const std::string& name) {
+    m_forceFields.erase(name);
+}
+
+/**
+ * @brief 批次計算所有力場並施加到剛體
+ *
+ * 將剛體狀態收集成 SoA，逐一以 SIMD 累加各力場的作用力，最後一次寫回。
+ * 只有活動中的動態剛體參與，與 Bullet 只對非休眠剛體施加重力的行為一致；
+ * 力場以 affectedGroups 與剛體的 collisionGroup 做位元遮罩。
+ *
+ * 具半徑的力場先向寬相位查詢與其包圍盒重疊的剛體，只計算這些剛體，
+ * 因此大量小型力場（陣風、爆炸）的成本與受影響的剛體數成正比。
+ */
+void PhysicsEngine::UpdateForceFields() {
+    if (m_forceFields.empty() || m_bodyList.empty()) return;
+
+    const size_t bodyCount = m_bodyList.size();
+    m_forceFieldBatch.Resize(bodyCount);
+
+    for (size_t i = 0; i < bodyCount; ++i) {
+        const RigidBodyData* data = m_bodyList[i];
+        const btRigidBody* body = data->bulletBody.get();
+        const btScalar inverseMass = body->getInvMass();
+        const bool affected = inverseMass > 0.0f && body->isActive();
+
+        m_forceFieldBatch.SetBody(i,
+                                  FromBulletVector3(body->getCenterOfMassPosition()),
+                                  FromBulletVector3(body->getLinearVelocity()),
+                                  affected ? 1.0f / inverseMass : 0.0f,
+                                  affected ? data->sceneData.collisionGroup : 0);
+    }
+
+    for (const auto& [name, forceField] : m_forceFields) {
+        const PhysicsScene::ForceField& field = forceField->sceneData;
+        if (!field.enabled) continue;
+
+        if (ForceFieldBatch::IsLocalized(field.type)) {
+            QueryForceFieldOverlaps(field, m_forceFieldOverlaps);
+            m_forceFieldBatch.Evaluate(field, m_forceFieldOverlaps);
+        } else {
+            m_forceFieldBatch.Evaluate(field);
+        }
+    }
+
+    for (size_t i = 0; i < bodyCount; ++i) {
+        if (m_forceFieldBatch.HasForce(i)) {
+            m_bodyList[i]->bulletBody->applyCentralForce(ToBulletVector3(m_forceFieldBatch.GetForce(i)));
+        }
+    }
+}
+
+/**
+ * @brief 以寬相位的動態包圍體樹查詢力場半徑內的剛體
+ */
+void PhysicsEngine::QueryForceFieldOverlaps(const PhysicsScene::ForceField& forceField,
+                                            std::vector<uint32_t>& bodyIndices) const {
+    bodyIndices.clear();
+    if (forceField.radius <= 0.0f) return;
+
+    const btVector3 center = ToBulletVector3(forceField.position);
+    const btVector3 extent(forceField.radius, forceField.radius, forceField.radius);
+
+    ForceFieldOverlapCallback callback(bodyIndices);
+    m_broadphase->aabbTest(center - extent, center + extent, callback);
+}
+
+/**
+ * @brief 計算單一力場在某點對單位質量靜止物體的作用力
+ */
+PhysicsScene::Vector3 PhysicsEngine::CalculateForceFieldForce(const PhysicsScene::ForceField& forceField,
+                                                              const PhysicsScene::Vector3& position) const {
+    return ForceFieldBatch::EvaluatePoint(forceField, position, PhysicsScene::Vector3(), 1.0f);
+}
+
+/**
+ * @brief 建立 OGC 求解器並使用共用的工作執行緒池
+ */
+void PhysicsEngine::InitializeOGCIntegration() {
+    if (!m_workerPool) {
+        m_workerPool = std::make_unique<WorkerPool>();
+    }
+    m_ogcSolver = std::make_unique<OGCContactSolver>();
+    m_ogcSolver->SetWorkerPool(m_workerPool.get());
+}
+
+/**
+ * @brief 啟用或停用 OGC 接觸；停用時將所有接觸交還 Bullet 求解器
+ */
+void PhysicsEngine::EnableOGCContact(bool enable) {
+    m_useOGCContact = enable;
+    if (enable) {
+        if (!m_ogcSolver) {
+            InitializeOGCIntegration();
+        }
+        return;
+    }
+
+    for (RigidBodyData* data : m_bodyList) {
+        data->bulletBody->setContactProcessingThreshold(BT_LARGE_FLOAT);
+    }
+    if (m_dispatcher) {
+        const int manifoldCount = m_dispatcher->getNumManifolds();
+        for (int i = 0; i < manifoldCount; ++i) {
+            m_dispatcher->getManifoldByIndexInternal(i)->setContactProcessingThreshold(BT_LARGE_FLOAT);
+        }
+    }
+}
+
+/**
+ * @brief 設定 OGC 偏移半徑
+ */
+void PhysicsEngine::SetOGCContactRadius(float radius) {
+    m_ogcContactRadius = std::max(radius, 0.0f);
+}
+
+/**
+ * @brief 模擬步驟前決定每個流形由 OGC 或 Bullet 求解
+ *
+ * Bullet 求解器只處理距離不大於流形 contactProcessingThreshold 的接觸點，
+ * 因此將門檻設為 -BT_LARGE_FLOAT 即可讓該流形只由 OGC 求解，而碰撞偵測
+ * 與接觸點的持久化仍由 Bullet 負責。新流形的門檻取兩個剛體的較小值，
+ * 所以剛體也一併設定：純 OGC 模式下新接觸直接歸 OGC，混合模式下先歸
+ * Bullet，下一步再依快取的決策分派。斷開門檻至少為偏移半徑，間隙內的
+ * 接觸點才會保留。
+ */
+void PhysicsEngine::UpdateOGCContacts() {
+    if (!m_ogcSolver) {
+        InitializeOGCIntegration();
+    }
+
+    OGCContactSolver::Settings settings = m_ogcSolver->GetSettings();
+    settings.contactRadius = m_ogcContactRadius;
+    settings.iterations = m_solverIterations;
+    m_ogcSolver->SetSettings(settings);
+
+    const btScalar bodyThreshold = m_hybridMode ? BT_LARGE_FLOAT : -BT_LARGE_FLOAT;
+    for (RigidBodyData* data : m_bodyList) {
+        data->bulletBody->setContactProcessingThreshold(bodyThreshold);
+    }
+
+    const int manifoldCount = m_dispatcher->getNumManifolds();
+    for (int i = 0; i < manifoldCount; ++i) {
+        btPersistentManifold* manifold = m_dispatcher->getManifoldByIndexInternal(i);
+        const bool useOGC = !m_hybridMode || ShouldUseOGCForContact(manifold);
+        manifold->setContactProcessingThreshold(useOGC ? -BT_LARGE_FLOAT : BT_LARGE_FLOAT);
+        if (useOGC && manifold->getContactBreakingThreshold() < m_ogcContactRadius) {
+            manifold->setContactBreakingThreshold(m_ogcContactRadius);
+        }
+    }
+}
+
+/**
+ * @brief 啟用或停用混合模式；切換時捨棄所有剛體對的決策
+ */
+void PhysicsEngine::SetHybridMode(bool enable) {
+    m_hybridMode = enable;
+    m_hybridPairs.clear();
+}
+
+/**
+ * @brief 更新每個剛體對的 Bullet/OGC 路徑決策
+ *
+ * 每個流形以 EvaluateHybridCost 的便宜特徵評分，偏好改變時須連續
+ * HYBRID_SWITCH_FRAMES 個影格才切換，避免在兩個求解器間來回而失去暖啟動；
+ * 唯一例外是穿隧風險，會立即改用 OGC。長時間未出現的剛體對自快取移除。
+ */
+void PhysicsEngine::UpdateHybridMode(float deltaTime) {
+    ++m_hybridFrame;
+    m_statistics.hybridSwitchCount = 0;
+    const float timeStep = m_timeStep > 0.0f ? m_timeStep : deltaTime;
+
+    const int manifoldCount = m_dispatcher->getNumManifolds();
+    for (int i = 0; i < manifoldCount; ++i) {
+        const btPersistentManifold* manifold = m_dispatcher->getManifoldByIndexInternal(i);
+        const int indexA = manifold->getBody0()->getUserIndex();
+        const int indexB = manifold->getBody1()->getUserIndex();
+        if (indexA < 0 || indexB < 0) continue;
+
+        bool tunneling = false;
+        const bool prefersOGC = EvaluateHybridCost(manifold, timeStep, tunneling) > 0;
+
+        HybridPairState& state = m_hybridPairs[MakeBodyPairKey(indexA, indexB)];
+        state.lastSeenFrame = m_hybridFrame;
+        if (prefersOGC == state.useOGC) {
+            state.pendingFrames = 0;
+            continue;
+        }
+        if (tunneling || ++state.pendingFrames >= HYBRID_SWITCH_FRAMES) {
+            state.useOGC = prefersOGC;
+            state.pendingFrames = 0;
+            ++m_statistics.hybridSwitchCount;
+        }
+    }
+
+    for (auto it = m_hybridPairs.begin(); it != m_hybridPairs.end();) {
+        if (m_hybridFrame - it->second.lastSeenFrame > HYBRID_PAIR_EXPIRY_FRAMES) {
+            it = m_hybridPairs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+/**
+ * @brief 查詢流形目前的路徑決策；尚未評估的剛體對交給 Bullet
+ */
+bool PhysicsEngine::ShouldUseOGCForContact(const btPersistentManifold* manifold) const {
+    const int indexA = manifold->getBody0()->getUserIndex();
+    const int indexB = manifold->getBody1()->getUserIndex();
+    if (indexA < 0 || indexB < 0) return false;
+
+    auto it = m_hybridPairs.find(MakeBodyPairKey(indexA, indexB));
+    return it != m_hybridPairs.end() && it->second.useOGC;
+}
+
+/**
+ * @brief 流形的路徑成本：正值偏好 OGC，否則偏好 Bullet
+ *
+ * 薄物體與帶接觸剛度（軟接觸）的物體在 OGC 的偏移接觸下較穩定；單步
+ * 接近距離接近物體厚度時有穿隧風險，也交給 OGC。低速且多點接觸的
+ * 靜置堆疊則留給 Bullet 的序列衝量求解器，它在堆疊上收斂較快。
+ */
+int PhysicsEngine::EvaluateHybridCost(const btPersistentManifold* manifold, float timeStep, bool& tunneling) const {
+    const btCollisionObject* objectA = manifold->getBody0();
+    const btCollisionObject* objectB = manifold->getBody1();
+    const btScalar extent = std::min(MinimumHalfExtent(objectA), MinimumHalfExtent(objectB));
+
+    int cost = 0;
+    if (extent < HYBRID_THIN_EXTENT) ++cost;
+
+    const int softFlag = btCollisionObject::CF_HAS_CONTACT_STIFFNESS_DAMPING;
+    if ((objectA->getCollisionFlags() & softFlag) || (objectB->getCollisionFlags() & softFlag)) ++cost;
+
+    // 接近速度：有接觸點時取沿法向的分量，否則取整體相對速度
+    const btVector3 relativeVelocity = objectA->getInterpolationLinearVelocity() -
+                                       objectB->getInterpolationLinearVelocity();
+    const int contactCount = manifold->getNumContacts();
+    const btScalar closingSpeed = contactCount > 0
+        ? std::max(-relativeVelocity.dot(manifold->getContactPoint(0).m_normalWorldOnB), btScalar(0.0f))
+        : relativeVelocity.length();
+
+    tunneling = closingSpeed * timeStep > extent * HYBRID_TUNNELING_RATIO;
+    if (tunneling) ++cost;
+
+    if (contactCount >= HYBRID_RESTING_CONTACTS && closingSpeed < HYBRID_RESTING_SPEED) --cost;
+    return cost;
+}
+
+void PhysicsEngine::InternalTickCallback(btDynamicsWorld* world, btScalar timeStep) {
+    auto* engine = static_cast<PhysicsEngine*>(world->getWorldUserInfo());
+    if (engine && engine->m_useOGCContact) {
+        engine->SolveOGCContacts(static_cast<float>(timeStep));
+    }
+}
+
+/**
+ * @brief 以 OGC 求解本子步的所有接觸並寫回衝量
+ *
+ * 統計資訊為一個影格內所有子步的總和（接觸點數取最後一個子步）。
+ */
+void PhysicsEngine::SolveOGCContacts(float timeStep) {
+    if (!m_ogcSolver) return;
+
+    auto solveStart = std::chrono::high_resolution_clock::now();
+
+    ExtractContactPoints();
+    m_statistics.ogcContactCount = static_cast<int>(m_ogcContacts.size());
+    if (!m_ogcContacts.empty()) {
+        // 衝量在下一個固定子步積分，速度約束以子步長為準
+        m_ogcSolver->Solve(m_ogcBodies, m_ogcContacts, timeStep, m_ogcImpulses);
+        ApplyOGCImpulses(m_ogcImpulses);
+        m_statistics.ogcIterations += m_ogcSolver->GetStatistics().iterations;
+    }
+
+    auto solveEnd = std::chrono::high_resolution_clock::now();
+    m_statistics.ogcSolveTime += std::chrono::duration<float, std::milli>(solveEnd - solveStart).count();
+}
+
+/**
+ * @brief 將 OGC 擁有的流形一次收集成扁平接觸陣列
+ *
+ * 只收集至少一方為活動中動態剛體的流形；接觸點先以目前變換更新距離，
+ * 保留距離小於偏移半徑者。剛體狀態依首次出現的順序放入 m_ogcBodies，
+ * 以密集剛體索引對應，同一剛體只收集一次。
+ */
+void PhysicsEngine::ExtractContactPoints() {
+    m_ogcBodies.clear();
+    m_ogcSlotBodies.clear();
+    m_ogcContacts.clear();
+    m_ogcManifoldPoints.clear();
+    m_ogcBodySlots.assign(m_bodyList.size(), -1);
+    m_statistics.bulletContactCount = 0;
+
+    const int manifoldCount = m_dispatcher->getNumManifolds();
+    for (int i = 0; i < manifoldCount; ++i) {
+        btPersistentManifold* manifold = m_dispatcher->getManifoldByIndexInternal(i);
+        if (manifold->getContactProcessingThreshold() != -BT_LARGE_FLOAT) {
+            m_statistics.bulletContactCount += manifold->getNumContacts();
+            continue;
+        }
+
+        const btCollisionObject* objectA = manifold->getBody0();
+        const btCollisionObject* objectB = manifold->getBody1();
+        const bool awakeA = !objectA->isStaticOrKinematicObject() && objectA->isActive();
+        const bool awakeB = !objectB->isStaticOrKinematicObject() && objectB->isActive();
+        if (!awakeA && !awakeB) continue;
+
+        manifold->refreshContactPoints(objectA->getWorldTransform(), objectB->getWorldTransform());
+        if (manifold->getNumContacts() == 0) continue;
+
+        const int32_t slotA = GetOGCBodySlot(objectA);
+        const int32_t slotB = GetOGCBodySlot(objectB);
+        if (slotA < 0 || slotB < 0) continue;
+
+        for (int p = 0; p < manifold->getNumContacts(); ++p) {
+            btManifoldPoint& point = manifold->getContactPoint(p);
+            if (point.getDistance() >= m_ogcContactRadius) continue;
+
+            const btVector3& pointA = point.getPositionWorldOnA();
+            const btVector3& pointB = point.getPositionWorldOnB();
+
+            OGCContactSolver::ContactPoint contact;
+            contact.bodyA = static_cast<uint32_t>(slotA);
+            contact.bodyB = static_cast<uint32_t>(slotB);
+            contact.pointA = Eigen::Vector3f(pointA.getX(), pointA.getY(), pointA.getZ());
+            contact.pointB = Eigen::Vector3f(pointB.getX(), pointB.getY(), pointB.getZ());
+            contact.normal = Eigen::Vector3f(point.m_normalWorldOnB.getX(),
+                                             point.m_normalWorldOnB.getY(),
+                                             point.m_normalWorldOnB.getZ());
+            contact.distance = point.getDistance();
+            contact.friction = point.m_combinedFriction;
+            contact.restitution = point.m_combinedRestitution;
+            contact.warmStartImpulse = point.m_appliedImpulse;
+
+            m_ogcContacts.push_back(contact);
+            m_ogcManifoldPoints.push_back(&point);
+        }
+    }
+}
+
+/**
+ * @brief 取得剛體在 m_ogcBodies 中的索引，首次出現時收集其狀態
+ */
+int32_t PhysicsEngine::GetOGCBodySlot(const btCollisionObject* object) {
+    const int index = object->getUserIndex();
+    if (index < 0 || static_cast<size_t>(index) >= m_ogcBodySlots.size()) return -1;
+
+    int32_t& slot = m_ogcBodySlots[index];
+    if (slot >= 0) return slot;
+
+    btRigidBody* body = m_bodyList[index]->bulletBody.get();
+    const btVector3& position = body->getCenterOfMassPosition();
+    const btVector3& linearVelocity = body->getLinearVelocity();
+    const btVector3& angularVelocity = body->getAngularVelocity();
+    const btMatrix3x3& inverseInertia = body->getInvInertiaTensorWorld();
+
+    OGCContactSolver::BodyState state;
+    state.position = Eigen::Vector3f(position.getX(), position.getY(), position.getZ());
+    state.linearVelocity = Eigen::Vector3f(linearVelocity.getX(), linearVelocity.getY(), linearVelocity.getZ());
+    state.angularVelocity = Eigen::Vector3f(angularVelocity.getX(), angularVelocity.getY(), angularVelocity.getZ());
+    if (!body->isStaticOrKinematicObject()) {
+        state.inverseMass = body->getInvMass();
+        for (int row = 0; row < 3; ++row) {
+            for (int column = 0; column < 3; ++column) {
+                state.inverseInertia(row, column) = inverseInertia[row][column];
+            }
+        }
+    }
+
+    slot = static_cast<int32_t>(m_ogcBodies.size());
+    m_ogcBodies.push_back(state);
+    m_ogcSlotBodies.push_back(body);
+    return slot;
+}
+
+/**
+ * @brief 將 OGC 衝量施加到剛體，並把法向衝量存回接觸點作為下一步的暖啟動
+ */
+void PhysicsEngine::ApplyOGCImpulses(const std::vector<OGCContactSolver::ContactImpulse>& impulses) {
+    for (size_t i = 0; i < impulses.size(); ++i) {
+        const OGCContactSolver::ContactPoint& contact = m_ogcContacts[i];
+        const OGCContactSolver::ContactImpulse& result = impulses[i];
+        btManifoldPoint& point = *m_ogcManifoldPoints[i];
+        point.m_appliedImpulse = result.normalImpulse;
+
+        if (result.normalImpulse <= 0.0f && result.impulse.isZero()) continue;
+        const btVector3 impulse(result.impulse.x(), result.impulse.y(), result.impulse.z());
+
+        btRigidBody* bodyA = m_ogcSlotBodies[contact.bodyA];
+        if (m_ogcBodies[contact.bodyA].inverseMass > 0.0f) {
+            bodyA->activate();
+            bodyA->applyImpulse(impulse, point.getPositionWorldOnA() - bodyA->getCenterOfMassPosition());
+        }
+
+        btRigidBody* bodyB = m_ogcSlotBodies[contact.bodyB];
+        if (m_ogcBodies[contact.bodyB].inverseMass > 0.0f) {
+            bodyB->activate();
+            bodyB->applyImpulse(-impulse, point.getPositionWorldOnB() - bodyB->getCenterOfMassPosition());
+        }
+    }
+}
+
+/**
+ * @brief 批次射線檢測
+ *
+ * 射線以 RAY_QUERY_GRAIN 條為一個區塊分給工作執行緒，每個區塊建立自己的
+ * BroadphaseQuery（內含遍歷堆疊），因此執行緒之間只共用唯讀的世界資料。
+ */
+void PhysicsEngine::RaycastBatch(const std::vector<RayQuery>& rays, std::vector<QueryHit>& hits, bool usePackets) const {
+    hits.assign(rays.size(), QueryHit());
+    if (!m_broadphase || rays.empty()) return;
+
+    RunQueryBatch(rays.size(), RAY_QUERY_GRAIN, [&](size_t begin, size_t end) {
+        BroadphaseQuery query(m_broadphase.get());
+        BroadphaseQuery::Ray packetRays[BroadphaseQuery::PACKET_SIZE];
+        BroadphaseQuery::Hit packetHits[BroadphaseQuery::PACKET_SIZE];
+
+        const size_t step = usePackets ? BroadphaseQuery::PACKET_SIZE : 1;
+        for (size_t first = begin; first < end; first += step) {
+            const size_t count = std::min(step, end - first);
+            for (size_t lane = 0; lane < count; ++lane) {
+                const RayQuery& ray = rays[first + lane];
+                packetRays[lane].from = ToBulletVector3(ray.from);
+                packetRays[lane].to = ToBulletVector3(ray.to);
+                packetRays[lane].collisionMask = ray.collisionMask;
+            }
+
+            if (usePackets) {
+                query.RaycastPacket(packetRays, count, packetHits);
+            } else {
+                query.Raycast(packetRays[0], packetHits[0]);
+            }
+
+            for (size_t lane = 0; lane < count; ++lane) {
+                FillQueryHit(packetHits[lane], hits[first + lane]);
+            }
+        }
+    });
+}
+
+/**
+ * @brief 批次球體掃掠
+ */
+void PhysicsEngine::SphereSweepBatch(const std::vector<SweepQuery>& sweeps, std::vector<QueryHit>& hits) const {
+    hits.assign(sweeps.size(), QueryHit());
+    if (!m_broadphase || sweeps.empty()) return;
+
+    RunQueryBatch(sweeps.size(), SWEEP_QUERY_GRAIN, [&](size_t begin, size_t end) {
+        BroadphaseQuery query(m_broadphase.get());
+        BroadphaseQuery::Hit hit;
+        for (size_t i = begin; i < end; ++i) {
+            const SweepQuery& sweep = sweeps[i];
+            query.SphereSweep(ToBulletVector3(sweep.from), ToBulletVector3(sweep.to),
+                              sweep.radius, sweep.collisionMask, hit);
+            FillQueryHit(hit, hits[i]);
+        }
+    });
+}
+
+/**
+ * @brief 批次包圍盒重疊查詢
+ *
+ * 每個區塊先把結果寫入自己的暫存陣列並記錄各查詢的數量，
+ * 最後在呼叫端依序串接成扁平結果。
+ */
+void PhysicsEngine::OverlapBatch(const std::vector<OverlapQuery>& boxes, OverlapResults& results) const {
+    results.offsets.assign(boxes.size() + 1, 0);
+    results.bodyIndices.clear();
+    if (!m_broadphase || boxes.empty()) return;
+
+    const size_t chunkCount = (boxes.size() + OVERLAP_QUERY_GRAIN - 1) / OVERLAP_QUERY_GRAIN;
+    std::vector<std::vector<uint32_t>> chunkIndices(chunkCount);
+
+    RunQueryBatch(boxes.size(), OVERLAP_QUERY_GRAIN, [&](size_t begin, size_t end) {
+        BroadphaseQuery query(m_broadphase.get());
+        std::vector<const btCollisionObject*> objects;
+        std::vector<uint32_t>& indices = chunkIndices[begin / OVERLAP_QUERY_GRAIN];
+
+        for (size_t i = begin; i < end; ++i) {
+            const OverlapQuery& box = boxes[i];
+            query.Overlap(ToBulletVector3(box.aabbMin), ToBulletVector3(box.aabbMax), box.collisionMask, objects);
+
+            uint32_t count = 0;
+            for (const btCollisionObject* object : objects) {
+                const int index = object->getUserIndex();
+                if (index < 0) continue;
+                indices.push_back(static_cast<uint32_t>(index));
+                ++count;
+            }
+            results.offsets[i + 1] = count;
+        }
+    });
+
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        results.offsets[i + 1] += results.offsets[i];
+    }
+    results.bodyIndices.reserve(results.offsets.back());
+    for (const std::vector<uint32_t>& indices : chunkIndices) {
+        results.bodyIndices.insert(results.bodyIndices.end(), indices.begin(), indices.end());
+    }
+}
+
+/**
+ * @brief 將批次查詢分給 Initialize 建立的工作執行緒；執行緒池無法啟動時在呼叫端執行
+ */
+void PhysicsEngine::RunQueryBatch(size_t count, size_t grainSize, const WorkerPool::RangeFunction& function) const {
+    if (m_workerPool) {
+        m_workerPool->ParallelFor(count, grainSize, function);
+    } else {
+        function(0, count);
+    }
+}
+
+void PhysicsEngine::FillQueryHit(const BroadphaseQuery::Hit& source, QueryHit& hit) const {
+    hit.hit = source.object != nullptr;
+    if (!hit.hit) return;
+
+    const int index = source.object->getUserIndex();
+    hit.bodyIndex = index >= 0 ? static_cast<uint32_t>(index) : INVALID_BODY_INDEX;
+    hit.point = FromBulletVector3(source.point);
+    hit.normal = FromBulletVector3(source.normal);
+    hit.fraction = source.fraction;
+}
+
+/**
+ * @brief 將剛體附加到密集剛體表尾端
+ */
+void PhysicsEngine::RegisterBody(RigidBodyData* data) {
+    data->bodyIndex = static_cast<uint32_t>(m_bodyList.size());
+    data->bulletBody->setUserIndex(static_cast<int>(data->bodyIndex));
+    m_bodyList.push_back(data);
+}
+
+/**
+ * @brief 以接觸流形產生碰撞事件
+ *
+ * 收集有接觸點的剛體對成為已排序的整數鍵值陣列，與上一步的陣列合併比較：
+ * 只在本步出現者為進入、兩步都有者為持續、只在上一步出現者為離開。
+ * 所有事件一次交給回調，名稱只在回調需要時才查表。
+ */
+void PhysicsEngine::ProcessCollisionCallbacks() {
+    m_contactPairs.clear();
+    const int manifoldCount = m_dispatcher->getNumManifolds();
+    for (int i = 0; i < manifoldCount; ++i) {
+        const btPersistentManifold* manifold = m_dispatcher->getManifoldByIndexInternal(i);
+        if (manifold->getNumContacts() == 0) continue;
+
+        const int indexA = manifold->getBody0()->getUserIndex();
+        const int indexB = manifold->getBody1()->getUserIndex();
+        if (indexA < 0 || indexB < 0) continue;
+        m_contactPairs.push_back(MakeBodyPairKey(indexA, indexB));
+    }
+    // 複合形狀等情況下同一對剛體可能有多個流形
+    std::sort(m_contactPairs.begin(), m_contactPairs.end());
+    m_contactPairs.erase(std::unique(m_contactPairs.begin(), m_contactPairs.end()), m_contactPairs.end());
+
+    if (m_collisionCallback) {
+        m_collisionEvents.Clear();
+        m_collisionEvents.bodyNames = m_bodyNames;
+
+        size_t current = 0;
+        size_t previous = 0;
+        while (current < m_contactPairs.size() || previous < m_previousContactPairs.size()) {
+            if (previous == m_previousContactPairs.size() ||
+                (current < m_contactPairs.size() && m_contactPairs[current] < m_previousContactPairs[previous])) {
+                m_collisionEvents.entered.push_back(UnpackBodyPairKey(m_contactPairs[current++]));
+            } else if (current == m_contactPairs.size() || m_previousContactPairs[previous] < m_contactPairs[current]) {
+                m_collisionEvents.exited.push_back(UnpackBodyPairKey(m_previousContactPairs[previous++]));
+            } else {
+                m_collisionEvents.stayed.push_back(UnpackBodyPairKey(m_contactPairs[current]));
+                ++current;
+                ++previous;
+            }
+        }
+
+        if (!m_collisionEvents.IsEmpty()) {
+            m_collisionCallback->OnCollisionEvents(m_collisionEvents);
+        }
+    }
+
+    m_previousContactPairs.swap(m_contactPairs);
+}
+
+/**
+ * @brief 剛體移除後以新舊索引對照表更新以密集索引為鍵的剛體對
+ *
+ * 含被移除剛體（對照為 INVALID_BODY_INDEX）的對直接捨棄，不產生離開事件。
+ * 壓縮保持相對順序，對照是遞增的，因此上一步的剛體對仍維持排序。
+ */
+void PhysicsEngine::RemapBodyIndices(const std::vector<uint32_t>& newIndices) {
+    size_t count = 0;
+    for (uint64_t key : m_previousContactPairs) {
+        const CollisionPair pair = UnpackBodyPairKey(key);
+        const uint32_t bodyA = newIndices[pair.bodyA];
+        const uint32_t bodyB = newIndices[pair.bodyB];
+        if (bodyA == INVALID_BODY_INDEX || bodyB == INVALID_BODY_INDEX) continue;
+        m_previousContactPairs[count++] = MakeBodyPairKey(bodyA, bodyB);
+    }
+    m_previousContactPairs.resize(count);
+
+    std::unordered_map<uint64_t, HybridPairState> hybridPairs;
+    hybridPairs.reserve(m_hybridPairs.size());
+    for (const auto& [key, state] : m_hybridPairs) {
+        const CollisionPair pair = UnpackBodyPairKey(key);
+        const uint32_t bodyA = newIndices[pair.bodyA];
+        const uint32_t bodyB = newIndices[pair.bodyB];
+        if (bodyA == INVALID_BODY_INDEX || bodyB == INVALID_BODY_INDEX) continue;
+        hybridPairs.emplace(MakeBodyPairKey(bodyA, bodyB), state);
+    }
+    m_hybridPairs.swap(hybridPairs);
+}
+
+/**
+ * @brief 預設的批次碰撞回調：逐對轉呼叫個別事件函數
+ */
+void PhysicsEngine::CollisionCallback::OnCollisionEvents(const CollisionEvents& events) {
+    for (const CollisionPair& pair : events.entered) {
+        OnCollisionEnter(events.GetName(pair.bodyA), events.GetName(pair.bodyB));
+    }
+    for (const CollisionPair& pair : events.stayed) {
+        OnCollisionStay(events.GetName(pair.bodyA), events.GetName(pair.bodyB));
+    }
+    for (const CollisionPair& pair : events.exited) {
+        OnCollisionExit(events.GetName(pair.bodyA), events.GetName(pair.bodyB));
+    }
+}
+
+/**
+ * @brief 重建快照共用的剛體名稱表
+ *
+ * 已發佈的快照仍持有舊名稱表的 shared_ptr，因此這裡總是建立新的向量，
+ * 不會修改消費者正在讀取的資料。
+ */
+void PhysicsEngine::RebuildBodyNameTable() {
+    auto names = std::make_shared<std::vector<std::string>>();
+    names->reserve(m_bodyList.size());
+    for (const RigidBodyData* data : m_bodyList) {
+        names->push_back(data->sceneData.name);
+    }
+    m_bodyNames = std::move(names);
+}
+
+/**
+ * @brief 將本步驟結束後的狀態發佈到快照環形緩衝區
+ */
+void PhysicsEngine::PublishSnapshot() {
+    FrameSnapshot* snapshot = m_snapshotRing.BeginWrite();
+    if (!snapshot) {
+        // 所有槽位都被消費者占用，本影格不發佈
+        return;
+    }
+
+    snapshot->simulationTime = m_simulationTime;
+    snapshot->bodyNames = m_bodyNames;
+
+    // 剛體狀態
+    snapshot->bodies.resize(m_bodyList.size());
+    for (size_t i = 0; i < m_bodyList.size(); ++i) {
+        const RigidBodyData* data = m_bodyList[i];
+        const btRigidBody* body = data->bulletBody.get();
+        FrameSnapshot::BodyState& state = snapshot->bodies[i];
+
+        state.transform = FromBulletTransform(body->getWorldTransform());
+        state.transform.scale = data->sceneData.transform.scale;
+        state.linearVelocity = FromBulletVector3(body->getLinearVelocity());
+        state.angularVelocity = FromBulletVector3(body->getAngularVelocity());
+        state.active = body->isActive();
+    }
+
+    // 接觸點
+    snapshot->contacts.clear();
+    const int manifoldCount = m_dispatcher->getNumManifolds();
+    for (int m = 0; m < manifoldCount; ++m) {
+        const btPersistentManifold* manifold = m_dispatcher->getManifoldByIndexInternal(m);
+        const int indexA = manifold->getBody0()->getUserIndex();
+        const int indexB = manifold->getBody1()->getUserIndex();
+        if (indexA < 0 || indexB < 0) continue;
+
+        for (int c = 0; c < manifold->getNumContacts(); ++c) {
+            const btManifoldPoint& point = manifold->getContactPoint(c);
+            if (point.getDistance() > 0.0f) continue;
+
+            FrameSnapshot::ContactState contact;
+            contact.bodyA = static_cast<uint32_t>(indexA);
+            contact.bodyB = static_cast<uint32_t>(indexB);
+            contact.point = FromBulletVector3(point.getPositionWorldOnB());
+            contact.normal = FromBulletVector3(point.m_normalWorldOnB);
+            contact.distance = point.getDistance();
+            contact.impulse = point.getAppliedImpulse();
+            snapshot->contacts.push_back(contact);
+        }
+    }
+
+    // 統計資訊
+    snapshot->statistics.rigidBodyCount = m_statistics.rigidBodyCount;
+    snapshot->statistics.activeBodyCount = m_statistics.activeBodyCount;
+    snapshot->statistics.contactPointCount = m_statistics.contactPointCount;
+    snapshot->statistics.stepTime = m_statistics.simulationTime;
+    snapshot->statistics.ogcSolveTime = m_statistics.ogcSolveTime;
+    snapshot->statistics.bulletSolveTime = m_statistics.bulletSolveTime;
+
+    m_snapshotRing.EndWrite();
+}
+
+/**
+ * @brief 將完整動態狀態寫入檢查點
+ *
+ * 內容包含剛體變換與速度、休眠狀態、接觸流形（含暖啟動用的累積衝量）、
+ * 約束衝量與啟用狀態、力場參數、碰撞回調的上一步狀態、混合模式的剛體對決策、求解器亂數種子，
+ * 以及固定步長累積的剩餘時間（決定下一次 StepSimulation 的子步數）。
+ * 應在兩次 StepSimulation 之間呼叫；此時 Bullet 已清除累積外力，故不另外保存。
+ */
+bool PhysicsEngine::SaveCheckpoint(SimulationCheckpoint& checkpoint) const {
+    if (!m_dynamicsWorld) return false;
+
+    checkpoint.data.clear();
+    checkpoint.bodyNames = m_bodyNames;
+    checkpoint.simulationTime = m_simulationTime;
+
+    CheckpointWriter writer(checkpoint.data);
+    writer.Write(SimulationCheckpoint::BLOB_VERSION);
+    writer.Write(m_simulationTime);
+    writer.Write(LocalTime(*m_dynamicsWorld));
+    writer.Write(static_cast<uint64_t>(m_solver->getRandSeed()));
+
+    // 剛體（依密集索引順序）
+    writer.Write(static_cast<uint32_t>(m_bodyList.size()));
+    for (const RigidBodyData* data : m_bodyList) {
+        const btRigidBody* body = data->bulletBody.get();
+        BodyCheckpoint state;
+        body->getWorldTransform().getOpenGLMatrix(state.worldTransform);
+        body->getInterpolationWorldTransform().getOpenGLMatrix(state.interpolationWorldTransform);
+        StoreVector(body->getLinearVelocity(), state.linearVelocity);
+        StoreVector(body->getAngularVelocity(), state.angularVelocity);
+        StoreVector(body->getInterpolationLinearVelocity(), state.interpolationLinearVelocity);
+        StoreVector(body->getInterpolationAngularVelocity(), state.interpolationAngularVelocity);
+        state.deactivationTime = body->getDeactivationTime();
+        state.activationState = body->getActivationState();
+        writer.Write(state);
+    }
+
+    // 接觸流形
+    SaveContactManifolds(writer);
+
+    // 約束
+    writer.Write(static_cast<uint32_t>(m_constraints.size()));
+    for (const auto& [name, data] : m_constraints) {
+        const btTypedConstraint* constraint = data->bulletConstraint.get();
+        writer.WriteString(name);
+        writer.Write(constraint->getAppliedImpulse());
+        writer.Write(static_cast<uint8_t>(constraint->isEnabled() ? 1 : 0));
+    }
+
+    // 力場
+    writer.Write(static_cast<uint32_t>(m_forceFields.size()));
+    for (const auto& [name, data] : m_forceFields) {
+        const PhysicsScene::ForceField& field = data->sceneData;
+        ForceFieldCheckpoint state;
+        state.position = field.position;
+        state.direction = field.direction;
+        state.strength = field.strength;
+        state.radius = field.radius;
+        state.falloff = field.falloff;
+        state.affectedGroups = field.affectedGroups;
+        state.enabled = field.enabled ? 1 : 0;
+        writer.WriteString(name);
+        writer.Write(state);
+    }
+
+    // 碰撞事件狀態
+    writer.Write(static_cast<uint32_t>(m_previousContactPairs.size()));
+    for (uint64_t key : m_previousContactPairs) {
+        writer.Write(key);
+    }
+
+    // 混合模式的剛體對決策；切換遲滯與過期都以 m_hybridFrame 計算
+    writer.Write(m_hybridFrame);
+    writer.Write(static_cast<uint32_t>(m_hybridPairs.size()));
+    for (const auto& [key, state] : m_hybridPairs) {
+        writer.Write(key);
+        writer.Write(state);
+    }
+
+    return true;
+}
+
+/**
+ * @brief 從檢查點還原完整動態狀態
+ *
+ * 直接覆寫現有剛體與約束的狀態，不重建世界。剛體集合與儲存時相同時
+ * 依密集索引還原；否則依名稱對應，儲存後新增的剛體維持原狀，
+ * 已移除的剛體則略過。整個區塊先解碼並驗證完畢才一次套用，
+ * 損壞或截斷的檢查點不會留下只還原一半的世界。
+ */
+bool PhysicsEngine::RestoreCheckpoint(const SimulationCheckpoint& checkpoint) {
+    if (!m_dynamicsWorld || !checkpoint.IsValid()) return false;
+
+    CheckpointReader reader(checkpoint.data);
+    uint32_t version = 0;
+    double simulationTime = 0.0;
+    btScalar localTime = 0.0f;
+    uint64_t randSeed = 0;
+    if (!reader.Read(version) || version != SimulationCheckpoint::BLOB_VERSION ||
+        !reader.Read(simulationTime) || !reader.Read(localTime) || !reader.Read(randSeed)) {
+        HandlePhysicsError("Invalid simulation checkpoint");
+        return false;
+    }
+
+    std::vector<RigidBodyData*> bodies = ResolveCheckpointBodies(checkpoint);
+
+    // 剛體
+    uint32_t bodyCount = 0;
+    if (!reader.Read(bodyCount) || bodyCount != bodies.size()) {
+        HandlePhysicsError("Simulation checkpoint body table mismatch");
+        return false;
+    }
+    std::vector<BodyCheckpoint> bodyStates(bodyCount);
+    for (BodyCheckpoint& state : bodyStates) {
+        if (!reader.Read(state)) {
+            HandlePhysicsError("Truncated simulation checkpoint");
+            return false;
+        }
+    }
+
+    // 接觸流形
+    std::vector<CheckpointManifold> manifolds;
+    if (!ReadContactManifolds(reader, manifolds)) {
+        HandlePhysicsError("Truncated simulation checkpoint");
+        return false;
+    }
+
+    // 約束
+    struct ConstraintState {
+        ConstraintData* data;
+        btScalar appliedImpulse;
+        bool enabled;
+    };
+    std::vector<ConstraintState> constraints;
+    uint32_t constraintCount = 0;
+    if (!reader.Read(constraintCount)) {
+        HandlePhysicsError("Truncated simulation checkpoint");
+        return false;
+    }
+    for (uint32_t i = 0; i < constraintCount; ++i) {
+        std::string name;
+        btScalar appliedImpulse = 0.0f;
+        uint8_t enabled = 0;
+        if (!reader.ReadString(name) || !reader.Read(appliedImpulse) || !reader.Read(enabled)) {
+            HandlePhysicsError("Truncated simulation checkpoint");
+            return false;
+        }
+        auto it = m_constraints.find(name);
+        if (it == m_constraints.end()) continue;
+        constraints.push_back({it->second.get(), appliedImpulse, enabled != 0});
+    }
+
+    // 力場
+    std::vector<std::pair<ForceFieldData*, ForceFieldCheckpoint>> forceFields;
+    uint32_t forceFieldCount = 0;
+    if (!reader.Read(forceFieldCount)) {
+        HandlePhysicsError("Truncated simulation checkpoint");
+        return false;
+    }
+    for (uint32_t i = 0; i < forceFieldCount; ++i) {
+        std::string name;
+        ForceFieldCheckpoint state;
+        if (!reader.ReadString(name) || !reader.Read(state)) {
+            HandlePhysicsError("Truncated simulation checkpoint");
+            return false;
+        }
+        auto it = m_forceFields.find(name);
+        if (it == m_forceFields.end()) continue;
+        forceFields.emplace_back(it->second.get(), state);
+    }
+
+    // 碰撞事件狀態：鍵值中的索引為儲存時的索引，需換成目前的密集索引
+    std::vector<uint64_t> previousContactPairs;
+    uint32_t pairCount = 0;
+    if (!reader.Read(pairCount)) {
+        HandlePhysicsError("Truncated simulation checkpoint");
+        return false;
+    }
+    for (uint32_t i = 0; i < pairCount; ++i) {
+        uint64_t key = 0;
+        if (!reader.Read(key)) {
+            HandlePhysicsError("Truncated simulation checkpoint");
+            return false;
+        }
+        const CollisionPair pair = UnpackBodyPairKey(key);
+        if (pair.bodyB >= bodies.size() || !bodies[pair.bodyA] || !bodies[pair.bodyB]) continue;
+        previousContactPairs.push_back(MakeBodyPairKey(bodies[pair.bodyA]->bodyIndex, bodies[pair.bodyB]->bodyIndex));
+    }
+    std::sort(previousContactPairs.begin(), previousContactPairs.end());
+
+    // 混合模式的剛體對決策：整個取代，避免回溯後沿用來自未來的決策
+    std::unordered_map<uint64_t, HybridPairState> hybridPairs;
+    uint32_t hybridFrame = 0;
+    uint32_t hybridPairCount = 0;
+    if (!reader.Read(hybridFrame) || !reader.Read(hybridPairCount)) {
+        HandlePhysicsError("Truncated simulation checkpoint");
+        return false;
+    }
+    for (uint32_t i = 0; i < hybridPairCount; ++i) {
+        uint64_t key = 0;
+        HybridPairState state;
+        if (!reader.Read(key) || !reader.Read(state)) {
+            HandlePhysicsError("Truncated simulation checkpoint");
+            return false;
+        }
+        const CollisionPair pair = UnpackBodyPairKey(key);
+        if (pair.bodyB >= bodies.size() || !bodies[pair.bodyA] || !bodies[pair.bodyB]) continue;
+        hybridPairs[MakeBodyPairKey(bodies[pair.bodyA]->bodyIndex, bodies[pair.bodyB]->bodyIndex)] = state;
+    }
+
+    if (!reader.AtEnd()) {
+        HandlePhysicsError("Invalid simulation checkpoint");
+        return false;
+    }
+
+    // 以下全部套用，不再有失敗路徑
+    for (uint32_t i = 0; i < bodyCount; ++i) {
+        if (!bodies[i]) continue;
+
+        const BodyCheckpoint& state = bodyStates[i];
+        btRigidBody* body = bodies[i]->bulletBody.get();
+        btTransform worldTransform = LoadTransform(state.worldTransform);
+        body->setWorldTransform(worldTransform);
+        body->setInterpolationWorldTransform(LoadTransform(state.interpolationWorldTransform));
+        body->setLinearVelocity(LoadVector(state.linearVelocity));
+        body->setAngularVelocity(LoadVector(state.angularVelocity));
+        body->setInterpolationLinearVelocity(LoadVector(state.interpolationLinearVelocity));
+        body->setInterpolationAngularVelocity(LoadVector(state.interpolationAngularVelocity));
+        body->clearForces();
+        body->forceActivationState(state.activationState);
+        body->setDeactivationTime(state.deactivationTime);
+
+        // 運動學剛體由 motion state 驅動，必須一併更新
+        if (body->getMotionState()) {
+            body->getMotionState()->setWorldTransform(worldTransform);
+        }
+    }
+
+    RestoreContactManifolds(manifolds, bodies);
+
+    for (const ConstraintState& state : constraints) {
+        state.data->bulletConstraint->internalSetAppliedImpulse(state.appliedImpulse);
+        state.data->bulletConstraint->setEnabled(state.enabled);
+    }
+
+    for (const auto& [data, state] : forceFields) {
+        PhysicsScene::ForceField& field = data->sceneData;
+        field.position = state.position;
+        field.direction = state.direction;
+        field.strength = state.strength;
+        field.radius = state.radius;
+        field.falloff = state.falloff;
+        field.affectedGroups = state.affectedGroups;
+        field.enabled = state.enabled != 0;
+    }
+
+    m_previousContactPairs.swap(previousContactPairs);
+    m_hybridPairs.swap(hybridPairs);
+    m_hybridFrame = hybridFrame;
+
+    m_solver->setRandSeed(static_cast<unsigned long>(randSeed));
+    m_simulationTime = simulationTime;
+    // 下一次 StepSimulation 的子步數取決於剩餘時間
+    LocalTime(*m_dynamicsWorld) = localTime;
+
+    UpdateStatistics();
+    PublishSnapshot();
+    return true;
+}
+
+/**
+ * @brief 將檢查點中的剛體索引對應到目前的剛體
+ */
+std::vector<PhysicsEngine::RigidBodyData*> PhysicsEngine::ResolveCheckpointBodies(
+    const SimulationCheckpoint& checkpoint) const {
+    if (checkpoint.bodyNames == m_bodyNames) {
+        return m_bodyList;
+    }
+
+    std::vector<RigidBodyData*> bodies;
+    if (!checkpoint.bodyNames) return bodies;
+
+    bodies.reserve(checkpoint.bodyNames->size());
+    for (const std::string& name : *checkpoint.bodyNames) {
+        auto it = m_rigidBodies.find(name);
+        bodies.push_back(it != m_rigidBodies.end() ? it->second.get() : nullptr);
+    }
+    return bodies;
+}
+
+/**
+ * @brief 依 dispatcher 中的順序保存接觸流形
+ *
+ * 求解器以流形陣列順序處理接觸，保存順序是重現相同結果的必要條件。
+ */
+void PhysicsEngine::SaveContactManifolds(CheckpointWriter& writer) const {
+    const int manifoldCount = m_dispatcher->getNumManifolds();
+    writer.Write(static_cast<uint32_t>(manifoldCount));
+
+    for (int m = 0; m < manifoldCount; ++m) {
+        const btPersistentManifold* manifold = m_dispatcher->getManifoldByIndexInternal(m);
+        const int indexA = manifold->getBody0()->getUserIndex();
+        const int indexB = manifold->getBody1()->getUserIndex();
+
+        ManifoldCheckpoint header;
+        header.bodyA = indexA >= 0 ? static_cast<uint32_t>(indexA) : INVALID_BODY;
+        header.bodyB = indexB >= 0 ? static_cast<uint32_t>(indexB) : INVALID_BODY;
+        header.contactCount = manifold->getNumContacts();
+        writer.Write(header);
+
+        for (int c = 0; c < header.contactCount; ++c) {
+            btManifoldPoint point = manifold->getContactPoint(c);
+            point.m_userPersistentData = nullptr;
+            writer.WriteBytes(&point, sizeof(btManifoldPoint));
+        }
+    }
+}
+
+/**
+ * @brief 解碼檢查點中的接觸流形；只讀取與驗證，不修改世界
+ */
+bool PhysicsEngine::ReadContactManifolds(CheckpointReader& reader, std::vector<CheckpointManifold>& manifolds) {
+    uint32_t manifoldCount = 0;
+    if (!reader.Read(manifoldCount)) return false;
+
+    manifolds.clear();
+    for (uint32_t m = 0; m < manifoldCount; ++m) {
+        ManifoldCheckpoint header;
+        if (!reader.Read(header) || header.contactCount < 0 ||
+            header.contactCount > MANIFOLD_CACHE_SIZE) {
+            return false;
+        }
+
+        CheckpointManifold manifold;
+        manifold.bodyA = header.bodyA;
+        manifold.bodyB = header.bodyB;
+        manifold.points.resize(header.contactCount);
+        for (btManifoldPoint& point : manifold.points) {
+            if (!reader.ReadBytes(&point, sizeof(btManifoldPoint))) return false;
+        }
+        manifolds.push_back(std::move(manifold));
+    }
+    return true;
+}
+
+/**
+ * @brief 還原接觸流形與暖啟動衝量
+ *
+ * 先以還原後的變換執行一次窄相位，讓每個重疊剛體對都擁有流形，
+ * 再以保存的接觸點覆寫，並把 dispatcher 的流形陣列重排成儲存時的順序。
+ * 儲存時不存在的流形會被清空，下一步由窄相位重新產生。
+ */
+void PhysicsEngine::RestoreContactManifolds(const std::vector<CheckpointManifold>& manifolds,
+                                            const std::vector<RigidBodyData*>& bodies) {
+    m_dynamicsWorld->performDiscreteCollisionDetection();
+
+    // 以不分順序的剛體索引對查找目前的流形；窄相位重建的流形可能互換兩個剛體，
+    // 複合形狀的同一對剛體也可能有多個流形
+    std::unordered_map<uint64_t, std::vector<btPersistentManifold*>> liveManifolds;
+    const int liveCount = m_dispatcher->getNumManifolds();
+    liveManifolds.reserve(liveCount);
+    for (int m = 0; m < liveCount; ++m) {
+        btPersistentManifold* manifold = m_dispatcher->getManifoldByIndexInternal(m);
+        const int indexA = manifold->getBody0()->getUserIndex();
+        const int indexB = manifold->getBody1()->getUserIndex();
+        if (indexA >= 0 && indexB >= 0) {
+            liveManifolds[MakeBodyPairKey(indexA, indexB)].push_back(manifold);
+        }
+    }
+
+    std::vector<btPersistentManifold*> ordered;
+    std::vector<uint8_t> placed(liveCount, 0);
+    ordered.reserve(liveCount);
+
+    for (const CheckpointManifold& saved : manifolds) {
+        // 對應到目前的剛體索引
+        const RigidBodyData* bodyA = saved.bodyA < bodies.size() ? bodies[saved.bodyA] : nullptr;
+        const RigidBodyData* bodyB = saved.bodyB < bodies.size() ? bodies[saved.bodyB] : nullptr;
+        if (!bodyA || !bodyB) continue;
+
+        auto it = liveManifolds.find(MakeBodyPairKey(static_cast<int>(bodyA->bodyIndex),
+                                                     static_cast<int>(bodyB->bodyIndex)));
+        if (it == liveManifolds.end() || it->second.empty()) continue;
+
+        btPersistentManifold* manifold = it->second.front();
+        it->second.erase(it->second.begin());
+
+        const bool swapped = manifold->getBody0()->getUserIndex() != static_cast<int>(bodyA->bodyIndex);
+        manifold->clearManifold();
+        for (btManifoldPoint point : saved.points) {
+            if (swapped) {
+                SwapManifoldPointBodies(point);
+            }
+            manifold->addManifoldPoint(point);
+        }
+        placed[manifold->m_index1a] = 1;
+        ordered.push_back(manifold);
+    }
+
+    // 儲存時不存在的流形清空後排在後面
+    for (int m = 0; m < liveCount; ++m) {
+        if (placed[m]) continue;
+        btPersistentManifold* manifold = m_dispatcher->getManifoldByIndexInternal(m);
+        manifold->clearManifold();
+        ordered.push_back(manifold);
+    }
+
+    // 重排 dispatcher 的流形陣列；m_index1a 是 releaseManifold 使用的陣列索引
+    btPersistentManifold** manifolds = m_dispatcher->getInternalManifoldPointer();
+    for (int m = 0; m < liveCount; ++m) {
+        manifolds[m] = ordered[m];
+        ordered[m]->m_index1a = m;
+    }
+}
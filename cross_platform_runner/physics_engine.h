@@ -16,6 +16,21 @@
 // 場景格式
 #include "../scene_format/physics_scene_format.h"
 
+// 影格快照
+#include "frame_snapshot.h"
+
+// 模擬檢查點
+#include "simulation_checkpoint.h"
+
+// 力場批次計算
+#include "force_field_batch.h"
+
+// 工作執行緒池
+#include "worker_pool.h"
+
+// 平行寬相位查詢
+#include "broadphase_query.h"
+
 /**
  * @file physics_engine.h
  * @brief 跨平台物理引擎類別
@@ -24,6 +39,8 @@
  * 支援混合模式，可以根據場景需求自動選擇最適合的物理演算法。
  */
 
+class Renderer;
+
 class PhysicsEngine {
 public:
     PhysicsEngine();
@@ -35,12 +52,19 @@ public:
     bool InitializeScene(const PhysicsScene::PhysicsScene& scene);
     void ResetScene();
 
+    // 檢查點：儲存與還原完整動態狀態，不重建世界
+    bool SaveCheckpoint(SimulationCheckpoint& checkpoint) const;
+    bool RestoreCheckpoint(const SimulationCheckpoint& checkpoint);
+
     // 模擬控制
     void StepSimulation(float deltaTime);
     void SetTimeStep(float timeStep);
     void SetGravity(const PhysicsScene::Vector3& gravity);
     void SetSolverIterations(int iterations);
 
+    // 碰撞過濾：套用場景的碰撞層矩陣與寬相位剔除規則，並重建現有剛體的寬相位代理
+    void SetCollisionFiltering(const PhysicsScene::SimulationSettings& settings);
+
     // OGC 設定
     void EnableOGCContact(bool enable);
     void SetOGCContactRadius(float radius);
@@ -51,6 +75,9 @@ public:
     // 物件管理
     void AddRigidBody(const std::string& name, const PhysicsScene::RigidBody& rigidBody);
     void RemoveRigidBody(const std::string& name);
+    // 批次增減：整批只重建一次名稱表與剛體對索引，供串流等一次處理大量剛體的呼叫者使用
+    void AddRigidBodies(const PhysicsScene::RigidBody* rigidBodies, size_t count);
+    void RemoveRigidBodies(const std::vector<std::string>& names);
     void UpdateRigidBody(const std::string& name, const PhysicsScene::RigidBody& rigidBody);
     
     void AddConstraint(const std::string& name, const PhysicsScene::Constraint& constraint);
@@ -75,6 +102,44 @@ public:
     };
     RaycastResult Raycast(const PhysicsScene::Vector3& from, const PhysicsScene::Vector3& to) const;
 
+    // 批次查詢：陣列中的查詢分給工作執行緒，對唯讀的寬相位平行執行，
+    // 不可與 StepSimulation 同時呼叫。bodyIndex 與快照中的 bodies[] 一致
+    static constexpr uint32_t INVALID_BODY_INDEX = 0xFFFFFFFFu;
+
+    struct RayQuery {
+        PhysicsScene::Vector3 from;
+        PhysicsScene::Vector3 to;
+        int collisionMask = -1;
+    };
+    struct SweepQuery {
+        PhysicsScene::Vector3 from;
+        PhysicsScene::Vector3 to;
+        float radius = 0.0f;
+        int collisionMask = -1;
+    };
+    struct OverlapQuery {
+        PhysicsScene::Vector3 aabbMin;
+        PhysicsScene::Vector3 aabbMax;
+        int collisionMask = -1;
+    };
+    struct QueryHit {
+        bool hit = false;
+        uint32_t bodyIndex = INVALID_BODY_INDEX;  // 非剛體（如觸發器幽靈物件）為 INVALID_BODY_INDEX
+        PhysicsScene::Vector3 point;
+        PhysicsScene::Vector3 normal;
+        float fraction = 1.0f;                    // 沿 from -> to 的比例
+    };
+    // 第 i 個查詢的結果為 bodyIndices[offsets[i], offsets[i + 1])
+    struct OverlapResults {
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> bodyIndices;
+    };
+
+    // usePackets 為 true 時每四條射線以 SIMD 一起遍歷，適合同一原點的密集射線
+    void RaycastBatch(const std::vector<RayQuery>& rays, std::vector<QueryHit>& hits, bool usePackets = true) const;
+    void SphereSweepBatch(const std::vector<SweepQuery>& sweeps, std::vector<QueryHit>& hits) const;
+    void OverlapBatch(const std::vector<OverlapQuery>& boxes, OverlapResults& results) const;
+
     // 碰撞檢測
     std::vector<std::string> GetCollidingObjects(const std::string& objectName) const;
     bool IsColliding(const std::string& objectA, const std::string& objectB) const;
@@ -86,13 +151,20 @@ public:
         int contactPointCount = 0;
         int activeBodyCount = 0;
         float simulationTime = 0.0f;
-        float ogcSolveTime = 0.0f;
-        float bulletSolveTime = 0.0f;
-        int ogcIterations = 0;
+        float ogcSolveTime = 0.0f;      // 本影格所有子步的 OGC 求解時間
+        float bulletSolveTime = 0.0f;   // stepSimulation 扣除 OGC 求解的時間
+        int ogcIterations = 0;          // 本影格所有子步的迭代次數總和
         int bulletIterations = 0;
+        int ogcContactCount = 0;       // 本步驟由 OGC 求解的接觸點數
+        int bulletContactCount = 0;    // 本步驟由 Bullet 求解的接觸點數
+        int hybridSwitchCount = 0;     // 本步驟改變路徑的剛體對數
+        int filterRejectionCount = 0;  // 寬相位過濾器拒絕的次數（累計，不是不重複的剛體對數）
     };
     const Statistics& GetStatistics() const { return m_statistics; }
 
+    // 影格快照（供渲染器、錄製器、UI 面板無鎖讀取）
+    const SnapshotRing& GetSnapshotRing() const { return m_snapshotRing; }
+
     // 除錯功能
     void SetDebugDrawer(btIDebugDraw* debugDrawer);
     void DebugDrawWorld();
@@ -112,15 +184,40 @@ private:
     float m_ogcContactRadius;
     bool m_hybridMode;
 
+    // 平行工作（OGC 批次求解、批次查詢）共用的執行緒池，於 Initialize 建立
+    std::unique_ptr<WorkerPool> m_workerPool;
+
+    // OGC 接觸的扁平緩衝區，每一步重新收集
+    std::vector<OGCContactSolver::BodyState> m_ogcBodies;
+    std::vector<btRigidBody*> m_ogcSlotBodies;        // m_ogcBodies 索引 -> 剛體
+    std::vector<int32_t> m_ogcBodySlots;              // 密集剛體索引 -> m_ogcBodies 索引，-1 表示未收集
+    std::vector<OGCContactSolver::ContactPoint> m_ogcContacts;
+    std::vector<btManifoldPoint*> m_ogcManifoldPoints;
+    std::vector<OGCContactSolver::ContactImpulse> m_ogcImpulses;
+
+    // 混合模式：每個剛體對的路徑決策，跨影格保留以避免來回切換
+    struct HybridPairState {
+        bool useOGC = false;
+        int pendingFrames = 0;       // 連續偏好另一路徑的影格數
+        uint32_t lastSeenFrame = 0;
+    };
+    std::unordered_map<uint64_t, HybridPairState> m_hybridPairs;
+    uint32_t m_hybridFrame = 0;
+
     // 物件管理
     struct RigidBodyData {
         std::unique_ptr<btRigidBody> bulletBody;
         std::unique_ptr<btCollisionShape> shape;
         std::unique_ptr<btMotionState> motionState;
         PhysicsScene::RigidBody sceneData;
+        uint32_t bodyIndex = 0;  // 在 m_bodyList 中的密集索引，同時存於 btCollisionObject::m_userIndex
     };
     std::unordered_map<std::string, std::unique_ptr<RigidBodyData>> m_rigidBodies;
 
+    // 密集剛體表：索引與快照中的 bodies[] 一致；新增時附加在尾端，移除時壓縮並保持其餘剛體的相對順序
+    std::vector<RigidBodyData*> m_bodyList;
+    std::shared_ptr<const std::vector<std::string>> m_bodyNames;
+
     struct ConstraintData {
         std::unique_ptr<btTypedConstraint> bulletConstraint;
         PhysicsScene::Constraint sceneData;
@@ -129,10 +226,18 @@ private:
 
     struct ForceFieldData {
         PhysicsScene::ForceField sceneData;
-        std::vector<std::string> affectedBodies;
     };
     std::unordered_map<std::string, std::unique_ptr<ForceFieldData>> m_forceFields;
 
+    // 力場批次計算的 SoA 緩衝區，每一步重新收集
+    ForceFieldBatch m_forceFieldBatch;
+    std::vector<uint32_t> m_forceFieldOverlaps;
+
+    // 碰撞過濾
+    class CollisionPairFilter;
+    PhysicsScene::CollisionLayerMatrix m_collisionLayers;
+    std::unique_ptr<CollisionPairFilter> m_overlapFilter;
+
     // 材質管理
     std::unordered_map<std::string, PhysicsScene::PhysicsMaterial> m_physicsMaterials;
 
@@ -140,11 +245,20 @@ private:
     float m_timeStep;
     PhysicsScene::Vector3 m_gravity;
     int m_solverIterations;
-    float m_simulationTime;
+    double m_simulationTime;
+    static constexpr int MAX_SUB_STEPS = 10;
+
+    // 批次查詢每個工作區塊的查詢數；射線區塊為 PACKET_SIZE 的倍數
+    static constexpr size_t RAY_QUERY_GRAIN = 256;
+    static constexpr size_t SWEEP_QUERY_GRAIN = 64;
+    static constexpr size_t OVERLAP_QUERY_GRAIN = 64;
 
     // 統計資訊
     mutable Statistics m_statistics;
 
+    // 影格快照
+    SnapshotRing m_snapshotRing;
+
     // 除錯繪製
     btIDebugDraw* m_debugDrawer;
     bool m_debugDrawEnabled;
@@ -153,6 +267,7 @@ private:
     void InitializeBulletPhysics();
     void InitializeOGCIntegration();
     void SetupCollisionFiltering();
+    int GetBodyCollisionMask(const PhysicsScene::RigidBody& rigidBody) const;
 
     // 物件建立輔助函數
     btCollisionShape* CreateCollisionShape(const PhysicsScene::RigidBody& rigidBody);
@@ -177,20 +292,28 @@ private:
     btTypedConstraint* CreateGeneric6DofConstraint(const PhysicsScene::Constraint& constraint);
 
     // 力場處理
-    void UpdateForceFields(float deltaTime);
-    void ApplyForceField(const ForceFieldData& forceField, float deltaTime);
+    void UpdateForceFields();
+    void QueryForceFieldOverlaps(const PhysicsScene::ForceField& forceField, std::vector<uint32_t>& bodyIndices) const;
     PhysicsScene::Vector3 CalculateForceFieldForce(const PhysicsScene::ForceField& forceField,
                                                     const PhysicsScene::Vector3& position) const;
 
     // OGC 整合函數
     void UpdateOGCContacts();
-    void SolveOGCContacts(float deltaTime);
-    std::vector<OGCContactSolver::ContactPoint> ExtractContactPoints() const;
+    // 每個固定子步結束時由 Bullet 呼叫；衝量在下一個子步積分
+    static void InternalTickCallback(btDynamicsWorld* world, btScalar timeStep);
+    void SolveOGCContacts(float timeStep);
+    void ExtractContactPoints();
+    int32_t GetOGCBodySlot(const btCollisionObject* object);
     void ApplyOGCImpulses(const std::vector<OGCContactSolver::ContactImpulse>& impulses);
 
     // 混合模式處理
     void UpdateHybridMode(float deltaTime);
     bool ShouldUseOGCForContact(const btPersistentManifold* manifold) const;
+    int EvaluateHybridCost(const btPersistentManifold* manifold, float timeStep, bool& tunneling) const;
+
+    // 批次查詢輔助函數
+    void RunQueryBatch(size_t count, size_t grainSize, const WorkerPool::RangeFunction& function) const;
+    void FillQueryHit(const BroadphaseQuery::Hit& source, QueryHit& hit) const;
 
     // 輔助函數
     btVector3 ToBulletVector3(const PhysicsScene::Vector3& v) const;
@@ -204,47 +327,88 @@ private:
     void UpdateStatistics();
     void ResetStatistics();
 
+    // 快照發佈
+    RigidBodyData* InsertRigidBody(const std::string& name, const PhysicsScene::RigidBody& rigidBody);
+    void RegisterBody(RigidBodyData* data);
+    void RebuildBodyNameTable();
+    void PublishSnapshot();
+
+    // 檢查點輔助函數
+    std::vector<RigidBodyData*> ResolveCheckpointBodies(const SimulationCheckpoint& checkpoint) const;
+    void SaveContactManifolds(CheckpointWriter& writer) const;
+    // 解碼後的接觸流形；bodyA/bodyB 為儲存時的剛體索引
+    struct CheckpointManifold {
+        uint32_t bodyA = 0;
+        uint32_t bodyB = 0;
+        std::vector<btManifoldPoint> points;
+    };
+    static bool ReadContactManifolds(CheckpointReader& reader, std::vector<CheckpointManifold>& manifolds);
+    void RestoreContactManifolds(const std::vector<CheckpointManifold>& manifolds, const std::vector<RigidBodyData*>& bodies);
+
     // 錯誤處理
     void HandlePhysicsError(const std::string& message);
 
 public:
+    // 碰撞事件中的剛體對；索引與快照中的 bodies[] 一致，bodyA < bodyB
+    struct CollisionPair {
+        uint32_t bodyA;
+        uint32_t bodyB;
+    };
+
+    // 一個模擬步驟的所有碰撞事件，一次交給回調
+    struct CollisionEvents {
+        std::vector<CollisionPair> entered;
+        std::vector<CollisionPair> stayed;
+        std::vector<CollisionPair> exited;
+        std::shared_ptr<const std::vector<std::string>> bodyNames;
+
+        const std::string& GetName(uint32_t bodyIndex) const { return (*bodyNames)[bodyIndex]; }
+        bool IsEmpty() const { return entered.empty() && stayed.empty() && exited.empty(); }
+        void Clear() { entered.clear(); stayed.clear(); exited.clear(); }
+    };
+
     // 回調介面
     class CollisionCallback {
     public:
         virtual ~CollisionCallback() = default;
-        virtual void OnCollisionEnter(const std::string& objectA, const std::string& objectB) = 0;
-        virtual void OnCollisionExit(const std::string& objectA, const std::string& objectB) = 0;
-        virtual void OnCollisionStay(const std::string& objectA, const std::string& objectB) = 0;
+
+        // 每步驟呼叫一次；預設逐對轉呼叫下列函數，事件量大時覆寫此函數直接處理索引
+        virtual void OnCollisionEvents(const CollisionEvents& events);
+
+        virtual void OnCollisionEnter(const std::string& objectA, const std::string& objectB) {}
+        virtual void OnCollisionExit(const std::string& objectA, const std::string& objectB) {}
+        virtual void OnCollisionStay(const std::string& objectA, const std::string& objectB) {}
     };
 
     void SetCollisionCallback(CollisionCallback* callback);
 
 private:
     CollisionCallback* m_collisionCallback;
-    std::unordered_map<std::pair<std::string, std::string>, bool, 
-                       std::hash<std::string>> m_previousCollisions;
 
-    void ProcessCollisionCallbacks();
+    // 有接觸點的剛體對，鍵值為 (較大索引 << 32) | 較小索引，已排序；
+    // 與上一步的陣列做合併比較即得到進入、持續與離開事件
+    std::vector<uint64_t> m_contactPairs;
+    std::vector<uint64_t> m_previousContactPairs;
+    CollisionEvents m_collisionEvents;
 
-    // 自訂哈希函數
-    struct PairHash {
-        std::size_t operator()(const std::pair<std::string, std::string>& p) const {
-            return std::hash<std::string>{}(p.first) ^ (std::hash<std::string>{}(p.second) << 1);
-        }
-    };
+    void ProcessCollisionCallbacks();
+    void RemapBodyIndices(const std::vector<uint32_t>& newIndices);
 };
 
 /**
  * @class PhysicsDebugDrawer
  * @brief Bullet Physics 除錯繪製器
  * 
- * 實現 btIDebugDraw 介面，用於在 OpenGL 中繪製物理除錯資訊。
+ * 實現 btIDebugDraw 介面，把線段與接觸點轉交 Renderer::DrawLine/DrawPoint，
+ * 在渲染器的除錯 pass 中與其他除錯圖元一起批次繪製。
  */
 class PhysicsDebugDrawer : public btIDebugDraw {
 public:
-    PhysicsDebugDrawer();
+    explicit PhysicsDebugDrawer(Renderer* renderer = nullptr);
     virtual ~PhysicsDebugDrawer();
 
+    void SetRenderer(Renderer* renderer) { m_renderer = renderer; }
+
     // btIDebugDraw 介面實現
     virtual void drawLine(const btVector3& from, const btVector3& to, const btVector3& color) override;
     virtual void drawContactPoint(const btVector3& PointOnB, const btVector3& normalOnB, 
@@ -260,11 +424,9 @@ public:
     void EnableDepthTest(bool enable) { m_depthTestEnabled = enable; }
 
 private:
+    Renderer* m_renderer;
     int m_debugMode;
     float m_lineWidth;
     float m_pointSize;
     bool m_depthTestEnabled;
-
-    void SetupRenderState();
-    void RestoreRenderState();
 };
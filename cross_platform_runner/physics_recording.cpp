@@ -0,0 +1,751 @@
+/**
+ * @file physics_recording.cpp
+ * @brief 物理模擬錄製與回放快取實現
+ */
+
+#include "physics_recording.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace PhysicsRecording;
+
+namespace {
+
+constexpr size_t TRAILER_SIZE = 32;  // indexOffset + frameCount + duration + magic
+constexpr float ROTATION_SCALE = 32767.0f;
+
+// 編碼輔助函數（一律使用 little-endian）
+void WriteVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void WriteZigZag(std::vector<uint8_t>& out, int64_t value) {
+    WriteVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void WriteU64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void WriteF64(std::vector<uint8_t>& out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    WriteU64(out, bits);
+}
+
+void WriteF32(std::vector<uint8_t>& out, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+    }
+}
+
+// 解碼輔助函數；越界時回傳 false
+bool ReadVarint(const std::vector<uint8_t>& in, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+        uint8_t byte = in[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ReadZigZag(const std::vector<uint8_t>& in, size_t& pos, int64_t& value) {
+    uint64_t raw;
+    if (!ReadVarint(in, pos, raw)) return false;
+    value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+    return true;
+}
+
+bool ReadU64(const std::vector<uint8_t>& in, size_t& pos, uint64_t& value) {
+    if (pos + 8 > in.size()) return false;
+    value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(in[pos++]) << (8 * i);
+    }
+    return true;
+}
+
+bool ReadF64(const std::vector<uint8_t>& in, size_t& pos, double& value) {
+    uint64_t bits;
+    if (!ReadU64(in, pos, bits)) return false;
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+bool ReadF32(const std::vector<uint8_t>& in, size_t& pos, float& value) {
+    if (pos + 4 > in.size()) return false;
+    uint32_t bits = 0;
+    for (int i = 0; i < 4; ++i) {
+        bits |= static_cast<uint32_t>(in[pos++]) << (8 * i);
+    }
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+void WriteBitMask(std::vector<uint8_t>& out, const std::vector<bool>& bits) {
+    size_t start = out.size();
+    out.resize(start + (bits.size() + 7) / 8, 0);
+    for (size_t i = 0; i < bits.size(); ++i) {
+        if (bits[i]) out[start + i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+    }
+}
+
+bool ReadBit(const std::vector<uint8_t>& in, size_t maskStart, size_t index) {
+    return (in[maskStart + index / 8] >> (index % 8)) & 1u;
+}
+
+} // namespace
+
+// ============================================================================
+// PhysicsRecorder Implementation
+// ============================================================================
+
+PhysicsRecorder::PhysicsRecorder()
+    : m_nameTableOffset(0)
+    , m_frameCount(0)
+    , m_lastSimulationTime(0.0)
+    , m_framesSinceKey(0)
+    , m_lastPolledFrame(0)
+    , m_missedFrames(0)
+    , m_bytesWritten(0)
+{
+}
+
+PhysicsRecorder::~PhysicsRecorder() {
+    Close();
+}
+
+bool PhysicsRecorder::Open(const std::string& filename, const Options& options) {
+    Close();
+
+    if (options.positionPrecision <= 0.0f || options.keyFrameInterval <= 0) {
+        SetError("Invalid recording options");
+        return false;
+    }
+
+    m_file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        SetError("Cannot open recording file: " + filename);
+        return false;
+    }
+
+    m_options = options;
+    m_bodyNames.reset();
+    m_previous.clear();
+    m_keyFrames.clear();
+    m_frameCount = 0;
+    m_lastSimulationTime = 0.0;
+    m_framesSinceKey = 0;
+    m_lastPolledFrame = 0;
+    m_missedFrames = 0;
+    m_bytesWritten = 0;
+
+    // 檔頭
+    m_buffer.clear();
+    m_buffer.insert(m_buffer.end(), FILE_MAGIC, FILE_MAGIC + 8);
+    WriteVarint(m_buffer, FORMAT_VERSION);
+    WriteF32(m_buffer, m_options.positionPrecision);
+    WriteVarint(m_buffer, static_cast<uint64_t>(m_options.keyFrameInterval));
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+    m_bytesWritten += m_buffer.size();
+
+    return m_file.good();
+}
+
+bool PhysicsRecorder::Close() {
+    if (!m_file.is_open()) {
+        return true;
+    }
+
+    // 關鍵影格索引
+    const uint64_t indexOffset = m_bytesWritten;
+    m_buffer.clear();
+    WriteVarint(m_buffer, m_keyFrames.size());
+    for (const auto& entry : m_keyFrames) {
+        WriteVarint(m_buffer, entry.frameNumber);
+        WriteU64(m_buffer, entry.fileOffset);
+        WriteU64(m_buffer, entry.nameTableOffset);
+        WriteF64(m_buffer, entry.simulationTime);
+    }
+
+    // 檔尾
+    WriteU64(m_buffer, indexOffset);
+    WriteU64(m_buffer, m_frameCount);
+    WriteF64(m_buffer, m_lastSimulationTime);
+    m_buffer.insert(m_buffer.end(), INDEX_MAGIC, INDEX_MAGIC + 8);
+
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+    m_bytesWritten += m_buffer.size();
+
+    bool ok = m_file.good();
+    m_file.close();
+    if (!ok) {
+        SetError("Failed to finalize recording file");
+    }
+    return ok;
+}
+
+bool PhysicsRecorder::RecordFrame(const FrameSnapshot& snapshot) {
+    if (!m_file.is_open()) {
+        return false;
+    }
+
+    // 第一個影格或剛體集合變更時寫入新名稱表，並強制寫入關鍵影格
+    bool forceKeyFrame = false;
+    if (m_frameCount == 0 || snapshot.bodyNames != m_bodyNames || snapshot.bodies.size() != m_previous.size()) {
+        WriteNameTable(snapshot);
+        forceKeyFrame = true;
+    }
+
+    QuantizeFrame(snapshot);
+
+    if (forceKeyFrame || m_framesSinceKey >= static_cast<uint64_t>(m_options.keyFrameInterval)) {
+        WriteKeyFrame(snapshot);
+    } else {
+        WriteDeltaFrame(snapshot);
+    }
+
+    m_previous.swap(m_current);
+    m_lastSimulationTime = snapshot.simulationTime;
+    ++m_frameCount;
+
+    if (!m_file.good()) {
+        SetError("Failed to write recording frame");
+        return false;
+    }
+    return true;
+}
+
+int PhysicsRecorder::Poll(const SnapshotRing& ring) {
+    const uint64_t latest = ring.GetLatestFrameIndex();
+    if (latest == 0 || latest <= m_lastPolledFrame) {
+        return 0;
+    }
+
+    // 第一次輪詢時從目前最新影格開始錄製
+    uint64_t first = m_lastPolledFrame == 0 ? latest : m_lastPolledFrame + 1;
+    int recorded = 0;
+    for (uint64_t frame = first; frame <= latest; ++frame) {
+        auto handle = ring.Acquire(frame);
+        if (!handle) {
+            ++m_missedFrames;
+            continue;
+        }
+        if (RecordFrame(*handle)) {
+            ++recorded;
+        }
+    }
+
+    m_lastPolledFrame = latest;
+    return recorded;
+}
+
+void PhysicsRecorder::WriteNameTable(const FrameSnapshot& snapshot) {
+    m_nameTableOffset = m_bytesWritten;
+    m_bodyNames = snapshot.bodyNames;
+
+    m_buffer.clear();
+    m_buffer.push_back(static_cast<uint8_t>(RecordType::NameTable));
+    std::vector<uint8_t> payload;
+    WriteVarint(payload, snapshot.bodies.size());
+    for (size_t i = 0; i < snapshot.bodies.size(); ++i) {
+        const std::string& name = snapshot.GetBodyName(i);
+        WriteVarint(payload, name.size());
+        payload.insert(payload.end(), name.begin(), name.end());
+
+        const auto& scale = snapshot.bodies[i].transform.scale;
+        WriteF32(payload, scale.x);
+        WriteF32(payload, scale.y);
+        WriteF32(payload, scale.z);
+    }
+    WriteVarint(m_buffer, payload.size());
+    m_buffer.insert(m_buffer.end(), payload.begin(), payload.end());
+    FlushRecord();
+
+    m_previous.assign(snapshot.bodies.size(), QuantizedBody());
+}
+
+void PhysicsRecorder::QuantizeFrame(const FrameSnapshot& snapshot) {
+    const float invPrecision = 1.0f / m_options.positionPrecision;
+    m_current.resize(snapshot.bodies.size());
+
+    for (size_t i = 0; i < snapshot.bodies.size(); ++i) {
+        const auto& body = snapshot.bodies[i];
+        QuantizedBody& q = m_current[i];
+
+        q.position[0] = static_cast<int32_t>(std::lround(body.transform.position.x * invPrecision));
+        q.position[1] = static_cast<int32_t>(std::lround(body.transform.position.y * invPrecision));
+        q.position[2] = static_cast<int32_t>(std::lround(body.transform.position.z * invPrecision));
+
+        // 四元數 q 與 -q 等價，統一使 w >= 0 讓差分保持連續
+        PhysicsScene::Quaternion r = body.transform.rotation;
+        float length = std::sqrt(r.w * r.w + r.x * r.x + r.y * r.y + r.z * r.z);
+        float sign = r.w < 0.0f ? -1.0f : 1.0f;
+        float scale = length > 0.0f ? sign * ROTATION_SCALE / length : 0.0f;
+        q.rotation[0] = static_cast<int16_t>(std::lround(r.w * scale));
+        q.rotation[1] = static_cast<int16_t>(std::lround(r.x * scale));
+        q.rotation[2] = static_cast<int16_t>(std::lround(r.y * scale));
+        q.rotation[3] = static_cast<int16_t>(std::lround(r.z * scale));
+
+        q.active = body.active;
+    }
+}
+
+void PhysicsRecorder::WriteKeyFrame(const FrameSnapshot& snapshot) {
+    KeyFrameEntry entry;
+    entry.frameNumber = m_frameCount;
+    entry.fileOffset = m_bytesWritten;
+    entry.nameTableOffset = m_nameTableOffset;
+    entry.simulationTime = snapshot.simulationTime;
+    m_keyFrames.push_back(entry);
+
+    std::vector<uint8_t> payload;
+    WriteF64(payload, snapshot.simulationTime);
+
+    std::vector<bool> active(m_current.size());
+    for (size_t i = 0; i < m_current.size(); ++i) active[i] = m_current[i].active;
+    WriteBitMask(payload, active);
+
+    for (const auto& q : m_current) {
+        for (int a = 0; a < 3; ++a) WriteZigZag(payload, q.position[a]);
+        for (int a = 0; a < 4; ++a) WriteZigZag(payload, q.rotation[a]);
+    }
+
+    m_buffer.clear();
+    m_buffer.push_back(static_cast<uint8_t>(RecordType::KeyFrame));
+    WriteVarint(m_buffer, payload.size());
+    m_buffer.insert(m_buffer.end(), payload.begin(), payload.end());
+    FlushRecord();
+
+    m_framesSinceKey = 1;
+}
+
+void PhysicsRecorder::WriteDeltaFrame(const FrameSnapshot& snapshot) {
+    std::vector<uint8_t> payload;
+    WriteF64(payload, snapshot.simulationTime);
+
+    // 活動狀態遮罩與變更遮罩；未移動的剛體不寫入任何差分
+    std::vector<bool> active(m_current.size());
+    std::vector<bool> changed(m_current.size());
+    for (size_t i = 0; i < m_current.size(); ++i) {
+        const QuantizedBody& cur = m_current[i];
+        const QuantizedBody& prev = m_previous[i];
+        active[i] = cur.active;
+        changed[i] = std::memcmp(cur.position, prev.position, sizeof(cur.position)) != 0 ||
+                     std::memcmp(cur.rotation, prev.rotation, sizeof(cur.rotation)) != 0;
+    }
+    WriteBitMask(payload, active);
+    WriteBitMask(payload, changed);
+
+    for (size_t i = 0; i < m_current.size(); ++i) {
+        if (!changed[i]) continue;
+        const QuantizedBody& cur = m_current[i];
+        const QuantizedBody& prev = m_previous[i];
+        for (int a = 0; a < 3; ++a) {
+            WriteZigZag(payload, static_cast<int64_t>(cur.position[a]) - prev.position[a]);
+        }
+        for (int a = 0; a < 4; ++a) {
+            WriteZigZag(payload, static_cast<int64_t>(cur.rotation[a]) - prev.rotation[a]);
+        }
+    }
+
+    m_buffer.clear();
+    m_buffer.push_back(static_cast<uint8_t>(RecordType::DeltaFrame));
+    WriteVarint(m_buffer, payload.size());
+    m_buffer.insert(m_buffer.end(), payload.begin(), payload.end());
+    FlushRecord();
+
+    ++m_framesSinceKey;
+}
+
+void PhysicsRecorder::FlushRecord() {
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+    m_bytesWritten += m_buffer.size();
+}
+
+void PhysicsRecorder::SetError(const std::string& error) {
+    m_lastError = error;
+}
+
+// ============================================================================
+// PhysicsPlayback Implementation
+// ============================================================================
+
+PhysicsPlayback::PhysicsPlayback()
+    : m_positionPrecision(0.0001f)
+    , m_frameCount(0)
+    , m_duration(0.0)
+    , m_readPos(0)
+    , m_nextRecordOffset(0)
+    , m_currentFrame(0)
+    , m_frameValid(false)
+{
+}
+
+PhysicsPlayback::~PhysicsPlayback() {
+    Close();
+}
+
+bool PhysicsPlayback::Open(const std::string& filename) {
+    Close();
+
+    m_file.open(filename, std::ios::binary);
+    if (!m_file.is_open()) {
+        SetError("Cannot open playback file: " + filename);
+        return false;
+    }
+
+    // 檔頭
+    std::vector<uint8_t> header(32);
+    m_file.read(reinterpret_cast<char*>(header.data()), header.size());
+    header.resize(static_cast<size_t>(m_file.gcount()));
+    size_t pos = 8;
+    uint64_t version = 0, keyInterval = 0;
+    if (header.size() < 8 || std::memcmp(header.data(), FILE_MAGIC, 8) != 0 ||
+        !ReadVarint(header, pos, version) || version != FORMAT_VERSION ||
+        !ReadF32(header, pos, m_positionPrecision) || !ReadVarint(header, pos, keyInterval)) {
+        SetError("Not a physics recording file: " + filename);
+        Close();
+        return false;
+    }
+
+    // 檔尾
+    m_file.clear();
+    m_file.seekg(0, std::ios::end);
+    const uint64_t fileSize = static_cast<uint64_t>(m_file.tellg());
+    if (fileSize < pos + TRAILER_SIZE) {
+        SetError("Recording file is truncated (missing index): " + filename);
+        Close();
+        return false;
+    }
+
+    std::vector<uint8_t> trailer(TRAILER_SIZE);
+    m_file.seekg(static_cast<std::streamoff>(fileSize - TRAILER_SIZE));
+    m_file.read(reinterpret_cast<char*>(trailer.data()), TRAILER_SIZE);
+    size_t tpos = 0;
+    uint64_t indexOffset = 0;
+    ReadU64(trailer, tpos, indexOffset);
+    ReadU64(trailer, tpos, m_frameCount);
+    ReadF64(trailer, tpos, m_duration);
+    if (std::memcmp(trailer.data() + tpos, INDEX_MAGIC, 8) != 0 || indexOffset > fileSize - TRAILER_SIZE) {
+        SetError("Recording file is truncated (missing index): " + filename);
+        Close();
+        return false;
+    }
+
+    // 關鍵影格索引
+    std::vector<uint8_t> index(static_cast<size_t>(fileSize - TRAILER_SIZE - indexOffset));
+    m_file.seekg(static_cast<std::streamoff>(indexOffset));
+    m_file.read(reinterpret_cast<char*>(index.data()), index.size());
+    size_t ipos = 0;
+    uint64_t count = 0;
+    if (!ReadVarint(index, ipos, count)) {
+        SetError("Corrupted keyframe index: " + filename);
+        Close();
+        return false;
+    }
+    m_keyFrames.resize(static_cast<size_t>(count));
+    for (auto& entry : m_keyFrames) {
+        if (!ReadVarint(index, ipos, entry.frameNumber) || !ReadU64(index, ipos, entry.fileOffset) ||
+            !ReadU64(index, ipos, entry.nameTableOffset) || !ReadF64(index, ipos, entry.simulationTime)) {
+            SetError("Corrupted keyframe index: " + filename);
+            Close();
+            return false;
+        }
+    }
+
+    if (m_frameCount > 0 && (m_keyFrames.empty() || m_keyFrames.front().frameNumber != 0)) {
+        SetError("Recording has no initial keyframe: " + filename);
+        Close();
+        return false;
+    }
+
+    return m_frameCount == 0 || SeekFrame(0);
+}
+
+void PhysicsPlayback::Close() {
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+    m_keyFrames.clear();
+    m_frameCount = 0;
+    m_duration = 0.0;
+    m_currentFrame = 0;
+    m_frameValid = false;
+    m_frame = FrameSnapshot();
+}
+
+bool PhysicsPlayback::SeekFrame(uint64_t frameNumber) {
+    if (frameNumber >= m_frameCount) {
+        return false;
+    }
+
+    // 目標之前最近的關鍵影格
+    auto it = std::upper_bound(m_keyFrames.begin(), m_keyFrames.end(), frameNumber,
+        [](uint64_t frame, const KeyFrameEntry& entry) { return frame < entry.frameNumber; });
+    const KeyFrameEntry& key = *(it - 1);
+
+    // 向前拖曳且仍在同一段關鍵影格區間內時，直接從目前位置往後解碼
+    bool continueForward = m_frameValid && m_currentFrame <= frameNumber && m_currentFrame >= key.frameNumber;
+    if (!continueForward) {
+        if (!ReadNameTable(key.nameTableOffset)) {
+            return false;
+        }
+        m_nextRecordOffset = key.fileOffset;
+
+        RecordType type;
+        if (!ReadRecord(type) || type != RecordType::KeyFrame || !DecodeFrame(type)) {
+            SetError("Corrupted keyframe at frame " + std::to_string(key.frameNumber));
+            m_frameValid = false;
+            return false;
+        }
+        m_currentFrame = key.frameNumber;
+        m_frameValid = true;
+    }
+
+    while (m_currentFrame < frameNumber) {
+        if (!AdvanceFrame()) {
+            return false;
+        }
+    }
+
+    DequantizeFrame();
+    return true;
+}
+
+bool PhysicsPlayback::SeekTime(double simulationTime) {
+    if (m_keyFrames.empty()) {
+        return false;
+    }
+
+    auto it = std::upper_bound(m_keyFrames.begin(), m_keyFrames.end(), simulationTime,
+        [](double time, const KeyFrameEntry& entry) { return time < entry.simulationTime; });
+    if (it != m_keyFrames.begin()) --it;
+
+    // 連續播放時目前影格通常已在目標之前，直接往後解碼即可
+    bool continueForward = m_frameValid && m_frame.simulationTime <= simulationTime &&
+                           m_currentFrame >= it->frameNumber;
+    if (!continueForward && !SeekFrame(it->frameNumber)) {
+        return false;
+    }
+
+    // 往後解碼到第一個不早於目標時間的影格；DecodeFrame 已更新 simulationTime
+    bool advanced = false;
+    while (m_frame.simulationTime < simulationTime && m_currentFrame + 1 < m_frameCount) {
+        if (!AdvanceFrame()) {
+            return false;
+        }
+        advanced = true;
+    }
+    if (advanced) {
+        DequantizeFrame();
+    }
+    return true;
+}
+
+bool PhysicsPlayback::NextFrame() {
+    if (!AdvanceFrame()) {
+        return false;
+    }
+    DequantizeFrame();
+    return true;
+}
+
+bool PhysicsPlayback::AdvanceFrame() {
+    if (!m_frameValid || m_currentFrame + 1 >= m_frameCount) {
+        return false;
+    }
+
+    for (;;) {
+        RecordType type;
+        if (!ReadRecord(type)) {
+            m_frameValid = false;
+            return false;
+        }
+
+        // 剛體集合在錄製途中變更，名稱表緊接在下一個關鍵影格之前
+        if (type == RecordType::NameTable) {
+            if (!ParseNameTable()) {
+                m_frameValid = false;
+                return false;
+            }
+            continue;
+        }
+
+        if (!DecodeFrame(type)) {
+            SetError("Corrupted frame after frame " + std::to_string(m_currentFrame));
+            m_frameValid = false;
+            return false;
+        }
+        ++m_currentFrame;
+        return true;
+    }
+}
+
+bool PhysicsPlayback::ReadRecord(RecordType& type) {
+    m_file.clear();
+    m_file.seekg(static_cast<std::streamoff>(m_nextRecordOffset));
+
+    int typeByte = m_file.get();
+    if (typeByte == EOF) {
+        SetError("Unexpected end of recording");
+        return false;
+    }
+
+    uint64_t length = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = m_file.get();
+        if (byte == EOF) {
+            SetError("Unexpected end of recording");
+            return false;
+        }
+        length |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) break;
+    }
+
+    m_record.resize(static_cast<size_t>(length));
+    m_file.read(reinterpret_cast<char*>(m_record.data()), m_record.size());
+    if (static_cast<uint64_t>(m_file.gcount()) != length) {
+        SetError("Unexpected end of recording");
+        return false;
+    }
+
+    m_readPos = 0;
+    m_nextRecordOffset = static_cast<uint64_t>(m_file.tellg());
+    type = static_cast<RecordType>(typeByte);
+    return true;
+}
+
+bool PhysicsPlayback::ReadNameTable(uint64_t offset) {
+    m_nextRecordOffset = offset;
+    RecordType type;
+    if (!ReadRecord(type) || type != RecordType::NameTable) {
+        SetError("Missing body name table");
+        return false;
+    }
+    return ParseNameTable();
+}
+
+bool PhysicsPlayback::ParseNameTable() {
+    uint64_t count = 0;
+    if (!ReadVarint(m_record, m_readPos, count)) {
+        SetError("Corrupted body name table");
+        return false;
+    }
+
+    auto names = std::make_shared<std::vector<std::string>>();
+    names->reserve(static_cast<size_t>(count));
+    m_scales.resize(static_cast<size_t>(count));
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t length = 0;
+        if (!ReadVarint(m_record, m_readPos, length) || m_readPos + length > m_record.size()) {
+            SetError("Corrupted body name table");
+            return false;
+        }
+        names->emplace_back(reinterpret_cast<const char*>(m_record.data() + m_readPos), static_cast<size_t>(length));
+        m_readPos += static_cast<size_t>(length);
+
+        PhysicsScene::Vector3& scale = m_scales[static_cast<size_t>(i)];
+        if (!ReadF32(m_record, m_readPos, scale.x) || !ReadF32(m_record, m_readPos, scale.y) ||
+            !ReadF32(m_record, m_readPos, scale.z)) {
+            SetError("Corrupted body name table");
+            return false;
+        }
+    }
+
+    m_frame.bodyNames = std::move(names);
+    m_quantized.assign(static_cast<size_t>(count), QuantizedBody());
+    return true;
+}
+
+bool PhysicsPlayback::DecodeFrame(RecordType type) {
+    if (type != RecordType::KeyFrame && type != RecordType::DeltaFrame) {
+        return false;
+    }
+
+    const size_t bodyCount = m_quantized.size();
+    const size_t maskBytes = (bodyCount + 7) / 8;
+
+    if (!ReadF64(m_record, m_readPos, m_frame.simulationTime)) return false;
+
+    const size_t activeMask = m_readPos;
+    m_readPos += maskBytes;
+    size_t changedMask = 0;
+    if (type == RecordType::DeltaFrame) {
+        changedMask = m_readPos;
+        m_readPos += maskBytes;
+    }
+    if (m_readPos > m_record.size()) return false;
+
+    for (size_t i = 0; i < bodyCount; ++i) {
+        QuantizedBody& q = m_quantized[i];
+        q.active = ReadBit(m_record, activeMask, i);
+
+        if (type == RecordType::DeltaFrame && !ReadBit(m_record, changedMask, i)) {
+            continue;
+        }
+
+        // 關鍵影格為絕對值，差分影格為相對前一影格的增量
+        const bool isDelta = type == RecordType::DeltaFrame;
+        for (int a = 0; a < 3; ++a) {
+            int64_t value;
+            if (!ReadZigZag(m_record, m_readPos, value)) return false;
+            q.position[a] = static_cast<int32_t>(isDelta ? q.position[a] + value : value);
+        }
+        for (int a = 0; a < 4; ++a) {
+            int64_t value;
+            if (!ReadZigZag(m_record, m_readPos, value)) return false;
+            q.rotation[a] = static_cast<int16_t>(isDelta ? q.rotation[a] + value : value);
+        }
+    }
+    return true;
+}
+
+void PhysicsPlayback::DequantizeFrame() {
+    const size_t bodyCount = m_quantized.size();
+    m_frame.frameIndex = m_currentFrame + 1;
+    m_frame.bodies.resize(bodyCount);
+    m_frame.contacts.clear();
+
+    for (size_t i = 0; i < bodyCount; ++i) {
+        const QuantizedBody& q = m_quantized[i];
+        FrameSnapshot::BodyState& body = m_frame.bodies[i];
+
+        body.transform.position = PhysicsScene::Vector3(q.position[0] * m_positionPrecision,
+                                                        q.position[1] * m_positionPrecision,
+                                                        q.position[2] * m_positionPrecision);
+
+        float w = q.rotation[0] / ROTATION_SCALE;
+        float x = q.rotation[1] / ROTATION_SCALE;
+        float y = q.rotation[2] / ROTATION_SCALE;
+        float z = q.rotation[3] / ROTATION_SCALE;
+        float length = std::sqrt(w * w + x * x + y * y + z * z);
+        if (length > 0.0f) {
+            body.transform.rotation = PhysicsScene::Quaternion(w / length, x / length, y / length, z / length);
+        } else {
+            body.transform.rotation = PhysicsScene::Quaternion();
+        }
+
+        body.transform.scale = m_scales[i];
+        body.linearVelocity = PhysicsScene::Vector3();
+        body.angularVelocity = PhysicsScene::Vector3();
+        body.active = q.active;
+    }
+}
+
+void PhysicsPlayback::SetError(const std::string& error) {
+    m_lastError = error;
+}
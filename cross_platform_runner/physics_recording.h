@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 影格快照
+#include "frame_snapshot.h"
+
+/**
+ * @file physics_recording.h
+ * @brief 物理模擬錄製與可拖曳時間軸的回放快取
+ *
+ * PhysicsRecorder 將每一步的剛體變換量化後寫入磁碟：位置以固定精度
+ * 轉為整數、旋轉以 16 位元分量儲存，並對前一影格做差分編碼
+ * （zigzag + varint），未移動的剛體只占一個位元。每隔固定影格數寫入
+ * 一個關鍵影格，檔尾附上關鍵影格索引。
+ *
+ * PhysicsPlayback 讀取索引後，拖曳時間軸只需跳到最近的關鍵影格，
+ * 再往後解碼少量差分影格，不必重新模擬。
+ *
+ * 檔案結構：
+ *   [標頭] [名稱表 | 關鍵影格 | 差分影格 ...] [關鍵影格索引] [檔尾]
+ */
+
+namespace PhysicsRecording {
+
+// 檔案格式常數
+constexpr char FILE_MAGIC[8] = {'P', 'R', 'E', 'C', 'A', 'C', 'H', 'E'};
+constexpr char INDEX_MAGIC[8] = {'P', 'R', 'E', 'C', 'I', 'D', 'X', '\0'};
+constexpr uint32_t FORMAT_VERSION = 1;
+
+// 紀錄類型
+enum class RecordType : uint8_t {
+    NameTable = 'N',
+    KeyFrame = 'K',
+    DeltaFrame = 'D'
+};
+
+// 量化後的單一剛體狀態
+struct QuantizedBody {
+    int32_t position[3] = {0, 0, 0};
+    int16_t rotation[4] = {32767, 0, 0, 0};  // w, x, y, z
+    bool active = false;
+};
+
+// 關鍵影格索引項目
+struct KeyFrameEntry {
+    uint64_t frameNumber = 0;       // 從 0 開始
+    uint64_t fileOffset = 0;        // 關鍵影格紀錄的位置
+    uint64_t nameTableOffset = 0;   // 此影格使用的名稱表紀錄位置
+    double simulationTime = 0.0;
+};
+
+} // namespace PhysicsRecording
+
+/**
+ * @class PhysicsRecorder
+ * @brief 將影格快照錄製成壓縮的回放快取檔案
+ */
+class PhysicsRecorder {
+public:
+    struct Options {
+        float positionPrecision = 0.0001f;  // 位置量化步長（公尺）
+        int keyFrameInterval = 60;          // 關鍵影格間隔（影格數）
+    };
+
+    PhysicsRecorder();
+    ~PhysicsRecorder();
+
+    bool Open(const std::string& filename, const Options& options);
+    bool Open(const std::string& filename) { return Open(filename, Options()); }
+    bool Close();
+    bool IsRecording() const { return m_file.is_open(); }
+
+    // 直接錄製一個影格
+    bool RecordFrame(const FrameSnapshot& snapshot);
+
+    // 從快照環形緩衝區讀取上次之後的所有新影格；被覆寫而錯過的影格計入 GetMissedFrameCount()
+    int Poll(const SnapshotRing& ring);
+
+    uint64_t GetRecordedFrameCount() const { return m_frameCount; }
+    uint64_t GetMissedFrameCount() const { return m_missedFrames; }
+    uint64_t GetBytesWritten() const { return m_bytesWritten; }
+    const std::string& GetLastError() const { return m_lastError; }
+
+private:
+    void WriteNameTable(const FrameSnapshot& snapshot);
+    void WriteKeyFrame(const FrameSnapshot& snapshot);
+    void WriteDeltaFrame(const FrameSnapshot& snapshot);
+    void QuantizeFrame(const FrameSnapshot& snapshot);
+    void FlushRecord();
+    void SetError(const std::string& error);
+
+    std::ofstream m_file;
+    Options m_options;
+    std::string m_lastError;
+
+    std::vector<uint8_t> m_buffer;
+    std::vector<PhysicsRecording::QuantizedBody> m_current;
+    std::vector<PhysicsRecording::QuantizedBody> m_previous;
+    std::vector<PhysicsRecording::KeyFrameEntry> m_keyFrames;
+
+    std::shared_ptr<const std::vector<std::string>> m_bodyNames;
+    uint64_t m_nameTableOffset;
+    uint64_t m_frameCount;
+    double m_lastSimulationTime;
+    uint64_t m_framesSinceKey;
+    uint64_t m_lastPolledFrame;
+    uint64_t m_missedFrames;
+    uint64_t m_bytesWritten;
+};
+
+/**
+ * @class PhysicsPlayback
+ * @brief 讀取回放快取並支援依影格或時間拖曳
+ */
+class PhysicsPlayback {
+public:
+    PhysicsPlayback();
+    ~PhysicsPlayback();
+
+    bool Open(const std::string& filename);
+    void Close();
+    bool IsOpen() const { return m_file.is_open(); }
+
+    // 時間軸
+    uint64_t GetFrameCount() const { return m_frameCount; }
+    double GetDuration() const { return m_duration; }
+    uint64_t GetCurrentFrameNumber() const { return m_currentFrame; }
+
+    bool SeekFrame(uint64_t frameNumber);
+    bool SeekTime(double simulationTime);
+    bool NextFrame();
+
+    // 目前影格；bodies 與 bodyNames 的對應方式與即時快照相同
+    const FrameSnapshot& GetCurrentFrame() const { return m_frame; }
+    const std::string& GetLastError() const { return m_lastError; }
+
+private:
+    bool ReadRecord(PhysicsRecording::RecordType& type);
+    bool ReadNameTable(uint64_t offset);
+    bool ParseNameTable();
+    bool DecodeFrame(PhysicsRecording::RecordType type);
+    // 只累加量化的增量；回傳給呼叫者的影格才需要 DequantizeFrame
+    bool AdvanceFrame();
+    void DequantizeFrame();
+    void SetError(const std::string& error);
+
+    std::ifstream m_file;
+    std::string m_lastError;
+
+    float m_positionPrecision;
+    uint64_t m_frameCount;
+    double m_duration;
+    std::vector<PhysicsRecording::KeyFrameEntry> m_keyFrames;
+
+    // 解碼狀態
+    std::vector<uint8_t> m_record;
+    size_t m_readPos;
+    uint64_t m_nextRecordOffset;
+    uint64_t m_currentFrame;
+    bool m_frameValid;
+    std::vector<PhysicsRecording::QuantizedBody> m_quantized;
+    std::vector<PhysicsScene::Vector3> m_scales;
+    FrameSnapshot m_frame;
+};
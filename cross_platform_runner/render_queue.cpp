@@ -0,0 +1,56 @@
+/**
+ * @file render_queue.cpp
+ * @brief 依狀態排序的繪製佇列實現
+ */
+
+#include "render_queue.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr uint32_t DEPTH_BITS = 24;
+constexpr uint32_t DEPTH_MAX = (1u << DEPTH_BITS) - 1;
+
+uint32_t QuantizeDepth(float depth) {
+    // NaN 視為最遠
+    if (!(depth >= 0.0f)) return depth < 0.0f ? 0u : DEPTH_MAX;
+    if (depth >= 1.0f) return DEPTH_MAX;
+    return static_cast<uint32_t>(depth * static_cast<float>(DEPTH_MAX));
+}
+
+} // namespace
+
+uint64_t RenderQueue::MakeKey(Pass pass, uint32_t shader, uint32_t material, uint32_t texture, float depth) {
+    const uint64_t p = static_cast<uint64_t>(pass) & 0x3u;
+    const uint64_t s = std::min(shader, MAX_SHADER_ID);
+    const uint64_t m = std::min(material, MAX_MATERIAL_ID);
+    const uint64_t t = std::min(texture, MAX_TEXTURE_ID);
+    const uint64_t d = QuantizeDepth(depth);
+
+    if (pass == Pass::Transparent) {
+        return (p << 62) | (static_cast<uint64_t>(DEPTH_MAX - d) << 38) | (s << 32) | (m << 16) | t;
+    }
+    return (p << 62) | (s << 56) | (m << 40) | (t << 24) | d;
+}
+
+void RenderQueue::Add(Pass pass, uint32_t shader, uint32_t material, uint32_t texture, float depth,
+                      uint32_t object) {
+    Item item;
+    item.key = MakeKey(pass, shader, material, texture, depth);
+    item.object = object;
+    item.shader = static_cast<uint16_t>(std::min(shader, MAX_SHADER_ID));
+    item.material = static_cast<uint16_t>(std::min(material, MAX_MATERIAL_ID));
+    item.texture = static_cast<uint16_t>(std::min(texture, MAX_TEXTURE_ID));
+    item.pass = pass;
+    m_items.push_back(item);
+}
+
+/**
+ * @brief 依排序鍵排序；鍵相同時保持加入順序，讓結果在各影格間穩定
+ */
+void RenderQueue::Sort() {
+    std::sort(m_items.begin(), m_items.end(), [](const Item& a, const Item& b) {
+        return a.key != b.key ? a.key < b.key : a.object < b.object;
+    });
+}
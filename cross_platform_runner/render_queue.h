@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file render_queue.h
+ * @brief 依狀態排序的繪製佇列
+ *
+ * 每個影格收集繪製項目，以 64 位元排序鍵排序後依序提交，
+ * 連續項目的著色器、材質、紋理相同時不重複切換狀態。
+ *
+ * 排序鍵（由高位到低位）：
+ *   不透明：pass(2) | shader(6) | material(16) | texture(16) | depth(24，由近到遠)
+ *   半透明：pass(2) | depth(24，由遠到近) | shader(6) | material(16) | texture(16)
+ * 半透明物件必須依深度混合，因此深度優先於狀態。
+ */
+
+class RenderQueue {
+public:
+    enum class Pass : uint8_t {
+        Opaque = 0,
+        Transparent = 1,
+        Overlay = 2
+    };
+
+    static constexpr uint32_t MAX_SHADER_ID = (1u << 6) - 1;
+    static constexpr uint32_t MAX_MATERIAL_ID = (1u << 16) - 1;
+    static constexpr uint32_t MAX_TEXTURE_ID = (1u << 16) - 1;
+
+    struct Item {
+        uint64_t key = 0;
+        uint32_t object = 0;        // 呼叫端的物件索引
+        uint16_t shader = 0;
+        uint16_t material = 0;
+        uint16_t texture = 0;       // 0 表示沒有紋理
+        Pass pass = Pass::Opaque;
+    };
+
+    struct SubmitStatistics {
+        int items = 0;
+        int shaderChanges = 0;
+        int materialChanges = 0;
+        int textureChanges = 0;
+        int skippedStateChanges = 0;    // 與前一個項目相同而省略的狀態設定
+    };
+
+    // depth 為正規化的觀察深度 [0, 1]，超出範圍會被截斷；ID 超過上限時截斷為上限
+    static uint64_t MakeKey(Pass pass, uint32_t shader, uint32_t material, uint32_t texture, float depth);
+
+    void Clear() { m_items.clear(); }
+    void Reserve(size_t count) { m_items.reserve(count); }
+    void Add(Pass pass, uint32_t shader, uint32_t material, uint32_t texture, float depth, uint32_t object);
+    void Sort();
+
+    const std::vector<Item>& GetItems() const { return m_items; }
+    size_t Size() const { return m_items.size(); }
+    bool Empty() const { return m_items.empty(); }
+
+    /**
+     * @brief 依排序後的順序提交
+     *
+     * Visitor 需提供 BindShader(uint16_t)、BindMaterial(uint16_t)、BindTexture(uint16_t)
+     * 與 Draw(const Item&)。第一個項目一律設定所有狀態，之後只在值改變時呼叫；
+     * 切換著色器時材質與紋理也會重新設定，因為它們的 uniform 屬於著色器。
+     */
+    template <typename Visitor>
+    SubmitStatistics Submit(Visitor& visitor) const;
+
+private:
+    std::vector<Item> m_items;
+};
+
+template <typename Visitor>
+RenderQueue::SubmitStatistics RenderQueue::Submit(Visitor& visitor) const {
+    SubmitStatistics statistics;
+    const Item* previous = nullptr;
+
+    for (const Item& item : m_items) {
+        const bool shaderChanged = !previous || previous->shader != item.shader;
+        if (shaderChanged) {
+            visitor.BindShader(item.shader);
+            ++statistics.shaderChanges;
+        } else {
+            ++statistics.skippedStateChanges;
+        }
+
+        if (shaderChanged || previous->material != item.material) {
+            visitor.BindMaterial(item.material);
+            ++statistics.materialChanges;
+        } else {
+            ++statistics.skippedStateChanges;
+        }
+
+        if (shaderChanged || previous->texture != item.texture) {
+            visitor.BindTexture(item.texture);
+            ++statistics.textureChanges;
+        } else {
+            ++statistics.skippedStateChanges;
+        }
+
+        visitor.Draw(item);
+        ++statistics.items;
+        previous = &item;
+    }
+    return statistics;
+}
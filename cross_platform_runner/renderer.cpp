@@ -0,0 +1,1957 @@
+/**
+ * @file renderer.cpp
+ * @brief 跨平台 OpenGL 渲染器實現
+ */
+
+#include "renderer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#include <glm/gtc/type_ptr.hpp>
+
+namespace {
+
+// 繪製佇列中的著色器 ID
+enum QueueShader : uint16_t {
+    QUEUE_SHADER_LIT = 0,
+    QUEUE_SHADER_BASIC = 1,
+    QUEUE_SHADER_WIREFRAME = 2
+};
+
+// 材質不存在時使用的漫反射顏色
+const glm::vec4 DEFAULT_INSTANCE_COLOR(0.8f, 0.8f, 0.8f, 1.0f);
+
+// 與 Shader::Uniform 順序一致
+const char* const UNIFORM_NAMES[] = {
+    "model", "view", "projection", "viewPos", "lightingEnabled", "specularColor", "emissiveColor", "shininess",
+    "lightSpaceMatrix", "shadowMap"
+};
+
+// 串聯陰影貼圖綁定的紋理單元，材質紋理使用較小的單元
+constexpr GLint SHADOW_TEXTURE_UNIT = 7;
+
+// 與 Shader::UniformBlock 順序一致
+const char* const UNIFORM_BLOCK_NAMES[] = {"FrameData", "ObjectData"};
+
+// 著色器中的 uniform block 宣告，與 FrameUniforms / ObjectUniforms 的 std140 配置一致
+const char* const FRAME_DATA_BLOCK = R"(
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 viewPosition;
+    vec4 lightDirection;
+    vec4 lightColor;
+    vec4 ambientColor;
+    mat4 lightSpaceMatrices[4];
+    vec4 cascadeSplits;
+    vec4 cascadeTexelSizes;
+    vec4 shadowParams;
+};
+)";
+
+// 陰影投影物件固定使用的 LOD 層級（不足時取最粗的層級）；與相機無關，靜態深度快取才不會隨相機移動而過期
+constexpr size_t SHADOW_CASTER_LOD = 1;
+
+// 除錯串流緩衝區每段的初始頂點數，不足時倍增
+constexpr size_t DEBUG_STREAM_INITIAL_CAPACITY = 65536;
+
+uint32_t PackDebugColor(const glm::vec3& color) {
+    const auto channel = [](float value) {
+        return static_cast<uint32_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+    };
+    return channel(color.r) | (channel(color.g) << 8) | (channel(color.b) << 16) | (255u << 24);
+}
+
+float GetShapeParameter(const PhysicsScene::GeometryShape& shape, const char* name, float defaultValue) {
+    auto it = shape.parameters.find(name);
+    return it != shape.parameters.end() ? it->second : defaultValue;
+}
+
+// FNV-1a
+void HashBytes(uint64_t& hash, const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+}
+
+void HashShape(uint64_t& hash, const PhysicsScene::GeometryShape& shape) {
+    const size_t header[3] = {static_cast<size_t>(shape.type), shape.parameters.size(), shape.vertices.size()};
+    HashBytes(hash, header, sizeof(header));
+    for (const auto& parameter : shape.parameters) {
+        HashBytes(hash, parameter.first.data(), parameter.first.size());
+        HashBytes(hash, &parameter.second, sizeof(parameter.second));
+    }
+    HashBytes(hash, shape.meshFile.data(), shape.meshFile.size());
+    for (const auto& vertex : shape.vertices) {
+        const float position[3] = {vertex.x, vertex.y, vertex.z};
+        HashBytes(hash, position, sizeof(position));
+    }
+}
+
+// 與物理引擎相同的靜態判定：質量不大於 0 或物理材質為靜態，且不是運動學物件
+bool IsStaticCaster(const PhysicsScene::PhysicsScene& scene, const PhysicsScene::RigidBody& rigidBody) {
+    const PhysicsScene::PhysicsMaterial* material = scene.findPhysicsMaterial(rigidBody.physicsMaterial);
+    const bool kinematic = material && material->isKinematic;
+    const bool isStatic = !kinematic && (rigidBody.mass <= 0.0f || (material && material->isStatic));
+    return isStatic && rigidBody.visible && rigidBody.castShadows;
+}
+
+// 決定包圍盒的形狀資料（含複合子形狀與其局部變換）的雜湊
+uint64_t HashBodyShape(const PhysicsScene::RigidBody& rigidBody) {
+    uint64_t hash = 14695981039346656037ull;
+    HashShape(hash, rigidBody.collisionShape);
+    for (const auto& child : rigidBody.compoundChildren) {
+        HashShape(hash, child.shape);
+        const PhysicsScene::Transform& t = child.localTransform;
+        const float transform[10] = {t.position.x, t.position.y, t.position.z,
+                                     t.rotation.w, t.rotation.x, t.rotation.y, t.rotation.z,
+                                     t.scale.x, t.scale.y, t.scale.z};
+        HashBytes(hash, transform, sizeof(transform));
+    }
+    return hash;
+}
+
+} // namespace
+
+// ============================================================================
+// 影格
+// ============================================================================
+
+/**
+ * @brief 渲染一個影格：場景（陰影與不透明 pass）後接除錯 pass
+ */
+void Renderer::Render(const PhysicsScene::PhysicsScene& scene) {
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    if (m_renderCallback) {
+        m_renderCallback->OnPreRender();
+    }
+
+    RenderScene(scene);
+    RenderDebugElements();
+
+    if (m_renderCallback) {
+        m_renderCallback->OnPostRender();
+    }
+    const auto endTime = std::chrono::high_resolution_clock::now();
+    m_statistics.renderTime = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+}
+
+/**
+ * @brief 除錯 pass：格線、座標軸，以及本影格經 DrawLine/DrawPoint 累積的除錯圖元
+ *
+ * 圖元批次使用 FrameData 的矩陣，RenderScene 已在前面上傳。
+ */
+void Renderer::RenderDebugElements() {
+    GpuProfiler::Scope gpuTiming(m_gpuProfiler, GpuProfiler::Pass::Debug);
+    if (m_showGrid) {
+        RenderGrid();
+    }
+    if (m_showAxes) {
+        RenderAxes();
+    }
+    RenderDebugPrimitives();
+}
+
+// ============================================================================
+// 剛體渲染
+// ============================================================================
+
+/**
+ * @brief 渲染所有剛體
+ *
+ * 先以視錐剔除挑出可見的剛體。
+ * 基本形狀依（網格、材質）分組，每組以一次 glDrawElementsInstanced 繪製；
+ * 自訂網格、複合形狀、半透明、線框模式與帶紋理的材質放進繪製佇列，
+ * 依著色器、材質、紋理、深度排序後提交。
+ */
+void Renderer::RenderRigidBodies(const PhysicsScene::PhysicsScene& scene) {
+    const bool instancing = m_instancingEnabled && m_renderMode != RenderMode::Wireframe &&
+                            (m_instancingInitialized ? m_instancedShader != nullptr : InitializeInstancing());
+
+    for (auto& group : m_instanceGroups) {
+        group.instances.clear();
+    }
+    m_renderQueue.Clear();
+    m_queuedBodies.clear();
+
+    if (m_lodEnabled && !m_lodInitialized) {
+        InitializePrimitiveLods();
+    }
+    m_statistics.lodReducedObjects = 0;
+
+    BuildDrawList(scene);
+
+    // 陰影使用已更新的剔除樹，並且必須在上傳 FrameData 之前決定各段的矩陣
+    RenderCascadedShadows(scene);
+    if (m_cascadeShadowsActive) {
+        glActiveTexture(GL_TEXTURE0 + SHADOW_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, m_cascadedShadowMap.depthTexture);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    // 相機與光照每影格上傳一次，所有使用 FrameData 的著色器共用
+    if (m_uniformBuffersInitialized ? m_uniformBuffers.frameBuffer != 0 : InitializeUniformBuffers()) {
+        UpdateFrameUniforms();
+    }
+
+    m_gpuProfiler.BeginPass(GpuProfiler::Pass::Opaque);
+    for (uint32_t index : m_drawList) {
+        const auto& rigidBody = scene.rigidBodies[index];
+
+        glm::vec3 meshScale;
+        Mesh* mesh = instancing ? GetInstanceMesh(rigidBody, meshScale) : nullptr;
+        auto material = m_materials.find(rigidBody.visualMaterial);
+        if (mesh && material != m_materials.end()) {
+            const Material& m = material->second;
+            const bool textured = m_renderMode == RenderMode::Textured && !m.diffuseTexture.empty();
+            if (textured || m.transparency < 1.0f || m.diffuseColor.a < 1.0f) {
+                mesh = nullptr;
+            }
+        }
+        if (!mesh) {
+            QueueRigidBody(rigidBody);
+            continue;
+        }
+
+        if (m_renderCallback) {
+            m_renderCallback->OnRenderObject(rigidBody.name);
+        }
+
+        // 每個 LOD 網格各自成組
+        const glm::mat4 model = glm::scale(ToGLMMatrix(rigidBody.transform), meshScale);
+        mesh = SelectLod(mesh, model);
+
+        auto& lookup = m_instanceGroupLookup[mesh];
+        auto it = lookup.find(rigidBody.visualMaterial);
+        if (it == lookup.end()) {
+            it = lookup.emplace(rigidBody.visualMaterial, m_instanceGroups.size()).first;
+            InstanceGroup group;
+            group.mesh = mesh;
+            group.materialName = rigidBody.visualMaterial;
+            m_instanceGroups.push_back(std::move(group));
+        }
+
+        InstanceData instance;
+        instance.model = model;
+        instance.color = material != m_materials.end() ? material->second.diffuseColor : DEFAULT_INSTANCE_COLOR;
+        m_instanceGroups[it->second].instances.push_back(instance);
+    }
+
+    // 實例化的都是不透明物件，先畫完再提交佇列（半透明項目排在最後）
+    if (instancing) {
+        RenderInstanceGroups();
+    }
+    SubmitRenderQueue();
+    m_gpuProfiler.EndPass(GpuProfiler::Pass::Opaque);
+}
+
+// ============================================================================
+// GPU 計時
+// ============================================================================
+
+/**
+ * @brief 切換到下一組計時查詢，並把已完成的量測寫入統計資訊
+ */
+void Renderer::BeginGpuTimingFrame() {
+    if (!m_gpuProfilerInitialized) {
+        m_gpuProfilerInitialized = true;
+        if (!m_gpuProfiler.Initialize()) {
+            HandleRenderError("GPU timer queries are unavailable, GPU pass timing disabled");
+        }
+    }
+    m_gpuProfiler.BeginFrame();
+
+    m_statistics.gpuShadowTime = m_gpuProfiler.GetPassTime(GpuProfiler::Pass::Shadow);
+    m_statistics.gpuOpaqueTime = m_gpuProfiler.GetPassTime(GpuProfiler::Pass::Opaque);
+    m_statistics.gpuDebugTime = m_gpuProfiler.GetPassTime(GpuProfiler::Pass::Debug);
+    m_statistics.gpuUITime = m_gpuProfiler.GetPassTime(GpuProfiler::Pass::UI);
+}
+
+// ============================================================================
+// 紋理串流
+// ============================================================================
+
+void Renderer::LoadTexture(const std::string& name, const std::string& filename) {
+    if (!m_textureStreamer.IsInitialized() && !m_textureStreamer.Initialize()) {
+        HandleRenderError("Failed to initialize texture streaming: " + m_textureStreamer.GetLastError());
+        return;
+    }
+    m_textureStreamer.Request(name, filename);
+}
+
+void Renderer::UnloadTexture(const std::string& name) {
+    m_textureStreamer.Release(name);
+}
+
+bool Renderer::HasTexture(const std::string& name) const {
+    return m_textureStreamer.Has(name);
+}
+
+void Renderer::BindTexture(const std::string& textureName, int unit) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, m_textureStreamer.Acquire(textureName));
+}
+
+void Renderer::SetTextureMemoryBudget(size_t megabytes) {
+    TextureStreamer::Settings settings = m_textureStreamer.GetSettings();
+    settings.memoryBudgetBytes = megabytes << 20;
+    m_textureStreamer.SetSettings(settings);
+}
+
+void Renderer::UpdateTextureStreaming() {
+    m_textureStreamer.Update();
+
+    const TextureStreamer::Statistics& statistics = m_textureStreamer.GetStatistics();
+    m_statistics.textureMemoryMB = static_cast<int>(statistics.textureBytes >> 20);
+    if (statistics.failedTextures != m_reportedTextureFailures) {
+        m_reportedTextureFailures = statistics.failedTextures;
+        HandleRenderError("Failed to load texture: " + m_textureStreamer.GetLastError());
+    }
+}
+
+// ============================================================================
+// 畫面擷取
+// ============================================================================
+
+/**
+ * @brief 排入截圖請求；回傳時檔案尚未寫出，會在下一次 CaptureFrame 後數個影格內完成
+ */
+bool Renderer::SaveScreenshot(const std::string& filename, int width, int height) {
+    if (filename.empty()) return false;
+    m_frameCapture.RequestScreenshot(filename, width, height);
+    return true;
+}
+
+bool Renderer::StartFrameCapture(const std::string& path, FrameCapture::Format format) {
+    if (!m_frameCapture.StartSequence(path, format)) {
+        m_reportedCaptureError = m_frameCapture.GetLastError();
+        HandleRenderError("Failed to start frame capture: " + m_reportedCaptureError);
+        return false;
+    }
+    return true;
+}
+
+void Renderer::StopFrameCapture() {
+    m_frameCapture.StopSequence();
+    m_frameCapture.Flush();
+}
+
+void Renderer::CaptureFrame() {
+    // 讀取整個視口；視窗大小改變時以新的大小擷取
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    m_frameCapture.Capture(viewport[2], viewport[3]);
+
+    const FrameCapture::Statistics statistics = m_frameCapture.GetStatistics();
+    m_statistics.captureTime = static_cast<float>(statistics.lastCaptureMilliseconds);
+    const std::string error = m_frameCapture.GetLastError();
+    if (error != m_reportedCaptureError) {
+        m_reportedCaptureError = error;
+        HandleRenderError("Frame capture: " + error);
+    }
+}
+
+// ============================================================================
+// 串聯陰影
+// ============================================================================
+
+void Renderer::SetShadowCascadeSettings(const ShadowCascades::Settings& settings) {
+    m_shadowCascades.SetSettings(settings);
+    // 解析度或段數可能改變，下一影格重新建立貼圖
+    m_cascadedShadowMap.Cleanup();
+    m_cascadeDepthShader.reset();
+    m_cascadeShadowsInitialized = false;
+}
+
+/**
+ * @brief 第一個投射陰影的方向光；其他光源的陰影由 RenderShadowMaps 處理
+ */
+const Renderer::Light* Renderer::GetShadowLight() const {
+    for (const auto& light : m_lights) {
+        if (light.type == Light::Directional && light.castShadows) {
+            return &light;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief 建立深度著色器、兩個深度紋理陣列與繪製用的 framebuffer；失敗時停用串聯陰影
+ */
+bool Renderer::InitializeCascadedShadows() {
+    m_cascadeShadowsInitialized = true;
+
+    auto shader = std::make_unique<Shader>();
+    if (!shader->LoadFromSource(GetCascadeDepthVertexShader(), GetCascadeDepthFragmentShader())) {
+        HandleRenderError("Failed to compile cascaded shadow shader, disabling directional shadows");
+        return false;
+    }
+
+    const ShadowCascades::Settings& settings = m_shadowCascades.GetSettings();
+    CascadedShadowMap& map = m_cascadedShadowMap;
+    map.resolution = settings.resolution;
+    map.layers = settings.cascadeCount;
+
+    for (GLuint* texture : {&map.depthTexture, &map.staticDepthTexture}) {
+        // 取樣用的紋理開啟深度比較，讓 PCF 由硬體雙線性過濾
+        const bool sampled = texture == &map.depthTexture;
+        glGenTextures(1, texture);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, *texture);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, map.resolution, map.resolution,
+                     static_cast<GLsizei>(map.layers), 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, sampled ? GL_LINEAR : GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, sampled ? GL_LINEAR : GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        if (sampled) {
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    glGenFramebuffers(1, &map.framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, map.framebuffer);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, map.depthTexture, 0, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+    glGenFramebuffers(1, &map.readFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, map.readFramebuffer);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, map.staticDepthTexture, 0, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (!complete || !CheckGLError("InitializeCascadedShadows")) {
+        HandleRenderError("Cascaded shadow framebuffer is incomplete, disabling directional shadows");
+        map.Cleanup();
+        return false;
+    }
+
+    m_cascadeDepthShader = std::move(shader);
+    return true;
+}
+
+/**
+ * @brief 繪製方向光的各段陰影貼圖
+ *
+ * 靜態物件的深度畫在另一個紋理陣列中並跨影格保留，只在該段的投影矩陣改變
+ * 或靜態物件改變時重畫。每影格先把靜態深度複製到取樣用的紋理，再疊上動態物件。
+ * 投影物件以視錐剔除樹對每段的正交視錐篩選。
+ */
+void Renderer::RenderCascadedShadows(const PhysicsScene::PhysicsScene& scene) {
+    m_cascadeShadowsActive = false;
+    m_statistics.staticShadowRebuilds = 0;
+
+    const Light* light = m_shadowsEnabled ? GetShadowLight() : nullptr;
+    if (!light) return;
+    if (m_cascadeShadowsInitialized ? m_cascadeDepthShader == nullptr : !InitializeCascadedShadows()) return;
+
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    GpuProfiler::Scope gpuTiming(m_gpuProfiler, GpuProfiler::Pass::Shadow);
+
+    ShadowCascades::View view;
+    view.viewMatrix = m_camera.GetViewMatrix();
+    view.fovY = glm::radians(m_camera.fov);
+    view.aspectRatio = m_aspectRatio;
+    view.nearPlane = m_camera.nearPlane;
+    view.farPlane = m_camera.farPlane;
+    view.orthographic = m_camera.orthographic;
+    view.orthographicSize = m_camera.orthographicSize;
+    const uint32_t changedCascades = m_shadowCascades.Update(view, light->direction);
+
+    CascadedShadowMap& map = m_cascadedShadowMap;
+    UpdateStaticCasters(scene);
+    if (m_staticSceneVersion != map.staticSceneVersion) {
+        map.staticSceneVersion = m_staticSceneVersion;
+        map.staticValidMask = 0;
+    }
+    map.staticValidMask &= ~changedCascades;
+
+    // 視錐剔除關閉時 BuildDrawList 不會更新剔除樹
+    if (!m_frustumCullingEnabled) {
+        UpdateCullingBounds(scene);
+    }
+
+    GLint previousFramebuffer = 0;
+    GLint previousViewport[4] = {0, 0, 0, 0};
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
+
+    glViewport(0, 0, map.resolution, map.resolution);
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(1.5f, 2.0f);
+    m_cascadeDepthShader->Use();
+
+    for (size_t i = 0; i < m_shadowCascades.GetCascadeCount(); ++i) {
+        const uint32_t bit = 1u << i;
+        const GLint layer = static_cast<GLint>(i);
+        const ShadowCascades::Cascade& cascade = m_shadowCascades.GetCascade(i);
+        m_cascadeDepthShader->SetMat4(Shader::Uniform::LightSpaceMatrix, cascade.lightSpaceMatrix);
+
+        m_frustumCuller.Cull(FrustumCuller::ExtractFrustum(glm::value_ptr(cascade.lightSpaceMatrix)), m_shadowCasters);
+        const size_t culledCount = m_shadowCasters.size();
+        m_shadowCasters.insert(m_shadowCasters.end(), m_unboundedBodies.begin(), m_unboundedBodies.end());
+        std::inplace_merge(m_shadowCasters.begin(), m_shadowCasters.begin() + culledCount, m_shadowCasters.end());
+
+        glBindFramebuffer(GL_FRAMEBUFFER, map.framebuffer);
+        if (!(map.staticValidMask & bit)) {
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, map.staticDepthTexture, 0, layer);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            DrawShadowCasters(scene, true);
+            map.staticValidMask |= bit;
+            m_statistics.staticShadowRebuilds++;
+        }
+
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, map.depthTexture, 0, layer);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, map.readFramebuffer);
+        glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, map.staticDepthTexture, 0, layer);
+        glBlitFramebuffer(0, 0, map.resolution, map.resolution, 0, 0, map.resolution, map.resolution,
+                          GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+        DrawShadowCasters(scene, false);
+    }
+
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer));
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+
+    m_cascadeShadowsActive = CheckGLError("RenderCascadedShadows");
+
+    const auto endTime = std::chrono::high_resolution_clock::now();
+    m_statistics.shadowMapTime = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+}
+
+/**
+ * @brief 繪製 m_shadowCasters 中靜態或動態的投影物件（深度著色器已綁定）
+ */
+void Renderer::DrawShadowCasters(const PhysicsScene::PhysicsScene& scene, bool staticCasters) {
+    for (uint32_t index : m_shadowCasters) {
+        const auto& rigidBody = scene.rigidBodies[index];
+        if (!rigidBody.castShadows || (m_staticCasters[index] != 0) != staticCasters) continue;
+
+        m_shadowParts.clear();
+        CollectDrawParts(rigidBody, m_shadowParts, true);
+        for (const DrawPart& part : m_shadowParts) {
+            m_cascadeDepthShader->SetMat4(Shader::Uniform::Model, part.model);
+            DrawMesh(*part.mesh);
+        }
+    }
+}
+
+/**
+ * @brief 判定靜態投影物件；靜態投影物件增減或被標記移動時遞增 m_staticSceneVersion
+ *
+ * 只重新判定 MarkBodiesMoved 標記的剛體，其餘靜態物件不花任何成本。
+ * 剛體數改變或 InvalidateCulling 後重新判定全部。
+ */
+void Renderer::UpdateStaticCasters(const PhysicsScene::PhysicsScene& scene) {
+    const size_t count = scene.rigidBodies.size();
+    if (m_staticCastersDirty || m_staticCasters.size() != count) {
+        m_staticCasters.assign(count, 0);
+        for (size_t i = 0; i < count; ++i) {
+            m_staticCasters[i] = IsStaticCaster(scene, scene.rigidBodies[i]) ? 1 : 0;
+        }
+        m_staticCastersDirty = false;
+        m_staticCheckBodies.clear();
+        ++m_staticSceneVersion;
+        return;
+    }
+
+    bool changed = false;
+    for (uint32_t index : m_staticCheckBodies) {
+        if (index >= count) continue;
+        const uint8_t isStatic = IsStaticCaster(scene, scene.rigidBodies[index]) ? 1 : 0;
+        changed = changed || isStatic != 0 || m_staticCasters[index] != 0;
+        m_staticCasters[index] = isStatic;
+    }
+    m_staticCheckBodies.clear();
+    if (changed) {
+        ++m_staticSceneVersion;
+    }
+}
+
+void Renderer::CascadedShadowMap::Cleanup() {
+    for (GLuint* texture : {&depthTexture, &staticDepthTexture}) {
+        if (*texture != 0) {
+            glDeleteTextures(1, texture);
+            *texture = 0;
+        }
+    }
+    for (GLuint* framebufferObject : {&framebuffer, &readFramebuffer}) {
+        if (*framebufferObject != 0) {
+            glDeleteFramebuffers(1, framebufferObject);
+            *framebufferObject = 0;
+        }
+    }
+    resolution = 0;
+    layers = 0;
+    staticValidMask = 0;
+    staticSceneVersion = 0;
+}
+
+std::string Renderer::GetCascadeDepthVertexShader() {
+    return R"(#version 330 core
+layout(location = 0) in vec3 aPosition;
+
+uniform mat4 lightSpaceMatrix;
+uniform mat4 model;
+
+void main() {
+    gl_Position = lightSpaceMatrix * model * vec4(aPosition, 1.0);
+}
+)";
+}
+
+std::string Renderer::GetCascadeDepthFragmentShader() {
+    return R"(#version 330 core
+void main() {
+}
+)";
+}
+
+// ============================================================================
+// 除錯渲染
+// ============================================================================
+
+void Renderer::DrawLine(const glm::vec3& from, const glm::vec3& to, const glm::vec3& color) {
+    const uint32_t packed = PackDebugColor(color);
+    m_debugLineVertices.push_back({from, packed, 1.0f});
+    m_debugLineVertices.push_back({to, packed, 1.0f});
+}
+
+void Renderer::DrawPoint(const glm::vec3& position, const glm::vec3& color, float size) {
+    m_debugPointVertices.push_back({position, PackDebugColor(color), size});
+}
+
+void Renderer::DrawSphere(const glm::vec3& center, float radius, const glm::vec3& color) {
+    // 三個互相垂直的大圓
+    constexpr int SEGMENTS = 24;
+    const uint32_t packed = PackDebugColor(color);
+    const float step = 2.0f * 3.14159265359f / static_cast<float>(SEGMENTS);
+    for (int axis = 0; axis < 3; ++axis) {
+        const auto point = [&](int i) {
+            const float c = radius * std::cos(step * static_cast<float>(i));
+            const float s = radius * std::sin(step * static_cast<float>(i));
+            glm::vec3 offset(0.0f);
+            offset[(axis + 1) % 3] = c;
+            offset[(axis + 2) % 3] = s;
+            return center + offset;
+        };
+        for (int i = 0; i < SEGMENTS; ++i) {
+            m_debugLineVertices.push_back({point(i), packed, 1.0f});
+            m_debugLineVertices.push_back({point(i + 1), packed, 1.0f});
+        }
+    }
+}
+
+void Renderer::DrawBox(const glm::vec3& center, const glm::vec3& halfExtents, const glm::vec3& color) {
+    const uint32_t packed = PackDebugColor(color);
+    const auto corner = [&](int i) {
+        return center + halfExtents * glm::vec3((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f);
+    };
+    // 12 條邊：相差一個位元的角點相連
+    for (int i = 0; i < 8; ++i) {
+        for (int bit = 1; bit < 8; bit <<= 1) {
+            if (i & bit) continue;
+            m_debugLineVertices.push_back({corner(i), packed, 1.0f});
+            m_debugLineVertices.push_back({corner(i | bit), packed, 1.0f});
+        }
+    }
+}
+
+/**
+ * @brief 將本影格累積的除錯頂點寫入串流緩衝區的下一段，線段與點各以一次 glDrawArrays 繪製
+ *
+ * 視圖與投影矩陣取自 FrameData，必須在 UpdateFrameUniforms 之後呼叫。
+ */
+void Renderer::RenderDebugPrimitives() {
+    const size_t lineVertices = m_debugLineVertices.size();
+    const size_t pointVertices = m_debugPointVertices.size();
+    const size_t totalVertices = lineVertices + pointVertices;
+
+    const bool ready = totalVertices > 0 && m_uniformBuffers.frameBuffer != 0 &&
+                       (m_debugBatchInitialized ? m_debugBatchShader != nullptr : InitializeDebugBatch());
+    DebugStreamBuffer& stream = m_debugStream;
+    if (ready && (totalVertices <= stream.segmentCapacity ||
+                  AllocateDebugStream(std::max(totalVertices, stream.segmentCapacity * 2)))) {
+        stream.segment = (stream.segment + 1) % DebugStreamBuffer::RING_SEGMENTS;
+        if (GLsync fence = stream.fences[stream.segment]) {
+            glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+            glDeleteSync(fence);
+            stream.fences[stream.segment] = nullptr;
+        }
+
+        const size_t first = static_cast<size_t>(stream.segment) * stream.segmentCapacity;
+        glBindBuffer(GL_ARRAY_BUFFER, stream.buffer);
+        DebugVertex* destination = stream.persistent
+            ? stream.mapped + first
+            : static_cast<DebugVertex*>(glMapBufferRange(
+                  GL_ARRAY_BUFFER, static_cast<GLintptr>(first * sizeof(DebugVertex)),
+                  static_cast<GLsizeiptr>(totalVertices * sizeof(DebugVertex)),
+                  GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+
+        if (destination) {
+            std::memcpy(destination, m_debugLineVertices.data(), lineVertices * sizeof(DebugVertex));
+            std::memcpy(destination + lineVertices, m_debugPointVertices.data(), pointVertices * sizeof(DebugVertex));
+            if (!stream.persistent) {
+                glUnmapBuffer(GL_ARRAY_BUFFER);
+            }
+
+            m_debugBatchShader->Use();
+            glBindVertexArray(stream.vertexArray);
+            if (lineVertices > 0) {
+                glDrawArrays(GL_LINES, static_cast<GLint>(first), static_cast<GLsizei>(lineVertices));
+                m_statistics.drawCalls++;
+            }
+            if (pointVertices > 0) {
+                glEnable(GL_PROGRAM_POINT_SIZE);
+                glDrawArrays(GL_POINTS, static_cast<GLint>(first + lineVertices), static_cast<GLsizei>(pointVertices));
+                glDisable(GL_PROGRAM_POINT_SIZE);
+                m_statistics.drawCalls++;
+            }
+            glBindVertexArray(0);
+            m_debugBatchShader->Unuse();
+
+            // 本段在 GPU 讀完前不會再被覆寫
+            stream.fences[stream.segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        CheckGLError("RenderDebugPrimitives");
+    }
+
+    // 保留容量，下一影格不再配置
+    m_debugLineVertices.clear();
+    m_debugPointVertices.clear();
+}
+
+bool Renderer::InitializeDebugBatch() {
+    m_debugBatchInitialized = true;
+
+    auto shader = std::make_unique<Shader>();
+    if (!shader->LoadFromSource(GetDebugBatchVertexShader(), GetDebugBatchFragmentShader())) {
+        HandleRenderError("Failed to compile debug line shader, debug drawing disabled");
+        return false;
+    }
+
+    glGenVertexArrays(1, &m_debugStream.vertexArray);
+    m_debugStream.persistent = GLEW_ARB_buffer_storage;
+    if (!AllocateDebugStream(DEBUG_STREAM_INITIAL_CAPACITY)) {
+        m_debugStream.Cleanup();
+        return false;
+    }
+
+    m_debugBatchShader = std::move(shader);
+    return true;
+}
+
+/**
+ * @brief 重新建立可容納 segmentCapacity 個頂點的串流緩衝區
+ *
+ * 持續映射的緩衝區大小不可變，因此擴充時一律建立新的緩衝區；
+ * 持續映射失敗時改用每影格映射。
+ */
+bool Renderer::AllocateDebugStream(size_t segmentCapacity) {
+    DebugStreamBuffer& stream = m_debugStream;
+    stream.WaitForFences();
+    if (stream.buffer != 0) {
+        if (stream.mapped) {
+            glBindBuffer(GL_ARRAY_BUFFER, stream.buffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            stream.mapped = nullptr;
+        }
+        glDeleteBuffers(1, &stream.buffer);
+        stream.buffer = 0;
+    }
+
+    const GLsizeiptr size = static_cast<GLsizeiptr>(segmentCapacity * DebugStreamBuffer::RING_SEGMENTS *
+                                                    sizeof(DebugVertex));
+    glGenBuffers(1, &stream.buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, stream.buffer);
+    if (stream.persistent) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+        stream.mapped = static_cast<DebugVertex*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+        if (!stream.mapped) {
+            glDeleteBuffers(1, &stream.buffer);
+            glGenBuffers(1, &stream.buffer);
+            glBindBuffer(GL_ARRAY_BUFFER, stream.buffer);
+            stream.persistent = false;
+        }
+    }
+    if (!stream.persistent) {
+        glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    }
+
+    glBindVertexArray(stream.vertexArray);
+    const GLsizei stride = static_cast<GLsizei>(sizeof(DebugVertex));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<const void*>(offsetof(DebugVertex, position)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                          reinterpret_cast<const void*>(offsetof(DebugVertex, color)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<const void*>(offsetof(DebugVertex, size)));
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    stream.segmentCapacity = segmentCapacity;
+    stream.segment = 0;
+    if (!CheckGLError("AllocateDebugStream")) {
+        stream.segmentCapacity = 0;
+        return false;
+    }
+    return true;
+}
+
+void Renderer::DebugStreamBuffer::WaitForFences() {
+    for (GLsync& fence : fences) {
+        if (fence) {
+            glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+}
+
+void Renderer::DebugStreamBuffer::Cleanup() {
+    for (GLsync& fence : fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    if (buffer != 0) {
+        if (mapped) {
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            mapped = nullptr;
+        }
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+    if (vertexArray != 0) {
+        glDeleteVertexArrays(1, &vertexArray);
+        vertexArray = 0;
+    }
+    segmentCapacity = 0;
+    segment = 0;
+    persistent = false;
+}
+
+std::string Renderer::GetDebugBatchVertexShader() {
+    return std::string("#version 330 core\n") + FRAME_DATA_BLOCK + R"(
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec4 aColor;
+layout(location = 2) in float aSize;
+
+out vec4 vColor;
+
+void main() {
+    gl_Position = viewProjection * vec4(aPosition, 1.0);
+    gl_PointSize = aSize;
+    vColor = aColor;
+}
+)";
+}
+
+std::string Renderer::GetDebugBatchFragmentShader() {
+    return R"(#version 330 core
+in vec4 vColor;
+
+out vec4 fragColor;
+
+void main() {
+    fragColor = vColor;
+}
+)";
+}
+
+// ============================================================================
+// 細節層級
+// ============================================================================
+
+/**
+ * @brief 以較少的分段數重新產生曲面基本形狀；方塊與平面已是最少的三角形，沒有 LOD
+ */
+void Renderer::InitializePrimitiveLods() {
+    m_lodInitialized = true;
+
+    struct PrimitiveLod {
+        const Mesh* mesh;
+        float radius;                   // 共用網格的包圍球半徑
+        std::vector<int> segments;      // LOD 1 以後的分段數
+    };
+    const PrimitiveLod primitives[] = {
+        {m_sphereMesh.get(), 1.0f, {16, 10, 6}},
+        {m_cylinderMesh.get(), 1.4142136f, {16, 10, 6}},
+        {m_coneMesh.get(), 1.4142136f, {16, 10, 6}},
+        {m_capsuleMesh.get(), 2.0f, {10, 6}},
+    };
+
+    for (const auto& primitive : primitives) {
+        if (!primitive.mesh) continue;
+
+        LodChain& chain = m_meshLods[primitive.mesh];
+        chain.Cleanup();
+        chain.radius = primitive.radius;
+        for (int segments : primitive.segments) {
+            std::unique_ptr<Mesh> level;
+            if (primitive.mesh == m_sphereMesh.get()) {
+                level = CreateSphereMesh(1.0f, segments);
+            } else if (primitive.mesh == m_cylinderMesh.get()) {
+                level = CreateCylinderMesh(1.0f, 2.0f, segments);
+            } else if (primitive.mesh == m_coneMesh.get()) {
+                level = CreateConeMesh(1.0f, 2.0f, segments);
+            } else {
+                level = CreateCapsuleMesh(1.0f, 2.0f, segments);
+            }
+            if (!level) break;
+            chain.levels.push_back(std::move(level));
+        }
+    }
+}
+
+/**
+ * @brief 建立匯入的網格並產生其 LOD；同名網格會被取代
+ */
+Renderer::Mesh* Renderer::AddMesh(const std::string& name, const MeshLod::MeshData& data) {
+    std::unique_ptr<Mesh> mesh = CreateMeshFromVertices(data.vertices, data.normals, data.texCoords, data.indices);
+    if (!mesh) return nullptr;
+
+    auto& slot = m_meshes[name];
+    if (slot) {
+        m_meshLods.erase(slot.get());
+        slot->Cleanup();
+    }
+    slot = std::move(mesh);
+    BuildMeshLods(*slot, data);
+    return slot.get();
+}
+
+/**
+ * @brief 以邊收縮簡化產生 LOD 1 以後的層級並上傳
+ */
+void Renderer::BuildMeshLods(const Mesh& mesh, const MeshLod::MeshData& source) {
+    std::vector<MeshLod::MeshData> levels = MeshLod::BuildChain(source);
+    if (levels.empty()) {
+        m_meshLods.erase(&mesh);
+        return;
+    }
+
+    LodChain& chain = m_meshLods[&mesh];
+    chain.Cleanup();
+    chain.radius = MeshLod::ComputeBoundingRadius(source.vertices);
+    for (const auto& level : levels) {
+        std::unique_ptr<Mesh> lodMesh = CreateMeshFromVertices(level.vertices, level.normals, level.texCoords,
+                                                               level.indices);
+        if (!lodMesh) break;
+        chain.levels.push_back(std::move(lodMesh));
+    }
+}
+
+/**
+ * @brief 依物件在螢幕上的大小選擇要繪製的網格；沒有 LOD 時回傳 mesh 本身
+ */
+Renderer::Mesh* Renderer::SelectLod(Mesh* mesh, const glm::mat4& model) const {
+    if (!m_lodEnabled) return mesh;
+    auto it = m_meshLods.find(mesh);
+    if (it == m_meshLods.end() || it->second.levels.empty()) return mesh;
+
+    const float scale = std::max(glm::length(glm::vec3(model[0])),
+                                 std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+    const float screenSize = GetScreenSize(glm::vec3(model[3]), it->second.radius * scale) * m_lodBias;
+    const size_t level = MeshLod::SelectLevel(screenSize, it->second.levels.size() + 1);
+    if (level == 0) return mesh;
+
+    m_statistics.lodReducedObjects++;
+    return it->second.levels[level - 1].get();
+}
+
+/**
+ * @brief 啟用或停用 LOD；陰影投影物件的網格跟著改變，快取的靜態深度須重建
+ */
+void Renderer::EnableLod(bool enable) {
+    if (enable != m_lodEnabled) {
+        m_cascadedShadowMap.staticValidMask = 0;
+    }
+    m_lodEnabled = enable;
+}
+
+/**
+ * @brief 陰影投影物件的網格：固定的 LOD 層級，不依主相機距離選擇
+ */
+Renderer::Mesh* Renderer::SelectShadowLod(Mesh* mesh) const {
+    if (!m_lodEnabled) return mesh;
+    auto it = m_meshLods.find(mesh);
+    if (it == m_meshLods.end() || it->second.levels.empty()) return mesh;
+
+    const size_t level = std::min(SHADOW_CASTER_LOD, it->second.levels.size());
+    return level == 0 ? mesh : it->second.levels[level - 1].get();
+}
+
+/**
+ * @brief 包圍球投影半徑相對於視口半高的比例
+ */
+float Renderer::GetScreenSize(const glm::vec3& center, float radius) const {
+    if (m_camera.orthographic) {
+        return m_camera.orthographicSize > 0.0f ? radius / m_camera.orthographicSize : 1.0f;
+    }
+
+    const float distance = glm::length(center - m_camera.position);
+    if (distance <= radius) return 1.0f;
+    const float halfFov = glm::radians(m_camera.fov) * 0.5f;
+    return radius / (distance * std::tan(halfFov));
+}
+
+void Renderer::LodChain::Cleanup() {
+    for (auto& level : levels) {
+        level->Cleanup();
+    }
+    levels.clear();
+}
+
+// ============================================================================
+// 視錐剔除
+// ============================================================================
+
+void Renderer::MarkBodiesMoved(const std::vector<uint32_t>& bodies) {
+    // 多個影格未更新而累積的標記比剛體還多時，改為下次全部重新計算
+    if (m_movedBodies.size() + bodies.size() > m_cullingEntries.size()) {
+        m_cullingEntries.clear();
+        m_movedBodies.clear();
+    } else {
+        m_movedBodies.insert(m_movedBodies.end(), bodies.begin(), bodies.end());
+    }
+    if (m_staticCheckBodies.size() + bodies.size() > m_staticCasters.size()) {
+        m_staticCastersDirty = true;
+        m_staticCheckBodies.clear();
+    } else {
+        m_staticCheckBodies.insert(m_staticCheckBodies.end(), bodies.begin(), bodies.end());
+    }
+}
+
+void Renderer::InvalidateCulling() {
+    m_frustumCuller.Clear();
+    m_cullingEntries.clear();
+    m_movedBodies.clear();
+    m_staticCastersDirty = true;
+    m_staticCheckBodies.clear();
+}
+
+/**
+ * @brief 決定本影格要繪製的剛體：樹中與視錐相交者加上沒有包圍盒者
+ */
+void Renderer::BuildDrawList(const PhysicsScene::PhysicsScene& scene) {
+    m_drawList.clear();
+    int candidates = 0;
+
+    if (!m_frustumCullingEnabled) {
+        for (size_t i = 0; i < scene.rigidBodies.size(); ++i) {
+            if (scene.rigidBodies[i].visible) {
+                m_drawList.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        m_statistics.visibleObjects = static_cast<int>(m_drawList.size());
+        m_statistics.culledObjects = 0;
+        return;
+    }
+
+    UpdateCullingBounds(scene);
+
+    const glm::mat4 viewProjection = m_camera.GetProjectionMatrix(m_aspectRatio) * m_camera.GetViewMatrix();
+    m_frustumCuller.Cull(FrustumCuller::ExtractFrustum(glm::value_ptr(viewProjection)), m_culledVisible);
+
+    // 兩者皆已排序，合併後維持場景順序
+    m_drawList.resize(m_culledVisible.size() + m_unboundedBodies.size());
+    std::merge(m_culledVisible.begin(), m_culledVisible.end(),
+               m_unboundedBodies.begin(), m_unboundedBodies.end(), m_drawList.begin());
+
+    for (const auto& rigidBody : scene.rigidBodies) {
+        if (rigidBody.visible) ++candidates;
+    }
+    m_statistics.visibleObjects = static_cast<int>(m_drawList.size());
+    m_statistics.culledObjects = candidates - m_statistics.visibleObjects;
+}
+
+/**
+ * @brief 更新 MarkBodiesMoved 標記的剛體在樹中的包圍盒
+ *
+ * 剛體數改變或 InvalidateCulling 後重新計算全部；其餘影格只走訪標記的剛體，
+ * 靜止的剛體不花任何成本。移動量在葉節點外擴範圍內時 FrustumCuller 也不會改動樹。
+ */
+void Renderer::UpdateCullingBounds(const PhysicsScene::PhysicsScene& scene) {
+    const size_t count = scene.rigidBodies.size();
+    bool unboundedChanged = false;
+    if (m_cullingEntries.size() != count) {
+        m_cullingEntries.assign(count, CullingEntry());
+        m_frustumCuller.Resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            UpdateCullingEntry(scene.rigidBodies[i], static_cast<uint32_t>(i));
+        }
+        unboundedChanged = true;
+    } else {
+        for (uint32_t object : m_movedBodies) {
+            if (object < count) {
+                unboundedChanged = UpdateCullingEntry(scene.rigidBodies[object], object) || unboundedChanged;
+            }
+        }
+    }
+    m_movedBodies.clear();
+
+    if (unboundedChanged) {
+        m_unboundedBodies.clear();
+        for (size_t i = 0; i < count; ++i) {
+            if (m_cullingEntries[i].valid && m_cullingEntries[i].unbounded) {
+                m_unboundedBodies.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+}
+
+/**
+ * @brief 變換或形狀改變時重新計算剛體的包圍盒；隱藏的剛體自樹中移除
+ *
+ * 回傳剛體是否加入或離開 m_unboundedBodies。
+ */
+bool Renderer::UpdateCullingEntry(const PhysicsScene::RigidBody& rigidBody, uint32_t object) {
+    CullingEntry& entry = m_cullingEntries[object];
+    const bool wasUnbounded = entry.valid && entry.unbounded;
+
+    if (!rigidBody.visible) {
+        m_frustumCuller.RemoveBounds(object);
+        entry.valid = false;
+        return wasUnbounded;
+    }
+
+    const PhysicsScene::Transform& t = rigidBody.transform;
+    const uint64_t shapeKey = HashBodyShape(rigidBody);
+    const bool unchanged = entry.valid && shapeKey == entry.shapeKey && t.position == entry.transform.position &&
+                           t.rotation == entry.transform.rotation && t.scale == entry.transform.scale;
+    if (unchanged) return false;
+
+    entry.transform = t;
+    entry.shapeKey = shapeKey;
+    entry.valid = true;
+
+    const glm::mat4 bodyMatrix = ToGLMMatrix(t);
+    glm::vec3 aabbMin(std::numeric_limits<float>::max());
+    glm::vec3 aabbMax(-std::numeric_limits<float>::max());
+    bool bounded = true;
+    if (rigidBody.compoundChildren.empty()) {
+        bounded = GetShapeBounds(rigidBody.collisionShape, bodyMatrix, aabbMin, aabbMax);
+    } else {
+        for (const auto& child : rigidBody.compoundChildren) {
+            bounded = bounded &&
+                      GetShapeBounds(child.shape, bodyMatrix * ToGLMMatrix(child.localTransform), aabbMin, aabbMax);
+        }
+    }
+
+    if (bounded) {
+        m_frustumCuller.SetBounds(object, btVector3(aabbMin.x, aabbMin.y, aabbMin.z),
+                                  btVector3(aabbMax.x, aabbMax.y, aabbMax.z));
+    } else {
+        m_frustumCuller.RemoveBounds(object);
+    }
+    entry.unbounded = !bounded;
+    return entry.unbounded != wasUnbounded;
+}
+
+/**
+ * @brief 將形狀在 matrix 變換後的世界座標包圍盒併入 aabbMin/aabbMax
+ *
+ * 與 GetShapeMesh 的尺寸一致；只有外部網格檔而沒有頂點資料的形狀無法計算，回傳 false。
+ */
+bool Renderer::GetShapeBounds(const PhysicsScene::GeometryShape& shape, const glm::mat4& matrix,
+                              glm::vec3& aabbMin, glm::vec3& aabbMax) {
+    glm::vec3 localMin;
+    glm::vec3 localMax;
+
+    switch (shape.type) {
+        case PhysicsScene::ShapeType::Box:
+            localMax = 0.5f * glm::vec3(GetShapeParameter(shape, "width", 1.0f),
+                                        GetShapeParameter(shape, "height", 1.0f),
+                                        GetShapeParameter(shape, "depth", 1.0f));
+            localMin = -localMax;
+            break;
+        case PhysicsScene::ShapeType::Sphere:
+            localMax = glm::vec3(GetShapeParameter(shape, "radius", 0.5f));
+            localMin = -localMax;
+            break;
+        case PhysicsScene::ShapeType::Cylinder:
+        case PhysicsScene::ShapeType::Cone:
+        case PhysicsScene::ShapeType::Capsule: {
+            const float radius = GetShapeParameter(shape, "radius", 0.5f);
+            float halfHeight = GetShapeParameter(shape, "height", 1.0f) * 0.5f;
+            if (shape.type == PhysicsScene::ShapeType::Capsule) halfHeight += radius;
+            localMax = glm::vec3(radius, halfHeight, radius);
+            localMin = -localMax;
+            break;
+        }
+        case PhysicsScene::ShapeType::Plane:
+            localMax = glm::vec3(GetShapeParameter(shape, "width", 10.0f) * 0.5f, 0.0f,
+                                 GetShapeParameter(shape, "depth", 10.0f) * 0.5f);
+            localMin = -localMax;
+            break;
+        case PhysicsScene::ShapeType::ConvexHull:
+        case PhysicsScene::ShapeType::TriangleMesh:
+            if (shape.vertices.empty()) return false;
+            localMin = glm::vec3(std::numeric_limits<float>::max());
+            localMax = glm::vec3(-std::numeric_limits<float>::max());
+            for (const auto& vertex : shape.vertices) {
+                const glm::vec3 v(vertex.x, vertex.y, vertex.z);
+                localMin = glm::min(localMin, v);
+                localMax = glm::max(localMax, v);
+            }
+            break;
+        default:
+            return false;
+    }
+
+    // 中心與半徑分別變換：|M| * extent 即為旋轉後的半邊長
+    const glm::vec3 center = glm::vec3(matrix * glm::vec4(0.5f * (localMin + localMax), 1.0f));
+    const glm::vec3 extent = 0.5f * (localMax - localMin);
+    glm::vec3 worldExtent(0.0f);
+    for (int axis = 0; axis < 3; ++axis) {
+        worldExtent += glm::abs(glm::vec3(matrix[axis])) * extent[axis];
+    }
+    aabbMin = glm::min(aabbMin, center - worldExtent);
+    aabbMax = glm::max(aabbMax, center + worldExtent);
+    return true;
+}
+
+/**
+ * @brief 建立實例化著色器與實例緩衝區；失敗時之後一律走逐一繪製
+ */
+bool Renderer::InitializeInstancing() {
+    m_instancingInitialized = true;
+
+    auto shader = std::make_unique<Shader>();
+    if (!shader->LoadFromSource(GetInstancedVertexShader(), GetInstancedFragmentShader())) {
+        HandleRenderError("Failed to compile instanced shader, falling back to per-object rendering");
+        return false;
+    }
+
+    glGenBuffers(1, &m_instanceBuffer.buffer);
+    if (!CheckGLError("InitializeInstancing") || m_instanceBuffer.buffer == 0) {
+        m_instanceBuffer.Cleanup();
+        return false;
+    }
+
+    m_instancedShader = std::move(shader);
+    return true;
+}
+
+/**
+ * @brief 取得形狀使用的網格與套用在網格上的縮放；找不到網格時回傳 nullptr
+ *
+ * 共用網格的尺寸：方塊 1x1x1、球半徑 1、圓柱、圓錐與膠囊半徑 1 高 2、平面 10x10。
+ * 膠囊以非等比縮放近似，半球在高度與半徑比例不同時會變形。
+ * 凸包與三角網格使用以網格檔案名稱載入的網格。
+ */
+Renderer::Mesh* Renderer::GetShapeMesh(const PhysicsScene::GeometryShape& shape, glm::vec3& meshScale) const {
+    switch (shape.type) {
+        case PhysicsScene::ShapeType::Box:
+            meshScale = glm::vec3(GetShapeParameter(shape, "width", 1.0f),
+                                  GetShapeParameter(shape, "height", 1.0f),
+                                  GetShapeParameter(shape, "depth", 1.0f));
+            return m_boxMesh.get();
+        case PhysicsScene::ShapeType::Sphere:
+            meshScale = glm::vec3(GetShapeParameter(shape, "radius", 0.5f));
+            return m_sphereMesh.get();
+        case PhysicsScene::ShapeType::Cylinder:
+        case PhysicsScene::ShapeType::Cone:
+        case PhysicsScene::ShapeType::Capsule: {
+            const float radius = GetShapeParameter(shape, "radius", 0.5f);
+            meshScale = glm::vec3(radius, GetShapeParameter(shape, "height", 1.0f) * 0.5f, radius);
+            if (shape.type == PhysicsScene::ShapeType::Cylinder) return m_cylinderMesh.get();
+            if (shape.type == PhysicsScene::ShapeType::Cone) return m_coneMesh.get();
+            return m_capsuleMesh.get();
+        }
+        case PhysicsScene::ShapeType::Plane:
+            meshScale = glm::vec3(GetShapeParameter(shape, "width", 10.0f) / 10.0f, 1.0f,
+                                  GetShapeParameter(shape, "depth", 10.0f) / 10.0f);
+            return m_planeMesh.get();
+        case PhysicsScene::ShapeType::ConvexHull:
+        case PhysicsScene::ShapeType::TriangleMesh: {
+            meshScale = glm::vec3(1.0f);
+            auto it = m_meshes.find(shape.meshFile);
+            return it != m_meshes.end() ? it->second.get() : nullptr;
+        }
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * @brief 取得可實例化的共用網格；膠囊會變形、平面通常只有一個，兩者都不實例化
+ */
+Renderer::Mesh* Renderer::GetInstanceMesh(const PhysicsScene::RigidBody& rigidBody, glm::vec3& meshScale) const {
+    if (!rigidBody.compoundChildren.empty()) return nullptr;
+
+    switch (rigidBody.collisionShape.type) {
+        case PhysicsScene::ShapeType::Box:
+        case PhysicsScene::ShapeType::Sphere:
+        case PhysicsScene::ShapeType::Cylinder:
+        case PhysicsScene::ShapeType::Cone:
+            return GetShapeMesh(rigidBody.collisionShape, meshScale);
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * @brief 上傳本影格所有實例並逐組繪製
+ */
+void Renderer::RenderInstanceGroups() {
+    // 串接成連續資料，一次上傳
+    m_instanceUploadData.clear();
+    for (auto& group : m_instanceGroups) {
+        group.first = m_instanceUploadData.size();
+        m_instanceUploadData.insert(m_instanceUploadData.end(), group.instances.begin(), group.instances.end());
+    }
+    if (m_instanceUploadData.empty()) return;
+
+    const size_t count = m_instanceUploadData.size();
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer.buffer);
+    if (count > m_instanceBuffer.capacity) {
+        m_instanceBuffer.capacity = std::max(count, m_instanceBuffer.capacity * 2);
+    }
+    // 先以 nullptr 重新配置，讓驅動程式不必等待上一影格仍在使用的資料
+    glBufferData(GL_ARRAY_BUFFER, m_instanceBuffer.capacity * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(InstanceData), m_instanceUploadData.data());
+
+    // 相機與光照來自 FrameData
+    m_instancedShader->Use();
+    m_instancedShader->SetBool(Shader::Uniform::LightingEnabled, m_lightingEnabled);
+    m_instancedShader->SetInt(Shader::Uniform::ShadowMap, SHADOW_TEXTURE_UNIT);
+
+    for (const auto& group : m_instanceGroups) {
+        if (group.instances.empty() || !group.mesh || group.mesh->VAO == 0) continue;
+
+        auto material = m_materials.find(group.materialName);
+        const Material fallback;
+        const Material& m = material != m_materials.end() ? material->second : fallback;
+        m_instancedShader->SetVec3(Shader::Uniform::SpecularColor, m.specularColor);
+        m_instancedShader->SetVec3(Shader::Uniform::EmissiveColor, m.emissiveColor);
+        m_instancedShader->SetFloat(Shader::Uniform::Shininess, m.shininess);
+
+        // 屬性指標帶入本組的起始位置，所有組共用同一個緩衝區
+        glBindVertexArray(group.mesh->VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer.buffer);
+        const size_t base = group.first * sizeof(InstanceData);
+        for (GLuint column = 0; column < 4; ++column) {
+            glEnableVertexAttribArray(3 + column);
+            glVertexAttribPointer(3 + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                                  reinterpret_cast<const void*>(base + offsetof(InstanceData, model) +
+                                                                column * sizeof(glm::vec4)));
+            glVertexAttribDivisor(3 + column, 1);
+        }
+        glEnableVertexAttribArray(7);
+        glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              reinterpret_cast<const void*>(base + offsetof(InstanceData, color)));
+        glVertexAttribDivisor(7, 1);
+
+        const GLsizei instanceCount = static_cast<GLsizei>(group.instances.size());
+        if (group.mesh->indexCount > 0) {
+            glDrawElementsInstanced(group.mesh->primitiveType, group.mesh->indexCount, GL_UNSIGNED_INT, nullptr,
+                                    instanceCount);
+        } else {
+            glDrawArraysInstanced(group.mesh->primitiveType, 0, group.mesh->vertexCount, instanceCount);
+        }
+
+        // 關閉實例屬性，避免影響同一網格的逐一繪製
+        for (GLuint attribute = 3; attribute <= 7; ++attribute) {
+            glVertexAttribDivisor(attribute, 0);
+            glDisableVertexAttribArray(attribute);
+        }
+
+        m_statistics.drawCalls++;
+        m_statistics.instancedDrawCalls++;
+        m_statistics.instancedObjects += instanceCount;
+        m_statistics.triangleCount += (group.mesh->indexCount > 0 ? group.mesh->indexCount
+                                                                  : group.mesh->vertexCount) / 3 * instanceCount;
+        m_statistics.vertexCount += group.mesh->vertexCount * instanceCount;
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    m_instancedShader->Unuse();
+    CheckGLError("RenderInstanceGroups");
+}
+
+// ============================================================================
+// 繪製佇列
+// ============================================================================
+
+struct Renderer::QueueSubmitter {
+    Renderer& renderer;
+    Shader* shader = nullptr;
+    RenderQueue::Pass pass = RenderQueue::Pass::Opaque;
+
+    explicit QueueSubmitter(Renderer& owner) : renderer(owner) {}
+
+    void BindShader(uint16_t id) {
+        switch (id) {
+            case QUEUE_SHADER_WIREFRAME: shader = renderer.m_wireframeShader.get(); break;
+            case QUEUE_SHADER_BASIC: shader = renderer.m_basicShader.get(); break;
+            default: shader = renderer.m_litShader.get(); break;
+        }
+        if (!shader) return;
+        shader->Use();
+        // 沒有宣告 FrameData 的著色器改用各自的 uniform
+        if (!shader->HasUniformBlock(Shader::UniformBlock::Frame)) {
+            shader->SetMat4(Shader::Uniform::View, renderer.m_camera.GetViewMatrix());
+            shader->SetMat4(Shader::Uniform::Projection, renderer.m_camera.GetProjectionMatrix(renderer.m_aspectRatio));
+            shader->SetVec3(Shader::Uniform::ViewPosition, renderer.m_camera.position);
+        }
+    }
+
+    void BindMaterial(uint16_t id) {
+        if (id == RenderQueue::MAX_MATERIAL_ID) return;    // 超出容量，繪製時逐項設定
+        const std::string& name = renderer.m_materialIdNames[id];
+        auto it = renderer.m_materials.find(name);
+        renderer.ApplyMaterial(it != renderer.m_materials.end() ? it->second : Material());
+    }
+
+    void BindTexture(uint16_t id) {
+        if (id == RenderQueue::MAX_TEXTURE_ID) return;
+        if (id == 0) {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        } else {
+            renderer.BindTexture(renderer.m_textureIdNames[id], 0);
+        }
+    }
+
+    void Draw(const RenderQueue::Item& item) {
+        // 半透明項目排在所有不透明項目之後，進入時切換一次混合狀態
+        if (item.pass != pass) {
+            pass = item.pass;
+            if (pass == RenderQueue::Pass::Transparent) {
+                glEnable(GL_BLEND);
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                glDepthMask(GL_FALSE);
+            }
+        }
+        if (!shader) return;
+
+        const PhysicsScene::RigidBody& rigidBody = *renderer.m_queuedBodies[item.object];
+        if (item.material == RenderQueue::MAX_MATERIAL_ID || item.texture == RenderQueue::MAX_TEXTURE_ID) {
+            auto it = renderer.m_materials.find(rigidBody.visualMaterial);
+            const Material material = it != renderer.m_materials.end() ? it->second : Material();
+            if (item.material == RenderQueue::MAX_MATERIAL_ID) renderer.ApplyMaterial(material);
+            if (item.texture == RenderQueue::MAX_TEXTURE_ID) renderer.BindTexture(material.diffuseTexture, 0);
+        }
+        if (renderer.m_renderCallback) {
+            renderer.m_renderCallback->OnRenderObject(rigidBody.name);
+        }
+        renderer.DrawQueuedParts(item.object, *shader);
+    }
+};
+
+/**
+ * @brief 將剛體放進繪製佇列
+ */
+void Renderer::QueueRigidBody(const PhysicsScene::RigidBody& rigidBody) {
+    uint16_t shader = QUEUE_SHADER_LIT;
+    if (m_renderMode == RenderMode::Wireframe) {
+        shader = QUEUE_SHADER_WIREFRAME;
+    } else if (!m_lightingEnabled) {
+        shader = QUEUE_SHADER_BASIC;
+    }
+
+    RenderQueue::Pass pass = RenderQueue::Pass::Opaque;
+    uint16_t texture = 0;
+    auto material = m_materials.find(rigidBody.visualMaterial);
+    if (material != m_materials.end()) {
+        const Material& m = material->second;
+        if (m.transparency < 1.0f || m.diffuseColor.a < 1.0f) {
+            pass = RenderQueue::Pass::Transparent;
+        }
+        if (m_renderMode == RenderMode::Textured && !m.diffuseTexture.empty() && HasTexture(m.diffuseTexture)) {
+            texture = GetTextureId(m.diffuseTexture);
+        }
+    }
+
+    // 正規化觀察深度：沿視線方向的距離除以遠裁剪面
+    const glm::vec3 forward = glm::normalize(m_camera.target - m_camera.position);
+    const float viewDepth = glm::dot(ToGLMVec3(rigidBody.transform.position) - m_camera.position, forward);
+    const float depth = viewDepth / m_camera.farPlane;
+
+    m_renderQueue.Add(pass, shader, GetMaterialId(rigidBody.visualMaterial), texture, depth,
+                      static_cast<uint32_t>(m_queuedBodies.size()));
+    m_queuedBodies.push_back(&rigidBody);
+}
+
+/**
+ * @brief 排序並提交繪製佇列，只在狀態改變時切換著色器、材質與紋理
+ */
+void Renderer::SubmitRenderQueue() {
+    if (m_renderQueue.Empty()) return;
+
+    m_renderQueue.Sort();
+
+    // 依提交順序展開每次繪製，模型矩陣一次上傳到 ObjectData 環狀緩衝區
+    m_drawParts.clear();
+    m_queuedPartRanges.assign(m_queuedBodies.size(), {0u, 0u});
+    for (const auto& item : m_renderQueue.GetItems()) {
+        const uint32_t first = static_cast<uint32_t>(m_drawParts.size());
+        CollectDrawParts(*m_queuedBodies[item.object], m_drawParts);
+        m_queuedPartRanges[item.object] = {first, static_cast<uint32_t>(m_drawParts.size()) - first};
+    }
+    const bool objectUniforms = UploadObjectUniforms();
+
+    QueueSubmitter submitter(*this);
+    const RenderQueue::SubmitStatistics statistics = m_renderQueue.Submit(submitter);
+
+    // 本段在 GPU 讀完前不會再被覆寫
+    if (objectUniforms) {
+        GLsync& fence = m_uniformBuffers.fences[m_uniformBuffers.segment];
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    if (submitter.pass == RenderQueue::Pass::Transparent) {
+        glDepthMask(GL_TRUE);
+        glDisable(GL_BLEND);
+    }
+    if (submitter.shader) {
+        submitter.shader->Unuse();
+    }
+    glBindVertexArray(0);
+
+    m_statistics.shaderChanges += statistics.shaderChanges;
+    m_statistics.materialChanges += statistics.materialChanges;
+    m_statistics.textureChanges += statistics.textureChanges;
+    m_statistics.skippedStateChanges += statistics.skippedStateChanges;
+}
+
+/**
+ * @brief 展開剛體的每次繪製（單一形狀一次，複合形狀每個子形狀一次）
+ *
+ * shadowCaster 為 true 時使用固定的陰影 LOD，而不是依主相機選擇。
+ */
+void Renderer::CollectDrawParts(const PhysicsScene::RigidBody& rigidBody, std::vector<DrawPart>& parts,
+                                bool shadowCaster) const {
+    const glm::mat4 bodyMatrix = ToGLMMatrix(rigidBody.transform);
+    glm::vec3 meshScale;
+    const auto select = [&](Mesh* mesh, const glm::mat4& model) {
+        return shadowCaster ? SelectShadowLod(mesh) : SelectLod(mesh, model);
+    };
+
+    if (rigidBody.compoundChildren.empty()) {
+        if (Mesh* mesh = GetShapeMesh(rigidBody.collisionShape, meshScale)) {
+            const glm::mat4 model = glm::scale(bodyMatrix, meshScale);
+            parts.push_back({select(mesh, model), model});
+        }
+        return;
+    }
+
+    for (const auto& child : rigidBody.compoundChildren) {
+        if (Mesh* mesh = GetShapeMesh(child.shape, meshScale)) {
+            const glm::mat4 model = glm::scale(bodyMatrix * ToGLMMatrix(child.localTransform), meshScale);
+            parts.push_back({select(mesh, model), model});
+        }
+    }
+}
+
+/**
+ * @brief 以目前綁定的著色器繪製佇列物件（狀態由繪製佇列設定）
+ *
+ * 著色器宣告 ObjectData 時只需綁定環狀緩衝區中的範圍，否則設定 model uniform。
+ */
+void Renderer::DrawQueuedParts(uint32_t object, Shader& shader) {
+    const auto& range = m_queuedPartRanges[object];
+    const bool useBlock = m_uniformBuffers.objectBuffer != 0 && shader.HasUniformBlock(Shader::UniformBlock::Object);
+    const size_t segmentOffset = static_cast<size_t>(m_uniformBuffers.segment) *
+                                 m_uniformBuffers.segmentCapacity * m_uniformBuffers.objectStride;
+
+    for (uint32_t i = range.first; i < range.first + range.second; ++i) {
+        if (useBlock) {
+            glBindBufferRange(GL_UNIFORM_BUFFER, Shader::GetBindingPoint(Shader::UniformBlock::Object),
+                              m_uniformBuffers.objectBuffer,
+                              static_cast<GLintptr>(segmentOffset + i * m_uniformBuffers.objectStride),
+                              sizeof(ObjectUniforms));
+        } else {
+            shader.SetMat4(Shader::Uniform::Model, m_drawParts[i].model);
+        }
+        DrawMesh(*m_drawParts[i].mesh);
+    }
+}
+
+void Renderer::DrawMesh(const Mesh& mesh) {
+    if (mesh.VAO == 0) return;
+
+    glBindVertexArray(mesh.VAO);
+    if (mesh.indexCount > 0) {
+        glDrawElements(mesh.primitiveType, mesh.indexCount, GL_UNSIGNED_INT, nullptr);
+    } else {
+        glDrawArrays(mesh.primitiveType, 0, mesh.vertexCount);
+    }
+    m_statistics.drawCalls++;
+    m_statistics.triangleCount += (mesh.indexCount > 0 ? mesh.indexCount : mesh.vertexCount) / 3;
+    m_statistics.vertexCount += mesh.vertexCount;
+}
+
+/**
+ * @brief 取得材質的佇列 ID；第一次遇到時配置
+ */
+uint16_t Renderer::GetMaterialId(const std::string& materialName) {
+    auto it = m_materialIds.find(materialName);
+    if (it != m_materialIds.end()) return it->second;
+
+    // 最後一個 ID 保留給超出排序鍵容量的材質，這些項目在繪製時逐一設定材質
+    if (m_materialIdNames.size() >= RenderQueue::MAX_MATERIAL_ID) {
+        return RenderQueue::MAX_MATERIAL_ID;
+    }
+    const uint16_t id = static_cast<uint16_t>(m_materialIdNames.size());
+    m_materialIdNames.push_back(materialName);
+    m_materialIds.emplace(materialName, id);
+    return id;
+}
+
+uint16_t Renderer::GetTextureId(const std::string& textureName) {
+    if (m_textureIdNames.empty()) {
+        m_textureIdNames.emplace_back();    // ID 0：沒有紋理
+    }
+    auto it = m_textureIds.find(textureName);
+    if (it != m_textureIds.end()) return it->second;
+
+    if (m_textureIdNames.size() >= RenderQueue::MAX_TEXTURE_ID) {
+        return RenderQueue::MAX_TEXTURE_ID;
+    }
+    const uint16_t id = static_cast<uint16_t>(m_textureIdNames.size());
+    m_textureIdNames.push_back(textureName);
+    m_textureIds.emplace(textureName, id);
+    return id;
+}
+
+// ============================================================================
+// Uniform 緩衝區
+// ============================================================================
+
+/**
+ * @brief 建立 FrameData 與 ObjectData 緩衝區；失敗時所有著色器改用個別 uniform
+ */
+bool Renderer::InitializeUniformBuffers() {
+    m_uniformBuffersInitialized = true;
+
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    alignment = std::max(alignment, 1);
+    m_uniformBuffers.objectStride = (sizeof(ObjectUniforms) + alignment - 1) / alignment * alignment;
+
+    glGenBuffers(1, &m_uniformBuffers.frameBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_uniformBuffers.frameBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), nullptr, GL_DYNAMIC_DRAW);
+    glGenBuffers(1, &m_uniformBuffers.objectBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    if (!CheckGLError("InitializeUniformBuffers") || m_uniformBuffers.frameBuffer == 0) {
+        m_uniformBuffers.Cleanup();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 上傳本影格的相機與光照並綁定到 FrameData 綁定點
+ */
+void Renderer::UpdateFrameUniforms() {
+    glm::vec3 lightDirection;
+    glm::vec3 lightColor;
+    GetMainLight(lightDirection, lightColor);
+
+    FrameUniforms frame;
+    frame.view = m_camera.GetViewMatrix();
+    frame.projection = m_camera.GetProjectionMatrix(m_aspectRatio);
+    frame.viewProjection = frame.projection * frame.view;
+    frame.viewPosition = glm::vec4(m_camera.position, 1.0f);
+    frame.lightDirection = glm::vec4(lightDirection, 0.0f);
+    frame.lightColor = glm::vec4(lightColor, 1.0f);
+    frame.ambientColor = glm::vec4(m_ambientLight, 1.0f);
+
+    const size_t cascadeCount = m_cascadeShadowsActive ? m_shadowCascades.GetCascadeCount() : 0;
+    for (size_t i = 0; i < ShadowCascades::MAX_CASCADES; ++i) {
+        const bool active = i < cascadeCount;
+        frame.lightSpaceMatrices[i] = active ? m_shadowCascades.GetCascade(i).lightSpaceMatrix : glm::mat4(1.0f);
+        frame.cascadeSplits[i] = active ? m_shadowCascades.GetCascade(i).splitFar : 0.0f;
+        frame.cascadeTexelSizes[i] = active ? m_shadowCascades.GetCascade(i).texelSize : 0.0f;
+    }
+    frame.shadowParams = glm::vec4(cascadeCount > 0 ? 1.0f : 0.0f, static_cast<float>(cascadeCount), 0.0f, 0.0f);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_uniformBuffers.frameBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &frame);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, Shader::GetBindingPoint(Shader::UniformBlock::Frame),
+                     m_uniformBuffers.frameBuffer);
+}
+
+/**
+ * @brief 將 m_drawParts 的模型矩陣寫入環狀緩衝區的下一段
+ *
+ * 寫入前等待該段的 fence（通常早已完成）；容量不足時重新配置整個緩衝區。
+ */
+bool Renderer::UploadObjectUniforms() {
+    UniformBuffers& buffers = m_uniformBuffers;
+    if (buffers.objectBuffer == 0 || m_drawParts.empty()) return false;
+
+    buffers.segment = (buffers.segment + 1) % UniformBuffers::RING_SEGMENTS;
+    if (GLsync fence = buffers.fences[buffers.segment]) {
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        glDeleteSync(fence);
+        buffers.fences[buffers.segment] = nullptr;
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, buffers.objectBuffer);
+    if (m_drawParts.size() > buffers.segmentCapacity) {
+        // 重新配置前等待所有段，舊內容不再需要
+        for (GLsync& fence : buffers.fences) {
+            if (fence) {
+                glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+        buffers.segmentCapacity = std::max(m_drawParts.size(), buffers.segmentCapacity * 2);
+        glBufferData(GL_UNIFORM_BUFFER,
+                     static_cast<GLsizeiptr>(buffers.segmentCapacity * buffers.objectStride *
+                                             UniformBuffers::RING_SEGMENTS),
+                     nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    m_objectUniformData.resize(m_drawParts.size() * buffers.objectStride);
+    for (size_t o = 0; o < m_queuedBodies.size(); ++o) {
+        auto material = m_materials.find(m_queuedBodies[o]->visualMaterial);
+        const glm::vec4 color = material != m_materials.end() ? material->second.diffuseColor : DEFAULT_INSTANCE_COLOR;
+        const auto& range = m_queuedPartRanges[o];
+        for (uint32_t i = range.first; i < range.first + range.second; ++i) {
+            ObjectUniforms object;
+            object.model = m_drawParts[i].model;
+            object.normalMatrix = glm::transpose(glm::inverse(object.model));
+            object.color = color;
+            std::memcpy(m_objectUniformData.data() + i * buffers.objectStride, &object, sizeof(object));
+        }
+    }
+
+    const size_t segmentOffset = static_cast<size_t>(buffers.segment) * buffers.segmentCapacity * buffers.objectStride;
+    glBufferSubData(GL_UNIFORM_BUFFER, static_cast<GLintptr>(segmentOffset),
+                    static_cast<GLsizeiptr>(m_objectUniformData.size()), m_objectUniformData.data());
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    return CheckGLError("UploadObjectUniforms");
+}
+
+/**
+ * @brief 主光源：第一個方向光，沒有時使用預設的斜上方光
+ */
+void Renderer::GetMainLight(glm::vec3& direction, glm::vec3& color) const {
+    direction = glm::normalize(glm::vec3(-0.3f, -1.0f, -0.5f));
+    color = glm::vec3(1.0f);
+    for (const auto& light : m_lights) {
+        if (light.type == Light::Directional) {
+            direction = glm::normalize(light.direction);
+            color = light.color * light.intensity;
+            return;
+        }
+    }
+}
+
+void Renderer::UniformBuffers::Cleanup() {
+    for (GLsync& fence : fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    if (frameBuffer != 0) {
+        glDeleteBuffers(1, &frameBuffer);
+        frameBuffer = 0;
+    }
+    if (objectBuffer != 0) {
+        glDeleteBuffers(1, &objectBuffer);
+        objectBuffer = 0;
+    }
+    segmentCapacity = 0;
+    segment = 0;
+}
+
+// ============================================================================
+// Shader：列舉 uniform
+// ============================================================================
+
+/**
+ * @brief 解析列舉 uniform 的位置並把 uniform block 綁到固定綁定點
+ */
+void Renderer::Shader::ResolveUniforms() {
+    m_resolvedProgram = m_program;
+    for (size_t i = 0; i < m_cachedLocations.size(); ++i) {
+        m_cachedLocations[i] = m_program != 0 ? glGetUniformLocation(m_program, UNIFORM_NAMES[i]) : -1;
+    }
+    for (size_t i = 0; i < m_uniformBlocks.size(); ++i) {
+        const GLuint index = m_program != 0 ? glGetUniformBlockIndex(m_program, UNIFORM_BLOCK_NAMES[i])
+                                            : GL_INVALID_INDEX;
+        m_uniformBlocks[i] = index != GL_INVALID_INDEX;
+        if (m_uniformBlocks[i]) {
+            glUniformBlockBinding(m_program, index, static_cast<GLuint>(i));
+        }
+    }
+}
+
+GLint Renderer::Shader::GetUniformLocation(Uniform uniform) {
+    if (m_resolvedProgram != m_program) {
+        ResolveUniforms();
+    }
+    return m_cachedLocations[static_cast<size_t>(uniform)];
+}
+
+bool Renderer::Shader::HasUniformBlock(UniformBlock block) {
+    if (m_resolvedProgram != m_program) {
+        ResolveUniforms();
+    }
+    return m_uniformBlocks[static_cast<size_t>(block)];
+}
+
+void Renderer::Shader::SetBool(Uniform uniform, bool value) {
+    const GLint location = GetUniformLocation(uniform);
+    if (location >= 0) glUniform1i(location, value ? 1 : 0);
+}
+
+void Renderer::Shader::SetInt(Uniform uniform, int value) {
+    const GLint location = GetUniformLocation(uniform);
+    if (location >= 0) glUniform1i(location, value);
+}
+
+void Renderer::Shader::SetFloat(Uniform uniform, float value) {
+    const GLint location = GetUniformLocation(uniform);
+    if (location >= 0) glUniform1f(location, value);
+}
+
+void Renderer::Shader::SetVec3(Uniform uniform, const glm::vec3& value) {
+    const GLint location = GetUniformLocation(uniform);
+    if (location >= 0) glUniform3fv(location, 1, glm::value_ptr(value));
+}
+
+void Renderer::Shader::SetMat4(Uniform uniform, const glm::mat4& value) {
+    const GLint location = GetUniformLocation(uniform);
+    if (location >= 0) glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Renderer::InstanceBuffer::Cleanup() {
+    if (buffer != 0) {
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+    capacity = 0;
+}
+
+// ============================================================================
+// 著色器原始碼
+// ============================================================================
+
+/**
+ * @brief 實例化頂點著色器
+ *
+ * 頂點屬性 0-2 與 CreateMeshFromVertices 的配置一致（位置、法線、紋理座標），
+ * 3-6 為每個實例的模型矩陣，7 為顏色。模型矩陣為 T * R * S，
+ * 法線以 mat3(model) * (n / s^2) 轉換，等同於反轉置矩陣而不需逐頂點求逆。
+ */
+std::string Renderer::GetInstancedVertexShader() {
+    return std::string("#version 330 core\n") + FRAME_DATA_BLOCK + R"(
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aTexCoord;
+layout(location = 3) in mat4 aModel;
+layout(location = 7) in vec4 aColor;
+
+out vec3 vWorldPosition;
+out vec3 vNormal;
+out vec4 vColor;
+
+void main() {
+    vec4 worldPosition = aModel * vec4(aPosition, 1.0);
+    vec3 scaleSquared = vec3(dot(aModel[0].xyz, aModel[0].xyz),
+                             dot(aModel[1].xyz, aModel[1].xyz),
+                             dot(aModel[2].xyz, aModel[2].xyz));
+    vWorldPosition = worldPosition.xyz;
+    vNormal = normalize(mat3(aModel) * (aNormal / max(scaleSquared, vec3(1e-12))));
+    vColor = aColor;
+    gl_Position = viewProjection * worldPosition;
+}
+)";
+}
+
+std::string Renderer::GetInstancedFragmentShader() {
+    return std::string("#version 330 core\n") + FRAME_DATA_BLOCK + R"(
+in vec3 vWorldPosition;
+in vec3 vNormal;
+in vec4 vColor;
+
+uniform vec3 specularColor;
+uniform vec3 emissiveColor;
+uniform float shininess;
+uniform bool lightingEnabled;
+uniform sampler2DArrayShadow shadowMap;
+
+out vec4 fragColor;
+
+// 依觀察深度選擇段落，3x3 PCF；超出陰影範圍時視為受光
+float ShadowFactor(vec3 worldPosition, vec3 normal) {
+    int count = int(shadowParams.y);
+    if (shadowParams.x < 0.5 || count == 0) return 1.0;
+
+    float depth = -(view * vec4(worldPosition, 1.0)).z;
+    int cascade = 0;
+    while (cascade < count - 1 && depth > cascadeSplits[cascade]) {
+        ++cascade;
+    }
+    if (depth > cascadeSplits[count - 1]) return 1.0;
+
+    // 沿法向偏移約一個像素，減少自我陰影的條紋
+    vec3 offsetPosition = worldPosition + normal * cascadeTexelSizes[cascade] * 1.5;
+    vec4 lightSpace = lightSpaceMatrices[cascade] * vec4(offsetPosition, 1.0);
+    vec3 coord = lightSpace.xyz / lightSpace.w * 0.5 + 0.5;
+    if (coord.z > 1.0) return 1.0;
+
+    vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    float lit = 0.0;
+    for (int x = -1; x <= 1; ++x) {
+        for (int y = -1; y <= 1; ++y) {
+            lit += texture(shadowMap, vec4(coord.xy + vec2(x, y) * texel, float(cascade), coord.z));
+        }
+    }
+    return lit / 9.0;
+}
+
+void main() {
+    if (!lightingEnabled) {
+        fragColor = vColor;
+        return;
+    }
+    vec3 normal = normalize(vNormal);
+    vec3 toLight = -normalize(lightDirection.xyz);
+    vec3 toView = normalize(viewPosition.xyz - vWorldPosition);
+    vec3 halfway = normalize(toLight + toView);
+
+    float diffuse = max(dot(normal, toLight), 0.0);
+    float specular = diffuse > 0.0 ? pow(max(dot(normal, halfway), 0.0), shininess) : 0.0;
+    float shadow = ShadowFactor(vWorldPosition, normal);
+    vec3 color = ambientColor.rgb * vColor.rgb +
+                 shadow * lightColor.rgb * (diffuse * vColor.rgb + specular * specularColor) + emissiveColor;
+    fragColor = vec4(color, vColor.a);
+}
+)";
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <memory>
 #include <vector>
 #include <string>
@@ -13,6 +14,15 @@
 // 場景格式
 #include "../scene_format/physics_scene_format.h"
 
+// 繪製佇列、視錐剔除、細節層級、陰影、GPU 計時、紋理串流與畫面擷取
+#include "render_queue.h"
+#include "frustum_culler.h"
+#include "mesh_lod.h"
+#include "shadow_cascades.h"
+#include "gpu_profiler.h"
+#include "texture_streamer.h"
+#include "frame_capture.h"
+
 /**
  * @file renderer.h
  * @brief 跨平台 OpenGL 渲染器類別
@@ -37,6 +47,11 @@ public:
     void EndFrame();
     void Render(const PhysicsScene::PhysicsScene& scene);
     void SetViewport(int x, int y, int width, int height);
+    // GPU 計時：每影格在所有 pass 之前呼叫一次；陰影、不透明與除錯 pass 由 Render 自行標記，
+    // UI pass 由繪製它的呼叫端以 BeginGpuPass/EndGpuPass 包住
+    void BeginGpuTimingFrame();
+    void BeginGpuPass(GpuProfiler::Pass pass) { m_gpuProfiler.BeginPass(pass); }
+    void EndGpuPass(GpuProfiler::Pass pass) { m_gpuProfiler.EndPass(pass); }
 
     // 相機控制
     struct Camera {
@@ -75,17 +90,38 @@ public:
     void ShowConstraints(bool show);
     void EnableLighting(bool enable);
     void EnableShadows(bool enable);
+    // 方向光的串聯陰影；靜態物件的深度會快取，設定改變時重建
+    void SetShadowCascadeSettings(const ShadowCascades::Settings& settings);
+    const ShadowCascades::Settings& GetShadowCascadeSettings() const { return m_shadowCascades.GetSettings(); }
     void EnableAntiAliasing(bool enable);
+    // 實例化渲染：相同網格與材質的基本形狀剛體合併為一次繪製呼叫
+    void EnableInstancing(bool enable) { m_instancingEnabled = enable; }
+    bool IsInstancingEnabled() const { return m_instancingEnabled; }
+    // 視錐剔除：以動態 AABB 樹只送出與視錐相交的剛體
+    void EnableFrustumCulling(bool enable) { m_frustumCullingEnabled = enable; }
+    bool IsFrustumCullingEnabled() const { return m_frustumCullingEnabled; }
+    // 細節層級：依投影到螢幕上的大小選擇較粗糙的網格；bias 大於 1 時較晚切換
+    void EnableLod(bool enable);
+    bool IsLodEnabled() const { return m_lodEnabled; }
+    void SetLodBias(float bias) { m_lodBias = bias; }
+    // 剛體變換、形狀或可見性改變後以場景索引標記，下一影格只重新計算這些剛體的包圍盒
+    void MarkBodiesMoved(const std::vector<uint32_t>& bodies);
+    // 場景剛體增減或大量修改後呼叫，下一影格重新計算所有包圍盒與靜態投影物件
+    void InvalidateCulling();
 
     bool IsGridVisible() const { return m_showGrid; }
     bool IsAxesVisible() const { return m_showAxes; }
     bool IsLightingEnabled() const { return m_lightingEnabled; }
     bool AreShadowsEnabled() const { return m_shadowsEnabled; }
 
-    // 材質和紋理
+    // 材質和紋理：LoadTexture 在背景執行緒解碼並分批上傳，就緒前綁定佔位紋理
     void LoadTexture(const std::string& name, const std::string& filename);
     void UnloadTexture(const std::string& name);
     bool HasTexture(const std::string& name) const;
+    // 紋理記憶體超過預算時釋放最久未使用的紋理，再次使用時重新載入
+    void SetTextureMemoryBudget(size_t megabytes);
+    // 每影格在繪製前呼叫一次：收取解碼結果、上傳、依預算釋放
+    void UpdateTextureStreaming();
 
     // 除錯渲染
     void DrawLine(const glm::vec3& from, const glm::vec3& to, const glm::vec3& color = glm::vec3(1.0f));
@@ -97,17 +133,39 @@ public:
     // 統計資訊
     struct Statistics {
         int drawCalls = 0;
+        int instancedDrawCalls = 0;     // drawCalls 中的實例化繪製次數
+        int instancedObjects = 0;       // 以實例化繪製的剛體數
+        int shaderChanges = 0;          // 繪製佇列實際切換的狀態次數
+        int materialChanges = 0;
+        int textureChanges = 0;
+        int skippedStateChanges = 0;    // 排序後與前一項相同而省略的狀態設定
+        int visibleObjects = 0;         // 通過視錐剔除而送出繪製的剛體數
+        int culledObjects = 0;          // 被視錐剔除的剛體數
+        int lodReducedObjects = 0;      // 以 LOD 1 以後的網格繪製的物件數
         int triangleCount = 0;
         int vertexCount = 0;
         float renderTime = 0.0f;
         float shadowMapTime = 0.0f;
+        int staticShadowRebuilds = 0;   // 本影格重新繪製靜態深度快取的段落數
+        // 各 pass 的 GPU 時間（毫秒），為數個影格前的量測；不支援計時查詢時為 0
+        float gpuShadowTime = 0.0f;
+        float gpuOpaqueTime = 0.0f;
+        float gpuDebugTime = 0.0f;
+        float gpuUITime = 0.0f;
         int textureMemoryMB = 0;
         int bufferMemoryMB = 0;
+        float captureTime = 0.0f;       // 畫面擷取在渲染執行緒花費的時間（毫秒）
     };
     const Statistics& GetStatistics() const { return m_statistics; }
 
-    // 截圖功能
+    // 截圖與錄影：讀取以 PBO 非同步完成，檔案在數個影格後由背景執行緒寫出
     bool SaveScreenshot(const std::string& filename, int width = 0, int height = 0);
+    bool StartFrameCapture(const std::string& path, FrameCapture::Format format);
+    // 等待已擷取的影格寫完；需要 OpenGL 上下文
+    void StopFrameCapture();
+    bool IsCapturingFrames() const { return m_frameCapture.IsCapturingSequence(); }
+    // 每影格在繪製完成後、交換緩衝區前呼叫一次
+    void CaptureFrame();
 
 private:
     // 著色器管理
@@ -123,7 +181,37 @@ private:
         void Use();
         void Unuse();
 
-        // Uniform 設定
+        // 繪製迴圈使用的 uniform：程式連結後解析一次位置，之後以列舉索引存取
+        enum class Uniform : uint8_t {
+            Model,
+            View,
+            Projection,
+            ViewPosition,
+            LightingEnabled,
+            SpecularColor,
+            EmissiveColor,
+            Shininess,
+            LightSpaceMatrix,
+            ShadowMap,
+            Count
+        };
+
+        // uniform block 與固定的綁定點
+        enum class UniformBlock : uint8_t {
+            Frame,      // FrameData：相機與光照，每影格更新一次
+            Object,     // ObjectData：每次繪製的模型矩陣，由環狀緩衝區提供
+            Count
+        };
+
+        void SetBool(Uniform uniform, bool value);
+        void SetInt(Uniform uniform, int value);
+        void SetFloat(Uniform uniform, float value);
+        void SetVec3(Uniform uniform, const glm::vec3& value);
+        void SetMat4(Uniform uniform, const glm::mat4& value);
+        bool HasUniformBlock(UniformBlock block);
+        static GLuint GetBindingPoint(UniformBlock block) { return static_cast<GLuint>(block); }
+
+        // Uniform 設定（以名稱查詢，供初始化與不常用的 uniform 使用）
         void SetBool(const std::string& name, bool value);
         void SetInt(const std::string& name, int value);
         void SetFloat(const std::string& name, float value);
@@ -140,8 +228,15 @@ private:
         GLuint m_program;
         std::unordered_map<std::string, GLint> m_uniformLocations;
 
+        // 列舉 uniform 的位置與 uniform block 的有無；程式重新連結後自動重新解析
+        std::array<GLint, static_cast<size_t>(Uniform::Count)> m_cachedLocations{};
+        std::array<bool, static_cast<size_t>(UniformBlock::Count)> m_uniformBlocks{};
+        GLuint m_resolvedProgram = 0;
+
         GLuint CompileShader(const std::string& source, GLenum type);
         GLint GetUniformLocation(const std::string& name);
+        GLint GetUniformLocation(Uniform uniform);
+        void ResolveUniforms();
     };
 
     // 網格資料
@@ -207,6 +302,125 @@ private:
         void Cleanup();
     };
 
+    // 每個實例上傳到 GPU 的資料（頂點屬性 3-6 為模型矩陣，7 為顏色）
+    struct InstanceData {
+        glm::mat4 model;
+        glm::vec4 color;
+    };
+
+    // 除錯頂點：位置、顏色與點大小交錯存放（屬性 0-2）
+    struct DebugVertex {
+        glm::vec3 position;
+        uint32_t color;     // RGBA8，記憶體順序為 R、G、B、A
+        float size;         // 點的像素大小，線段不使用
+    };
+
+    // 除錯頂點的串流緩衝區，分成 RING_SEGMENTS 段輪流寫入並以 fence 確認 GPU 已讀完；
+    // 支援 ARB_buffer_storage 時整個緩衝區持續映射，否則每影格以不同步的 glMapBufferRange 映射該段
+    struct DebugStreamBuffer {
+        static constexpr int RING_SEGMENTS = 3;
+
+        GLuint vertexArray = 0;
+        GLuint buffer = 0;
+        size_t segmentCapacity = 0;     // 每段可容納的頂點數
+        int segment = 0;
+        bool persistent = false;
+        DebugVertex* mapped = nullptr;  // 持續映射時緩衝區的起點
+        GLsync fences[RING_SEGMENTS] = {};
+
+        ~DebugStreamBuffer() { Cleanup(); }
+        void Cleanup();
+        void WaitForFences();
+    };
+
+    // 同一網格與材質的實例；first 為本影格在實例緩衝區中的起始位置
+    struct InstanceGroup {
+        Mesh* mesh = nullptr;
+        std::string materialName;
+        std::vector<InstanceData> instances;
+        size_t first = 0;
+    };
+
+    // 跨影格重複使用的實例緩衝區，容量不足時倍增
+    struct InstanceBuffer {
+        GLuint buffer = 0;
+        size_t capacity = 0;    // 以實例數計
+
+        ~InstanceBuffer() { Cleanup(); }
+        void Cleanup();
+    };
+
+    // 串聯陰影貼圖：每段一層的深度紋理陣列，另存一份只有靜態物件的深度
+    struct CascadedShadowMap {
+        GLuint depthTexture = 0;        // 靜態快取 + 動態物件，供著色器取樣
+        GLuint staticDepthTexture = 0;  // 只有靜態物件
+        GLuint framebuffer = 0;         // 繪製目標
+        GLuint readFramebuffer = 0;     // 複製靜態深度時的來源
+        int resolution = 0;
+        size_t layers = 0;
+        uint32_t staticValidMask = 0;   // 靜態深度仍有效的段落
+        uint64_t staticSceneVersion = 0;    // 建立靜態深度時的 m_staticSceneVersion，不同時快取失效
+
+        ~CascadedShadowMap() { Cleanup(); }
+        void Cleanup();
+    };
+
+    // 基礎網格的細節層級：levels[i] 為 LOD i + 1
+    struct LodChain {
+        std::vector<std::unique_ptr<Mesh>> levels;
+        float radius = 1.0f;    // 基礎網格在模型空間的包圍球半徑
+
+        ~LodChain() { Cleanup(); }
+        void Cleanup();
+    };
+
+    // 將排序後的繪製佇列套用到 OpenGL 狀態（定義於 renderer.cpp）
+    struct QueueSubmitter;
+
+    // FrameData uniform block 的 std140 配置
+    struct FrameUniforms {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::mat4 viewProjection;
+        glm::vec4 viewPosition;
+        glm::vec4 lightDirection;
+        glm::vec4 lightColor;
+        glm::vec4 ambientColor;
+        glm::mat4 lightSpaceMatrices[ShadowCascades::MAX_CASCADES];
+        glm::vec4 cascadeSplits;        // 各段的遠端觀察深度
+        glm::vec4 cascadeTexelSizes;    // 各段一個像素的世界寬度，用於法向偏移
+        glm::vec4 shadowParams;         // x：是否啟用，y：段數
+    };
+
+    // ObjectData uniform block 的 std140 配置（法線矩陣以 mat4 存放以符合對齊）
+    struct ObjectUniforms {
+        glm::mat4 model;
+        glm::mat4 normalMatrix;
+        glm::vec4 color;
+    };
+
+    // 一次繪製：網格與其模型矩陣（複合形狀的每個子形狀各一個）
+    struct DrawPart {
+        const Mesh* mesh = nullptr;
+        glm::mat4 model;
+    };
+
+    // 每影格的 FrameData 與分成數段輪流使用的 ObjectData 緩衝區；
+    // 每段以 fence 確認 GPU 已讀完才覆寫
+    struct UniformBuffers {
+        static constexpr int RING_SEGMENTS = 3;
+
+        GLuint frameBuffer = 0;
+        GLuint objectBuffer = 0;
+        size_t objectStride = 0;        // ObjectUniforms 對齊到 GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+        size_t segmentCapacity = 0;     // 每段可容納的 ObjectUniforms 數
+        int segment = 0;
+        GLsync fences[RING_SEGMENTS] = {};
+
+        ~UniformBuffers() { Cleanup(); }
+        void Cleanup();
+    };
+
     // 核心資料
     Camera m_camera;
     int m_windowWidth;
@@ -231,10 +445,17 @@ private:
     std::unique_ptr<Shader> m_wireframeShader;
     std::unique_ptr<Shader> m_debugShader;
     std::unique_ptr<Shader> m_textShader;
+    std::unique_ptr<Shader> m_instancedShader;
 
     // 幾何資料
     std::unordered_map<std::string, std::unique_ptr<Mesh>> m_meshes;
     std::unordered_map<std::string, std::unique_ptr<Texture>> m_textures;
+    TextureStreamer m_textureStreamer;
+    uint64_t m_reportedTextureFailures = 0;
+
+    // 畫面擷取
+    FrameCapture m_frameCapture;
+    std::string m_reportedCaptureError;
     std::unordered_map<std::string, Material> m_materials;
 
     // 預建幾何
@@ -252,15 +473,76 @@ private:
     std::vector<std::unique_ptr<ShadowMap>> m_shadowMaps;
     glm::vec3 m_ambientLight;
 
+    // Uniform 緩衝區
+    bool m_uniformBuffersInitialized = false;
+    UniformBuffers m_uniformBuffers;
+
+    // 實例化渲染
+    bool m_instancingEnabled = true;
+    bool m_instancingInitialized = false;  // 已嘗試建立實例化著色器與緩衝區
+    InstanceBuffer m_instanceBuffer;
+    std::vector<InstanceGroup> m_instanceGroups;
+    std::unordered_map<const Mesh*, std::unordered_map<std::string, size_t>> m_instanceGroupLookup;
+    std::vector<InstanceData> m_instanceUploadData;
+
+    // 串聯陰影
+    ShadowCascades m_shadowCascades;
+    CascadedShadowMap m_cascadedShadowMap;
+    std::unique_ptr<Shader> m_cascadeDepthShader;
+    bool m_cascadeShadowsInitialized = false;   // 已嘗試建立陰影資源
+    bool m_cascadeShadowsActive = false;        // 本影格有方向光陰影可用
+    std::vector<uint32_t> m_shadowCasters;
+    std::vector<DrawPart> m_shadowParts;
+    std::vector<uint8_t> m_staticCasters;       // 依剛體索引，1 表示靜態投影物件
+    std::vector<uint32_t> m_staticCheckBodies;  // MarkBodiesMoved 標記、尚未重新判定的剛體
+    bool m_staticCastersDirty = true;           // 下次重新判定所有剛體
+    uint64_t m_staticSceneVersion = 0;          // 靜態投影物件增減、移動或修改時遞增
+
+    // 細節層級，以基礎網格查詢
+    bool m_lodEnabled = true;
+    bool m_lodInitialized = false;      // 已建立基本形狀的 LOD
+    float m_lodBias = 1.0f;
+    std::unordered_map<const Mesh*, LodChain> m_meshLods;
+
+    // 視錐剔除：物件索引即 scene.rigidBodies 的索引
+    struct CullingEntry {
+        PhysicsScene::Transform transform;  // 計算包圍盒時的變換與形狀雜湊，兩者皆未改變時不更新樹
+        uint64_t shapeKey = 0;
+        bool valid = false;
+        bool unbounded = false;             // 沒有包圍盒，列在 m_unboundedBodies
+    };
+    bool m_frustumCullingEnabled = true;
+    FrustumCuller m_frustumCuller;
+    std::vector<CullingEntry> m_cullingEntries;
+    std::vector<uint32_t> m_culledVisible;      // 樹中與視錐相交的剛體
+    std::vector<uint32_t> m_unboundedBodies;    // 沒有包圍盒（外部網格檔）而一律繪製的剛體，已排序
+    std::vector<uint32_t> m_movedBodies;        // MarkBodiesMoved 累積、尚未更新包圍盒的剛體
+    std::vector<uint32_t> m_drawList;           // 本影格要繪製的剛體，索引遞增
+
+    // 繪製佇列：物件索引對應 m_queuedBodies；材質與紋理以小整數 ID 放進排序鍵
+    RenderQueue m_renderQueue;
+    std::vector<const PhysicsScene::RigidBody*> m_queuedBodies;
+    std::vector<std::pair<uint32_t, uint32_t>> m_queuedPartRanges;  // 每個佇列物件在 m_drawParts 的 [first, count)
+    std::vector<DrawPart> m_drawParts;                                // 依提交順序排列
+    std::vector<uint8_t> m_objectUniformData;                         // 上傳用的暫存區，間距為 objectStride
+    std::unordered_map<std::string, uint16_t> m_materialIds;
+    std::vector<std::string> m_materialIdNames;
+    std::unordered_map<std::string, uint16_t> m_textureIds;
+    std::vector<std::string> m_textureIdNames;      // ID 0 保留給「沒有紋理」
+
+    // GPU 計時
+    GpuProfiler m_gpuProfiler;
+    bool m_gpuProfilerInitialized = false;  // 已嘗試建立查詢物件
+
     // 統計資訊
     mutable Statistics m_statistics;
 
-    // 除錯渲染
-    std::vector<glm::vec3> m_debugLines;
-    std::vector<glm::vec3> m_debugLineColors;
-    std::vector<glm::vec3> m_debugPoints;
-    std::vector<glm::vec3> m_debugPointColors;
-    std::vector<float> m_debugPointSizes;
+    // 除錯渲染：DrawLine/DrawPoint 只累積頂點，RenderDebugPrimitives 一次上傳後線與點各繪製一次
+    std::vector<DebugVertex> m_debugLineVertices;   // 每兩個頂點一條線段
+    std::vector<DebugVertex> m_debugPointVertices;
+    DebugStreamBuffer m_debugStream;
+    std::unique_ptr<Shader> m_debugBatchShader;
+    bool m_debugBatchInitialized = false;   // 已嘗試建立除錯著色器與緩衝區
 
     // 初始化函數
     bool InitializeShaders();
@@ -280,6 +562,10 @@ private:
     std::string GetWireframeFragmentShader();
     std::string GetDebugVertexShader();
     std::string GetDebugFragmentShader();
+    std::string GetInstancedVertexShader();
+    std::string GetInstancedFragmentShader();
+    std::string GetDebugBatchVertexShader();
+    std::string GetDebugBatchFragmentShader();
 
     // 幾何建立
     std::unique_ptr<Mesh> CreateBoxMesh(float width = 1.0f, float height = 1.0f, float depth = 1.0f);
@@ -305,12 +591,59 @@ private:
     void RenderScene(const PhysicsScene::PhysicsScene& scene);
     void RenderRigidBodies(const PhysicsScene::PhysicsScene& scene);
     void RenderRigidBody(const PhysicsScene::RigidBody& rigidBody, const std::string& materialName);
+    bool InitializeInstancing();
+    Mesh* GetShapeMesh(const PhysicsScene::GeometryShape& shape, glm::vec3& meshScale) const;
+    Mesh* GetInstanceMesh(const PhysicsScene::RigidBody& rigidBody, glm::vec3& meshScale) const;
+    void RenderInstanceGroups();
+    void QueueRigidBody(const PhysicsScene::RigidBody& rigidBody);
+    void SubmitRenderQueue();
+    void CollectDrawParts(const PhysicsScene::RigidBody& rigidBody, std::vector<DrawPart>& parts,
+                          bool shadowCaster = false) const;
+    void DrawQueuedParts(uint32_t object, Shader& shader);
+    void DrawMesh(const Mesh& mesh);
+    uint16_t GetMaterialId(const std::string& materialName);
+    uint16_t GetTextureId(const std::string& textureName);
+
+    // 串聯陰影
+    bool InitializeCascadedShadows();
+    void RenderCascadedShadows(const PhysicsScene::PhysicsScene& scene);
+    void DrawShadowCasters(const PhysicsScene::PhysicsScene& scene, bool staticCasters);
+    void UpdateStaticCasters(const PhysicsScene::PhysicsScene& scene);
+    const Light* GetShadowLight() const;
+    std::string GetCascadeDepthVertexShader();
+    std::string GetCascadeDepthFragmentShader();
+
+    // 細節層級
+    void InitializePrimitiveLods();
+    Mesh* AddMesh(const std::string& name, const MeshLod::MeshData& data);
+    void BuildMeshLods(const Mesh& mesh, const MeshLod::MeshData& source);
+    Mesh* SelectLod(Mesh* mesh, const glm::mat4& model) const;
+    Mesh* SelectShadowLod(Mesh* mesh) const;
+    float GetScreenSize(const glm::vec3& center, float radius) const;
+
+    // 視錐剔除
+    void BuildDrawList(const PhysicsScene::PhysicsScene& scene);
+    void UpdateCullingBounds(const PhysicsScene::PhysicsScene& scene);
+    bool UpdateCullingEntry(const PhysicsScene::RigidBody& rigidBody, uint32_t object);
+    static bool GetShapeBounds(const PhysicsScene::GeometryShape& shape, const glm::mat4& matrix,
+                               glm::vec3& aabbMin, glm::vec3& aabbMax);
+
+    // Uniform 緩衝區
+    bool InitializeUniformBuffers();
+    void UpdateFrameUniforms();
+    bool UploadObjectUniforms();
+    void GetMainLight(glm::vec3& direction, glm::vec3& color) const;
+
     void RenderConstraints(const PhysicsScene::PhysicsScene& scene);
     void RenderForceFields(const PhysicsScene::PhysicsScene& scene);
     void RenderLights(const PhysicsScene::PhysicsScene& scene);
     void RenderGrid();
     void RenderAxes();
     void RenderDebugElements();
+    // 繪製並清空本影格累積的除錯線段與點；由 RenderDebugElements 呼叫
+    void RenderDebugPrimitives();
+    bool InitializeDebugBatch();
+    bool AllocateDebugStream(size_t segmentCapacity);
 
     // 陰影渲染
     void RenderShadowMaps(const PhysicsScene::PhysicsScene& scene);
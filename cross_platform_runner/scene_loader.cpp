@@ -0,0 +1,1250 @@
+/**
+ * @file scene_loader.cpp
+ * @brief 物理場景載入器實現
+ */
+
+#include "scene_loader.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <tuple>
+
+// 工作執行緒池
+#include "worker_pool.h"
+
+using PhysicsScene::CompoundChild;
+using PhysicsScene::GeometryShape;
+using PhysicsScene::Quaternion;
+using PhysicsScene::RigidBody;
+using PhysicsScene::ShapeType;
+using PhysicsScene::Transform;
+using PhysicsScene::Vector3;
+
+namespace {
+
+Vector3 Add(const Vector3& a, const Vector3& b) { return Vector3(a.x + b.x, a.y + b.y, a.z + b.z); }
+Vector3 Sub(const Vector3& a, const Vector3& b) { return Vector3(a.x - b.x, a.y - b.y, a.z - b.z); }
+Vector3 Scale(const Vector3& a, float s) { return Vector3(a.x * s, a.y * s, a.z * s); }
+Vector3 Multiply(const Vector3& a, const Vector3& b) { return Vector3(a.x * b.x, a.y * b.y, a.z * b.z); }
+float Dot(const Vector3& a, const Vector3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+Vector3 Cross(const Vector3& a, const Vector3& b) {
+    return Vector3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+Quaternion Multiply(const Quaternion& a, const Quaternion& b) {
+    return Quaternion(a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+                      a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                      a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                      a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w);
+}
+
+Vector3 Rotate(const Quaternion& q, const Vector3& v) {
+    const Vector3 u(q.x, q.y, q.z);
+    const Vector3 t = Scale(Cross(u, v), 2.0f);
+    return Add(Add(v, Scale(t, q.w)), Cross(u, t));
+}
+
+// 子變換套用在父變換之後的世界變換；非均勻縮放與旋轉混合時只取近似
+Transform Compose(const Transform& parent, const Transform& child) {
+    Transform result;
+    result.position = Add(parent.position, Rotate(parent.rotation, Multiply(parent.scale, child.position)));
+    result.rotation = Multiply(parent.rotation, child.rotation);
+    result.scale = Multiply(parent.scale, child.scale);
+    return result;
+}
+
+float GetParameter(const GeometryShape& shape, const char* name, float fallback) {
+    auto it = shape.parameters.find(name);
+    return it != shape.parameters.end() ? it->second : fallback;
+}
+
+// 將縮放烘焙進形狀參數，合併後的子形狀變換只保留位置與旋轉；
+// 無法烘焙的形狀（外部網格檔案等）回傳 false，由呼叫端保留縮放
+bool BakeScale(GeometryShape& shape, const Vector3& scale) {
+    const Vector3 s(std::fabs(scale.x), std::fabs(scale.y), std::fabs(scale.z));
+    if (s.x == 1.0f && s.y == 1.0f && s.z == 1.0f) return true;
+
+    switch (shape.type) {
+    case ShapeType::Box:
+        shape.parameters["width"] = GetParameter(shape, "width", 1.0f) * s.x;
+        shape.parameters["height"] = GetParameter(shape, "height", 1.0f) * s.y;
+        shape.parameters["depth"] = GetParameter(shape, "depth", 1.0f) * s.z;
+        break;
+    case ShapeType::Sphere:
+        shape.parameters["radius"] = GetParameter(shape, "radius", 0.5f) * std::max({s.x, s.y, s.z});
+        break;
+    case ShapeType::Cylinder:
+    case ShapeType::Capsule:
+    case ShapeType::Cone:
+        shape.parameters["radius"] = GetParameter(shape, "radius", 0.5f) * std::max(s.x, s.z);
+        shape.parameters["height"] = GetParameter(shape, "height", 1.0f) * s.y;
+        break;
+    case ShapeType::ConvexHull:
+    case ShapeType::TriangleMesh:
+        if (!shape.meshFile.empty() || shape.vertices.empty()) return false;
+        for (Vector3& vertex : shape.vertices) {
+            vertex = Multiply(vertex, scale);
+        }
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+// 可烘焙進三角網格的形狀：方塊與內嵌頂點的三角網格
+bool IsTriangulable(const RigidBody& body) {
+    const GeometryShape& shape = body.collisionShape;
+    if (shape.type == ShapeType::Box) return true;
+    return shape.type == ShapeType::TriangleMesh && shape.meshFile.empty() &&
+           !shape.vertices.empty() && !shape.triangles.empty();
+}
+
+// 形狀局部空間的三角形；方塊的法向朝外
+void Triangulate(const GeometryShape& shape, std::vector<Vector3>& vertices, std::vector<std::array<int, 3>>& triangles) {
+    if (shape.type == ShapeType::TriangleMesh) {
+        vertices = shape.vertices;
+        triangles = shape.triangles;
+        return;
+    }
+
+    const Vector3 half(GetParameter(shape, "width", 1.0f) * 0.5f,
+                       GetParameter(shape, "height", 1.0f) * 0.5f,
+                       GetParameter(shape, "depth", 1.0f) * 0.5f);
+    vertices.clear();
+    for (int corner = 0; corner < 8; ++corner) {
+        vertices.emplace_back((corner & 1) ? half.x : -half.x,
+                              (corner & 2) ? half.y : -half.y,
+                              (corner & 4) ? half.z : -half.z);
+    }
+
+    // 每個面以四個角點組成兩個三角形，再依面法向修正繞序
+    static const int faces[6][4] = {
+        {0, 2, 6, 4}, {1, 3, 7, 5}, {0, 1, 5, 4}, {2, 3, 7, 6}, {0, 1, 3, 2}, {4, 5, 7, 6}
+    };
+    static const float normals[6][3] = {
+        {-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}
+    };
+    triangles.clear();
+    for (int face = 0; face < 6; ++face) {
+        const Vector3 normal(normals[face][0], normals[face][1], normals[face][2]);
+        const int* quad = faces[face];
+        for (const std::array<int, 3>& triangle : {std::array<int, 3>{quad[0], quad[1], quad[2]},
+                                                    std::array<int, 3>{quad[0], quad[2], quad[3]}}) {
+            const Vector3& a = vertices[triangle[0]];
+            const Vector3 n = Cross(Sub(vertices[triangle[1]], a), Sub(vertices[triangle[2]], a));
+            if (Dot(n, normal) >= 0.0f) {
+                triangles.push_back(triangle);
+            } else {
+                triangles.push_back({triangle[0], triangle[2], triangle[1]});
+            }
+        }
+    }
+}
+
+// 以 tolerance 為格距量化頂點並焊接；回傳頂點索引
+class VertexWelder {
+public:
+    VertexWelder(std::vector<Vector3>& vertices, float tolerance)
+        : m_vertices(vertices), m_tolerance(tolerance) {}
+
+    int Add(const Vector3& vertex) {
+        if (m_tolerance <= 0.0f) {
+            m_vertices.push_back(vertex);
+            return static_cast<int>(m_vertices.size()) - 1;
+        }
+
+        const std::array<int64_t, 3> key = {
+            static_cast<int64_t>(std::llround(vertex.x / m_tolerance)),
+            static_cast<int64_t>(std::llround(vertex.y / m_tolerance)),
+            static_cast<int64_t>(std::llround(vertex.z / m_tolerance))
+        };
+        auto it = m_lookup.find(key);
+        if (it != m_lookup.end()) return it->second;
+
+        const int index = static_cast<int>(m_vertices.size());
+        m_vertices.push_back(vertex);
+        m_lookup.emplace(key, index);
+        return index;
+    }
+
+private:
+    std::vector<Vector3>& m_vertices;
+    float m_tolerance;
+    std::map<std::array<int64_t, 3>, int> m_lookup;
+};
+
+// 合併分組鍵：材質、碰撞與渲染屬性都相同，且位於同一個空間格子
+using MergeKey = std::tuple<std::string, std::string, int, int, int, bool, int, int, int>;
+
+MergeKey MakeMergeKey(const RigidBody& body, bool triangleMesh, float cellSize) {
+    const int renderFlags = (body.visible ? 1 : 0) | (body.castShadows ? 2 : 0) | (body.receiveShadows ? 4 : 0);
+    const Vector3& p = body.transform.position;
+    return MergeKey(body.physicsMaterial, body.visualMaterial, body.collisionGroup, body.collisionMask,
+                    renderFlags, triangleMesh,
+                    static_cast<int>(std::floor(p.x / cellSize)),
+                    static_cast<int>(std::floor(p.y / cellSize)),
+                    static_cast<int>(std::floor(p.z / cellSize)));
+}
+
+std::string MakeUniqueName(const std::string& base, std::set<std::string>& usedNames) {
+    for (int suffix = 0;; ++suffix) {
+        std::string name = base + "_" + std::to_string(suffix);
+        if (usedNames.insert(name).second) return name;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 串流解析
+// ---------------------------------------------------------------------------
+
+using Json = nlohmann::json;
+
+/**
+ * @brief 建立 JSON 節點的 SAX 處理器
+ *
+ * 根物件中 keepSection 回傳 false 的區段只追蹤巢狀深度直到區段結束，
+ * 不配置任何節點；其餘部分與 nlohmann::json::parse 的結果相同。
+ */
+class SectionFilteringDomBuilder : public nlohmann::json_sax<Json> {
+public:
+    using SectionPredicate = std::function<bool(const std::string&)>;
+
+    SectionFilteringDomBuilder(Json& root, SectionPredicate keepSection)
+        : m_root(root), m_keepSection(std::move(keepSection)) {}
+
+    bool null() override { return AddValue(Json(nullptr)); }
+    bool boolean(bool value) override { return AddValue(Json(value)); }
+    bool number_integer(number_integer_t value) override { return AddValue(Json(value)); }
+    bool number_unsigned(number_unsigned_t value) override { return AddValue(Json(value)); }
+    bool number_float(number_float_t value, const string_t&) override { return AddValue(Json(value)); }
+    bool string(string_t& value) override { return AddValue(Json(std::move(value))); }
+    bool binary(binary_t& value) override { return AddValue(Json(std::move(value))); }
+
+    bool start_object(std::size_t) override { return StartContainer(Json::object()); }
+    bool start_array(std::size_t) override { return StartContainer(Json::array()); }
+    bool end_object() override { return EndContainer(); }
+    bool end_array() override { return EndContainer(); }
+
+    bool key(string_t& key) override {
+        if (m_skipDepth > 0) return true;
+        if (m_stack.size() == 1 && !m_keepSection(key)) {
+            m_skipNext = true;
+            return true;
+        }
+        m_key = std::move(key);
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const Json::exception& error) override {
+        m_error = error.what();
+        return false;
+    }
+
+    const std::string& GetError() const { return m_error; }
+
+private:
+    // 略過中的區段內，或略過區段本身是純量
+    bool ConsumeSkipped() {
+        if (m_skipDepth > 0) return true;
+        if (m_skipNext) {
+            m_skipNext = false;
+            return true;
+        }
+        return false;
+    }
+
+    bool AddValue(Json&& value) {
+        if (!ConsumeSkipped()) Insert(std::move(value));
+        return true;
+    }
+
+    bool StartContainer(Json&& container) {
+        if (m_skipDepth > 0 || m_skipNext) {
+            m_skipNext = false;
+            ++m_skipDepth;
+            return true;
+        }
+        m_stack.push_back(Insert(std::move(container)));
+        return true;
+    }
+
+    bool EndContainer() {
+        if (m_skipDepth > 0) {
+            --m_skipDepth;
+        } else {
+            m_stack.pop_back();
+        }
+        return true;
+    }
+
+    // 父容器只在子容器結束後才會再新增元素，堆疊中的指標因此保持有效
+    Json* Insert(Json&& value) {
+        if (m_stack.empty()) {
+            m_root = std::move(value);
+            return &m_root;
+        }
+        Json& parent = *m_stack.back();
+        if (parent.is_array()) {
+            parent.push_back(std::move(value));
+            return &parent.back();
+        }
+        Json& slot = parent[m_key];
+        slot = std::move(value);
+        return &slot;
+    }
+
+    Json& m_root;
+    SectionPredicate m_keepSection;
+    std::vector<Json*> m_stack;
+    std::string m_key;
+    std::string m_error;
+    size_t m_skipDepth = 0;
+    bool m_skipNext = false;
+};
+
+// 場景檔案掃描結果：頂層區段的元素數、元資料與剛體摘要
+struct SceneSummary {
+    struct Body {
+        float mass = RigidBody().mass;
+        std::string physicsMaterial = "Default";
+        Vector3 position;
+    };
+
+    std::map<std::string, int> sectionCounts;
+    std::map<std::string, std::string> metadata;
+    std::array<int, 3> formatVersion = {-1, -1, -1};
+
+    // 只在 collectDetails 時收集
+    std::vector<Body> bodies;
+    std::map<std::string, std::pair<bool, bool>> materialFlags;   // isStatic, isKinematic
+    std::set<std::string> textures;
+
+    int Count(const std::string& section) const {
+        auto it = sectionCounts.find(section);
+        return it != sectionCounts.end() ? it->second : 0;
+    }
+
+    std::string GetMetadata(const std::string& key) const {
+        auto it = metadata.find(key);
+        return it != metadata.end() ? it->second : std::string();
+    }
+};
+
+/**
+ * @brief 只收集摘要的 SAX 處理器
+ *
+ * 不建立任何 JSON 節點；以框架堆疊記錄目前位置（頂層區段、剛體、
+ * transform.position 等），只在需要的位置保存數值。
+ */
+class SceneSummaryHandler : public nlohmann::json_sax<Json> {
+public:
+    SceneSummaryHandler(SceneSummary& summary, bool collectDetails)
+        : m_summary(summary), m_collectDetails(collectDetails) {}
+
+    bool null() override { BeginValue(); return true; }
+    bool boolean(bool value) override {
+        BeginValue();
+        if (m_collectDetails && m_frames.size() == 3 && m_frames[1].name == "physicsMaterials") {
+            auto& flags = m_summary.materialFlags[m_frames[2].name];
+            if (m_key == "isStatic") flags.first = value;
+            if (m_key == "isKinematic") flags.second = value;
+        }
+        return true;
+    }
+    bool number_integer(number_integer_t value) override { return Number(static_cast<double>(value)); }
+    bool number_unsigned(number_unsigned_t value) override { return Number(static_cast<double>(value)); }
+    bool number_float(number_float_t value, const string_t&) override { return Number(value); }
+    bool binary(binary_t&) override { BeginValue(); return true; }
+
+    bool string(string_t& value) override {
+        BeginValue();
+        if (m_frames.size() == 2 && m_frames[1].name == "metadata") {
+            m_summary.metadata[m_key] = value;
+        } else if (m_collectDetails && m_frames.size() == 3) {
+            if (m_frames[1].name == "rigidBodies" && m_key == "physicsMaterial") {
+                m_summary.bodies.back().physicsMaterial = value;
+            } else if (m_frames[1].name == "visualMaterials" && !value.empty() && m_key.size() > 7 &&
+                       m_key.compare(m_key.size() - 7, 7, "Texture") == 0) {
+                m_summary.textures.insert(value);
+            }
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) override { return StartContainer(false); }
+    bool start_array(std::size_t) override { return StartContainer(true); }
+    bool end_object() override { m_frames.pop_back(); return true; }
+    bool end_array() override { m_frames.pop_back(); return true; }
+
+    bool key(string_t& key) override {
+        m_key = key;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const Json::exception& error) override {
+        m_error = error.what();
+        return false;
+    }
+
+    const std::string& GetError() const { return m_error; }
+
+private:
+    struct Frame {
+        std::string name;   // 物件成員的鍵；陣列元素為空字串
+        bool array = false;
+        int count = 0;      // 已出現的元素數
+    };
+
+    // 回傳值在父陣列中的索引（父層為物件時為 -1），並累計頂層區段的元素數
+    int BeginValue() {
+        if (m_frames.empty()) return -1;
+        if (m_frames.size() == 2) ++m_summary.sectionCounts[m_frames[1].name];
+        Frame& parent = m_frames.back();
+        const int index = parent.array ? parent.count : -1;
+        ++parent.count;
+        return index;
+    }
+
+    bool StartContainer(bool array) {
+        const bool parentIsArray = !m_frames.empty() && m_frames.back().array;
+        BeginValue();
+        m_frames.push_back(Frame{parentIsArray ? std::string() : m_key, array, 0});
+        if (m_collectDetails && !array && m_frames.size() == 3 && m_frames[1].name == "rigidBodies") {
+            m_summary.bodies.emplace_back();
+        }
+        return true;
+    }
+
+    bool Number(double value) {
+        const int index = BeginValue();
+        const size_t depth = m_frames.size();
+        if (depth == 2 && m_frames[1].name == "formatVersion") {
+            if (m_key == "major") m_summary.formatVersion[0] = static_cast<int>(value);
+            if (m_key == "minor") m_summary.formatVersion[1] = static_cast<int>(value);
+            if (m_key == "patch") m_summary.formatVersion[2] = static_cast<int>(value);
+        }
+        if (!m_collectDetails || depth < 3 || m_frames[1].name != "rigidBodies") return true;
+
+        if (depth == 3 && m_key == "mass") {
+            m_summary.bodies.back().mass = static_cast<float>(value);
+        } else if (depth == 5 && m_frames[3].name == "transform" && m_frames[4].name == "position") {
+            Vector3& position = m_summary.bodies.back().position;
+            if (index == 0) position.x = static_cast<float>(value);
+            if (index == 1) position.y = static_cast<float>(value);
+            if (index == 2) position.z = static_cast<float>(value);
+        }
+        return true;
+    }
+
+    SceneSummary& m_summary;
+    bool m_collectDetails;
+    std::vector<Frame> m_frames;
+    std::string m_key;
+    std::string m_error;
+};
+
+bool ScanSceneFile(const std::string& filename, bool collectDetails, SceneSummary& summary, std::string& error) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        error = "Cannot open scene file: " + filename;
+        return false;
+    }
+
+    SceneSummaryHandler handler(summary, collectDetails);
+    if (!Json::sax_parse(file, &handler)) {
+        error = "Failed to parse " + filename + ": " + handler.GetError();
+        return false;
+    }
+    return true;
+}
+
+// 場景統計的剛體累計，AnalyzeScene 與 AnalyzeSceneFile 共用
+void AccumulateBody(SceneLoader::SceneStatistics& statistics, float mass, bool isStatic, bool isKinematic,
+                    const Vector3& position) {
+    if (statistics.rigidBodies == 0) {
+        statistics.boundingBoxMin = position;
+        statistics.boundingBoxMax = position;
+    } else {
+        statistics.boundingBoxMin = Vector3(std::min(statistics.boundingBoxMin.x, position.x),
+                                            std::min(statistics.boundingBoxMin.y, position.y),
+                                            std::min(statistics.boundingBoxMin.z, position.z));
+        statistics.boundingBoxMax = Vector3(std::max(statistics.boundingBoxMax.x, position.x),
+                                            std::max(statistics.boundingBoxMax.y, position.y),
+                                            std::max(statistics.boundingBoxMax.z, position.z));
+    }
+    ++statistics.rigidBodies;
+
+    if (isKinematic) {
+        ++statistics.kinematicBodies;
+    } else if (isStatic || mass <= 0.0f) {
+        ++statistics.staticBodies;
+    } else {
+        statistics.totalMass += mass;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief 最佳化場景
+ *
+ * 依序合併重複材質、最佳化碰撞網格、合併靜態剛體、移除未使用的材質。
+ * 網格先於合併處理，合併烘焙出的大網格不再被簡化。紋理壓縮不在此處理。
+ */
+bool SceneLoader::OptimizeScene(PhysicsScene::PhysicsScene& scene, const OptimizationOptions& options) {
+    m_optimizationResult = OptimizationResult();
+
+    if (options.removeDuplicateMaterials) {
+        RemoveDuplicateMaterials(scene);
+    }
+    if (options.optimizeMeshes) {
+        OptimizeMeshes(scene, options);
+    }
+    if (options.mergeStaticBodies) {
+        MergeStaticBodies(scene, options);
+    }
+    if (options.removeUnusedMaterials) {
+        RemoveUnusedMaterials(scene);
+    }
+    return true;
+}
+
+/**
+ * @brief 將屬性完全相同的物理材質合併到 "Default"（在同一組時）或名稱排序最前者
+ */
+void SceneLoader::RemoveDuplicateMaterials(PhysicsScene::PhysicsScene& scene) {
+    auto sameProperties = [](const PhysicsScene::PhysicsMaterial& a, const PhysicsScene::PhysicsMaterial& b) {
+        return a.density == b.density && a.friction == b.friction && a.restitution == b.restitution &&
+               a.rollingFriction == b.rollingFriction && a.spinningFriction == b.spinningFriction &&
+               a.contactDamping == b.contactDamping && a.contactStiffness == b.contactStiffness &&
+               a.isKinematic == b.isKinematic && a.isStatic == b.isStatic;
+    };
+
+    // 預設材質先當保留者：RemoveUnusedMaterials 依賴 "Default" 永遠存在
+    using MaterialIterator = decltype(scene.physicsMaterials)::const_iterator;
+    std::vector<MaterialIterator> candidates;
+    candidates.reserve(scene.physicsMaterials.size());
+    MaterialIterator defaultMaterial = scene.physicsMaterials.find("Default");
+    if (defaultMaterial != scene.physicsMaterials.end()) {
+        candidates.push_back(defaultMaterial);
+    }
+    for (auto it = scene.physicsMaterials.cbegin(); it != scene.physicsMaterials.cend(); ++it) {
+        if (it != defaultMaterial) candidates.push_back(it);
+    }
+
+    std::map<std::string, std::string> replacements;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (replacements.count(candidates[i]->first)) continue;
+        for (size_t j = i + 1; j < candidates.size(); ++j) {
+            if (!replacements.count(candidates[j]->first) && sameProperties(candidates[i]->second, candidates[j]->second)) {
+                replacements[candidates[j]->first] = candidates[i]->first;
+            }
+        }
+    }
+    if (replacements.empty()) return;
+
+    for (RigidBody& body : scene.rigidBodies) {
+        auto it = replacements.find(body.physicsMaterial);
+        if (it != replacements.end()) body.physicsMaterial = it->second;
+    }
+    for (const auto& [name, replacement] : replacements) {
+        scene.physicsMaterials.erase(name);
+        ++m_optimizationResult.removedMaterialCount;
+    }
+}
+
+/**
+ * @brief 移除沒有剛體引用的材質；預設材質永遠保留
+ */
+void SceneLoader::RemoveUnusedMaterials(PhysicsScene::PhysicsScene& scene) {
+    std::set<std::string> usedPhysics = {"Default"};
+    std::set<std::string> usedVisual = {"Default"};
+    for (const RigidBody& body : scene.rigidBodies) {
+        usedPhysics.insert(body.physicsMaterial);
+        usedVisual.insert(body.visualMaterial);
+    }
+
+    for (auto it = scene.physicsMaterials.begin(); it != scene.physicsMaterials.end();) {
+        if (usedPhysics.count(it->first)) {
+            ++it;
+        } else {
+            it = scene.physicsMaterials.erase(it);
+            ++m_optimizationResult.removedMaterialCount;
+        }
+    }
+    for (auto it = scene.visualMaterials.begin(); it != scene.visualMaterials.end();) {
+        if (usedVisual.count(it->first)) {
+            ++it;
+        } else {
+            it = scene.visualMaterials.erase(it);
+            ++m_optimizationResult.removedMaterialCount;
+        }
+    }
+}
+
+/**
+ * @brief 最佳化碰撞網格
+ *
+ * 所有內嵌三角網格（含複合形狀的子形狀）先焊接頂點、移除退化三角形並
+ * 簡化到 maxMeshTriangles；動態剛體的三角網格再分解成凸包，只有一個凸包
+ * 時直接改為 ConvexHull，否則改為複合形狀。
+ */
+void SceneLoader::OptimizeMeshes(PhysicsScene::PhysicsScene& scene, const OptimizationOptions& options) {
+    auto isInlineMesh = [](const GeometryShape& shape) {
+        return shape.type == ShapeType::TriangleMesh && shape.meshFile.empty() && !shape.vertices.empty();
+    };
+    auto decompose = [&](const GeometryShape& shape) {
+        MeshOptimizer::Mesh mesh{shape.vertices, shape.triangles};
+        std::vector<GeometryShape> hulls;
+        for (std::vector<Vector3>& vertices : MeshOptimizer::DecomposeConvex(mesh, options.decomposition)) {
+            GeometryShape hull(ShapeType::ConvexHull);
+            hull.vertices = std::move(vertices);
+            hulls.push_back(std::move(hull));
+        }
+        m_optimizationResult.convexHullCount += static_cast<int>(hulls.size());
+        return hulls;
+    };
+
+    for (RigidBody& body : scene.rigidBodies) {
+        for (CompoundChild& child : body.compoundChildren) {
+            OptimizeMesh(child.shape, options);
+        }
+        OptimizeMesh(body.collisionShape, options);
+
+        const PhysicsScene::PhysicsMaterial* material = scene.findPhysicsMaterial(body.physicsMaterial);
+        const bool dynamic = body.mass > 0.0f && !(material && (material->isStatic || material->isKinematic));
+        if (!options.decomposeDynamicMeshes || !dynamic) continue;
+
+        bool decomposed = false;
+        if (body.collisionShape.type == ShapeType::Compound) {
+            std::vector<CompoundChild> children;
+            for (const CompoundChild& child : body.compoundChildren) {
+                std::vector<GeometryShape> hulls;
+                if (isInlineMesh(child.shape)) hulls = decompose(child.shape);
+                if (hulls.empty()) {
+                    children.push_back(child);
+                    continue;
+                }
+                for (GeometryShape& hull : hulls) {
+                    children.emplace_back(hull, child.localTransform);
+                }
+                decomposed = true;
+            }
+            body.compoundChildren = std::move(children);
+        } else if (isInlineMesh(body.collisionShape)) {
+            std::vector<GeometryShape> hulls = decompose(body.collisionShape);
+            if (hulls.size() == 1) {
+                body.collisionShape = std::move(hulls.front());
+                decomposed = true;
+            } else if (!hulls.empty()) {
+                body.collisionShape = GeometryShape(ShapeType::Compound);
+                body.compoundChildren.clear();
+                for (GeometryShape& hull : hulls) {
+                    body.compoundChildren.emplace_back(hull, Transform());
+                }
+                decomposed = true;
+            }
+        }
+        if (decomposed) ++m_optimizationResult.decomposedBodyCount;
+    }
+}
+
+void SceneLoader::OptimizeMesh(PhysicsScene::GeometryShape& shape, const OptimizationOptions& options) {
+    if (shape.type != ShapeType::TriangleMesh || !shape.meshFile.empty() || shape.vertices.empty()) return;
+
+    MeshOptimizer::Mesh mesh{std::move(shape.vertices), std::move(shape.triangles)};
+    const size_t originalTriangles = mesh.triangles.size();
+
+    MeshOptimizer::WeldVertices(mesh, options.mergeTolerance);
+    MeshOptimizer::RemoveDegenerateTriangles(mesh);
+    if (options.maxMeshTriangles > 0) {
+        MeshOptimizer::Decimate(mesh, static_cast<size_t>(options.maxMeshTriangles));
+    }
+
+    m_optimizationResult.removedTriangleCount += static_cast<int>(originalTriangles - mesh.triangles.size());
+    ++m_optimizationResult.optimizedMeshCount;
+    shape.vertices = std::move(mesh.vertices);
+    shape.triangles = std::move(mesh.triangles);
+}
+
+/**
+ * @brief 可合併的靜態剛體：質量為 0 或使用靜態材質、沒有初速、不是觸發器，
+ * 且形狀有限大小（平面與高度場維持獨立）
+ */
+bool SceneLoader::IsMergeableStaticBody(const PhysicsScene::PhysicsScene& scene,
+                                        const PhysicsScene::RigidBody& rigidBody) const {
+    const PhysicsScene::PhysicsMaterial* material = scene.findPhysicsMaterial(rigidBody.physicsMaterial);
+    const bool isStatic = rigidBody.mass <= 0.0f || (material && material->isStatic);
+    if (!isStatic || (material && material->isKinematic) || rigidBody.isTrigger) return false;
+
+    const Vector3 zero;
+    if (!(rigidBody.linearVelocity == zero) || !(rigidBody.angularVelocity == zero)) return false;
+
+    const ShapeType type = rigidBody.collisionShape.type;
+    return type != ShapeType::Plane && type != ShapeType::HeightField;
+}
+
+/**
+ * @brief 合併靜態剛體
+ *
+ * 靜態剛體依材質、碰撞群組與渲染屬性分組，再以 mergeCellSize 的格子做空間
+ * 分群，每群（最多 maxBodiesPerMerge 個）合併成一個剛體：預設為複合形狀，
+ * 子形狀保留原本的變換；mergeIntoTriangleMesh 時方塊與三角網格烘焙成一個
+ * 三角網格並以 mergeTolerance 焊接頂點。合併後的原點為成員位置的平均值，
+ * 使寬相位代理與繪製呼叫從每個物件一個降為每群一個。被約束引用的剛體
+ * 不合併，只有一個成員的群保持原樣。
+ */
+void SceneLoader::MergeStaticBodies(PhysicsScene::PhysicsScene& scene, const OptimizationOptions& options) {
+    const float cellSize = options.mergeCellSize > 0.0f ? options.mergeCellSize : 16.0f;
+    const size_t maxMembers = static_cast<size_t>(std::max(options.maxBodiesPerMerge, 2));
+
+    std::set<std::string> constrainedBodies;
+    for (const auto& constraint : scene.constraints) {
+        constrainedBodies.insert(constraint.bodyA);
+        constrainedBodies.insert(constraint.bodyB);
+    }
+
+    std::map<MergeKey, std::vector<size_t>> groups;
+    std::set<std::string> usedNames;
+    for (size_t i = 0; i < scene.rigidBodies.size(); ++i) {
+        const RigidBody& body = scene.rigidBodies[i];
+        usedNames.insert(body.name);
+        if (constrainedBodies.count(body.name) || !IsMergeableStaticBody(scene, body)) continue;
+
+        const bool triangleMesh = options.mergeIntoTriangleMesh && IsTriangulable(body);
+        groups[MakeMergeKey(body, triangleMesh, cellSize)].push_back(i);
+    }
+
+    std::vector<bool> merged(scene.rigidBodies.size(), false);
+    std::vector<RigidBody> mergedBodies;
+
+    for (const auto& [key, members] : groups) {
+        const bool triangleMesh = std::get<5>(key);
+
+        for (size_t first = 0; first + 1 < members.size(); first += maxMembers) {
+            const size_t last = std::min(first + maxMembers, members.size());
+            if (last - first < 2) break;
+
+            Vector3 origin;
+            for (size_t m = first; m < last; ++m) {
+                origin = Add(origin, scene.rigidBodies[members[m]].transform.position);
+            }
+            origin = Scale(origin, 1.0f / static_cast<float>(last - first));
+
+            const RigidBody& prototype = scene.rigidBodies[members[first]];
+            RigidBody result;
+            result.name = MakeUniqueName("MergedStatic_" + prototype.physicsMaterial, usedNames);
+            result.transform.position = origin;
+            result.mass = 0.0f;
+            result.physicsMaterial = prototype.physicsMaterial;
+            result.visualMaterial = prototype.visualMaterial;
+            result.collisionGroup = prototype.collisionGroup;
+            result.collisionMask = prototype.collisionMask;
+            result.visible = prototype.visible;
+            result.castShadows = prototype.castShadows;
+            result.receiveShadows = prototype.receiveShadows;
+
+            if (triangleMesh) {
+                result.collisionShape = GeometryShape(ShapeType::TriangleMesh);
+                VertexWelder welder(result.collisionShape.vertices, options.mergeTolerance);
+                std::vector<Vector3> localVertices;
+                std::vector<std::array<int, 3>> localTriangles;
+                std::vector<int> remap;
+
+                for (size_t m = first; m < last; ++m) {
+                    const RigidBody& body = scene.rigidBodies[members[m]];
+                    GeometryShape shape = body.collisionShape;
+                    BakeScale(shape, body.transform.scale);
+                    Triangulate(shape, localVertices, localTriangles);
+
+                    remap.resize(localVertices.size());
+                    for (size_t v = 0; v < localVertices.size(); ++v) {
+                        const Vector3 world = Add(body.transform.position, Rotate(body.transform.rotation, localVertices[v]));
+                        remap[v] = welder.Add(Sub(world, origin));
+                    }
+                    for (const std::array<int, 3>& triangle : localTriangles) {
+                        const std::array<int, 3> welded = {remap[triangle[0]], remap[triangle[1]], remap[triangle[2]]};
+                        // 焊接後退化的三角形捨棄
+                        if (welded[0] == welded[1] || welded[1] == welded[2] || welded[0] == welded[2]) continue;
+                        result.collisionShape.triangles.push_back(welded);
+                    }
+                }
+            } else {
+                result.collisionShape = GeometryShape(ShapeType::Compound);
+                for (size_t m = first; m < last; ++m) {
+                    const RigidBody& body = scene.rigidBodies[members[m]];
+
+                    auto addChild = [&](const GeometryShape& shape, const Transform& world) {
+                        CompoundChild child(shape, Transform());
+                        if (!BakeScale(child.shape, world.scale)) {
+                            child.localTransform.scale = world.scale;
+                        }
+                        child.localTransform.position = Sub(world.position, origin);
+                        child.localTransform.rotation = world.rotation;
+                        result.compoundChildren.push_back(child);
+                    };
+
+                    if (body.collisionShape.type == ShapeType::Compound) {
+                        for (const CompoundChild& child : body.compoundChildren) {
+                            addChild(child.shape, Compose(body.transform, child.localTransform));
+                        }
+                    } else {
+                        addChild(body.collisionShape, body.transform);
+                    }
+                }
+            }
+
+            for (size_t m = first; m < last; ++m) {
+                merged[members[m]] = true;
+            }
+            m_optimizationResult.mergedBodyCount += static_cast<int>(last - first);
+            ++m_optimizationResult.createdBodyCount;
+            mergedBodies.push_back(std::move(result));
+        }
+    }
+
+    if (mergedBodies.empty()) return;
+
+    // 保留未合併剛體的原始順序，合併結果附加在最後
+    std::vector<RigidBody> remaining;
+    remaining.reserve(scene.rigidBodies.size() - m_optimizationResult.mergedBodyCount + mergedBodies.size());
+    for (size_t i = 0; i < scene.rigidBodies.size(); ++i) {
+        if (!merged[i]) remaining.push_back(std::move(scene.rigidBodies[i]));
+    }
+    for (RigidBody& body : mergedBodies) {
+        remaining.push_back(std::move(body));
+    }
+    scene.rigidBodies = std::move(remaining);
+}
+
+/**
+ * @brief 批次驗證場景檔案
+ */
+SceneLoader::BatchResult SceneLoader::ValidateSceneFiles(const std::vector<std::string>& filenames) {
+    return RunBatch(filenames, "Validating", [&filenames](SceneLoader& loader, size_t index) {
+        ValidationResult validation = loader.ValidateSceneFile(filenames[index]);
+        if (validation.isValid) return std::string();
+
+        std::string error;
+        for (const std::string& message : validation.errors) {
+            if (!error.empty()) error += "; ";
+            error += message;
+        }
+        return error.empty() ? std::string("Validation failed") : error;
+    });
+}
+
+/**
+ * @brief 批次轉換場景檔案
+ *
+ * 輸出檔名為輸入檔名（不含副檔名）加上 targetFormat；不同目錄下同名的
+ * 輸入會寫到同一個輸出，只有第一個會被轉換，其餘記為失敗。
+ */
+SceneLoader::BatchResult SceneLoader::ConvertSceneFiles(const std::vector<std::string>& filenames,
+                                                        const std::string& outputDirectory,
+                                                        const std::string& targetFormat) {
+    std::vector<std::string> outputFiles(filenames.size());
+    std::map<std::string, size_t> firstWriter;
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        const std::filesystem::path stem = std::filesystem::path(filenames[i]).stem();
+        outputFiles[i] = (std::filesystem::path(outputDirectory) / stem).string() + targetFormat;
+        firstWriter.emplace(outputFiles[i], i);
+    }
+
+    const bool supported = IsSceneFileExtension(targetFormat);
+    return RunBatch(filenames, "Converting", [&](SceneLoader& loader, size_t index) {
+        if (!supported) return "Unsupported target format: " + targetFormat;
+        const size_t writer = firstWriter.find(outputFiles[index])->second;
+        if (writer != index) return "Output " + outputFiles[index] + " already written by " + filenames[writer];
+
+        PhysicsScene::PhysicsScene scene;
+        if (!loader.LoadScene(filenames[index], scene)) {
+            return loader.GetLastError().empty() ? std::string("Failed to load scene") : loader.GetLastError();
+        }
+        if (!loader.SaveScene(outputFiles[index], scene)) {
+            return loader.GetLastError().empty() ? std::string("Failed to save scene") : loader.GetLastError();
+        }
+        return std::string();
+    });
+}
+
+/**
+ * @brief 以有限大小的工作執行緒池處理檔案
+ *
+ * 檔案一個一個被領取（處理時間差異大，不做預先分段），每個檔案使用
+ * 新的 SceneLoader 以隔離錯誤與警告狀態，並捕捉所有例外。每完成一個
+ * 檔案回報一次進度並詢問是否取消；取消後尚未開始的檔案記為略過，
+ * 處理中的檔案會完成。結果依輸入順序整理，與執行緒數無關。
+ */
+SceneLoader::BatchResult SceneLoader::RunBatch(const std::vector<std::string>& filenames,
+                                               const std::string& operation,
+                                               const BatchFileFunction& processFile) {
+    enum class FileStatus { Skipped, Succeeded, Failed };
+    struct FileOutcome {
+        FileStatus status = FileStatus::Skipped;
+        std::string error;
+        size_t bytes = 0;
+    };
+
+    BatchResult result;
+    result.totalFiles = static_cast<int>(filenames.size());
+    if (filenames.empty()) return result;
+
+    std::vector<FileOutcome> outcomes(filenames.size());
+    std::mutex progressMutex;
+    std::atomic<bool> cancelled(false);
+    size_t completed = 0;
+
+    // 呼叫端執行緒也處理檔案，因此額外建立 workerCount - 1 個執行緒
+    size_t workerCount = m_batchOptions.maxWorkers > 0 ? m_batchOptions.maxWorkers
+                                                       : WorkerPool::DefaultWorkerCount() + 1;
+    workerCount = std::min(workerCount, filenames.size());
+    WorkerPool pool(workerCount - 1);
+
+    const auto start = std::chrono::steady_clock::now();
+    pool.ParallelFor(filenames.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (cancelled.load(std::memory_order_relaxed)) return;
+
+            FileOutcome& outcome = outcomes[i];
+            SceneLoader loader;
+            loader.SetLoadOptions(m_loadOptions);
+            loader.SetSaveOptions(m_saveOptions);
+            try {
+                outcome.bytes = loader.GetFileSize(filenames[i]);
+                outcome.error = processFile(loader, i);
+            } catch (const std::exception& e) {
+                outcome.error = std::string("Exception: ") + e.what();
+            } catch (...) {
+                outcome.error = "Unknown exception";
+            }
+            outcome.status = outcome.error.empty() ? FileStatus::Succeeded : FileStatus::Failed;
+
+            std::lock_guard<std::mutex> lock(progressMutex);
+            ++completed;
+            ReportProgress(100.0f * static_cast<float>(completed) / static_cast<float>(filenames.size()),
+                           operation + " " + filenames[i]);
+            if (CheckCancellation()) {
+                cancelled.store(true, std::memory_order_relaxed);
+            }
+        }
+    });
+    result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        const FileOutcome& outcome = outcomes[i];
+        switch (outcome.status) {
+        case FileStatus::Skipped:
+            ++result.skippedFiles;
+            continue;
+        case FileStatus::Succeeded:
+            result.successFiles.push_back(filenames[i]);
+            break;
+        case FileStatus::Failed:
+            result.failedFiles.emplace_back(filenames[i], outcome.error);
+            break;
+        }
+        ++result.processedFiles;
+        result.totalBytes += outcome.bytes;
+    }
+    result.cancelled = cancelled.load();
+
+    if (result.elapsedSeconds > 0.0) {
+        result.filesPerSecond = result.processedFiles / result.elapsedSeconds;
+        result.megabytesPerSecond = static_cast<double>(result.totalBytes) / (1024.0 * 1024.0) / result.elapsedSeconds;
+    }
+
+    std::ostringstream summary;
+    summary.setf(std::ios::fixed);
+    summary.precision(1);
+    summary << operation << " finished: " << result.successFiles.size() << " succeeded, "
+            << result.failedFiles.size() << " failed, " << result.skippedFiles << " skipped ("
+            << result.filesPerSecond << " files/s, " << result.megabytesPerSecond << " MB/s)";
+    ReportProgress(100.0f * static_cast<float>(result.processedFiles) / static_cast<float>(result.totalFiles),
+                   summary.str());
+    return result;
+}
+
+/**
+ * @brief 載入場景
+ *
+ * 以 SAX 串流解析檔案，LoadOptions 未要求的區段不建立 JSON 節點，
+ * 場景中對應的資料維持預設值。
+ */
+bool SceneLoader::LoadScene(const std::string& filename, PhysicsScene::PhysicsScene& scene) {
+    ClearErrors();
+    ReportProgress(0.0f, "Loading " + filename);
+
+    nlohmann::json json;
+    if (!ParseSceneFile(filename, json)) return false;
+    if (CheckCancellation()) {
+        SetError("Loading cancelled");
+        return false;
+    }
+
+    if (json.contains("formatVersion")) {
+        const nlohmann::json& formatVersion = json["formatVersion"];
+        const std::string version = std::to_string(formatVersion.value("major", 0)) + "." +
+                                    std::to_string(formatVersion.value("minor", 0)) + "." +
+                                    std::to_string(formatVersion.value("patch", 0));
+        if (!IsVersionSupported(version)) {
+            SetError("Unsupported scene format version: " + version);
+            return false;
+        }
+        if (version != CURRENT_VERSION) {
+            UpgradeScene(json, version, CURRENT_VERSION);
+        }
+    }
+
+    ReportProgress(50.0f, "Converting scene data");
+    if (!JsonToScene(json, scene)) return false;
+
+    if (m_loadOptions.repairOnLoad) {
+        for (auto& rigidBody : scene.rigidBodies) RepairRigidBody(rigidBody);
+        for (auto& constraint : scene.constraints) RepairConstraint(constraint);
+        for (auto& forceField : scene.forceFields) RepairForceField(forceField);
+        for (auto& light : scene.lights) RepairLight(light);
+        for (auto& camera : scene.cameras) RepairCamera(camera);
+        for (auto& [name, material] : scene.physicsMaterials) RepairPhysicsMaterial(material);
+        for (auto& [name, material] : scene.visualMaterials) RepairVisualMaterial(material);
+        RepairSimulationSettings(scene.simulationSettings);
+        RepairRenderSettings(scene.renderSettings);
+    }
+
+    if (m_loadOptions.validateOnLoad) {
+        ValidationResult validation = ValidateScene(scene);
+        for (const std::string& warning : validation.warnings) {
+            AddWarning(warning);
+        }
+        if (!validation.isValid) {
+            SetError(validation.errors.empty() ? std::string("Scene validation failed") : validation.errors.front());
+            return false;
+        }
+    }
+
+    ReportProgress(100.0f, "Scene loaded");
+    return true;
+}
+
+bool SceneLoader::ParseSceneFile(const std::string& filename, nlohmann::json& json) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        SetError("Cannot open scene file: " + filename);
+        return false;
+    }
+
+    SectionFilteringDomBuilder builder(json, [this](const std::string& section) {
+        return IsSectionRequested(section);
+    });
+    if (!nlohmann::json::sax_parse(file, &builder)) {
+        SetError("Failed to parse " + filename + ": " + builder.GetError());
+        return false;
+    }
+    return true;
+}
+
+bool SceneLoader::IsSectionRequested(const std::string& section) const {
+    if (section == "rigidBodies") return m_loadOptions.loadRigidBodies;
+    if (section == "constraints") return m_loadOptions.loadConstraints;
+    if (section == "forceFields") return m_loadOptions.loadForceFields;
+    if (section == "lights") return m_loadOptions.loadLights;
+    if (section == "cameras") return m_loadOptions.loadCameras;
+    if (section == "physicsMaterials" || section == "visualMaterials") return m_loadOptions.loadMaterials;
+    if (section == "simulationSettings") return m_loadOptions.loadSimulationSettings;
+    if (section == "renderSettings") return m_loadOptions.loadRenderSettings;
+    return true;
+}
+
+/**
+ * @brief 模擬設定轉為 JSON；碰撞層只輸出已命名的層
+ */
+nlohmann::json SceneLoader::SimulationSettingsToJson(const PhysicsScene::SimulationSettings& settings) {
+    nlohmann::json json;
+    json["timeStep"] = settings.timeStep;
+    json["maxSubSteps"] = settings.maxSubSteps;
+    json["fixedTimeStep"] = settings.fixedTimeStep;
+    json["gravity"] = Vector3ToJson(settings.gravity);
+    json["solverIterations"] = settings.solverIterations;
+    json["positionIterations"] = settings.positionIterations;
+    json["erp"] = settings.erp;
+    json["cfm"] = settings.cfm;
+    json["useOGCContact"] = settings.useOGCContact;
+    json["ogcContactRadius"] = settings.ogcContactRadius;
+    json["hybridMode"] = settings.hybridMode;
+    json["contactBreakingThreshold"] = settings.contactBreakingThreshold;
+    json["contactProcessingThreshold"] = settings.contactProcessingThreshold;
+    json["rejectStaticPairs"] = settings.rejectStaticPairs;
+    json["rejectTriggerPairs"] = settings.rejectTriggerPairs;
+    json["enableCCD"] = settings.enableCCD;
+    json["enableSleeping"] = settings.enableSleeping;
+    json["sleepingLinearThreshold"] = settings.sleepingLinearThreshold;
+    json["sleepingAngularThreshold"] = settings.sleepingAngularThreshold;
+    json["sleepingTime"] = settings.sleepingTime;
+
+    const PhysicsScene::CollisionLayerMatrix& layers = settings.collisionLayers;
+    nlohmann::json layerArray = nlohmann::json::array();
+    for (size_t i = 0; i < layers.layerNames.size(); ++i) {
+        layerArray.push_back({{"name", layers.layerNames[i]}, {"mask", layers.masks[i]}});
+    }
+    json["collisionLayers"] = std::move(layerArray);
+    return json;
+}
+
+/**
+ * @brief 讀取模擬設定；缺少的欄位維持預設值
+ */
+bool SceneLoader::JsonToSimulationSettings(const nlohmann::json& json, PhysicsScene::SimulationSettings& settings) {
+    if (!json.is_object()) {
+        SetError("Invalid simulationSettings section");
+        return false;
+    }
+
+    settings.timeStep = json.value("timeStep", settings.timeStep);
+    settings.maxSubSteps = json.value("maxSubSteps", settings.maxSubSteps);
+    settings.fixedTimeStep = json.value("fixedTimeStep", settings.fixedTimeStep);
+    if (json.contains("gravity") && !JsonToVector3(json["gravity"], settings.gravity)) {
+        SetError("Invalid gravity in simulationSettings");
+        return false;
+    }
+    settings.solverIterations = json.value("solverIterations", settings.solverIterations);
+    settings.positionIterations = json.value("positionIterations", settings.positionIterations);
+    settings.erp = json.value("erp", settings.erp);
+    settings.cfm = json.value("cfm", settings.cfm);
+    settings.useOGCContact = json.value("useOGCContact", settings.useOGCContact);
+    settings.ogcContactRadius = json.value("ogcContactRadius", settings.ogcContactRadius);
+    settings.hybridMode = json.value("hybridMode", settings.hybridMode);
+    settings.contactBreakingThreshold = json.value("contactBreakingThreshold", settings.contactBreakingThreshold);
+    settings.contactProcessingThreshold = json.value("contactProcessingThreshold", settings.contactProcessingThreshold);
+    settings.rejectStaticPairs = json.value("rejectStaticPairs", settings.rejectStaticPairs);
+    settings.rejectTriggerPairs = json.value("rejectTriggerPairs", settings.rejectTriggerPairs);
+    settings.enableCCD = json.value("enableCCD", settings.enableCCD);
+    settings.enableSleeping = json.value("enableSleeping", settings.enableSleeping);
+    settings.sleepingLinearThreshold = json.value("sleepingLinearThreshold", settings.sleepingLinearThreshold);
+    settings.sleepingAngularThreshold = json.value("sleepingAngularThreshold", settings.sleepingAngularThreshold);
+    settings.sleepingTime = json.value("sleepingTime", settings.sleepingTime);
+
+    // 碰撞層依檔案中的順序決定索引，剛體的 collisionGroup 位元依此對應
+    settings.collisionLayers = PhysicsScene::CollisionLayerMatrix();
+    if (json.contains("collisionLayers")) {
+        const nlohmann::json& layerArray = json["collisionLayers"];
+        if (!layerArray.is_array()) {
+            SetError("Invalid collisionLayers in simulationSettings");
+            return false;
+        }
+        for (const nlohmann::json& layer : layerArray) {
+            if (!layer.is_object() || !layer.contains("name") || !layer["name"].is_string()) {
+                SetError("Invalid collision layer entry");
+                return false;
+            }
+            const std::string name = layer["name"].get<std::string>();
+            if (settings.collisionLayers.findLayer(name) >= 0) {
+                AddWarning("Duplicate collision layer ignored: " + name);
+                continue;
+            }
+            const int index = settings.collisionLayers.addLayer(name);
+            if (index < 0) {
+                AddWarning("Too many collision layers, ignoring: " + name);
+                continue;
+            }
+            settings.collisionLayers.masks[static_cast<size_t>(index)] = layer.value("mask", 0xFFFFFFFFu);
+        }
+    }
+    return true;
+}
+
+SceneLoader::SceneInfo SceneLoader::GetSceneInfo(const std::string& filename) {
+    SceneInfo info;
+    info.filename = filename;
+    info.fileSize = GetFileSize(filename);
+
+    SceneSummary summary;
+    std::string error;
+    if (!ScanSceneFile(filename, false, summary, error)) {
+        SetError(error);
+        return info;
+    }
+
+    if (summary.formatVersion[0] >= 0) {
+        info.version = std::to_string(summary.formatVersion[0]) + "." +
+                       std::to_string(std::max(summary.formatVersion[1], 0)) + "." +
+                       std::to_string(std::max(summary.formatVersion[2], 0));
+    } else {
+        info.version = summary.GetMetadata("version");
+    }
+    info.createdBy = summary.GetMetadata("author");
+    info.createdDate = summary.GetMetadata("createdDate");
+    info.modifiedDate = summary.GetMetadata("modifiedDate");
+    info.description = summary.GetMetadata("description");
+    info.rigidBodyCount = summary.Count("rigidBodies");
+    info.constraintCount = summary.Count("constraints");
+    info.forceFieldCount = summary.Count("forceFields");
+    info.lightCount = summary.Count("lights");
+    info.cameraCount = summary.Count("cameras");
+    info.materialCount = summary.Count("physicsMaterials") + summary.Count("visualMaterials");
+    return info;
+}
+
+SceneLoader::SceneStatistics SceneLoader::AnalyzeScene(const PhysicsScene::PhysicsScene& scene) {
+    SceneStatistics statistics;
+    for (const RigidBody& body : scene.rigidBodies) {
+        const PhysicsScene::PhysicsMaterial* material = scene.findPhysicsMaterial(body.physicsMaterial);
+        AccumulateBody(statistics, body.mass, material && material->isStatic, material && material->isKinematic,
+                       body.transform.position);
+    }
+
+    std::set<std::string> textures;
+    for (const auto& [name, material] : scene.visualMaterials) {
+        for (const std::string* texture : {&material.diffuseTexture, &material.normalTexture,
+                                           &material.specularTexture, &material.emissiveTexture,
+                                           &material.metallicTexture, &material.roughnessTexture}) {
+            if (!texture->empty()) textures.insert(*texture);
+        }
+    }
+
+    statistics.constraints = static_cast<int>(scene.constraints.size());
+    statistics.forceFields = static_cast<int>(scene.forceFields.size());
+    statistics.lights = static_cast<int>(scene.lights.size());
+    statistics.cameras = static_cast<int>(scene.cameras.size());
+    statistics.materials = static_cast<int>(scene.physicsMaterials.size() + scene.visualMaterials.size());
+    statistics.textures = static_cast<int>(textures.size());
+    statistics.totalObjects = statistics.rigidBodies + statistics.constraints + statistics.forceFields +
+                              statistics.lights + statistics.cameras;
+    return statistics;
+}
+
+SceneLoader::SceneStatistics SceneLoader::AnalyzeSceneFile(const std::string& filename) {
+    SceneStatistics statistics;
+    SceneSummary summary;
+    std::string error;
+    if (!ScanSceneFile(filename, true, summary, error)) {
+        SetError(error);
+        return statistics;
+    }
+
+    for (const SceneSummary::Body& body : summary.bodies) {
+        auto flags = summary.materialFlags.find(body.physicsMaterial);
+        const bool isStatic = flags != summary.materialFlags.end() && flags->second.first;
+        const bool isKinematic = flags != summary.materialFlags.end() && flags->second.second;
+        AccumulateBody(statistics, body.mass, isStatic, isKinematic, body.position);
+    }
+
+    statistics.constraints = summary.Count("constraints");
+    statistics.forceFields = summary.Count("forceFields");
+    statistics.lights = summary.Count("lights");
+    statistics.cameras = summary.Count("cameras");
+    statistics.materials = summary.Count("physicsMaterials") + summary.Count("visualMaterials");
+    statistics.textures = static_cast<int>(summary.textures.size());
+    statistics.totalObjects = statistics.rigidBodies + statistics.constraints + statistics.forceFields +
+                              statistics.lights + statistics.cameras;
+    return statistics;
+}
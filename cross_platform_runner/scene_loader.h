@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <vector>
@@ -11,6 +12,9 @@
 // 場景格式
 #include "../scene_format/physics_scene_format.h"
 
+// 網格最佳化
+#include "mesh_optimizer.h"
+
 /**
  * @file scene_loader.h
  * @brief 物理場景載入器類別
@@ -87,9 +91,11 @@ public:
         size_t fileSize = 0;
     };
 
+    // 只串流掃描檔案取得元資料與物件數量，不建立 JSON 或場景
     SceneInfo GetSceneInfo(const std::string& filename);
 
     // 匯入/匯出選項
+    // 未要求的區段在解析時直接略過，不會建立對應的 JSON 節點
     struct LoadOptions {
         bool loadRigidBodies = true;
         bool loadConstraints = true;
@@ -130,6 +136,10 @@ private:
     nlohmann::json SceneToJson(const PhysicsScene::PhysicsScene& scene);
     bool JsonToScene(const nlohmann::json& json, PhysicsScene::PhysicsScene& scene);
 
+    // 串流解析：只為 LoadOptions 要求的頂層區段建立 JSON 節點
+    bool ParseSceneFile(const std::string& filename, nlohmann::json& json);
+    bool IsSectionRequested(const std::string& section) const;
+
     // 個別物件轉換
     nlohmann::json RigidBodyToJson(const PhysicsScene::RigidBody& rigidBody);
     bool JsonToRigidBody(const nlohmann::json& json, PhysicsScene::RigidBody& rigidBody);
@@ -244,13 +254,30 @@ public:
     static bool IsSceneFileExtension(const std::string& extension);
 
     // 批次處理
+    // 每個檔案由獨立的 SceneLoader 在工作執行緒上處理，一個檔案失敗（含例外）
+    // 不影響其他檔案；ProgressCallback 會在工作執行緒上呼叫，但同一時間只有一個。
+    struct BatchOptions {
+        size_t maxWorkers = 0;      // 同時處理的檔案數上限，0 表示硬體執行緒數
+    };
+
     struct BatchResult {
         std::vector<std::string> successFiles;
         std::vector<std::pair<std::string, std::string>> failedFiles; // filename, error
         int totalFiles = 0;
         int processedFiles = 0;
+        int skippedFiles = 0;           // 取消後未處理的檔案數
+        bool cancelled = false;
+
+        // 吞吐量統計（以輸入檔案大小計算）
+        uint64_t totalBytes = 0;
+        double elapsedSeconds = 0.0;
+        double filesPerSecond = 0.0;
+        double megabytesPerSecond = 0.0;
     };
 
+    void SetBatchOptions(const BatchOptions& options) { m_batchOptions = options; }
+    const BatchOptions& GetBatchOptions() const { return m_batchOptions; }
+
     BatchResult ValidateSceneFiles(const std::vector<std::string>& filenames);
     BatchResult ConvertSceneFiles(const std::vector<std::string>& filenames, 
                                  const std::string& outputDirectory,
@@ -284,7 +311,7 @@ public:
     };
 
     SceneStatistics AnalyzeScene(const PhysicsScene::PhysicsScene& scene);
-    SceneStatistics AnalyzeSceneFile(const std::string& filename);
+    SceneStatistics AnalyzeSceneFile(const std::string& filename);    // 與 GetSceneInfo 相同的串流掃描
 
     // 場景最佳化
     struct OptimizationOptions {
@@ -293,10 +320,50 @@ public:
         bool removeUnusedMaterials = true;
         bool optimizeMeshes = false;
         bool compressTextures = false;
-        float mergeTolerance = 0.001f;
+        float mergeTolerance = 0.001f;          // 焊接頂點的距離（網格最佳化與三角網格烘焙）
+
+        // 靜態剛體合併
+        float mergeCellSize = 16.0f;            // 空間分群的格子邊長（公尺）
+        int maxBodiesPerMerge = 256;            // 每個合併剛體的成員上限
+        bool mergeIntoTriangleMesh = false;     // 方塊與三角網格烘焙成單一三角網格，其餘形狀仍為複合形狀
+
+        // 網格最佳化（只處理內嵌頂點的三角網格，外部網格檔案不變）
+        int maxMeshTriangles = 4096;            // 簡化後的三角形上限，0 表示不簡化
+        bool decomposeDynamicMeshes = true;     // 動態剛體的三角網格分解為凸包
+        MeshOptimizer::DecompositionSettings decomposition;
+    };
+
+    // 最佳化結果統計
+    struct OptimizationResult {
+        int mergedBodyCount = 0;        // 被合併掉的靜態剛體數
+        int createdBodyCount = 0;       // 產生的合併剛體數
+        int removedMaterialCount = 0;
+        int optimizedMeshCount = 0;
+        int removedTriangleCount = 0;   // 焊接、退化移除與簡化共移除的三角形數
+        int decomposedBodyCount = 0;    // 改用凸包的動態剛體數
+        int convexHullCount = 0;
     };
 
     bool OptimizeScene(PhysicsScene::PhysicsScene& scene, const OptimizationOptions& options);
     bool OptimizeSceneFile(const std::string& inputFile, const std::string& outputFile, 
                           const OptimizationOptions& options);
+    const OptimizationResult& GetLastOptimizationResult() const { return m_optimizationResult; }
+
+private:
+    // 最佳化輔助函數
+    void RemoveDuplicateMaterials(PhysicsScene::PhysicsScene& scene);
+    void RemoveUnusedMaterials(PhysicsScene::PhysicsScene& scene);
+    void MergeStaticBodies(PhysicsScene::PhysicsScene& scene, const OptimizationOptions& options);
+    bool IsMergeableStaticBody(const PhysicsScene::PhysicsScene& scene, const PhysicsScene::RigidBody& rigidBody) const;
+    void OptimizeMeshes(PhysicsScene::PhysicsScene& scene, const OptimizationOptions& options);
+    void OptimizeMesh(PhysicsScene::GeometryShape& shape, const OptimizationOptions& options);
+
+    // 批次處理：processFile 回傳空字串表示成功，否則為錯誤訊息
+    using BatchFileFunction = std::function<std::string(SceneLoader& loader, size_t index)>;
+    BatchResult RunBatch(const std::vector<std::string>& filenames, const std::string& operation,
+                         const BatchFileFunction& processFile);
+
+    BatchOptions m_batchOptions;
+
+    OptimizationResult m_optimizationResult;
 };
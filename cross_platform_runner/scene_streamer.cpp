@@ -0,0 +1,404 @@
+/**
+ * @file scene_streamer.cpp
+ * @brief 分塊場景串流管理器實現
+ */
+
+#include "scene_streamer.h"
+#include "physics_engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+SceneStreamer::SceneStreamer(PhysicsEngine* physicsEngine)
+    : m_physicsEngine(physicsEngine)
+    , m_nextRequest(0)
+    , m_stopping(false)
+{
+}
+
+SceneStreamer::~SceneStreamer() {
+    Close();
+}
+
+/**
+ * @brief 開啟分塊檔案並啟動 I/O 執行緒
+ */
+bool SceneStreamer::Open(const std::string& tileFile) {
+    Close();
+
+    if (!m_physicsEngine) {
+        m_lastError = "SceneStreamer requires a physics engine";
+        return false;
+    }
+    if (!m_reader.open(tileFile, &m_lastError)) {
+        return false;
+    }
+
+    const auto& entries = m_reader.getTiles();
+    m_tiles.assign(entries.size(), TileSlot());
+    m_tileLookup.reserve(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        m_tileLookup[PackCoord(entries[i].coord)] = i;
+    }
+
+    m_lastError.clear();
+    m_stopping = false;
+    m_ioThread = std::thread(&SceneStreamer::IOThreadLoop, this);
+    return true;
+}
+
+/**
+ * @brief 停止串流並移除所有串流剛體
+ */
+void SceneStreamer::Close() {
+    StopIOThread();
+
+    UnloadAllTiles();
+    m_tiles.clear();
+    m_tileLookup.clear();
+    m_reader.close();
+    m_statistics = Statistics();
+}
+
+/**
+ * @brief 場景重置：移除所有串流剛體，分塊之後重新串流
+ *
+ * I/O 執行緒中仍在讀取的結果會因分塊已不是 Reading 狀態而被丟棄。
+ */
+void SceneStreamer::Reset() {
+    if (!IsOpen()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requests.clear();
+        m_results.clear();
+    }
+    UnloadAllTiles();
+    m_statistics = Statistics();
+}
+
+void SceneStreamer::SetSettings(const Settings& settings) {
+    m_settings = settings;
+    m_settings.loadRadius = std::max(0.0f, m_settings.loadRadius);
+    m_settings.unloadRadius = std::max(m_settings.loadRadius, m_settings.unloadRadius);
+    m_settings.maxPendingTiles = std::max<size_t>(1, m_settings.maxPendingTiles);
+}
+
+/**
+ * @brief 依相機位置更新分塊：收取讀取結果、卸載遠處分塊、請求近處分塊、分批整合
+ */
+void SceneStreamer::Update(const PhysicsScene::Vector3& cameraPosition) {
+    if (!IsOpen()) return;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    CollectResults();
+    UnloadDistantTiles(cameraPosition);
+    RemoveUnloadingBodies();
+    RequestNearbyTiles(cameraPosition);
+    IntegratePendingBodies(cameraPosition);
+
+    m_statistics.residentTiles = 0;
+    m_statistics.pendingTiles = 0;
+    m_statistics.unloadingTiles = 0;
+    m_statistics.residentBodies = 0;
+    for (size_t tile : m_activeTiles) {
+        const TileSlot& slot = m_tiles[tile];
+        if (slot.state == TileState::Resident) {
+            ++m_statistics.residentTiles;
+        } else if (slot.state == TileState::Unloading) {
+            ++m_statistics.unloadingTiles;
+        } else {
+            ++m_statistics.pendingTiles;
+        }
+        m_statistics.residentBodies += slot.bodyNames.size();
+    }
+    m_statistics.lastUpdateMilliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ============================================================================
+// I/O 執行緒
+// ============================================================================
+
+void SceneStreamer::IOThreadLoop() {
+    for (;;) {
+        ReadRequest request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_requests.empty(); });
+            if (m_stopping) return;
+            request = m_requests.front();
+            m_requests.pop_front();
+        }
+
+        // 分塊索引在 I/O 執行緒存在期間不會變動
+        ReadResult result;
+        result.tile = request.tile;
+        result.request = request.request;
+        result.success = m_reader.readTile(m_reader.getTiles()[request.tile], result.bodies, &result.error);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_results.push_back(std::move(result));
+    }
+}
+
+void SceneStreamer::StopIOThread() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    if (m_ioThread.joinable()) {
+        m_ioThread.join();
+    }
+    m_requests.clear();
+    m_results.clear();
+}
+
+// ============================================================================
+// 主執行緒
+// ============================================================================
+
+/**
+ * @brief 收取 I/O 執行緒的結果；請求已被取消或重發的結果直接丟棄
+ */
+void SceneStreamer::CollectResults() {
+    std::vector<ReadResult> results;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        results.swap(m_results);
+    }
+
+    for (auto& result : results) {
+        TileSlot& slot = m_tiles[result.tile];
+        if (slot.state != TileState::Reading || slot.request != result.request) {
+            continue;
+        }
+        if (!result.success) {
+            slot.state = TileState::Failed;
+            m_lastError = result.error;
+            ++m_statistics.failedTiles;
+            continue;
+        }
+        slot.pending = std::move(result.bodies);
+        slot.integrated = 0;
+        slot.state = TileState::Integrating;
+    }
+
+    m_activeTiles.erase(std::remove_if(m_activeTiles.begin(), m_activeTiles.end(),
+                                       [this](size_t tile) { return m_tiles[tile].state == TileState::Failed; }),
+                        m_activeTiles.end());
+}
+
+/**
+ * @brief 將超出卸載半徑的分塊標為卸載中；剛體由 RemoveUnloadingBodies 分批移除
+ */
+void SceneStreamer::UnloadDistantTiles(const PhysicsScene::Vector3& cameraPosition) {
+    bool cancelled = false;
+    for (size_t tile : m_activeTiles) {
+        const TileState state = m_tiles[tile].state;
+        if (state == TileState::Unloading) continue;
+        if (DistanceToTile(tile, cameraPosition) <= m_settings.unloadRadius) continue;
+        cancelled = cancelled || state == TileState::Reading;
+        BeginUnload(tile);
+    }
+    m_activeTiles.erase(std::remove_if(m_activeTiles.begin(), m_activeTiles.end(),
+                                       [this](size_t tile) { return m_tiles[tile].state == TileState::Unloaded; }),
+                        m_activeTiles.end());
+
+    if (cancelled) {
+        CancelStaleRequests();
+    }
+}
+
+/**
+ * @brief 自卸載中的分塊移除剛體，每次最多 maxRemovalsPerUpdate 個，整批交給 PhysicsEngine
+ *
+ * 分塊的剛體全部移除後才回到未載入狀態，在此之前不會被重新請求。
+ */
+void SceneStreamer::RemoveUnloadingBodies() {
+    // 0 表示不限制
+    size_t budget = m_settings.maxRemovalsPerUpdate > 0 ? m_settings.maxRemovalsPerUpdate
+                                                        : std::numeric_limits<size_t>::max();
+    std::vector<std::string> names;
+    for (size_t tile : m_activeTiles) {
+        if (budget == 0) break;
+        TileSlot& slot = m_tiles[tile];
+        if (slot.state != TileState::Unloading) continue;
+
+        const size_t count = std::min(budget, slot.bodyNames.size());
+        auto first = slot.bodyNames.end() - static_cast<std::ptrdiff_t>(count);
+        names.insert(names.end(), std::make_move_iterator(first), std::make_move_iterator(slot.bodyNames.end()));
+        slot.bodyNames.erase(first, slot.bodyNames.end());
+        budget -= count;
+        if (slot.bodyNames.empty()) {
+            slot.state = TileState::Unloaded;
+        }
+    }
+    if (names.empty()) return;
+
+    m_physicsEngine->RemoveRigidBodies(names);
+    m_activeTiles.erase(std::remove_if(m_activeTiles.begin(), m_activeTiles.end(),
+                                       [this](size_t tile) { return m_tiles[tile].state == TileState::Unloaded; }),
+                        m_activeTiles.end());
+}
+
+/**
+ * @brief 尚未開始讀取的請求直接撤回；讀取中的結果會因編號不符被丟棄
+ */
+void SceneStreamer::CancelStaleRequests() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_requests.erase(std::remove_if(m_requests.begin(), m_requests.end(),
+                                    [this](const ReadRequest& request) {
+                                        const TileSlot& slot = m_tiles[request.tile];
+                                        return slot.state != TileState::Reading || slot.request != request.request;
+                                    }),
+                     m_requests.end());
+}
+
+/**
+ * @brief 依距離由近到遠請求載入半徑內的分塊
+ */
+void SceneStreamer::RequestNearbyTiles(const PhysicsScene::Vector3& cameraPosition) {
+    if (m_activeTiles.size() >= m_tiles.size()) return;
+
+    size_t pending = 0;
+    for (size_t tile : m_activeTiles) {
+        const TileState state = m_tiles[tile].state;
+        if (state == TileState::Reading || state == TileState::Integrating) ++pending;
+    }
+    if (pending >= m_settings.maxPendingTiles) return;
+
+    std::vector<std::pair<float, size_t>> candidates;
+    auto consider = [&](size_t tile) {
+        if (m_tiles[tile].state != TileState::Unloaded) return;
+        const float distance = DistanceToTile(tile, cameraPosition);
+        if (distance <= m_settings.loadRadius) {
+            candidates.emplace_back(distance, tile);
+        }
+    };
+
+    // 只查詢載入半徑涵蓋的格子；格子數比分塊還多時直接掃描全部分塊
+    const double tileSize = m_reader.getTileSize();
+    const double radius = m_settings.loadRadius;
+    // 分塊 x 涵蓋 [x * tileSize, (x + 1) * tileSize]，邊緣恰好落在半徑上的也要納入
+    const double minX = std::ceil((cameraPosition.x - radius) / tileSize) - 1.0;
+    const double maxX = std::floor((cameraPosition.x + radius) / tileSize);
+    const double minZ = std::ceil((cameraPosition.z - radius) / tileSize) - 1.0;
+    const double maxZ = std::floor((cameraPosition.z + radius) / tileSize);
+    if ((maxX - minX + 1.0) * (maxZ - minZ + 1.0) > static_cast<double>(m_tiles.size())) {
+        for (size_t tile = 0; tile < m_tiles.size(); ++tile) {
+            consider(tile);
+        }
+    } else {
+        for (double x = minX; x <= maxX; x += 1.0) {
+            for (double z = minZ; z <= maxZ; z += 1.0) {
+                auto it = m_tileLookup.find(
+                    PackCoord(PhysicsScene::TileCoord(static_cast<int32_t>(x), static_cast<int32_t>(z))));
+                if (it != m_tileLookup.end()) {
+                    consider(it->second);
+                }
+            }
+        }
+    }
+    if (candidates.empty()) return;
+
+    const size_t count = std::min(candidates.size(), m_settings.maxPendingTiles - pending);
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < count; ++i) {
+            const size_t tile = candidates[i].second;
+            TileSlot& slot = m_tiles[tile];
+            slot.state = TileState::Reading;
+            slot.request = ++m_nextRequest;
+            m_requests.push_back({tile, slot.request});
+            m_activeTiles.push_back(tile);
+        }
+    }
+    m_condition.notify_one();
+}
+
+/**
+ * @brief 將解碼完成的剛體加入物理世界，近的分塊優先，每次最多 maxBodiesPerUpdate 個
+ */
+void SceneStreamer::IntegratePendingBodies(const PhysicsScene::Vector3& cameraPosition) {
+    std::vector<std::pair<float, size_t>> integrating;
+    for (size_t tile : m_activeTiles) {
+        if (m_tiles[tile].state == TileState::Integrating) {
+            integrating.emplace_back(DistanceToTile(tile, cameraPosition), tile);
+        }
+    }
+    std::sort(integrating.begin(), integrating.end());
+
+    // 0 表示不限制
+    size_t budget = m_settings.maxBodiesPerUpdate > 0 ? m_settings.maxBodiesPerUpdate : std::numeric_limits<size_t>::max();
+    for (const auto& [distance, tile] : integrating) {
+        if (budget == 0) break;
+        TileSlot& slot = m_tiles[tile];
+        const size_t count = std::min(budget, slot.pending.size() - slot.integrated);
+        m_physicsEngine->AddRigidBodies(slot.pending.data() + slot.integrated, count);
+        for (size_t i = 0; i < count; ++i) {
+            slot.bodyNames.push_back(slot.pending[slot.integrated + i].name);
+        }
+        slot.integrated += count;
+        budget -= count;
+        if (slot.integrated == slot.pending.size()) {
+            std::vector<PhysicsScene::RigidBody>().swap(slot.pending);
+            slot.integrated = 0;
+            slot.state = TileState::Resident;
+            ++m_statistics.tilesLoaded;
+        }
+    }
+}
+
+/**
+ * @brief 捨棄分塊尚未整合的剛體；已加入物理世界的剛體留給 RemoveUnloadingBodies
+ */
+void SceneStreamer::BeginUnload(size_t tile) {
+    TileSlot& slot = m_tiles[tile];
+    if (slot.state == TileState::Resident) {
+        ++m_statistics.tilesUnloaded;
+    }
+    std::vector<PhysicsScene::RigidBody>().swap(slot.pending);
+    slot.integrated = 0;
+    slot.state = slot.bodyNames.empty() ? TileState::Unloaded : TileState::Unloading;
+}
+
+/**
+ * @brief 一次移除所有串流剛體，不受每次移除上限限制
+ */
+void SceneStreamer::UnloadAllTiles() {
+    std::vector<std::string> names;
+    for (size_t tile : m_activeTiles) {
+        TileSlot& slot = m_tiles[tile];
+        names.insert(names.end(), std::make_move_iterator(slot.bodyNames.begin()),
+                     std::make_move_iterator(slot.bodyNames.end()));
+        slot = TileSlot();
+    }
+    m_activeTiles.clear();
+    if (m_physicsEngine && !names.empty()) {
+        m_physicsEngine->RemoveRigidBodies(names);
+    }
+}
+
+/**
+ * @brief 相機到分塊矩形的水平距離（相機在分塊內時為 0）
+ */
+float SceneStreamer::DistanceToTile(size_t tile, const PhysicsScene::Vector3& cameraPosition) const {
+    const PhysicsScene::TileCoord& coord = m_reader.getTiles()[tile].coord;
+    const float tileSize = m_reader.getTileSize();
+    const float minX = coord.x * tileSize;
+    const float minZ = coord.z * tileSize;
+    const float dx = std::max({minX - cameraPosition.x, 0.0f, cameraPosition.x - (minX + tileSize)});
+    const float dz = std::max({minZ - cameraPosition.z, 0.0f, cameraPosition.z - (minZ + tileSize)});
+    return std::sqrt(dx * dx + dz * dz);
+}
+
+uint64_t SceneStreamer::PackCoord(const PhysicsScene::TileCoord& coord) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(coord.x)) << 32) | static_cast<uint32_t>(coord.z);
+}
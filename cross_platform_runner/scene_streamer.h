@@ -0,0 +1,139 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 場景格式
+#include "../scene_format/scene_tile_format.h"
+
+/**
+ * @file scene_streamer.h
+ * @brief 分塊場景串流管理器
+ *
+ * 依相機位置載入與卸載 .ptiles 分塊。讀檔與解碼在背景 I/O 執行緒進行，
+ * 主執行緒在 Update 中把解碼好的剛體加入 PhysicsEngine，加入與卸載都以每次的
+ * 剛體數量上限分攤到多個影格並整批交給 PhysicsEngine，避免大型分塊造成卡頓。卸載半徑大於載入半徑，
+ * 相機在分塊邊界來回移動時不會反覆載入。
+ *
+ * 分塊內的剛體名稱必須與場景其餘剛體不重複（writeTiledScene 從同一個場景切出時成立）。
+ */
+
+class PhysicsEngine;
+
+class SceneStreamer {
+public:
+    struct Settings {
+        float loadRadius = 150.0f;          // 水平距離小於此值的分塊會被載入
+        float unloadRadius = 200.0f;        // 水平距離大於此值的分塊才會卸載
+        size_t maxBodiesPerUpdate = 500;    // 每次 Update 最多加入物理世界的剛體數
+        size_t maxRemovalsPerUpdate = 1000; // 每次 Update 最多自物理世界移除的剛體數
+        size_t maxPendingTiles = 8;         // 已送出但尚未整合完成的分塊上限
+    };
+
+    struct Statistics {
+        size_t residentTiles = 0;           // 已完整加入物理世界的分塊
+        size_t pendingTiles = 0;            // 讀取中或等待整合的分塊
+        size_t unloadingTiles = 0;          // 剛體分批移除中的分塊
+        size_t residentBodies = 0;          // 目前由串流加入的剛體數
+        uint64_t tilesLoaded = 0;
+        uint64_t tilesUnloaded = 0;
+        uint64_t failedTiles = 0;
+        double lastUpdateMilliseconds = 0.0;
+    };
+
+    explicit SceneStreamer(PhysicsEngine* physicsEngine);
+    ~SceneStreamer();
+
+    SceneStreamer(const SceneStreamer&) = delete;
+    SceneStreamer& operator=(const SceneStreamer&) = delete;
+
+    // 開啟分塊檔案並啟動 I/O 執行緒；失敗時可用 GetLastError 取得原因
+    bool Open(const std::string& tileFile);
+    // 停止 I/O 執行緒並從物理世界移除所有串流剛體；必須在 PhysicsEngine 清理前呼叫
+    void Close();
+    // 移除所有串流剛體並將分塊標回未載入，保留檔案與 I/O 執行緒；之後的 Update 依相機位置重新串流
+    void Reset();
+    bool IsOpen() const { return m_reader.isOpen(); }
+
+    void SetSettings(const Settings& settings);
+    const Settings& GetSettings() const { return m_settings; }
+
+    // 每個影格在主執行緒呼叫（StepSimulation 之前）
+    void Update(const PhysicsScene::Vector3& cameraPosition);
+
+    const Statistics& GetStatistics() const { return m_statistics; }
+    const std::string& GetLastError() const { return m_lastError; }
+    float GetTileSize() const { return m_reader.getTileSize(); }
+
+private:
+    enum class TileState {
+        Unloaded,
+        Reading,        // 已送給 I/O 執行緒
+        Integrating,    // 已解碼，分批加入物理世界中
+        Resident,
+        Unloading,      // 已超出卸載半徑，剛體分批移除中
+        Failed          // 讀取失敗，不再重試
+    };
+
+    struct TileSlot {
+        TileState state = TileState::Unloaded;
+        uint64_t request = 0;                           // 最新一次請求的編號，用來丟棄過期的結果
+        std::vector<PhysicsScene::RigidBody> pending;   // 尚未加入物理世界的剛體
+        size_t integrated = 0;                          // pending 中已加入的數量
+        std::vector<std::string> bodyNames;             // 已加入物理世界的剛體名稱
+    };
+
+    struct ReadRequest {
+        size_t tile;
+        uint64_t request;
+    };
+
+    struct ReadResult {
+        size_t tile;
+        uint64_t request;
+        bool success;
+        std::string error;
+        std::vector<PhysicsScene::RigidBody> bodies;
+    };
+
+    void IOThreadLoop();
+    void StopIOThread();
+
+    void CollectResults();
+    void UnloadDistantTiles(const PhysicsScene::Vector3& cameraPosition);
+    void RequestNearbyTiles(const PhysicsScene::Vector3& cameraPosition);
+    void IntegratePendingBodies(const PhysicsScene::Vector3& cameraPosition);
+    void RemoveUnloadingBodies();
+    void BeginUnload(size_t tile);
+    void UnloadAllTiles();
+    void CancelStaleRequests();
+
+    float DistanceToTile(size_t tile, const PhysicsScene::Vector3& cameraPosition) const;
+    static uint64_t PackCoord(const PhysicsScene::TileCoord& coord);
+
+    PhysicsEngine* m_physicsEngine;
+    PhysicsScene::TiledSceneReader m_reader;
+    Settings m_settings;
+    Statistics m_statistics;
+    std::string m_lastError;
+
+    // 與 m_reader.getTiles() 一一對應；只由主執行緒存取
+    std::vector<TileSlot> m_tiles;
+    std::unordered_map<uint64_t, size_t> m_tileLookup;
+    std::vector<size_t> m_activeTiles;      // 狀態不是 Unloaded / Failed 的分塊
+    uint64_t m_nextRequest;
+
+    // I/O 執行緒；佇列與結果由 m_mutex 保護
+    std::thread m_ioThread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<ReadRequest> m_requests;
+    std::vector<ReadResult> m_results;
+    bool m_stopping;
+};
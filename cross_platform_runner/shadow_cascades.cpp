@@ -0,0 +1,127 @@
+/**
+ * @file shadow_cascades.cpp
+ * @brief 方向光的串聯陰影貼圖（CSM）切割與投影實現
+ */
+
+#include "shadow_cascades.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+
+/**
+ * @brief 觀察深度 [nearDepth, farDepth] 的視錐切片在觀察空間中的最小包圍球
+ *
+ * 切片對稱於視線，球心在視線上；回傳球心的觀察深度與半徑。
+ */
+void ComputeSliceSphere(const ShadowCascades::View& view, float nearDepth, float farDepth,
+                        float& centerDepth, float& radius) {
+    if (view.orthographic) {
+        const float halfHeight = view.orthographicSize;
+        const float halfWidth = halfHeight * view.aspectRatio;
+        const float halfDepth = 0.5f * (farDepth - nearDepth);
+        centerDepth = 0.5f * (nearDepth + farDepth);
+        radius = std::sqrt(halfWidth * halfWidth + halfHeight * halfHeight + halfDepth * halfDepth);
+        return;
+    }
+
+    // 切片角點到視線的距離與深度成正比
+    const float tanHalfFov = std::tan(0.5f * view.fovY);
+    const float cornerScale = tanHalfFov * std::sqrt(1.0f + view.aspectRatio * view.aspectRatio);
+    const float nearRadius = nearDepth * cornerScale;
+    const float farRadius = farDepth * cornerScale;
+
+    // 使球心到近端與遠端角點的距離相等
+    const float depth = farDepth - nearDepth;
+    float center = 0.5f * (nearDepth + farDepth) +
+                   (farRadius * farRadius - nearRadius * nearRadius) / (2.0f * std::max(depth, 1e-6f));
+    center = std::min(std::max(center, nearDepth), farDepth);
+
+    const float toNear = std::sqrt((center - nearDepth) * (center - nearDepth) + nearRadius * nearRadius);
+    const float toFar = std::sqrt((farDepth - center) * (farDepth - center) + farRadius * farRadius);
+    centerDepth = center;
+    radius = std::max(toNear, toFar);
+}
+
+} // namespace
+
+void ShadowCascades::ComputeSplits(float nearPlane, float farPlane, size_t count, float lambda, float* splits) {
+    nearPlane = std::max(nearPlane, 1e-4f);
+    farPlane = std::max(farPlane, nearPlane * 1.001f);
+    for (size_t i = 1; i <= count; ++i) {
+        const float fraction = static_cast<float>(i) / static_cast<float>(count);
+        const float logarithmic = nearPlane * std::pow(farPlane / nearPlane, fraction);
+        const float uniform = nearPlane + (farPlane - nearPlane) * fraction;
+        splits[i - 1] = lambda * logarithmic + (1.0f - lambda) * uniform;
+    }
+    // 避免浮點誤差讓最後一段略短於 farPlane
+    splits[count - 1] = farPlane;
+}
+
+void ShadowCascades::SetSettings(const Settings& settings) {
+    m_settings = settings;
+    m_settings.cascadeCount = std::min(std::max<size_t>(settings.cascadeCount, 1), MAX_CASCADES);
+    m_settings.resolution = std::max(settings.resolution, 16);
+    m_valid = false;
+}
+
+uint32_t ShadowCascades::Update(const View& view, const glm::vec3& lightDirection) {
+    const size_t count = std::min(std::max<size_t>(m_settings.cascadeCount, 1), MAX_CASCADES);
+    const float nearPlane = view.nearPlane;
+    const float farPlane = std::min(view.farPlane, m_settings.maxDistance);
+
+    float splits[MAX_CASCADES];
+    ComputeSplits(nearPlane, farPlane, count, m_settings.splitLambda, splits);
+
+    // 光源觀察矩陣只由光源方向決定，相機移動時不變
+    const float directionLength = glm::length(lightDirection);
+    const glm::vec3 direction = directionLength > 0.0f ? lightDirection / directionLength : glm::vec3(0.0f, -1.0f, 0.0f);
+    const glm::vec3 up = std::fabs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    const glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), direction, up);
+    const glm::mat4 inverseView = glm::inverse(view.viewMatrix);
+
+    uint32_t changed = (!m_valid || count != m_cascadeCount) ? (1u << count) - 1 : 0u;
+    const float resolution = static_cast<float>(m_settings.resolution);
+
+    for (size_t i = 0; i < count; ++i) {
+        Cascade cascade;
+        cascade.splitNear = i == 0 ? nearPlane : splits[i - 1];
+        cascade.splitFar = splits[i];
+
+        float centerDepth;
+        float radius;
+        ComputeSliceSphere(view, cascade.splitNear, cascade.splitFar, centerDepth, radius);
+
+        // 涵蓋範圍與格距只取決於半徑；格距為整數個像素
+        const float halfExtent = radius * (1.0f + m_settings.snapFraction);
+        const float texelSize = 2.0f * halfExtent / resolution;
+        const float grid = texelSize * std::max(1.0f, std::floor(radius * m_settings.snapFraction / texelSize));
+
+        const glm::vec3 worldCenter = glm::vec3(inverseView * glm::vec4(0.0f, 0.0f, -centerDepth, 1.0f));
+        glm::vec3 lightCenter = glm::vec3(lightView * glm::vec4(worldCenter, 1.0f));
+        lightCenter.x = std::floor(lightCenter.x / grid) * grid;
+        lightCenter.y = std::floor(lightCenter.y / grid) * grid;
+        lightCenter.z = std::floor(lightCenter.z / grid) * grid;
+
+        // 光源觀察空間朝 -z 看，光源方向上游（投影物件所在）的 z 較大
+        const float extent = radius + grid;
+        const glm::mat4 projection = glm::ortho(lightCenter.x - halfExtent, lightCenter.x + halfExtent,
+                                                lightCenter.y - halfExtent, lightCenter.y + halfExtent,
+                                                -(lightCenter.z + extent + m_settings.casterDistance),
+                                                -(lightCenter.z - extent));
+        cascade.lightSpaceMatrix = projection * lightView;
+        cascade.texelSize = texelSize;
+
+        if (cascade.lightSpaceMatrix != m_cascades[i].lightSpaceMatrix) {
+            changed |= 1u << i;
+        }
+        m_cascades[i] = cascade;
+    }
+
+    m_cascadeCount = count;
+    m_valid = true;
+    return changed;
+}
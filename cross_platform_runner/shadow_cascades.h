@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+/**
+ * @file shadow_cascades.h
+ * @brief 方向光的串聯陰影貼圖（CSM）切割與投影
+ *
+ * 相機視錐依觀察深度切成數段，每段各用一張正交陰影貼圖，近處的段落涵蓋
+ * 範圍小、解析度高。切割距離採用對數與均勻切割的混合（practical split scheme）。
+ *
+ * 每段以包圍球而不是包圍盒擬合：球的半徑與相機方向無關，陰影貼圖的涵蓋範圍
+ * 不會隨相機轉動而縮放。球心在光源空間中對齊到固定的格點（涵蓋範圍的一小部分，
+ * 且為整數個貼圖像素），相機在格點內移動時投影矩陣完全不變，因此靜態物件的
+ * 深度可以快取，只在矩陣改變時重新繪製；對齊到像素也避免了陰影邊緣閃爍。
+ */
+
+class ShadowCascades {
+public:
+    static constexpr size_t MAX_CASCADES = 4;
+
+    struct Settings {
+        size_t cascadeCount = 4;
+        float maxDistance = 150.0f;     // 陰影涵蓋的最大觀察深度
+        float splitLambda = 0.75f;      // 0 為均勻切割，1 為對數切割
+        int resolution = 2048;          // 每段陰影貼圖的邊長（像素）
+        float casterDistance = 200.0f;  // 段落朝光源方向延伸的距離，涵蓋畫面外的投影物件
+        float snapFraction = 0.125f;    // 球心對齊的格距（相對於半徑），涵蓋範圍因此外擴同樣比例
+    };
+
+    // 相機參數；fovY 為弧度
+    struct View {
+        glm::mat4 viewMatrix = glm::mat4(1.0f);
+        float fovY = 0.785398f;
+        float aspectRatio = 1.0f;
+        float nearPlane = 0.1f;
+        float farPlane = 1000.0f;
+        bool orthographic = false;
+        float orthographicSize = 10.0f; // 正交投影的半高
+    };
+
+    struct Cascade {
+        glm::mat4 lightSpaceMatrix = glm::mat4(1.0f);  // 世界座標 -> 裁剪座標
+        float splitNear = 0.0f;
+        float splitFar = 0.0f;          // 觀察深度，著色器以此選擇段落
+        float texelSize = 0.0f;         // 一個陰影貼圖像素在世界座標中的寬度
+    };
+
+    // 計算 count 段的遠端切割距離，寫入 splits[0..count)
+    static void ComputeSplits(float nearPlane, float farPlane, size_t count, float lambda, float* splits);
+
+    void SetSettings(const Settings& settings);
+    const Settings& GetSettings() const { return m_settings; }
+
+    /**
+     * @brief 依相機與光源方向更新所有段落
+     * @return 投影矩陣與上一次不同的段落位元遮罩（第一次呼叫時全部為 1）
+     */
+    uint32_t Update(const View& view, const glm::vec3& lightDirection);
+
+    size_t GetCascadeCount() const { return m_cascadeCount; }
+    const Cascade& GetCascade(size_t index) const { return m_cascades[index]; }
+
+    // 讓下一次 Update 回報所有段落都已改變
+    void Invalidate() { m_valid = false; }
+
+private:
+    Settings m_settings;
+    std::array<Cascade, MAX_CASCADES> m_cascades;
+    size_t m_cascadeCount = 0;
+    bool m_valid = false;
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @file simulation_checkpoint.h
+ * @brief 模擬完整動態狀態的記憶體檢查點
+ *
+ * PhysicsEngine::SaveCheckpoint 將剛體變換、速度、休眠狀態、帶有暖啟動
+ * 衝量的接觸流形、約束衝量與力場狀態寫入單一記憶體區塊；
+ * RestoreCheckpoint 直接套用回現有世界，不需要從 PhysicsScene 重新建立，
+ * 可用於模擬中途分岔的假設分析與回溯。
+ *
+ * 區塊內容只在同一個行程內有效（直接複製 Bullet 的內部結構），
+ * 不可寫入磁碟或跨版本使用；需要持久化請使用 PhysicsRecorder。
+ */
+
+struct SimulationCheckpoint {
+    static constexpr uint32_t BLOB_VERSION = 4;
+
+    std::vector<uint8_t> data;
+
+    // 儲存時的剛體名稱表；與引擎目前的名稱表相同時可依索引直接還原
+    std::shared_ptr<const std::vector<std::string>> bodyNames;
+
+    double simulationTime = 0.0;
+
+    bool IsValid() const { return !data.empty(); }
+    size_t GetMemorySize() const { return data.capacity(); }
+    void Clear() { data.clear(); bodyNames.reset(); simulationTime = 0.0; }
+};
+
+/**
+ * @class CheckpointWriter
+ * @brief 以原始位元組附加到檢查點區塊
+ */
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(std::vector<uint8_t>& out) : m_out(out) {}
+
+    template<typename T>
+    void Write(const T& value) {
+        size_t offset = m_out.size();
+        m_out.resize(offset + sizeof(T));
+        std::memcpy(m_out.data() + offset, &value, sizeof(T));
+    }
+
+    void WriteBytes(const void* data, size_t size) {
+        size_t offset = m_out.size();
+        m_out.resize(offset + size);
+        std::memcpy(m_out.data() + offset, data, size);
+    }
+
+    void WriteString(const std::string& value) {
+        Write(static_cast<uint32_t>(value.size()));
+        WriteBytes(value.data(), value.size());
+    }
+
+private:
+    std::vector<uint8_t>& m_out;
+};
+
+/**
+ * @class CheckpointReader
+ * @brief 依寫入順序自檢查點區塊讀回資料；越界時回傳 false
+ */
+class CheckpointReader {
+public:
+    explicit CheckpointReader(const std::vector<uint8_t>& in) : m_in(in), m_pos(0) {}
+
+    template<typename T>
+    bool Read(T& value) {
+        return ReadBytes(&value, sizeof(T));
+    }
+
+    bool ReadBytes(void* data, size_t size) {
+        if (m_pos + size > m_in.size()) return false;
+        std::memcpy(data, m_in.data() + m_pos, size);
+        m_pos += size;
+        return true;
+    }
+
+    bool ReadString(std::string& value) {
+        uint32_t size = 0;
+        if (!Read(size) || m_pos + size > m_in.size()) return false;
+        value.assign(reinterpret_cast<const char*>(m_in.data() + m_pos), size);
+        m_pos += size;
+        return true;
+    }
+
+    bool AtEnd() const { return m_pos == m_in.size(); }
+
+private:
+    const std::vector<uint8_t>& m_in;
+    size_t m_pos;
+};
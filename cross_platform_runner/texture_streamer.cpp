@@ -0,0 +1,419 @@
+/**
+ * @file texture_streamer.cpp
+ * @brief 非同步紋理載入與串流實現
+ */
+
+#include "texture_streamer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr size_t BYTES_PER_PIXEL = 4;
+
+} // namespace
+
+TextureStreamer::TextureStreamer()
+    : m_initialized(false)
+    , m_uploadBufferIndex(0)
+    , m_placeholder(0)
+    , m_frame(0)
+    , m_nextRequest(0)
+    , m_decoder(&ImageDecoder::DecodeFile)
+    , m_stopping(false)
+{
+}
+
+TextureStreamer::~TextureStreamer() {
+    Shutdown();
+}
+
+bool TextureStreamer::Initialize() {
+    if (m_initialized) return true;
+
+    const uint8_t white[BYTES_PER_PIXEL] = {255, 255, 255, 255};
+    glGenTextures(1, &m_placeholder);
+    glBindTexture(GL_TEXTURE_2D, m_placeholder);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    for (auto& uploadBuffer : m_uploadBuffers) {
+        glGenBuffers(1, &uploadBuffer.buffer);
+    }
+    if (glGetError() != GL_NO_ERROR || m_placeholder == 0) {
+        m_lastError = "Failed to create texture streaming resources";
+        Shutdown();
+        return false;
+    }
+
+    // 初始化前送出的請求已在佇列中，執行緒啟動後開始處理
+    m_stopping = false;
+    const size_t threadCount = std::max<size_t>(1, m_settings.decodeThreads);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_decodeThreads.emplace_back(&TextureStreamer::DecodeThreadLoop, this);
+    }
+    m_initialized = true;
+    return true;
+}
+
+void TextureStreamer::Shutdown() {
+    StopDecodeThreads();
+
+    for (auto& entry : m_entries) {
+        DeleteTexture(entry.second);
+    }
+    m_entries.clear();
+    m_lru.clear();
+    m_uploadQueue.clear();
+
+    for (auto& uploadBuffer : m_uploadBuffers) {
+        if (uploadBuffer.fence) {
+            glDeleteSync(uploadBuffer.fence);
+        }
+        if (uploadBuffer.buffer != 0) {
+            glDeleteBuffers(1, &uploadBuffer.buffer);
+        }
+        uploadBuffer = UploadBuffer();
+    }
+    if (m_placeholder != 0) {
+        glDeleteTextures(1, &m_placeholder);
+        m_placeholder = 0;
+    }
+
+    m_statistics = Statistics();
+    m_uploadBufferIndex = 0;
+    m_initialized = false;
+}
+
+void TextureStreamer::SetSettings(const Settings& settings) {
+    m_settings = settings;
+    m_settings.uploadBytesPerFrame = std::max<size_t>(m_settings.uploadBytesPerFrame, BYTES_PER_PIXEL);
+    m_settings.decodeThreads = std::max<size_t>(m_settings.decodeThreads, 1);
+}
+
+void TextureStreamer::SetDecoder(Decoder decoder) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_decoder = decoder ? std::move(decoder) : Decoder(&ImageDecoder::DecodeFile);
+}
+
+void TextureStreamer::Request(const std::string& name, const std::string& filename) {
+    auto it = m_entries.find(name);
+    if (it != m_entries.end()) {
+        if (it->second.filename == filename && it->second.state != State::Failed) return;
+        DeleteTexture(it->second);
+    }
+
+    Entry& entry = m_entries[name];
+    entry.filename = filename;
+    StartDecode(name, entry);
+}
+
+void TextureStreamer::Release(const std::string& name) {
+    auto it = m_entries.find(name);
+    if (it == m_entries.end()) return;
+    // 解碼中或上傳佇列中的項目會因找不到名稱而被丟棄
+    DeleteTexture(it->second);
+    m_entries.erase(it);
+}
+
+bool TextureStreamer::IsResident(const std::string& name) const {
+    auto it = m_entries.find(name);
+    return it != m_entries.end() && it->second.state == State::Resident;
+}
+
+GLuint TextureStreamer::Acquire(const std::string& name) {
+    auto it = m_entries.find(name);
+    if (it == m_entries.end()) return m_placeholder;
+
+    Entry& entry = it->second;
+    entry.lastUsedFrame = m_frame;
+    switch (entry.state) {
+        case State::Resident:
+            Touch(name, entry);
+            return entry.texture;
+        case State::Evicted:
+            StartDecode(name, entry);
+            return m_placeholder;
+        default:
+            return m_placeholder;
+    }
+}
+
+/**
+ * @brief 推進串流：收取解碼結果、在上傳預算內分批上傳、超出記憶體預算時釋放
+ */
+void TextureStreamer::Update() {
+    if (!m_initialized) return;
+
+    CollectResults();
+    UploadPending();
+    EvictOverBudget();
+
+    m_statistics.residentTextures = m_lru.size();
+    m_statistics.pendingTextures = 0;
+    for (const auto& entry : m_entries) {
+        if (entry.second.state == State::Decoding || entry.second.state == State::Uploading) {
+            m_statistics.pendingTextures++;
+        }
+    }
+
+    // 之後的 Acquire 屬於新的影格
+    ++m_frame;
+}
+
+// ============================================================================
+// 解碼執行緒
+// ============================================================================
+
+void TextureStreamer::DecodeThreadLoop() {
+    for (;;) {
+        DecodeRequest request;
+        Decoder decoder;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_requests.empty(); });
+            if (m_stopping) return;
+            request = std::move(m_requests.front());
+            m_requests.pop_front();
+            decoder = m_decoder;
+        }
+
+        DecodeResult result;
+        result.name = std::move(request.name);
+        result.request = request.request;
+        result.success = decoder(request.filename, result.image, result.error);
+        const Image& image = result.image;
+        if (result.success &&
+            (image.width <= 0 || image.height <= 0 ||
+             image.pixels.size() != static_cast<size_t>(image.width) * image.height * BYTES_PER_PIXEL)) {
+            result.success = false;
+            result.error = request.filename + ": decoder returned an invalid image";
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_results.push_back(std::move(result));
+    }
+}
+
+void TextureStreamer::StopDecodeThreads() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    for (auto& thread : m_decodeThreads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    m_decodeThreads.clear();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_requests.clear();
+    m_results.clear();
+    m_stopping = false;
+}
+
+void TextureStreamer::StartDecode(const std::string& name, Entry& entry) {
+    entry.state = State::Decoding;
+    entry.request = ++m_nextRequest;
+    entry.uploadedRows = 0;
+    entry.image = Image();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requests.push_back({name, entry.filename, entry.request});
+    }
+    m_condition.notify_one();
+}
+
+// ============================================================================
+// 主執行緒
+// ============================================================================
+
+void TextureStreamer::CollectResults() {
+    std::vector<DecodeResult> results;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        results.swap(m_results);
+    }
+
+    for (auto& result : results) {
+        // 已釋放或重新請求的紋理，結果已過期
+        auto it = m_entries.find(result.name);
+        if (it == m_entries.end() || it->second.request != result.request || it->second.state != State::Decoding) {
+            continue;
+        }
+
+        Entry& entry = it->second;
+        if (!result.success) {
+            entry.state = State::Failed;
+            m_lastError = result.error;
+            m_statistics.failedTextures++;
+            continue;
+        }
+        entry.image = std::move(result.image);
+        entry.uploadedRows = 0;
+        entry.state = State::Uploading;
+        m_uploadQueue.emplace_back(result.name, result.request);
+    }
+}
+
+/**
+ * @brief 把佇列前端的影像逐列寫入下一個 PBO，再以 glTexSubImage2D 從 PBO 上傳
+ *
+ * 每次最多寫入 uploadBytesPerFrame 位元組（至少一列），未完成的紋理留到下一影格繼續。
+ * 紋理在所有列送出後產生 mipmap 並成為常駐紋理。
+ */
+void TextureStreamer::UploadPending() {
+    m_statistics.uploadedBytes = 0;
+
+    // 佇列前端的有效項目；已釋放或重新請求的項目直接丟棄
+    const auto frontEntry = [this]() -> std::pair<const std::string, Entry>* {
+        while (!m_uploadQueue.empty()) {
+            auto it = m_entries.find(m_uploadQueue.front().first);
+            if (it != m_entries.end() && it->second.request == m_uploadQueue.front().second &&
+                it->second.state == State::Uploading) {
+                return &*it;
+            }
+            m_uploadQueue.pop_front();
+        }
+        return nullptr;
+    };
+    auto* first = frontEntry();
+    if (!first) return;
+
+    UploadBuffer& uploadBuffer = m_uploadBuffers[m_uploadBufferIndex];
+    m_uploadBufferIndex = (m_uploadBufferIndex + 1) % UPLOAD_BUFFER_COUNT;
+    if (uploadBuffer.fence) {
+        glClientWaitSync(uploadBuffer.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        glDeleteSync(uploadBuffer.fence);
+        uploadBuffer.fence = nullptr;
+    }
+
+    const size_t budget = m_settings.uploadBytesPerFrame;
+    const size_t capacity = std::max(budget, static_cast<size_t>(first->second.image.width) * BYTES_PER_PIXEL);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBuffer.buffer);
+    if (uploadBuffer.capacity < capacity) {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(capacity), nullptr, GL_STREAM_DRAW);
+        uploadBuffer.capacity = capacity;
+    }
+    auto* mapped = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0,
+                                                          static_cast<GLsizeiptr>(uploadBuffer.capacity),
+                                                          GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    if (!mapped) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return;
+    }
+
+    // 每個紋理在一次 Update 中最多出現一次：未完成表示 PBO 已滿
+    struct PendingUpload {
+        std::pair<const std::string, Entry>* item;
+        int firstRow;
+        int rowCount;
+        size_t offset;
+    };
+    std::vector<PendingUpload> uploads;
+    size_t offset = 0;
+    for (auto* item = first; item && offset < budget; item = frontEntry()) {
+        Entry& entry = item->second;
+        const size_t rowBytes = static_cast<size_t>(entry.image.width) * BYTES_PER_PIXEL;
+        const int rows = static_cast<int>(std::min(static_cast<size_t>(entry.image.height - entry.uploadedRows),
+                                                   (uploadBuffer.capacity - offset) / rowBytes));
+        if (rows <= 0) break;
+
+        std::memcpy(mapped + offset, entry.image.pixels.data() + static_cast<size_t>(entry.uploadedRows) * rowBytes,
+                    static_cast<size_t>(rows) * rowBytes);
+        uploads.push_back({item, entry.uploadedRows, rows, offset});
+        entry.uploadedRows += rows;
+        offset += static_cast<size_t>(rows) * rowBytes;
+
+        if (entry.uploadedRows < entry.image.height) break;
+        m_uploadQueue.pop_front();
+    }
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    // 配置紋理儲存空間時不能綁定 PBO，否則 nullptr 會被視為 PBO 位移
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    for (const auto& upload : uploads) {
+        Entry& entry = upload.item->second;
+        if (entry.texture != 0) continue;
+        glGenTextures(1, &entry.texture);
+        glBindTexture(GL_TEXTURE_2D, entry.texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, entry.image.width, entry.image.height, 0, GL_RGBA,
+                     GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        // 完整 mipmap 鏈約為基底層的 4/3
+        entry.bytes = static_cast<size_t>(entry.image.width) * entry.image.height * BYTES_PER_PIXEL * 4 / 3;
+        m_statistics.textureBytes += entry.bytes;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBuffer.buffer);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (const auto& upload : uploads) {
+        Entry& entry = upload.item->second;
+        glBindTexture(GL_TEXTURE_2D, entry.texture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, upload.firstRow, entry.image.width, upload.rowCount, GL_RGBA,
+                        GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(upload.offset));
+        if (entry.uploadedRows == entry.image.height) {
+            glGenerateMipmap(GL_TEXTURE_2D);
+            entry.image = Image();
+            entry.state = State::Resident;
+            // 剛載入的紋理視為本影格使用，避免立即被釋放
+            entry.lastUsedFrame = m_frame;
+            Touch(upload.item->first, entry);
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    uploadBuffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_statistics.uploadedBytes = offset;
+}
+
+/**
+ * @brief 超出記憶體預算時從最久未使用的常駐紋理開始釋放
+ *
+ * 本影格用過的紋理不釋放；即使如此仍超出預算時暫時維持超出。
+ */
+void TextureStreamer::EvictOverBudget() {
+    while (m_statistics.textureBytes > m_settings.memoryBudgetBytes && !m_lru.empty()) {
+        Entry& entry = m_entries.at(m_lru.back());
+        if (entry.lastUsedFrame >= m_frame) break;
+        DeleteTexture(entry);
+        entry.state = State::Evicted;
+        m_statistics.evictedTextures++;
+    }
+}
+
+// 移到 LRU 最前面
+void TextureStreamer::Touch(const std::string& name, Entry& entry) {
+    if (entry.inLru) {
+        m_lru.splice(m_lru.begin(), m_lru, entry.lruPosition);
+    } else {
+        entry.lruPosition = m_lru.insert(m_lru.begin(), name);
+        entry.inLru = true;
+    }
+}
+
+// 刪除紋理物件並移出 LRU；狀態由呼叫端設定
+void TextureStreamer::DeleteTexture(Entry& entry) {
+    if (entry.inLru) {
+        m_lru.erase(entry.lruPosition);
+        entry.inLru = false;
+    }
+    if (entry.texture != 0) {
+        glDeleteTextures(1, &entry.texture);
+        entry.texture = 0;
+        m_statistics.textureBytes -= entry.bytes;
+    }
+    entry.bytes = 0;
+    entry.uploadedRows = 0;
+    entry.image = Image();
+}
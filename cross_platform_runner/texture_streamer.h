@@ -0,0 +1,172 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// OpenGL
+#include <GL/glew.h>
+
+#include "image_decoder.h"
+
+/**
+ * @file texture_streamer.h
+ * @brief 非同步紋理載入與串流
+ *
+ * 讀檔與解碼在背景執行緒進行；主執行緒在 Update 中把解碼好的影像經由
+ * pixel buffer object 分批上傳，每個影格上傳的位元組數有上限，大型紋理會
+ * 分散到多個影格。紋理就緒前 Acquire 回傳佔位紋理（1x1 白色）。
+ *
+ * 常駐紋理以 LRU 管理：總記憶體超過預算時，從最久未使用的紋理開始釋放，
+ * 本影格使用過的紋理不會被釋放。被釋放的紋理再次 Acquire 時會重新載入。
+ *
+ * 預設以 ImageDecoder 解碼，其他格式可以 SetDecoder 換成外部解碼器。
+ */
+
+class TextureStreamer {
+public:
+    struct Settings {
+        size_t memoryBudgetBytes = 256u << 20;      // 常駐紋理（含 mipmap）的記憶體上限
+        size_t uploadBytesPerFrame = 4u << 20;      // 每次 Update 最多上傳的位元組數
+        size_t decodeThreads = 2;
+    };
+
+    struct Statistics {
+        size_t residentTextures = 0;
+        size_t pendingTextures = 0;     // 解碼或上傳中
+        size_t textureBytes = 0;        // 紋理佔用的 GPU 記憶體（含上傳中的紋理與 mipmap）
+        size_t uploadedBytes = 0;       // 上一次 Update 上傳的位元組數
+        uint64_t evictedTextures = 0;
+        uint64_t failedTextures = 0;
+    };
+
+    using Image = ImageDecoder::Image;
+
+    // 在背景執行緒呼叫，必須可重入；輸出格式與 ImageDecoder 相同
+    using Decoder = std::function<bool(const std::string& filename, Image& image, std::string& error)>;
+
+    TextureStreamer();
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // 建立佔位紋理並啟動解碼執行緒；需要有效的 OpenGL 上下文
+    bool Initialize();
+    // 停止解碼執行緒並刪除所有紋理
+    void Shutdown();
+    bool IsInitialized() const { return m_initialized; }
+
+    // 解碼執行緒數在下一次 Initialize 時生效
+    void SetSettings(const Settings& settings);
+    const Settings& GetSettings() const { return m_settings; }
+    void SetDecoder(Decoder decoder);
+
+    // 登記並開始非同步載入；同名紋理的檔案不同時重新載入
+    void Request(const std::string& name, const std::string& filename);
+    void Release(const std::string& name);
+    bool Has(const std::string& name) const { return m_entries.count(name) != 0; }
+    bool IsResident(const std::string& name) const;
+
+    /**
+     * @brief 取得可綁定的紋理並標記為本影格使用
+     *
+     * 未就緒、載入失敗或未登記時回傳佔位紋理；已被釋放的紋理會重新載入。
+     */
+    GLuint Acquire(const std::string& name);
+    GLuint GetPlaceholder() const { return m_placeholder; }
+
+    // 每個影格在主執行緒呼叫一次：收取解碼結果、分批上傳、依預算釋放
+    void Update();
+
+    const Statistics& GetStatistics() const { return m_statistics; }
+    // 最近一次載入失敗的原因
+    const std::string& GetLastError() const { return m_lastError; }
+
+private:
+    enum class State {
+        Decoding,
+        Uploading,
+        Resident,
+        Evicted,    // 因預算被釋放，再次使用時重新載入
+        Failed
+    };
+
+    struct Entry {
+        std::string filename;
+        State state = State::Decoding;
+        uint64_t request = 0;           // 最新一次請求的編號，用來丟棄過期的結果
+        GLuint texture = 0;
+        Image image;                    // 上傳中的影像，完成後釋放
+        int uploadedRows = 0;
+        size_t bytes = 0;               // 紋理物件佔用的記憶體（含 mipmap），配置時計入 textureBytes
+        uint64_t lastUsedFrame = 0;
+        std::list<std::string>::iterator lruPosition;
+        bool inLru = false;
+    };
+
+    struct DecodeRequest {
+        std::string name;
+        std::string filename;
+        uint64_t request;
+    };
+
+    struct DecodeResult {
+        std::string name;
+        uint64_t request;
+        bool success;
+        std::string error;
+        Image image;
+    };
+
+    // 上傳用的 PBO，輪流使用並以 fence 確認 GPU 已讀完
+    struct UploadBuffer {
+        GLuint buffer = 0;
+        size_t capacity = 0;
+        GLsync fence = nullptr;
+    };
+    static constexpr size_t UPLOAD_BUFFER_COUNT = 3;
+
+    void DecodeThreadLoop();
+    void StopDecodeThreads();
+    void StartDecode(const std::string& name, Entry& entry);
+
+    void CollectResults();
+    void UploadPending();
+    void EvictOverBudget();
+    void Touch(const std::string& name, Entry& entry);
+    void DeleteTexture(Entry& entry);
+
+    Settings m_settings;
+    Statistics m_statistics;
+    std::string m_lastError;
+    bool m_initialized;
+
+    // 只由主執行緒存取
+    std::unordered_map<std::string, Entry> m_entries;
+    std::list<std::string> m_lru;               // 常駐紋理，最近使用的在前
+    std::deque<std::pair<std::string, uint64_t>> m_uploadQueue;    // 等待上傳的（名稱、請求編號），依解碼完成順序
+    UploadBuffer m_uploadBuffers[UPLOAD_BUFFER_COUNT];
+    size_t m_uploadBufferIndex;
+    GLuint m_placeholder;
+    uint64_t m_frame;
+    uint64_t m_nextRequest;
+
+    // 解碼執行緒；佇列、結果與解碼器由 m_mutex 保護
+    std::vector<std::thread> m_decodeThreads;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<DecodeRequest> m_requests;
+    std::vector<DecodeResult> m_results;
+    Decoder m_decoder;
+    bool m_stopping;
+};
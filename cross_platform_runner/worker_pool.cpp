@@ -0,0 +1,102 @@
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <system_error>
+
+WorkerPool::WorkerPool(size_t workerCount)
+    : m_function(nullptr)
+    , m_count(0)
+    , m_grainSize(1)
+    , m_nextIndex(0)
+    , m_generation(0)
+    , m_activeWorkers(0)
+    , m_stopping(false)
+{
+    m_workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        // 無法建立更多執行緒時以已建立的執行緒運作；一個都沒有時 ParallelFor 在呼叫端執行
+        try {
+            m_workers.emplace_back(&WorkerPool::WorkerLoop, this);
+        } catch (const std::system_error&) {
+            break;
+        }
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeCondition.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+size_t WorkerPool::DefaultWorkerCount() {
+    const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+void WorkerPool::ParallelFor(size_t count, size_t grainSize, const RangeFunction& function) {
+    if (count == 0) return;
+    grainSize = std::max<size_t>(grainSize, 1);
+
+    // 工作量不足一個區塊或沒有工作執行緒時直接在呼叫端執行
+    if (m_workers.empty() || count <= grainSize) {
+        function(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> dispatchLock(m_dispatchMutex);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_function = &function;
+        m_count = count;
+        m_grainSize = grainSize;
+        m_nextIndex.store(0, std::memory_order_relaxed);
+        m_activeWorkers = m_workers.size();
+        ++m_generation;
+    }
+    m_wakeCondition.notify_all();
+
+    RunChunks();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this] { return m_activeWorkers == 0; });
+    m_function = nullptr;
+}
+
+void WorkerPool::WorkerLoop() {
+    uint64_t seenGeneration = 0;
+
+    while (true) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wakeCondition.wait(lock, [&] { return m_stopping || m_generation != seenGeneration; });
+        if (m_stopping) return;
+        seenGeneration = m_generation;
+        lock.unlock();
+
+        RunChunks();
+
+        lock.lock();
+        if (--m_activeWorkers == 0) {
+            m_doneCondition.notify_one();
+        }
+    }
+}
+
+void WorkerPool::RunChunks() {
+    const RangeFunction& function = *m_function;
+    const size_t count = m_count;
+    const size_t grainSize = m_grainSize;
+
+    while (true) {
+        const size_t begin = m_nextIndex.fetch_add(grainSize, std::memory_order_relaxed);
+        if (begin >= count) break;
+        function(begin, std::min(begin + grainSize, count));
+    }
+}
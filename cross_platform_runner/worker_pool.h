@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file worker_pool.h
+ * @brief 固定大小的工作執行緒池
+ *
+ * 提供 ParallelFor：將 [0, count) 切成固定大小的區塊，由工作執行緒與
+ * 呼叫端執行緒共同領取，全部完成後才返回。執行緒在建構時建立並重複使用，
+ * 每次分派只需要一次喚醒，適合每個模擬步驟都要執行的短小工作。
+ */
+
+class WorkerPool {
+public:
+    using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+    // workerCount 為額外建立的執行緒數，呼叫端執行緒也會參與工作
+    explicit WorkerPool(size_t workerCount = DefaultWorkerCount());
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // 平行執行 function(begin, end)；function 不可拋出例外，
+    // 同一時間只會有一個 ParallelFor 在執行，其餘呼叫端會等待
+    void ParallelFor(size_t count, size_t grainSize, const RangeFunction& function);
+
+    size_t GetWorkerCount() const { return m_workers.size(); }
+
+    // 硬體執行緒數減去呼叫端執行緒
+    static size_t DefaultWorkerCount();
+
+private:
+    void WorkerLoop();
+    void RunChunks();
+
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_dispatchMutex;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeCondition;
+    std::condition_variable m_doneCondition;
+
+    // 目前的工作；由 m_mutex 保護寫入，工作執行緒在喚醒後讀取
+    const RangeFunction* m_function;
+    size_t m_count;
+    size_t m_grainSize;
+    std::atomic<size_t> m_nextIndex;
+
+    uint64_t m_generation;
+    size_t m_activeWorkers;
+    bool m_stopping;
+};
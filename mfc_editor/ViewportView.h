@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../scene_format/physics_scene_format.h"
+#include "../cross_platform_runner/frame_snapshot.h"
 #include <gl/GL.h>
 #include <gl/GLU.h>
 
@@ -123,6 +124,9 @@ public:
 	void SetSelectedObjects(const CStringArray& objects);
 	void SetActiveObject(const CString& objectName);
 
+	// 模擬預覽：由快照環形緩衝區讀取剛體狀態，不直接存取物理引擎
+	void SetSnapshotSource(const SnapshotRing* pRing);
+
 	// 相機控制
 	void SetCameraPosition(const PhysicsScene::Vector3& position);
 	void SetCameraTarget(const PhysicsScene::Vector3& target);
@@ -300,6 +304,11 @@ private:
 	const PhysicsScene::PhysicsScene* m_pScene;
 	BOOL m_bSceneChanged;
 
+	// 模擬快照
+	const SnapshotRing* m_pSnapshotRing;
+	SnapshotRing::ReadHandle m_simulationFrame;
+	void AcquireSimulationFrame();
+
 	// 渲染快取
 	struct RenderCache {
 		GLuint gridDisplayList;
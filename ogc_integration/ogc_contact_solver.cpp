@@ -0,0 +1,270 @@
+#include "ogc_contact_solver.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../cross_platform_runner/worker_pool.h"
+
+using Eigen::Matrix3f;
+using Eigen::Vector3f;
+
+namespace {
+
+// 每個工作區塊處理的接觸數
+constexpr size_t CONTACT_GRAIN_SIZE = 64;
+
+// 與 normal 正交的兩個單位切向量
+void ComputeTangents(const Vector3f& normal, Vector3f& tangent0, Vector3f& tangent1) {
+    if (std::fabs(normal.x()) > 0.57735f) {
+        tangent0 = Vector3f(normal.y(), -normal.x(), 0.0f);
+    } else {
+        tangent0 = Vector3f(0.0f, normal.z(), -normal.y());
+    }
+    tangent0.normalize();
+    tangent1 = normal.cross(tangent0);
+}
+
+// 第一個為 0 的位元位置；mask 必須不是全 1
+size_t FirstFreeBatch(uint64_t mask) {
+    size_t index = 0;
+    while (mask & 1u) {
+        mask >>= 1;
+        ++index;
+    }
+    return index;
+}
+
+} // namespace
+
+OGCContactSolver::OGCContactSolver()
+    : m_workerPool(nullptr)
+{
+}
+
+OGCContactSolver::~OGCContactSolver() = default;
+
+void OGCContactSolver::Solve(const std::vector<BodyState>& bodies,
+                             const std::vector<ContactPoint>& contacts,
+                             float timeStep,
+                             std::vector<ContactImpulse>& impulses) {
+    m_statistics = Statistics();
+    impulses.resize(contacts.size());
+    if (contacts.empty() || timeStep <= 0.0f) {
+        std::fill(impulses.begin(), impulses.end(), ContactImpulse());
+        return;
+    }
+
+    // 複製剛體速度作為求解狀態
+    const size_t bodyCount = bodies.size();
+    m_linearVelocity.resize(bodyCount);
+    m_angularVelocity.resize(bodyCount);
+    m_inverseMass.resize(bodyCount);
+    m_inverseInertia.resize(bodyCount);
+    for (size_t i = 0; i < bodyCount; ++i) {
+        m_linearVelocity[i] = bodies[i].linearVelocity;
+        m_angularVelocity[i] = bodies[i].angularVelocity;
+        m_inverseMass[i] = bodies[i].inverseMass;
+        m_inverseInertia[i] = bodies[i].inverseInertia;
+    }
+
+    BuildBatches(bodies, contacts);
+    PrepareContacts(bodies, contacts, timeStep);
+    WarmStart();
+
+    const int iterations = std::max(m_settings.iterations, 1);
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        for (size_t batch = 0; batch + 1 < m_batchOffsets.size(); ++batch) {
+            SolveBatch(batch);
+        }
+    }
+
+    for (size_t i = 0; i < contacts.size(); ++i) {
+        const SolverContact& contact = m_contacts[i];
+        impulses[i].normalImpulse = contact.normalImpulse;
+        impulses[i].impulse = contact.normal * contact.normalImpulse +
+                              contact.tangent[0] * contact.tangentImpulse[0] +
+                              contact.tangent[1] * contact.tangentImpulse[1];
+    }
+
+    m_statistics.contactCount = static_cast<int>(contacts.size());
+    m_statistics.iterations = iterations;
+}
+
+/**
+ * 貪婪著色：每個接觸放入兩個動態剛體都尚未出現的第一個批次。
+ * 靜態剛體不會被寫入，可同時出現在同一批次的多個接觸中。
+ * 超過 MAX_BATCHES 仍無法放入的接觸歸入最後的依序批次。
+ */
+void OGCContactSolver::BuildBatches(const std::vector<BodyState>& bodies, const std::vector<ContactPoint>& contacts) {
+    m_bodyBatchMask.assign(bodies.size(), 0);
+    m_contactBatch.resize(contacts.size());
+
+    std::vector<size_t> batchSizes(MAX_BATCHES + 1, 0);
+    for (size_t i = 0; i < contacts.size(); ++i) {
+        const ContactPoint& contact = contacts[i];
+        const bool dynamicA = bodies[contact.bodyA].inverseMass > 0.0f;
+        const bool dynamicB = bodies[contact.bodyB].inverseMass > 0.0f;
+
+        uint64_t used = 0;
+        if (dynamicA) used |= m_bodyBatchMask[contact.bodyA];
+        if (dynamicB) used |= m_bodyBatchMask[contact.bodyB];
+
+        size_t batch = MAX_BATCHES;
+        if (used != ~uint64_t(0)) {
+            batch = FirstFreeBatch(used);
+            const uint64_t bit = uint64_t(1) << batch;
+            if (dynamicA) m_bodyBatchMask[contact.bodyA] |= bit;
+            if (dynamicB) m_bodyBatchMask[contact.bodyB] |= bit;
+        }
+        m_contactBatch[i] = static_cast<uint32_t>(batch);
+        ++batchSizes[batch];
+    }
+
+    // 計數排序，保留批次內的原始順序
+    m_batchOffsets.clear();
+    m_batchOffsets.push_back(0);
+    for (size_t batch = 0; batch <= MAX_BATCHES; ++batch) {
+        if (batchSizes[batch] == 0 && batch < MAX_BATCHES) continue;
+        m_batchOffsets.push_back(m_batchOffsets.back() + batchSizes[batch]);
+    }
+
+    std::vector<size_t> cursor(MAX_BATCHES + 1, 0);
+    size_t offset = 0;
+    for (size_t batch = 0; batch <= MAX_BATCHES; ++batch) {
+        cursor[batch] = offset;
+        offset += batchSizes[batch];
+    }
+    m_batchOrder.resize(contacts.size());
+    for (size_t i = 0; i < contacts.size(); ++i) {
+        m_batchOrder[cursor[m_contactBatch[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    m_statistics.serialContactCount = static_cast<int>(batchSizes[MAX_BATCHES]);
+    m_statistics.batchCount = static_cast<int>(m_batchOffsets.size()) - (batchSizes[MAX_BATCHES] > 0 ? 1 : 2);
+}
+
+void OGCContactSolver::PrepareContacts(const std::vector<BodyState>& bodies,
+                                       const std::vector<ContactPoint>& contacts,
+                                       float timeStep) {
+    const float inverseTimeStep = 1.0f / timeStep;
+    m_contacts.resize(contacts.size());
+
+    for (size_t i = 0; i < contacts.size(); ++i) {
+        const ContactPoint& input = contacts[i];
+        const BodyState& bodyA = bodies[input.bodyA];
+        const BodyState& bodyB = bodies[input.bodyB];
+        SolverContact& contact = m_contacts[i];
+
+        contact.bodyA = input.bodyA;
+        contact.bodyB = input.bodyB;
+        contact.relativeA = input.pointA - bodyA.position;
+        contact.relativeB = input.pointB - bodyB.position;
+        contact.normal = input.normal;
+        ComputeTangents(contact.normal, contact.tangent[0], contact.tangent[1]);
+        contact.friction = input.friction;
+
+        // 有效質量
+        auto effectiveMass = [&](const Vector3f& direction) {
+            const Vector3f crossA = contact.relativeA.cross(direction);
+            const Vector3f crossB = contact.relativeB.cross(direction);
+            const float k = bodyA.inverseMass + bodyB.inverseMass +
+                            crossA.dot(bodyA.inverseInertia * crossA) +
+                            crossB.dot(bodyB.inverseInertia * crossB);
+            return k > 0.0f ? 1.0f / k : 0.0f;
+        };
+        contact.normalMass = effectiveMass(contact.normal);
+        contact.tangentMass[0] = effectiveMass(contact.tangent[0]);
+        contact.tangentMass[1] = effectiveMass(contact.tangent[1]);
+
+        // 偏移接觸的速度偏差：間隙內允許接近到剛好閉合，穿透時以有限速度推開
+        float bias;
+        if (input.distance > 0.0f) {
+            bias = input.distance * inverseTimeStep;
+        } else {
+            bias = std::max(m_settings.baumgarte * input.distance * inverseTimeStep,
+                            -m_settings.maxCorrectionVelocity);
+        }
+
+        // 反彈
+        const Vector3f relativeVelocity =
+            (bodyA.linearVelocity + bodyA.angularVelocity.cross(contact.relativeA)) -
+            (bodyB.linearVelocity + bodyB.angularVelocity.cross(contact.relativeB));
+        const float normalVelocity = relativeVelocity.dot(contact.normal);
+        if (normalVelocity < -m_settings.restitutionThreshold && input.restitution > 0.0f) {
+            bias = std::min(bias, input.restitution * normalVelocity);
+        }
+        contact.bias = bias;
+
+        contact.normalImpulse = std::max(input.warmStartImpulse, 0.0f) * m_settings.warmStartFactor;
+        contact.tangentImpulse[0] = 0.0f;
+        contact.tangentImpulse[1] = 0.0f;
+    }
+}
+
+void OGCContactSolver::WarmStart() {
+    for (const SolverContact& contact : m_contacts) {
+        if (contact.normalImpulse > 0.0f) {
+            ApplyImpulse(contact, contact.normal * contact.normalImpulse);
+        }
+    }
+}
+
+void OGCContactSolver::SolveBatch(size_t batch) {
+    const size_t begin = m_batchOffsets[batch];
+    const size_t end = m_batchOffsets[batch + 1];
+    const size_t count = end - begin;
+    const bool serialBatch = batch + 2 == m_batchOffsets.size() && m_statistics.serialContactCount > 0;
+
+    auto solveRange = [this, begin](size_t rangeBegin, size_t rangeEnd) {
+        for (size_t k = begin + rangeBegin; k < begin + rangeEnd; ++k) {
+            SolveContact(m_contacts[m_batchOrder[k]]);
+        }
+    };
+
+    if (m_workerPool && !serialBatch && count >= m_settings.parallelThreshold) {
+        m_workerPool->ParallelFor(count, CONTACT_GRAIN_SIZE, solveRange);
+    } else {
+        solveRange(0, count);
+    }
+}
+
+void OGCContactSolver::SolveContact(SolverContact& contact) {
+    auto relativeVelocity = [&]() -> Vector3f {
+        return (m_linearVelocity[contact.bodyA] + m_angularVelocity[contact.bodyA].cross(contact.relativeA)) -
+               (m_linearVelocity[contact.bodyB] + m_angularVelocity[contact.bodyB].cross(contact.relativeB));
+    };
+
+    // 法向：累積衝量不得為負
+    {
+        const float normalVelocity = relativeVelocity().dot(contact.normal);
+        const float lambda = -contact.normalMass * (normalVelocity + contact.bias);
+        const float previous = contact.normalImpulse;
+        contact.normalImpulse = std::max(previous + lambda, 0.0f);
+        ApplyImpulse(contact, contact.normal * (contact.normalImpulse - previous));
+    }
+
+    // 摩擦：限制在 Coulomb 摩擦錐（以兩個切向分別近似）
+    const float maxFriction = contact.friction * contact.normalImpulse;
+    for (int axis = 0; axis < 2; ++axis) {
+        const float tangentVelocity = relativeVelocity().dot(contact.tangent[axis]);
+        const float lambda = -contact.tangentMass[axis] * tangentVelocity;
+        const float previous = contact.tangentImpulse[axis];
+        contact.tangentImpulse[axis] = std::clamp(previous + lambda, -maxFriction, maxFriction);
+        ApplyImpulse(contact, contact.tangent[axis] * (contact.tangentImpulse[axis] - previous));
+    }
+}
+
+void OGCContactSolver::ApplyImpulse(const SolverContact& contact, const Vector3f& impulse) {
+    // 只寫入動態剛體，靜態剛體可被同一批次的多個接觸同時讀取
+    const float inverseMassA = m_inverseMass[contact.bodyA];
+    if (inverseMassA > 0.0f) {
+        m_linearVelocity[contact.bodyA] += impulse * inverseMassA;
+        m_angularVelocity[contact.bodyA] += m_inverseInertia[contact.bodyA] * contact.relativeA.cross(impulse);
+    }
+
+    const float inverseMassB = m_inverseMass[contact.bodyB];
+    if (inverseMassB > 0.0f) {
+        m_linearVelocity[contact.bodyB] -= impulse * inverseMassB;
+        m_angularVelocity[contact.bodyB] -= m_inverseInertia[contact.bodyB] * contact.relativeB.cross(impulse);
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Eigen
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+class WorkerPool;
+
+/**
+ * @file ogc_contact_solver.h
+ * @brief OGC (Offset Geometric Contact) 接觸求解器
+ *
+ * 接觸在兩物體距離小於偏移半徑 (contactRadius) 時即啟動，不必等到穿透：
+ * 間隙內的接觸以「下一步不得越過間隙」作為速度約束（推測式接觸），
+ * 已穿透的接觸則以 Baumgarte 偏移推開，因此不需要連續碰撞檢測。
+ *
+ * 求解器每一步接收一份扁平的接觸陣列，先以貪婪著色把接觸分成批次，
+ * 同一批次內沒有兩個接觸共用同一個動態剛體，可平行求解而不需鎖；
+ * 批次之間依序進行，結果與執行緒數無關。
+ */
+
+class OGCContactSolver {
+public:
+    struct Settings {
+        float contactRadius = 0.01f;           // 偏移半徑（公尺）
+        int iterations = 10;
+        float baumgarte = 0.2f;                // 每步修正的穿透比例
+        float maxCorrectionVelocity = 2.0f;    // 穿透修正的速度上限（公尺/秒）
+        float restitutionThreshold = 0.5f;     // 接近速度低於此值時不反彈（公尺/秒）
+        float warmStartFactor = 0.85f;
+        size_t parallelThreshold = 256;        // 批次接觸數低於此值時在呼叫端執行緒求解
+    };
+
+    // 剛體狀態（世界座標）；inverseMass 為 0 表示靜態或運動學剛體
+    struct BodyState {
+        Eigen::Vector3f position = Eigen::Vector3f::Zero();       // 質心
+        Eigen::Vector3f linearVelocity = Eigen::Vector3f::Zero();
+        Eigen::Vector3f angularVelocity = Eigen::Vector3f::Zero();
+        Eigen::Matrix3f inverseInertia = Eigen::Matrix3f::Zero();
+        float inverseMass = 0.0f;
+    };
+
+    // 接觸點；bodyA / bodyB 為 BodyState 陣列中的索引
+    struct ContactPoint {
+        uint32_t bodyA = 0;
+        uint32_t bodyB = 0;
+        Eigen::Vector3f pointA = Eigen::Vector3f::Zero();
+        Eigen::Vector3f pointB = Eigen::Vector3f::Zero();
+        Eigen::Vector3f normal = Eigen::Vector3f::UnitY();        // 由 B 指向 A
+        float distance = 0.0f;                                    // 正值為間隙，負值為穿透
+        float friction = 0.5f;
+        float restitution = 0.0f;
+        float warmStartImpulse = 0.0f;                            // 上一步的法向衝量
+    };
+
+    // 求解結果；impulse 施加於 A 的 pointA，B 的 pointB 承受相反衝量
+    struct ContactImpulse {
+        Eigen::Vector3f impulse = Eigen::Vector3f::Zero();
+        float normalImpulse = 0.0f;
+    };
+
+    struct Statistics {
+        int contactCount = 0;
+        int batchCount = 0;
+        int serialContactCount = 0;   // 無法著色而依序求解的接觸數
+        int iterations = 0;
+    };
+
+    OGCContactSolver();
+    ~OGCContactSolver();
+
+    void SetSettings(const Settings& settings) { m_settings = settings; }
+    const Settings& GetSettings() const { return m_settings; }
+
+    // 未設定時所有批次都在呼叫端執行緒求解
+    void SetWorkerPool(WorkerPool* workerPool) { m_workerPool = workerPool; }
+
+    // 求解接觸，impulses 與 contacts 一一對應
+    void Solve(const std::vector<BodyState>& bodies,
+               const std::vector<ContactPoint>& contacts,
+               float timeStep,
+               std::vector<ContactImpulse>& impulses);
+
+    const Statistics& GetStatistics() const { return m_statistics; }
+
+private:
+    // 求解用的預先計算資料
+    struct SolverContact {
+        uint32_t bodyA;
+        uint32_t bodyB;
+        Eigen::Vector3f relativeA;
+        Eigen::Vector3f relativeB;
+        Eigen::Vector3f normal;
+        Eigen::Vector3f tangent[2];
+        float normalMass;
+        float tangentMass[2];
+        float bias;
+        float friction;
+        float normalImpulse;
+        float tangentImpulse[2];
+    };
+
+    // 同時可平行的批次數上限（每個剛體以 64 位元遮罩記錄所在批次）
+    static constexpr size_t MAX_BATCHES = 64;
+
+    void BuildBatches(const std::vector<BodyState>& bodies, const std::vector<ContactPoint>& contacts);
+    void PrepareContacts(const std::vector<BodyState>& bodies, const std::vector<ContactPoint>& contacts, float timeStep);
+    void WarmStart();
+    void SolveBatch(size_t batch);
+    void SolveContact(SolverContact& contact);
+    void ApplyImpulse(const SolverContact& contact, const Eigen::Vector3f& impulse);
+
+    Settings m_settings;
+    Statistics m_statistics;
+    WorkerPool* m_workerPool;
+
+    // 求解中的剛體速度
+    std::vector<Eigen::Vector3f> m_linearVelocity;
+    std::vector<Eigen::Vector3f> m_angularVelocity;
+    std::vector<float> m_inverseMass;
+    std::vector<Eigen::Matrix3f> m_inverseInertia;
+
+    std::vector<SolverContact> m_contacts;
+
+    // 依批次排序的接觸索引；最後一個批次（索引 MAX_BATCHES）依序求解
+    std::vector<uint64_t> m_bodyBatchMask;
+    std::vector<uint32_t> m_contactBatch;
+    std::vector<uint32_t> m_batchOrder;
+    std::vector<size_t> m_batchOffsets;
+};
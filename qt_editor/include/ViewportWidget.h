@@ -20,6 +20,7 @@
 #include "../scene_format/physics_scene_format.h"
 #include "../cross_platform_runner/renderer.h"
 #include "../cross_platform_runner/physics_engine.h"
+#include "../cross_platform_runner/physics_recording.h"
 
 class Camera;
 class Grid;
@@ -116,6 +117,15 @@ public:
     void StepSimulation();
     void ResetSimulation();
 
+    // 回放快取（載入後以時間軸拖曳取代即時模擬）
+    bool LoadPlaybackCache(const QString& filename);
+    void ClosePlaybackCache();
+    bool IsPlaybackMode() const { return m_playback && m_playback->IsOpen(); }
+    int GetPlaybackFrameCount() const;
+    double GetPlaybackDuration() const;
+    void SeekPlaybackFrame(int frame);
+    void SeekPlaybackTime(double simulationTime);
+
     // 截圖
     QImage CaptureScreenshot();
     bool SaveScreenshot(const QString& filename);
@@ -198,6 +208,9 @@ private:
     void UpdateStatistics();
     void RenderStatisticsText();
 
+    // 模擬快照
+    void AcquireSimulationFrame();
+
 private:
     // 渲染器
     std::unique_ptr<Renderer> m_renderer;
@@ -252,6 +265,12 @@ private:
     QTimer* m_simulationTimer;
     QElapsedTimer m_frameTimer;
 
+    // 目前繪製中的物理影格（paintGL 開始時取得最新快照，持有至下一次繪製）
+    SnapshotRing::ReadHandle m_simulationFrame;
+
+    // 回放
+    std::unique_ptr<PhysicsPlayback> m_playback;
+
     // 動畫
     QTimer* m_animationTimer;
     float m_animationTime;
@@ -308,6 +327,9 @@ signals:
 
     // 統計信號
     void StatisticsUpdated(int frameCount, float frameTime, int triangleCount, int objectCount);
+
+    // 回放信號
+    void PlaybackFrameChanged(int frame, double simulationTime);
 };
 
 /**
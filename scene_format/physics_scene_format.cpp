@@ -3,7 +3,9 @@
 #include <sstream>
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
 #include <chrono>
+#include <ctime>
 #include <iomanip>
 
 // JSON 處理 (使用 nlohmann/json 或簡單的手動實現)
@@ -57,6 +59,51 @@ GeometryShape GeometryShape::createPlane(float width, float depth) {
     return shape;
 }
 
+// 碰撞層矩陣實現
+int CollisionLayerMatrix::addLayer(const std::string& name) {
+    int existing = findLayer(name);
+    if (existing >= 0) return existing;
+    if (static_cast<int>(layerNames.size()) >= MAX_LAYERS) return -1;
+    
+    layerNames.push_back(name);
+    return static_cast<int>(layerNames.size()) - 1;
+}
+
+int CollisionLayerMatrix::findLayer(const std::string& name) const {
+    auto it = std::find(layerNames.begin(), layerNames.end(), name);
+    return it != layerNames.end() ? static_cast<int>(it - layerNames.begin()) : -1;
+}
+
+void CollisionLayerMatrix::setLayersCollide(int layerA, int layerB, bool collide) {
+    if (layerA < 0 || layerA >= MAX_LAYERS || layerB < 0 || layerB >= MAX_LAYERS) return;
+    
+    const uint32_t bitA = 1u << layerA;
+    const uint32_t bitB = 1u << layerB;
+    if (collide) {
+        masks[layerA] |= bitB;
+        masks[layerB] |= bitA;
+    } else {
+        masks[layerA] &= ~bitB;
+        masks[layerB] &= ~bitA;
+    }
+}
+
+bool CollisionLayerMatrix::layersCollide(int layerA, int layerB) const {
+    if (layerA < 0 || layerA >= MAX_LAYERS || layerB < 0 || layerB >= MAX_LAYERS) return false;
+    return (masks[layerA] & (1u << layerB)) != 0;
+}
+
+uint32_t CollisionLayerMatrix::getCollisionMask(int collisionGroup) const {
+    if (!isEnabled()) return 0xFFFFFFFFu;
+    
+    uint32_t mask = 0;
+    uint32_t group = static_cast<uint32_t>(collisionGroup);
+    for (int layer = 0; group != 0; ++layer, group >>= 1) {
+        if (group & 1u) mask |= masks[layer];
+    }
+    return mask;
+}
+
 // PhysicsScene 實現
 PhysicsScene::PhysicsScene() {
     initializeDefaultMaterials();
@@ -65,8 +112,15 @@ PhysicsScene::PhysicsScene() {
     // 設定建立時間
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
+    // std::localtime 共用靜態緩衝區，批次處理會在多個執行緒同時建立場景
+    std::tm localTime{};
+#ifdef _WIN32
+    localtime_s(&localTime, &time_t);
+#else
+    localtime_r(&time_t, &localTime);
+#endif
     std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
+    ss << std::put_time(&localTime, "%Y-%m-%d %H:%M:%S");
     metadata.createdDate = ss.str();
     metadata.modifiedDate = ss.str();
 }
@@ -268,6 +322,23 @@ bool PhysicsScene::validate(std::vector<std::string>& errors) const {
         }
     }
     
+    // 檢查碰撞層
+    const CollisionLayerMatrix& layers = simulationSettings.collisionLayers;
+    for (size_t i = 0; i < layers.layerNames.size(); ++i) {
+        if (layers.findLayer(layers.layerNames[i]) != static_cast<int>(i)) {
+            errors.push_back("重複的碰撞層名稱: " + layers.layerNames[i]);
+        }
+    }
+    if (layers.isEnabled()) {
+        const uint32_t definedLayers = layers.layerNames.size() >= 32
+            ? 0xFFFFFFFFu : (1u << layers.layerNames.size()) - 1u;
+        for (const auto& body : rigidBodies) {
+            if ((static_cast<uint32_t>(body.collisionGroup) & ~definedLayers) != 0) {
+                errors.push_back("剛體 '" + body.name + "' 的碰撞群組使用了未定義的碰撞層");
+            }
+        }
+    }
+    
     // 檢查活動相機
     if (!activeCamera.empty() && !findCamera(activeCamera)) {
         errors.push_back("活動相機不存在: " + activeCamera);
@@ -442,7 +513,18 @@ std::string PhysicsScene::toJSONString() const {
        << simulationSettings.gravity.y << ", " << simulationSettings.gravity.z << "],\n";
     ss << "    \"solverIterations\": " << simulationSettings.solverIterations << ",\n";
     ss << "    \"useOGCContact\": " << (simulationSettings.useOGCContact ? "true" : "false") << ",\n";
-    ss << "    \"ogcContactRadius\": " << simulationSettings.ogcContactRadius << "\n";
+    ss << "    \"ogcContactRadius\": " << simulationSettings.ogcContactRadius << ",\n";
+    ss << "    \"rejectStaticPairs\": " << (simulationSettings.rejectStaticPairs ? "true" : "false") << ",\n";
+    ss << "    \"rejectTriggerPairs\": " << (simulationSettings.rejectTriggerPairs ? "true" : "false") << ",\n";
+    
+    // 碰撞層矩陣：只輸出已命名的層
+    const CollisionLayerMatrix& layers = simulationSettings.collisionLayers;
+    ss << "    \"collisionLayers\": [";
+    for (size_t i = 0; i < layers.layerNames.size(); ++i) {
+        if (i > 0) ss << ", ";
+        ss << "{\"name\": " << Utils::quoteJsonString(layers.layerNames[i]) << ", \"mask\": " << layers.masks[i] << "}";
+    }
+    ss << "]\n";
     ss << "  }\n";
     
     ss << "}\n";
@@ -745,6 +827,31 @@ std::string colorToHex(const Color& color) {
     return std::string(hex);
 }
 
+std::string quoteJsonString(const std::string& value) {
+    std::string result = "\"";
+    for (char c : value) {
+        switch (c) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\b': result += "\\b"; break;
+            case '\f': result += "\\f"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                    result += escaped;
+                } else {
+                    result += c;
+                }
+        }
+    }
+    result += '"';
+    return result;
+}
+
 bool isValidObjectName(const std::string& name) {
     if (name.empty() || name.length() > 128) {
         return false;
@@ -5,6 +5,7 @@
 #include <map>
 #include <memory>
 #include <array>
+#include <cstdint>
 
 /**
  * @file physics_scene_format.h
@@ -310,6 +311,31 @@ struct Camera {
     Camera(const std::string& name_) : name(name_) {}
 };
 
+// 碰撞層矩陣
+// 最多 32 個具名層，第 i 層對應 RigidBody::collisionGroup 的第 i 個位元；
+// masks[i] 的第 j 個位元表示第 i 層與第 j 層會碰撞（保持對稱）。
+// 沒有定義任何層時不啟用，只使用剛體自身的 collisionGroup / collisionMask。
+struct CollisionLayerMatrix {
+    static constexpr int MAX_LAYERS = 32;
+
+    std::vector<std::string> layerNames;
+    std::array<uint32_t, MAX_LAYERS> masks;
+
+    CollisionLayerMatrix() { masks.fill(0xFFFFFFFFu); }
+
+    bool isEnabled() const { return !layerNames.empty(); }
+
+    // 新增具名層並回傳其索引；名稱已存在時回傳既有索引，已滿時回傳 -1
+    int addLayer(const std::string& name);
+    int findLayer(const std::string& name) const;
+
+    void setLayersCollide(int layerA, int layerB, bool collide);
+    bool layersCollide(int layerA, int layerB) const;
+
+    // 依剛體的 collisionGroup 位元合併出可碰撞的層遮罩
+    uint32_t getCollisionMask(int collisionGroup) const;
+};
+
 // 模擬設定
 struct SimulationSettings {
     float timeStep = 1.0f / 60.0f;     // 時間步長
@@ -332,6 +358,11 @@ struct SimulationSettings {
     // 碰撞檢測設定
     float contactBreakingThreshold = 0.02f;
     float contactProcessingThreshold = 0.01f;
+
+    // 碰撞過濾
+    CollisionLayerMatrix collisionLayers;
+    bool rejectStaticPairs = true;     // 在寬相位捨棄靜態對靜態的剛體對
+    bool rejectTriggerPairs = true;    // 在寬相位捨棄兩個觸發器之間的剛體對
     
     // 效能設定
     bool enableCCD = false;        // 連續碰撞檢測
@@ -512,6 +543,9 @@ namespace Utils {
     // 驗證工具
     bool isValidObjectName(const std::string& name);
     bool isValidFilePath(const std::string& path);
+
+    // 加上引號並跳脫為 JSON 字串
+    std::string quoteJsonString(const std::string& value);
     
     // 單位轉換
     float degreesToRadians(float degrees);
@@ -0,0 +1,590 @@
+#include "scene_tile_format.h"
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <set>
+#include <unordered_map>
+
+namespace PhysicsScene {
+
+namespace {
+
+constexpr size_t TILE_TRAILER_SIZE = 16;   // indexOffset + magic
+
+enum TileBodyFlags : uint8_t {
+    FLAG_TRIGGER = 1 << 0,
+    FLAG_VISIBLE = 1 << 1,
+    FLAG_CAST_SHADOWS = 1 << 2,
+    FLAG_RECEIVE_SHADOWS = 1 << 3
+};
+
+// 編碼輔助函數（一律使用 little-endian）
+void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void writeZigZag(std::vector<uint8_t>& out, int64_t value) {
+    writeVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void writeU64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void writeF32(std::vector<uint8_t>& out, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+    }
+}
+
+void writeVector(std::vector<uint8_t>& out, const Vector3& v) {
+    writeF32(out, v.x);
+    writeF32(out, v.y);
+    writeF32(out, v.z);
+}
+
+void writeTransform(std::vector<uint8_t>& out, const Transform& transform) {
+    writeVector(out, transform.position);
+    writeF32(out, transform.rotation.w);
+    writeF32(out, transform.rotation.x);
+    writeF32(out, transform.rotation.y);
+    writeF32(out, transform.rotation.z);
+    writeVector(out, transform.scale);
+}
+
+// 解碼輔助函數；越界時回傳 false
+bool readVarint(const std::vector<uint8_t>& in, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+        uint8_t byte = in[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool readZigZag(const std::vector<uint8_t>& in, size_t& pos, int64_t& value) {
+    uint64_t raw;
+    if (!readVarint(in, pos, raw)) return false;
+    value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+    return true;
+}
+
+bool readU64(const std::vector<uint8_t>& in, size_t& pos, uint64_t& value) {
+    if (pos + 8 > in.size()) return false;
+    value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(in[pos++]) << (8 * i);
+    }
+    return true;
+}
+
+bool readF32(const std::vector<uint8_t>& in, size_t& pos, float& value) {
+    if (pos + 4 > in.size()) return false;
+    uint32_t bits = 0;
+    for (int i = 0; i < 4; ++i) {
+        bits |= static_cast<uint32_t>(in[pos++]) << (8 * i);
+    }
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+bool readVector(const std::vector<uint8_t>& in, size_t& pos, Vector3& v) {
+    return readF32(in, pos, v.x) && readF32(in, pos, v.y) && readF32(in, pos, v.z);
+}
+
+bool readTransform(const std::vector<uint8_t>& in, size_t& pos, Transform& transform) {
+    return readVector(in, pos, transform.position) &&
+           readF32(in, pos, transform.rotation.w) && readF32(in, pos, transform.rotation.x) &&
+           readF32(in, pos, transform.rotation.y) && readF32(in, pos, transform.rotation.z) &&
+           readVector(in, pos, transform.scale);
+}
+
+// 讀取元素數量；每個元素至少占一個位元組，超過剩餘長度即為損毀
+bool readCount(const std::vector<uint8_t>& in, size_t& pos, size_t& count) {
+    uint64_t value;
+    if (!readVarint(in, pos, value) || value > in.size() - pos) return false;
+    count = static_cast<size_t>(value);
+    return true;
+}
+
+bool readString(const std::vector<uint8_t>& in, size_t& pos, std::string& value) {
+    size_t length;
+    if (!readCount(in, pos, length)) return false;
+    value.assign(reinterpret_cast<const char*>(in.data() + pos), length);
+    pos += length;
+    return true;
+}
+
+/**
+ * @brief 單一分塊的編碼器
+ *
+ * 剛體先寫入 body 緩衝區，材質名稱等重複字串收進字串表，
+ * 最後輸出 [字串表][剛體數量][剛體資料]。
+ */
+class TileEncoder {
+public:
+    void addBody(const RigidBody& rigidBody) {
+        writeString(rigidBody.name);
+        writeTransform(m_bodies, rigidBody.transform);
+        writeVarint(m_bodies, intern(rigidBody.physicsMaterial));
+        writeVarint(m_bodies, intern(rigidBody.visualMaterial));
+        writeZigZag(m_bodies, rigidBody.collisionGroup);
+        writeZigZag(m_bodies, rigidBody.collisionMask);
+
+        uint8_t flags = 0;
+        if (rigidBody.isTrigger) flags |= FLAG_TRIGGER;
+        if (rigidBody.visible) flags |= FLAG_VISIBLE;
+        if (rigidBody.castShadows) flags |= FLAG_CAST_SHADOWS;
+        if (rigidBody.receiveShadows) flags |= FLAG_RECEIVE_SHADOWS;
+        m_bodies.push_back(flags);
+
+        writeShape(rigidBody.collisionShape);
+        writeVarint(m_bodies, rigidBody.compoundChildren.size());
+        for (const auto& child : rigidBody.compoundChildren) {
+            writeTransform(m_bodies, child.localTransform);
+            writeShape(child.shape);
+        }
+        ++m_bodyCount;
+    }
+
+    std::vector<uint8_t> finish() const {
+        std::vector<uint8_t> out;
+        writeVarint(out, m_strings.size());
+        for (const auto* value : m_strings) {
+            writeVarint(out, value->size());
+            out.insert(out.end(), value->begin(), value->end());
+        }
+        writeVarint(out, m_bodyCount);
+        out.insert(out.end(), m_bodies.begin(), m_bodies.end());
+        return out;
+    }
+
+private:
+    uint64_t intern(const std::string& value) {
+        auto result = m_stringIndex.emplace(value, m_strings.size());
+        if (result.second) {
+            m_strings.push_back(&result.first->first);
+        }
+        return result.first->second;
+    }
+
+    void writeString(const std::string& value) {
+        writeVarint(m_bodies, value.size());
+        m_bodies.insert(m_bodies.end(), value.begin(), value.end());
+    }
+
+    void writeShape(const GeometryShape& shape) {
+        m_bodies.push_back(static_cast<uint8_t>(shape.type));
+        writeVarint(m_bodies, shape.parameters.size());
+        for (const auto& [key, value] : shape.parameters) {
+            writeVarint(m_bodies, intern(key));
+            writeF32(m_bodies, value);
+        }
+        // 0 表示沒有網格檔案
+        writeVarint(m_bodies, shape.meshFile.empty() ? 0 : intern(shape.meshFile) + 1);
+        writeVarint(m_bodies, shape.vertices.size());
+        for (const auto& vertex : shape.vertices) {
+            writeVector(m_bodies, vertex);
+        }
+        writeVarint(m_bodies, shape.triangles.size());
+        for (const auto& triangle : shape.triangles) {
+            for (int index : triangle) {
+                writeVarint(m_bodies, static_cast<uint32_t>(index));
+            }
+        }
+    }
+
+    std::unordered_map<std::string, uint64_t> m_stringIndex;
+    std::vector<const std::string*> m_strings;
+    std::vector<uint8_t> m_bodies;
+    uint64_t m_bodyCount = 0;
+};
+
+class TileDecoder {
+public:
+    explicit TileDecoder(const std::vector<uint8_t>& data) : m_in(data) {}
+
+    bool decode(std::vector<RigidBody>& bodies) {
+        size_t stringCount;
+        if (!readCount(m_in, m_pos, stringCount)) return false;
+        m_strings.resize(stringCount);
+        for (auto& value : m_strings) {
+            if (!readString(m_in, m_pos, value)) return false;
+        }
+
+        size_t bodyCount;
+        if (!readCount(m_in, m_pos, bodyCount)) return false;
+        bodies.reserve(bodies.size() + bodyCount);
+        for (size_t i = 0; i < bodyCount; ++i) {
+            RigidBody rigidBody;
+            if (!decodeBody(rigidBody)) return false;
+            bodies.push_back(std::move(rigidBody));
+        }
+        return m_pos == m_in.size();
+    }
+
+private:
+    bool readIndexedString(std::string& value) {
+        uint64_t index;
+        if (!readVarint(m_in, m_pos, index) || index >= m_strings.size()) return false;
+        value = m_strings[static_cast<size_t>(index)];
+        return true;
+    }
+
+    bool decodeBody(RigidBody& rigidBody) {
+        int64_t group, mask;
+        if (!readString(m_in, m_pos, rigidBody.name) ||
+            !readTransform(m_in, m_pos, rigidBody.transform) ||
+            !readIndexedString(rigidBody.physicsMaterial) ||
+            !readIndexedString(rigidBody.visualMaterial) ||
+            !readZigZag(m_in, m_pos, group) || !readZigZag(m_in, m_pos, mask) ||
+            m_pos >= m_in.size()) {
+            return false;
+        }
+        rigidBody.collisionGroup = static_cast<int>(group);
+        rigidBody.collisionMask = static_cast<int>(mask);
+
+        const uint8_t flags = m_in[m_pos++];
+        rigidBody.isTrigger = (flags & FLAG_TRIGGER) != 0;
+        rigidBody.visible = (flags & FLAG_VISIBLE) != 0;
+        rigidBody.castShadows = (flags & FLAG_CAST_SHADOWS) != 0;
+        rigidBody.receiveShadows = (flags & FLAG_RECEIVE_SHADOWS) != 0;
+
+        // 分塊只保存靜態剛體
+        rigidBody.mass = 0.0f;
+
+        if (!decodeShape(rigidBody.collisionShape)) return false;
+        size_t childCount;
+        if (!readCount(m_in, m_pos, childCount)) return false;
+        rigidBody.compoundChildren.resize(childCount);
+        for (auto& child : rigidBody.compoundChildren) {
+            if (!readTransform(m_in, m_pos, child.localTransform) || !decodeShape(child.shape)) return false;
+        }
+        return true;
+    }
+
+    bool decodeShape(GeometryShape& shape) {
+        if (m_pos >= m_in.size() || m_in[m_pos] > static_cast<uint8_t>(ShapeType::HeightField)) return false;
+        shape.type = static_cast<ShapeType>(m_in[m_pos++]);
+
+        size_t parameterCount;
+        if (!readCount(m_in, m_pos, parameterCount)) return false;
+        for (size_t i = 0; i < parameterCount; ++i) {
+            std::string key;
+            float value;
+            if (!readIndexedString(key) || !readF32(m_in, m_pos, value)) return false;
+            shape.parameters[key] = value;
+        }
+
+        uint64_t meshFile;
+        if (!readVarint(m_in, m_pos, meshFile) || meshFile > m_strings.size()) return false;
+        if (meshFile > 0) {
+            shape.meshFile = m_strings[static_cast<size_t>(meshFile - 1)];
+        }
+
+        size_t vertexCount;
+        if (!readCount(m_in, m_pos, vertexCount)) return false;
+        shape.vertices.resize(vertexCount);
+        for (auto& vertex : shape.vertices) {
+            if (!readVector(m_in, m_pos, vertex)) return false;
+        }
+
+        size_t triangleCount;
+        if (!readCount(m_in, m_pos, triangleCount)) return false;
+        shape.triangles.resize(triangleCount);
+        for (auto& triangle : shape.triangles) {
+            for (int& index : triangle) {
+                uint64_t value;
+                if (!readVarint(m_in, m_pos, value) || value >= vertexCount) return false;
+                index = static_cast<int>(value);
+            }
+        }
+        return true;
+    }
+
+    const std::vector<uint8_t>& m_in;
+    size_t m_pos = 0;
+    std::vector<std::string> m_strings;
+};
+
+void setError(std::string* error, const std::string& message) {
+    if (error) {
+        *error = message;
+    }
+}
+
+bool isStaticBody(const PhysicsScene& scene, const RigidBody& rigidBody) {
+    const PhysicsMaterial* material = scene.findPhysicsMaterial(rigidBody.physicsMaterial);
+    if (material && material->isKinematic) {
+        return false;
+    }
+    return rigidBody.mass <= 0.0f || (material && material->isStatic);
+}
+
+std::set<std::string> collectConstrainedBodies(const PhysicsScene& scene) {
+    std::set<std::string> names;
+    for (const auto& constraint : scene.constraints) {
+        names.insert(constraint.bodyA);
+        names.insert(constraint.bodyB);
+    }
+    return names;
+}
+
+} // namespace
+
+TileCoord getTileCoord(const Vector3& position, float tileSize) {
+    auto toCell = [tileSize](float value) {
+        const double cell = std::floor(static_cast<double>(value) / tileSize);
+        const double limit = static_cast<double>(std::numeric_limits<int32_t>::max());
+        return static_cast<int32_t>(std::max(-limit, std::min(limit, cell)));
+    };
+    return TileCoord(toCell(position.x), toCell(position.z));
+}
+
+bool isStreamableBody(const PhysicsScene& scene, const RigidBody& rigidBody) {
+    return isStaticBody(scene, rigidBody) && collectConstrainedBodies(scene).count(rigidBody.name) == 0;
+}
+
+bool writeTiledScene(PhysicsScene& scene, const std::string& tileFile, float tileSize, std::string* error) {
+    const std::set<std::string> constrained = collectConstrainedBodies(scene);
+    std::vector<bool> streamable(scene.rigidBodies.size(), false);
+    std::vector<RigidBody> bodies;
+    for (size_t i = 0; i < scene.rigidBodies.size(); ++i) {
+        const RigidBody& rigidBody = scene.rigidBodies[i];
+        if (isStaticBody(scene, rigidBody) && constrained.count(rigidBody.name) == 0) {
+            streamable[i] = true;
+            bodies.push_back(rigidBody);
+        }
+    }
+    if (bodies.empty()) {
+        setError(error, "No streamable static bodies in scene");
+        return false;
+    }
+    if (!writeTileFile(tileFile, bodies, tileSize, error)) {
+        return false;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < scene.rigidBodies.size(); ++i) {
+        if (!streamable[i]) {
+            if (kept != i) {
+                scene.rigidBodies[kept] = std::move(scene.rigidBodies[i]);
+            }
+            ++kept;
+        }
+    }
+    scene.rigidBodies.resize(kept);
+    return true;
+}
+
+bool writeTileFile(const std::string& tileFile, const std::vector<RigidBody>& bodies, float tileSize,
+                   std::string* error) {
+    if (!(tileSize > 0.0f) || !std::isfinite(tileSize)) {
+        setError(error, "Tile size must be a positive finite value");
+        return false;
+    }
+
+    // 依分塊座標分組；std::map 讓輸出順序固定
+    std::map<TileCoord, std::vector<const RigidBody*>> tiles;
+    for (const auto& rigidBody : bodies) {
+        tiles[getTileCoord(rigidBody.transform.position, tileSize)].push_back(&rigidBody);
+    }
+
+    std::ofstream file(tileFile, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        setError(error, "Cannot open file for writing: " + tileFile);
+        return false;
+    }
+
+    std::vector<uint8_t> header(TILE_FILE_MAGIC, TILE_FILE_MAGIC + sizeof(TILE_FILE_MAGIC));
+    writeVarint(header, TILE_FORMAT_VERSION);
+    writeF32(header, tileSize);
+    file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    uint64_t offset = header.size();
+
+    std::vector<TileEntry> entries;
+    entries.reserve(tiles.size());
+    for (const auto& [coord, tileBodies] : tiles) {
+        TileEncoder encoder;
+        TileEntry entry;
+        entry.coord = coord;
+        entry.boundsMin = tileBodies.front()->transform.position;
+        entry.boundsMax = entry.boundsMin;
+        for (const RigidBody* rigidBody : tileBodies) {
+            encoder.addBody(*rigidBody);
+            const Vector3& p = rigidBody->transform.position;
+            entry.boundsMin = Vector3(std::min(entry.boundsMin.x, p.x), std::min(entry.boundsMin.y, p.y),
+                                      std::min(entry.boundsMin.z, p.z));
+            entry.boundsMax = Vector3(std::max(entry.boundsMax.x, p.x), std::max(entry.boundsMax.y, p.y),
+                                      std::max(entry.boundsMax.z, p.z));
+        }
+
+        const std::vector<uint8_t> payload = encoder.finish();
+        file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        entry.fileOffset = offset;
+        entry.byteSize = payload.size();
+        entry.bodyCount = static_cast<uint32_t>(tileBodies.size());
+        offset += payload.size();
+        entries.push_back(entry);
+    }
+
+    std::vector<uint8_t> index;
+    writeVarint(index, entries.size());
+    for (const auto& entry : entries) {
+        writeZigZag(index, entry.coord.x);
+        writeZigZag(index, entry.coord.z);
+        writeVarint(index, entry.fileOffset);
+        writeVarint(index, entry.byteSize);
+        writeVarint(index, entry.bodyCount);
+        writeVector(index, entry.boundsMin);
+        writeVector(index, entry.boundsMax);
+    }
+    writeU64(index, offset);
+    index.insert(index.end(), TILE_INDEX_MAGIC, TILE_INDEX_MAGIC + sizeof(TILE_INDEX_MAGIC));
+    file.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size()));
+
+    if (!file.good()) {
+        setError(error, "Failed to write tile file: " + tileFile);
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// TiledSceneReader
+// ============================================================================
+
+bool TiledSceneReader::open(const std::string& tileFile, std::string* error) {
+    close();
+
+    std::ifstream file(tileFile, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        setError(error, "Cannot open tile file: " + tileFile);
+        return false;
+    }
+    const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+
+    // 標頭：magic + 版本 + 分塊大小
+    std::vector<uint8_t> header(static_cast<size_t>(std::min<uint64_t>(fileSize, 32)));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    size_t pos = sizeof(TILE_FILE_MAGIC);
+    uint64_t version;
+    float tileSize;
+    if (!file || header.size() < pos || std::memcmp(header.data(), TILE_FILE_MAGIC, pos) != 0 ||
+        !readVarint(header, pos, version) || !readF32(header, pos, tileSize)) {
+        setError(error, "Not a tile file: " + tileFile);
+        return false;
+    }
+    if (version > TILE_FORMAT_VERSION) {
+        setError(error, "Unsupported tile format version: " + std::to_string(version));
+        return false;
+    }
+    if (!(tileSize > 0.0f) || !std::isfinite(tileSize)) {
+        setError(error, "Invalid tile size in: " + tileFile);
+        return false;
+    }
+    const uint64_t dataStart = pos;
+
+    // 檔尾：索引位置 + 索引標記
+    std::vector<uint8_t> trailer(TILE_TRAILER_SIZE);
+    uint64_t indexOffset = 0;
+    size_t trailerPos = 0;
+    if (fileSize >= dataStart + TILE_TRAILER_SIZE) {
+        file.seekg(static_cast<std::streamoff>(fileSize - TILE_TRAILER_SIZE));
+        file.read(reinterpret_cast<char*>(trailer.data()), static_cast<std::streamsize>(trailer.size()));
+    }
+    if (!file || fileSize < dataStart + TILE_TRAILER_SIZE || !readU64(trailer, trailerPos, indexOffset) ||
+        std::memcmp(trailer.data() + trailerPos, TILE_INDEX_MAGIC, sizeof(TILE_INDEX_MAGIC)) != 0 ||
+        indexOffset < dataStart || indexOffset > fileSize - TILE_TRAILER_SIZE) {
+        setError(error, "Tile index is missing or truncated: " + tileFile);
+        return false;
+    }
+
+    std::vector<uint8_t> index(static_cast<size_t>(fileSize - TILE_TRAILER_SIZE - indexOffset));
+    file.seekg(static_cast<std::streamoff>(indexOffset));
+    file.read(reinterpret_cast<char*>(index.data()), static_cast<std::streamsize>(index.size()));
+
+    pos = 0;
+    size_t tileCount;
+    bool valid = file.good() && readCount(index, pos, tileCount);
+    std::vector<TileEntry> tiles;
+    for (size_t i = 0; valid && i < tileCount; ++i) {
+        TileEntry entry;
+        int64_t x, z;
+        uint64_t bodyCount;
+        valid = readZigZag(index, pos, x) && readZigZag(index, pos, z) &&
+                readVarint(index, pos, entry.fileOffset) && readVarint(index, pos, entry.byteSize) &&
+                readVarint(index, pos, bodyCount) &&
+                readVector(index, pos, entry.boundsMin) && readVector(index, pos, entry.boundsMax) &&
+                entry.fileOffset >= dataStart && entry.fileOffset <= indexOffset &&
+                entry.byteSize <= indexOffset - entry.fileOffset;
+        entry.coord = TileCoord(static_cast<int32_t>(x), static_cast<int32_t>(z));
+        entry.bodyCount = static_cast<uint32_t>(bodyCount);
+        tiles.push_back(entry);
+    }
+    if (!valid) {
+        setError(error, "Corrupted tile index: " + tileFile);
+        return false;
+    }
+
+    std::sort(tiles.begin(), tiles.end(),
+              [](const TileEntry& a, const TileEntry& b) { return a.coord < b.coord; });
+    m_filename = tileFile;
+    m_tileSize = tileSize;
+    m_tiles = std::move(tiles);
+    return true;
+}
+
+void TiledSceneReader::close() {
+    m_filename.clear();
+    m_tileSize = 0.0f;
+    m_tiles.clear();
+}
+
+const TileEntry* TiledSceneReader::findTile(const TileCoord& coord) const {
+    auto it = std::lower_bound(m_tiles.begin(), m_tiles.end(), coord,
+                               [](const TileEntry& entry, const TileCoord& value) { return entry.coord < value; });
+    return (it != m_tiles.end() && it->coord == coord) ? &*it : nullptr;
+}
+
+bool TiledSceneReader::readTile(const TileEntry& tile, std::vector<RigidBody>& bodies, std::string* error) const {
+    if (!isOpen()) {
+        setError(error, "Tile file is not open");
+        return false;
+    }
+
+    std::ifstream file(m_filename, std::ios::binary);
+    std::vector<uint8_t> data(static_cast<size_t>(tile.byteSize));
+    file.seekg(static_cast<std::streamoff>(tile.fileOffset));
+    file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!file) {
+        setError(error, "Failed to read tile (" + std::to_string(tile.coord.x) + ", " +
+                        std::to_string(tile.coord.z) + ") from " + m_filename);
+        return false;
+    }
+
+    std::vector<RigidBody> decoded;
+    if (!TileDecoder(data).decode(decoded)) {
+        setError(error, "Corrupted tile (" + std::to_string(tile.coord.x) + ", " +
+                        std::to_string(tile.coord.z) + ") in " + m_filename);
+        return false;
+    }
+    bodies.insert(bodies.end(), std::make_move_iterator(decoded.begin()), std::make_move_iterator(decoded.end()));
+    return true;
+}
+
+} // namespace PhysicsScene
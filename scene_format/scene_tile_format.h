@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "physics_scene_format.h"
+
+/**
+ * @file scene_tile_format.h
+ * @brief 可串流的分塊場景格式
+ *
+ * 開放世界場景的靜態剛體依水平位置（X/Z）切成正方形分塊，寫入一個
+ * .ptiles 二進位檔案；其餘內容（材質、動態剛體、約束、光源、設定）仍留在
+ * .pscene 中。每個分塊是獨立的紀錄，讀取索引後即可只解碼需要的分塊。
+ *
+ * 檔案結構：
+ *   [標頭] [分塊紀錄 ...] [分塊索引] [檔尾：索引位置 + 索引標記]
+ *
+ * 分塊紀錄內含自己的字串表（材質名稱、網格檔案、形狀參數鍵），
+ * 剛體只記錄靜態剛體需要的欄位，讀回時質量為 0。
+ */
+
+namespace PhysicsScene {
+
+// 檔案格式常數
+constexpr char TILE_FILE_MAGIC[8] = {'P', 'T', 'I', 'L', 'E', 'S', '\0', '\0'};
+constexpr char TILE_INDEX_MAGIC[8] = {'P', 'T', 'I', 'D', 'X', '\0', '\0', '\0'};
+constexpr uint32_t TILE_FORMAT_VERSION = 1;
+constexpr const char* TILE_FILE_EXTENSION = ".ptiles";
+
+// 分塊座標：floor(x / tileSize), floor(z / tileSize)
+struct TileCoord {
+    int32_t x = 0;
+    int32_t z = 0;
+
+    TileCoord() = default;
+    TileCoord(int32_t x_, int32_t z_) : x(x_), z(z_) {}
+
+    bool operator==(const TileCoord& other) const { return x == other.x && z == other.z; }
+    bool operator<(const TileCoord& other) const { return x != other.x ? x < other.x : z < other.z; }
+};
+
+// 分塊索引項目
+struct TileEntry {
+    TileCoord coord;
+    uint64_t fileOffset = 0;
+    uint64_t byteSize = 0;
+    uint32_t bodyCount = 0;
+    Vector3 boundsMin;      // 分塊內剛體位置的範圍
+    Vector3 boundsMax;
+};
+
+TileCoord getTileCoord(const Vector3& position, float tileSize);
+
+// 可串流的剛體：靜態（質量為 0 或靜態材質）、非運動學，且沒有被約束引用
+bool isStreamableBody(const PhysicsScene& scene, const RigidBody& rigidBody);
+
+/**
+ * @brief 將可串流的靜態剛體移出場景並寫成分塊檔案
+ *
+ * 成功時場景只剩其餘內容，呼叫端再另存 .pscene；失敗時場景不變。
+ */
+bool writeTiledScene(PhysicsScene& scene, const std::string& tileFile, float tileSize, std::string* error = nullptr);
+
+// 直接將剛體寫成分塊檔案（剛體的質量與速度不會寫入）
+bool writeTileFile(const std::string& tileFile, const std::vector<RigidBody>& bodies, float tileSize,
+                   std::string* error = nullptr);
+
+/**
+ * @class TiledSceneReader
+ * @brief 讀取分塊索引並按需解碼分塊
+ *
+ * open 之後索引不再變動；readTile 每次各自開啟檔案，可同時從多個執行緒呼叫。
+ */
+class TiledSceneReader {
+public:
+    bool open(const std::string& tileFile, std::string* error = nullptr);
+    void close();
+    bool isOpen() const { return !m_filename.empty(); }
+
+    float getTileSize() const { return m_tileSize; }
+    const std::vector<TileEntry>& getTiles() const { return m_tiles; }
+    const TileEntry* findTile(const TileCoord& coord) const;
+
+    bool readTile(const TileEntry& tile, std::vector<RigidBody>& bodies, std::string* error = nullptr) const;
+
+private:
+    std::string m_filename;
+    float m_tileSize = 0.0f;
+    std::vector<TileEntry> m_tiles;     // 依座標排序
+};
+
+} // namespace PhysicsScene
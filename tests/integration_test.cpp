@@ -45,6 +45,7 @@ public:
         // 基本功能測試
         RunTest("Basic Scene Loading", [this]() { return TestBasicSceneLoading(); });
         RunTest("Physics Engine Integration", [this]() { return TestPhysicsEngineIntegration(); });
+        RunTest("Truncated Checkpoint Restore", [this]() { return TestTruncatedCheckpointRestore(); });
         RunTest("Complex Scene Simulation", [this]() { return TestComplexSceneSimulation(); });
         RunTest("Error Handling", [this]() { return TestErrorHandling(); });
         RunTest("Performance Benchmarks", [this]() { return TestPerformanceBenchmarks(); });
@@ -226,6 +227,62 @@ private:
         return true;
     }
 
+    /**
+     * @brief 測試截斷的檢查點不會改動世界狀態
+     */
+    bool TestTruncatedCheckpointRestore() {
+        auto scene = CreateTestScene();
+
+        if (!physicsEngine->Initialize() || !physicsEngine->InitializeScene(scene)) {
+            return false;
+        }
+
+        for (int i = 0; i < 30; ++i) {
+            physicsEngine->StepSimulation(0.016666667f);
+        }
+
+        SimulationCheckpoint checkpoint;
+        if (!physicsEngine->SaveCheckpoint(checkpoint)) {
+            std::cerr << "Failed to save checkpoint" << std::endl;
+            return false;
+        }
+
+        for (int i = 0; i < 30; ++i) {
+            physicsEngine->StepSimulation(0.016666667f);
+        }
+
+        const auto transform = physicsEngine->GetRigidBodyTransform("box");
+        const auto velocity = physicsEngine->GetRigidBodyLinearVelocity("box");
+
+        // 剛體段落完整、後段（碰撞對與混合模式決策）缺少最後一個位元組
+        SimulationCheckpoint truncated = checkpoint;
+        truncated.data.pop_back();
+        if (physicsEngine->RestoreCheckpoint(truncated)) {
+            std::cerr << "Truncated checkpoint was accepted" << std::endl;
+            return false;
+        }
+
+        const auto transformAfter = physicsEngine->GetRigidBodyTransform("box");
+        const auto velocityAfter = physicsEngine->GetRigidBodyLinearVelocity("box");
+        if (transformAfter.position.x != transform.position.x ||
+            transformAfter.position.y != transform.position.y ||
+            transformAfter.position.z != transform.position.z ||
+            velocityAfter.x != velocity.x || velocityAfter.y != velocity.y || velocityAfter.z != velocity.z) {
+            std::cerr << "Truncated checkpoint partially restored the world" << std::endl;
+            return false;
+        }
+
+        // 完整的檢查點仍可還原
+        if (!physicsEngine->RestoreCheckpoint(checkpoint) ||
+            physicsEngine->GetRigidBodyTransform("box").position.y <= transform.position.y) {
+            std::cerr << "Failed to restore checkpoint" << std::endl;
+            return false;
+        }
+
+        physicsEngine->Cleanup();
+        return true;
+    }
+
     /**
      * @brief 測試複雜場景模擬
      */
@@ -0,0 +1,179 @@
+/**
+ * @file test_force_field_batch.cpp
+ * @brief 力場批次計算單元測試
+ *
+ * 以單點純量實作為參考，驗證 SIMD 批次結果、群組遮罩與補齊元素的處理。
+ * 使用 Google Test 框架進行單元測試。
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+
+#include "../cross_platform_runner/force_field_batch.h"
+
+using namespace PhysicsScene;
+
+class ForceFieldBatchTest : public ::testing::Test {
+protected:
+    struct Body {
+        Vector3 position;
+        Vector3 velocity;
+        float mass;
+        int32_t group;
+    };
+
+    // 產生 count 個隨機剛體（數量刻意不是 4 的倍數）
+    void SetUp() override {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> coord(-6.0f, 6.0f);
+        std::uniform_real_distribution<float> mass(0.5f, 5.0f);
+
+        const size_t count = 103;
+        bodies.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            bodies[i].position = Vector3(coord(rng), coord(rng), coord(rng));
+            bodies[i].velocity = Vector3(coord(rng), coord(rng), coord(rng));
+            bodies[i].mass = mass(rng);
+            bodies[i].group = 1 << (i % 3);
+        }
+        // 靜態或休眠剛體以群組 0 標記
+        bodies[7].group = 0;
+
+        batch.Resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            batch.SetBody(i, bodies[i].position, bodies[i].velocity, bodies[i].mass, bodies[i].group);
+        }
+    }
+
+    static ForceField MakeField(ForceFieldType type) {
+        ForceField field;
+        field.type = type;
+        field.position = Vector3(0.5f, -0.5f, 1.0f);
+        field.direction = Vector3(0.0f, 1.0f, 0.0f);
+        field.strength = 3.0f;
+        field.radius = 5.0f;
+        field.falloff = 2.0f;
+        return field;
+    }
+
+    // 與參考實作逐一比較
+    void ExpectMatchesReference(const std::vector<ForceField>& fields) {
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            Vector3 expected(0.0f, 0.0f, 0.0f);
+            for (const ForceField& field : fields) {
+                if ((bodies[i].group & field.affectedGroups) == 0) continue;
+                Vector3 f = ForceFieldBatch::EvaluatePoint(field, bodies[i].position, bodies[i].velocity, bodies[i].mass);
+                expected.x += f.x;
+                expected.y += f.y;
+                expected.z += f.z;
+            }
+
+            Vector3 actual = batch.GetForce(i);
+            EXPECT_NEAR(actual.x, expected.x, 1e-4f) << "body " << i;
+            EXPECT_NEAR(actual.y, expected.y, 1e-4f) << "body " << i;
+            EXPECT_NEAR(actual.z, expected.z, 1e-4f) << "body " << i;
+        }
+    }
+
+    std::vector<Body> bodies;
+    ForceFieldBatch batch;
+};
+
+// 測試每種力場類型與參考實作一致
+TEST_F(ForceFieldBatchTest, MatchesReferencePerType) {
+    for (ForceFieldType type : {ForceFieldType::Gravity, ForceFieldType::Uniform, ForceFieldType::Radial,
+                                ForceFieldType::Vortex, ForceFieldType::Drag, ForceFieldType::Spring}) {
+        ForceField field = MakeField(type);
+        batch.Resize(bodies.size());
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            batch.SetBody(i, bodies[i].position, bodies[i].velocity, bodies[i].mass, bodies[i].group);
+        }
+        batch.Evaluate(field);
+        SCOPED_TRACE(static_cast<int>(type));
+        ExpectMatchesReference({field});
+    }
+}
+
+// 測試多個力場累加、群組遮罩與非整數衰減指數
+TEST_F(ForceFieldBatchTest, AccumulatesMaskedFields) {
+    ForceField radial = MakeField(ForceFieldType::Radial);
+    radial.affectedGroups = 1;
+    radial.falloff = 1.5f;
+
+    ForceField vortex = MakeField(ForceFieldType::Vortex);
+    vortex.affectedGroups = 2 | 4;
+    vortex.direction = Vector3(1.0f, 1.0f, 0.0f);
+
+    ForceField drag = MakeField(ForceFieldType::Drag);
+    drag.strength = 0.2f;
+
+    std::vector<ForceField> fields = {radial, vortex, drag};
+    for (const ForceField& field : fields) {
+        batch.Evaluate(field);
+    }
+    ExpectMatchesReference(fields);
+
+    // 群組 0 的剛體不受任何力場影響
+    EXPECT_FALSE(batch.HasForce(7));
+}
+
+// 測試停用或半徑外的力場
+TEST_F(ForceFieldBatchTest, DisabledAndOutOfRange) {
+    ForceField disabled = MakeField(ForceFieldType::Uniform);
+    disabled.enabled = false;
+    batch.Evaluate(disabled);
+
+    ForceField far = MakeField(ForceFieldType::Spring);
+    far.position = Vector3(100.0f, 100.0f, 100.0f);
+    batch.Evaluate(far);
+
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        EXPECT_FALSE(batch.HasForce(i));
+    }
+}
+
+// 測試只對半徑內剛體索引計算時與全體計算一致
+TEST_F(ForceFieldBatchTest, IndexedMatchesFull) {
+    ForceField vortex = MakeField(ForceFieldType::Vortex);
+    vortex.radius = 3.0f;
+    ForceField spring = MakeField(ForceFieldType::Spring);
+    spring.position = Vector3(-2.0f, 2.0f, 0.0f);
+    spring.radius = 4.0f;
+
+    ForceFieldBatch full;
+    full.Resize(bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        full.SetBody(i, bodies[i].position, bodies[i].velocity, bodies[i].mass, bodies[i].group);
+    }
+
+    for (const ForceField& field : {vortex, spring}) {
+        full.Evaluate(field);
+
+        // 與力場包圍盒重疊的剛體，模擬寬相位查詢的結果
+        std::vector<uint32_t> indices;
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            const Vector3& p = bodies[i].position;
+            if (std::fabs(p.x - field.position.x) <= field.radius &&
+                std::fabs(p.y - field.position.y) <= field.radius &&
+                std::fabs(p.z - field.position.z) <= field.radius) {
+                indices.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        ASSERT_FALSE(indices.empty());
+        ASSERT_LT(indices.size(), bodies.size());
+        batch.Evaluate(field, indices);
+    }
+
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        EXPECT_NEAR(batch.GetForce(i).x, full.GetForce(i).x, 1e-5f) << "body " << i;
+        EXPECT_NEAR(batch.GetForce(i).y, full.GetForce(i).y, 1e-5f) << "body " << i;
+        EXPECT_NEAR(batch.GetForce(i).z, full.GetForce(i).z, 1e-5f) << "body " << i;
+    }
+}
+
+// 主函數
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+/**
+ * @file test_frustum_culler.cpp
+ * @brief 視錐剔除單元測試
+ *
+ * 測試平面提取、包圍盒與視錐的相交判斷，以及物件移動、移除後樹的更新。
+ * 使用 Google Test 框架進行單元測試。
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "../cross_platform_runner/frustum_culler.h"
+
+namespace {
+
+// 以 center 為中心、邊長 2 * halfSize 的正交投影（行主序，無旋轉）
+std::vector<float> MakeOrthographic(const btVector3& center, float halfSize) {
+    std::vector<float> m(16, 0.0f);
+    const float scale = 1.0f / halfSize;
+    m[0] = scale;
+    m[5] = scale;
+    m[10] = scale;
+    m[12] = -center.getX() * scale;
+    m[13] = -center.getY() * scale;
+    m[14] = -center.getZ() * scale;
+    m[15] = 1.0f;
+    return m;
+}
+
+void SetCube(FrustumCuller& culler, uint32_t object, const btVector3& center, float halfSize) {
+    const btVector3 half(halfSize, halfSize, halfSize);
+    culler.SetBounds(object, center - half, center + half);
+}
+
+} // namespace
+
+// 測試視錐內、外與跨越邊界的物件
+TEST(FrustumCullerTest, CullsObjectsOutsideFrustum) {
+    FrustumCuller culler(0.0f);
+    SetCube(culler, 0, btVector3(0, 0, 0), 1.0f);       // 內側
+    SetCube(culler, 1, btVector3(100, 0, 0), 1.0f);     // 右側外面
+    SetCube(culler, 2, btVector3(10.5f, 0, 0), 1.0f);   // 跨越右側平面
+    SetCube(culler, 3, btVector3(0, -20, 0), 1.0f);     // 下方外面
+    SetCube(culler, 4, btVector3(5, 5, 5), 1.0f);       // 內側
+    for (uint32_t i = 5; i < 200; ++i) {
+        SetCube(culler, i, btVector3(50.0f + static_cast<float>(i), 0, 0), 0.5f);
+    }
+
+    const std::vector<float> viewProjection = MakeOrthographic(btVector3(0, 0, 0), 10.0f);
+    const FrustumCuller::Frustum frustum = FrustumCuller::ExtractFrustum(viewProjection.data());
+
+    std::vector<uint32_t> visible;
+    culler.Cull(frustum, visible);
+    EXPECT_EQ(visible, (std::vector<uint32_t>{0, 2, 4}));
+
+    // 平移視錐後看到另一批物件
+    const std::vector<float> shifted = MakeOrthographic(btVector3(100, 0, 0), 10.0f);
+    culler.Cull(FrustumCuller::ExtractFrustum(shifted.data()), visible);
+    std::vector<uint32_t> expected{1};
+    for (uint32_t i = 40; i <= 60; ++i) {
+        expected.push_back(i);
+    }
+    EXPECT_EQ(visible, expected);
+}
+
+// 測試移動、移除與縮減物件數量
+TEST(FrustumCullerTest, UpdatesMovedAndRemovedObjects) {
+    FrustumCuller culler(0.5f);
+    SetCube(culler, 0, btVector3(0, 0, 0), 1.0f);
+    SetCube(culler, 1, btVector3(2, 0, 0), 1.0f);
+    SetCube(culler, 2, btVector3(-2, 0, 0), 1.0f);
+
+    const std::vector<float> viewProjection = MakeOrthographic(btVector3(0, 0, 0), 10.0f);
+    const FrustumCuller::Frustum frustum = FrustumCuller::ExtractFrustum(viewProjection.data());
+
+    std::vector<uint32_t> visible;
+    culler.Cull(frustum, visible);
+    EXPECT_EQ(visible, (std::vector<uint32_t>{0, 1, 2}));
+    EXPECT_EQ(culler.GetUpdatedLeafCount(), 0u);
+
+    // 在外擴範圍內移動不更新樹
+    SetCube(culler, 0, btVector3(0.2f, 0, 0), 1.0f);
+    EXPECT_EQ(culler.GetUpdatedLeafCount(), 0u);
+
+    // 移出視錐
+    SetCube(culler, 0, btVector3(0, 50, 0), 1.0f);
+    EXPECT_EQ(culler.GetUpdatedLeafCount(), 1u);
+    culler.Cull(frustum, visible);
+    EXPECT_EQ(visible, (std::vector<uint32_t>{1, 2}));
+
+    culler.RemoveBounds(1);
+    EXPECT_FALSE(culler.HasBounds(1));
+    culler.Cull(frustum, visible);
+    EXPECT_EQ(visible, (std::vector<uint32_t>{2}));
+
+    culler.Resize(2);
+    EXPECT_EQ(culler.GetObjectCount(), 2u);
+    culler.Cull(frustum, visible);
+    EXPECT_TRUE(visible.empty());
+
+    culler.Clear();
+    culler.Cull(frustum, visible);
+    EXPECT_TRUE(visible.empty());
+}
+
+// 主函數
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,117 @@
+/**
+ * @file test_image_decoder.cpp
+ * @brief 影像解碼器單元測試
+ *
+ * 測試 TGA（未壓縮、RLE、原點方向）與 PPM/PGM 解碼，以及截斷或不支援的資料。
+ * 使用 Google Test 框架進行單元測試。
+ */
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../cross_platform_runner/image_decoder.h"
+
+namespace {
+
+std::vector<uint8_t> MakeTgaHeader(uint8_t imageType, int width, int height, uint8_t depth, uint8_t descriptor) {
+    std::vector<uint8_t> header(18, 0);
+    header[2] = imageType;
+    header[12] = static_cast<uint8_t>(width & 0xFF);
+    header[13] = static_cast<uint8_t>(width >> 8);
+    header[14] = static_cast<uint8_t>(height & 0xFF);
+    header[15] = static_cast<uint8_t>(height >> 8);
+    header[16] = depth;
+    header[17] = descriptor;
+    return header;
+}
+
+std::vector<uint8_t> Pixel(const ImageDecoder::Image& image, int x, int y) {
+    const size_t offset = (static_cast<size_t>(y) * image.width + x) * 4;
+    return std::vector<uint8_t>(image.pixels.begin() + offset, image.pixels.begin() + offset + 4);
+}
+
+bool Decode(const std::vector<uint8_t>& data, ImageDecoder::Image& image, std::string& error) {
+    return ImageDecoder::DecodeMemory(data.data(), data.size(), image, error);
+}
+
+} // namespace
+
+// 測試未壓縮與 RLE 的 TGA，以及左上原點的翻轉
+TEST(ImageDecoderTest, DecodesTga) {
+    // 2x2，24 位元 BGR，左下原點：第一列為底部
+    std::vector<uint8_t> data = MakeTgaHeader(2, 2, 2, 24, 0);
+    const uint8_t pixels[] = {0, 0, 255,   0, 255, 0,      // 底部：紅、綠
+                              255, 0, 0,   255, 255, 255}; // 頂部：藍、白
+    data.insert(data.end(), pixels, pixels + sizeof(pixels));
+
+    ImageDecoder::Image image;
+    std::string error;
+    ASSERT_TRUE(Decode(data, image, error)) << error;
+    EXPECT_EQ(image.width, 2);
+    EXPECT_EQ(image.height, 2);
+    EXPECT_EQ(Pixel(image, 0, 0), (std::vector<uint8_t>{255, 0, 0, 255}));
+    EXPECT_EQ(Pixel(image, 1, 0), (std::vector<uint8_t>{0, 255, 0, 255}));
+    EXPECT_EQ(Pixel(image, 0, 1), (std::vector<uint8_t>{0, 0, 255, 255}));
+    EXPECT_EQ(Pixel(image, 1, 1), (std::vector<uint8_t>{255, 255, 255, 255}));
+
+    // 3x2，32 位元 RLE，左上原點：頂部三個重複像素，底部三個原始像素
+    std::vector<uint8_t> rle = MakeTgaHeader(10, 3, 2, 32, 0x20);
+    const uint8_t packets[] = {0x82, 10, 20, 30, 40,
+                               0x02, 1, 2, 3, 4,   5, 6, 7, 8,   9, 10, 11, 12};
+    rle.insert(rle.end(), packets, packets + sizeof(packets));
+    ASSERT_TRUE(Decode(rle, image, error)) << error;
+    EXPECT_EQ(image.width, 3);
+    EXPECT_EQ(Pixel(image, 2, 1), (std::vector<uint8_t>{30, 20, 10, 40}));
+    EXPECT_EQ(Pixel(image, 0, 0), (std::vector<uint8_t>{3, 2, 1, 4}));
+    EXPECT_EQ(Pixel(image, 2, 0), (std::vector<uint8_t>{11, 10, 9, 12}));
+
+    // 截斷的 RLE 資料
+    rle.resize(rle.size() - 2);
+    EXPECT_FALSE(Decode(rle, image, error));
+    EXPECT_FALSE(error.empty());
+
+    // 色盤影像不支援
+    std::vector<uint8_t> colorMapped = MakeTgaHeader(1, 1, 1, 8, 0);
+    colorMapped[1] = 1;
+    colorMapped.push_back(0);
+    EXPECT_FALSE(Decode(colorMapped, image, error));
+}
+
+// 測試 PPM、PGM 與註解、最大值縮放
+TEST(ImageDecoderTest, DecodesPnm) {
+    const std::string header = "P6\n# comment\n2 1\n255\n";
+    std::vector<uint8_t> ppm(header.begin(), header.end());
+    const uint8_t pixels[] = {255, 0, 0, 0, 0, 255};
+    ppm.insert(ppm.end(), pixels, pixels + sizeof(pixels));
+
+    ImageDecoder::Image image;
+    std::string error;
+    ASSERT_TRUE(Decode(ppm, image, error)) << error;
+    EXPECT_EQ(image.width, 2);
+    EXPECT_EQ(image.height, 1);
+    EXPECT_EQ(Pixel(image, 0, 0), (std::vector<uint8_t>{255, 0, 0, 255}));
+    EXPECT_EQ(Pixel(image, 1, 0), (std::vector<uint8_t>{0, 0, 255, 255}));
+
+    // PGM，兩列由上而下儲存，最大值 15
+    const std::string grayHeader = "P5 1 2 15 ";
+    std::vector<uint8_t> pgm(grayHeader.begin(), grayHeader.end());
+    pgm.push_back(15);  // 頂部
+    pgm.push_back(0);   // 底部
+    ASSERT_TRUE(Decode(pgm, image, error)) << error;
+    EXPECT_EQ(Pixel(image, 0, 0), (std::vector<uint8_t>{0, 0, 0, 255}));
+    EXPECT_EQ(Pixel(image, 0, 1), (std::vector<uint8_t>{255, 255, 255, 255}));
+
+    pgm.pop_back();
+    EXPECT_FALSE(Decode(pgm, image, error));
+
+    const std::string wide = "P6 2 1 65535\n";
+    EXPECT_FALSE(Decode(std::vector<uint8_t>(wide.begin(), wide.end()), image, error));
+}
+
+// 主函數
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
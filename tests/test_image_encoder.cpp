@@ -0,0 +1,165 @@
+/**
+ * @file test_image_encoder.cpp
+ * @brief 影像編碼器單元測試
+ *
+ * 解析輸出的 PNG：檢查簽章、區塊 CRC、IHDR，展開 stored block 並比對掃描線與 Adler-32。
+ * 使用 Google Test 框架進行單元測試。
+ */
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../cross_platform_runner/image_encoder.h"
+
+namespace {
+
+uint32_t ReadBE32(const std::vector<uint8_t>& data, size_t offset) {
+    return (static_cast<uint32_t>(data[offset]) << 24) | (static_cast<uint32_t>(data[offset + 1]) << 16) |
+           (static_cast<uint32_t>(data[offset + 2]) << 8) | static_cast<uint32_t>(data[offset + 3]);
+}
+
+struct Chunk {
+    std::string type;
+    std::vector<uint8_t> data;
+};
+
+// 拆出所有區塊並驗證 CRC
+std::vector<Chunk> ParseChunks(const std::vector<uint8_t>& png) {
+    std::vector<Chunk> chunks;
+    size_t offset = 8;
+    while (offset + 12 <= png.size()) {
+        const uint32_t length = ReadBE32(png, offset);
+        EXPECT_LE(offset + 12 + length, png.size());
+        Chunk chunk;
+        chunk.type.assign(png.begin() + offset + 4, png.begin() + offset + 8);
+        chunk.data.assign(png.begin() + offset + 8, png.begin() + offset + 8 + length);
+        EXPECT_EQ(ReadBE32(png, offset + 8 + length), ImageEncoder::Crc32(png.data() + offset + 4, length + 4))
+            << chunk.type;
+        chunks.push_back(std::move(chunk));
+        offset += 12 + length;
+    }
+    EXPECT_EQ(offset, png.size());
+    return chunks;
+}
+
+// 只支援 stored block 的 zlib 展開
+std::vector<uint8_t> InflateStored(const std::vector<uint8_t>& zlib, size_t& blockCount) {
+    std::vector<uint8_t> out;
+    EXPECT_EQ((zlib[0] * 256 + zlib[1]) % 31, 0);
+    size_t offset = 2;
+    blockCount = 0;
+    bool last = false;
+    while (!last && offset + 5 <= zlib.size()) {
+        last = (zlib[offset] & 1) != 0;
+        EXPECT_EQ(zlib[offset] >> 1, 0);
+        const uint16_t length = static_cast<uint16_t>(zlib[offset + 1] | (zlib[offset + 2] << 8));
+        const uint16_t inverse = static_cast<uint16_t>(zlib[offset + 3] | (zlib[offset + 4] << 8));
+        EXPECT_EQ(static_cast<uint16_t>(~length), inverse);
+        out.insert(out.end(), zlib.begin() + offset + 5, zlib.begin() + offset + 5 + length);
+        offset += 5 + length;
+        ++blockCount;
+    }
+    EXPECT_TRUE(last);
+    EXPECT_EQ(offset + 4, zlib.size());
+    EXPECT_EQ(ReadBE32(zlib, offset), ImageEncoder::Adler32(out.data(), out.size()));
+    return out;
+}
+
+std::vector<uint8_t> MakeRgba(int width, int height) {
+    std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            uint8_t* pixel = &rgba[(static_cast<size_t>(y) * width + x) * 4];
+            pixel[0] = static_cast<uint8_t>(x);
+            pixel[1] = static_cast<uint8_t>(y);
+            pixel[2] = static_cast<uint8_t>(x ^ y);
+            pixel[3] = 128;
+        }
+    }
+    return rgba;
+}
+
+} // namespace
+
+// 測試校驗和的已知值
+TEST(ImageEncoderTest, Checksums) {
+    const std::string text = "123456789";
+    const auto* data = reinterpret_cast<const uint8_t*>(text.data());
+    EXPECT_EQ(ImageEncoder::Crc32(data, text.size()), 0xCBF43926u);
+    EXPECT_EQ(ImageEncoder::Adler32(data, text.size()), 0x091E01DEu);
+
+    // 分段計算與一次計算相同
+    EXPECT_EQ(ImageEncoder::Crc32(data + 4, 5, ImageEncoder::Crc32(data, 4)), 0xCBF43926u);
+    EXPECT_EQ(ImageEncoder::Adler32(data + 4, 5, ImageEncoder::Adler32(data, 4)), 0x091E01DEu);
+
+    std::vector<uint8_t> large(100000, 0xFF);
+    uint32_t s1 = 1, s2 = 0;
+    for (uint8_t value : large) {
+        s1 = (s1 + value) % 65521;
+        s2 = (s2 + s1) % 65521;
+    }
+    EXPECT_EQ(ImageEncoder::Adler32(large.data(), large.size()), (s2 << 16) | s1);
+}
+
+// 測試 PNG 結構與像素內容，影像大到需要多個 stored block
+TEST(ImageEncoderTest, EncodesPng) {
+    const int width = 200;
+    const int height = 120;
+    const std::vector<uint8_t> rgba = MakeRgba(width, height);
+    const std::vector<uint8_t> png = ImageEncoder::EncodePng(width, height, rgba.data());
+    ASSERT_GT(png.size(), 8u);
+    EXPECT_EQ(std::vector<uint8_t>(png.begin(), png.begin() + 8),
+              (std::vector<uint8_t>{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'}));
+
+    const std::vector<Chunk> chunks = ParseChunks(png);
+    ASSERT_EQ(chunks.size(), 3u);
+    EXPECT_EQ(chunks[0].type, "IHDR");
+    EXPECT_EQ(chunks[1].type, "IDAT");
+    EXPECT_EQ(chunks[2].type, "IEND");
+    ASSERT_EQ(chunks[0].data.size(), 13u);
+    EXPECT_EQ(ReadBE32(chunks[0].data, 0), static_cast<uint32_t>(width));
+    EXPECT_EQ(ReadBE32(chunks[0].data, 4), static_cast<uint32_t>(height));
+    EXPECT_EQ(chunks[0].data[8], 8);
+    EXPECT_EQ(chunks[0].data[9], 2);
+
+    size_t blockCount = 0;
+    const std::vector<uint8_t> scanlines = InflateStored(chunks[1].data, blockCount);
+    EXPECT_EQ(blockCount, 2u);
+    const size_t rowBytes = static_cast<size_t>(width) * 3 + 1;
+    ASSERT_EQ(scanlines.size(), rowBytes * height);
+
+    // PNG 第一列是 RGBA 的最後一列
+    for (int row = 0; row < height; ++row) {
+        const int sourceRow = height - 1 - row;
+        EXPECT_EQ(scanlines[row * rowBytes], 0);
+        for (int x = 0; x < width; x += 37) {
+            const uint8_t* pixel = &scanlines[row * rowBytes + 1 + x * 3];
+            EXPECT_EQ(pixel[0], static_cast<uint8_t>(x));
+            EXPECT_EQ(pixel[1], static_cast<uint8_t>(sourceRow));
+            EXPECT_EQ(pixel[2], static_cast<uint8_t>(x ^ sourceRow));
+        }
+    }
+
+    EXPECT_TRUE(ImageEncoder::EncodePng(0, 4, rgba.data()).empty());
+    EXPECT_TRUE(ImageEncoder::EncodePng(4, 4, nullptr).empty());
+}
+
+// 測試原始串流用的 RGB 轉換
+TEST(ImageEncoderTest, ConvertsToRgbTopDown) {
+    const std::vector<uint8_t> rgba = MakeRgba(3, 2);
+    std::vector<uint8_t> rgb;
+    ImageEncoder::ConvertToRgbTopDown(3, 2, rgba.data(), rgb);
+    ASSERT_EQ(rgb.size(), 18u);
+    EXPECT_EQ(rgb[0], 0);
+    EXPECT_EQ(rgb[1], 1);   // 頂部為 RGBA 的第二列
+    EXPECT_EQ(rgb[9 + 3], 1);
+    EXPECT_EQ(rgb[9 + 4], 0);
+}
+
+// 主函數
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+/**
+ * @file test_mesh_lod.cpp
+ * @brief 網格細節層級單元測試
+ *
+ * 測試 LOD 鏈的三角形數遞減、頂點資料完整，以及依螢幕大小選擇層級。
+ * 使用 Google Test 框架進行單元測試。
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "../cross_platform_runner/mesh_lod.h"
+
+namespace {
+
+// 經緯球，接縫上的頂點分裂以保留紋理座標
+MeshLod::MeshData MakeSphere(int segments, int rings) {
+    const float pi = 3.14159265f;
+    MeshLod::MeshData mesh;
+    for (int ring = 0; ring <= rings; ++ring) {
+        const float v = static_cast<float>(ring) / static_cast<float>(rings);
+        const float phi = v * pi;
+        for (int segment = 0; segment <= segments; ++segment) {
+            const float u = static_cast<float>(segment) / static_cast<float>(segments);
+            const float theta = u * 2.0f * pi;
+            const glm::vec3 p(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+            mesh.vertices.push_back(p);
+            mesh.normals.push_back(p);
+            mesh.texCoords.push_back(glm::vec2(u, v));
+        }
+    }
+    for (int ring = 0; ring < rings; ++ring) {
+        for (int segment = 0; segment < segments; ++segment) {
+            const unsigned int a = static_cast<unsigned int>(ring * (segments + 1) + segment);
+            const unsigned int b = a + static_cast<unsigned int>(segments + 1);
+            if (ring != 0) {
+                mesh.indices.insert(mesh.indices.end(), {a, a + 1, b});
+            }
+            if (ring != rings - 1) {
+                mesh.indices.insert(mesh.indices.end(), {a + 1, b + 1, b});
+            }
+        }
+    }
+    return mesh;
+}
+
+} // namespace
+
+// 測試每一級的三角形數約減半，且頂點資料可直接上傳
+TEST(MeshLodTest, BuildChainReducesTriangles) {
+    const MeshLod::MeshData sphere = MakeSphere(32, 16);
+    const std::vector<MeshLod::MeshData> levels = MeshLod::BuildChain(sphere);
+
+    ASSERT_EQ(levels.size(), MeshLod::MAX_LEVELS - 1);
+    size_t previous = sphere.indices.size() / 3;
+    for (const auto& level : levels) {
+        const size_t triangles = level.indices.size() / 3;
+        EXPECT_LT(triangles, previous);
+        EXPECT_GE(triangles, previous / 2 - previous / 10);
+        previous = triangles;
+
+        ASSERT_EQ(level.normals.size(), level.vertices.size());
+        ASSERT_EQ(level.texCoords.size(), level.vertices.size());
+        for (unsigned int index : level.indices) {
+            ASSERT_LT(index, level.vertices.size());
+        }
+        float alignment = 0.0f;
+        for (size_t i = 0; i < level.vertices.size(); ++i) {
+            EXPECT_NEAR(glm::length(level.normals[i]), 1.0f, 1e-4f);
+            // 簡化後仍接近單位球，且法向朝外（極點附近的狹長三角形讓個別法向偏斜）
+            EXPECT_NEAR(glm::length(level.vertices[i]), 1.0f, 0.2f);
+            const float dot = glm::dot(level.normals[i], glm::normalize(level.vertices[i]));
+            EXPECT_GT(dot, 0.0f);
+            alignment += dot;
+            // 紋理座標取自位置相近的原頂點
+            EXPECT_GE(level.texCoords[i].y, 0.0f);
+            EXPECT_LE(level.texCoords[i].y, 1.0f);
+            const float cosine = level.vertices[i].y / glm::length(level.vertices[i]);
+            const float expectedV = std::acos(std::max(-1.0f, std::min(1.0f, cosine))) / 3.14159265f;
+            EXPECT_NEAR(level.texCoords[i].y, expectedV, 0.15f);
+        }
+        EXPECT_GT(alignment / static_cast<float>(level.vertices.size()), 0.9f);
+    }
+    EXPECT_NEAR(MeshLod::ComputeBoundingRadius(sphere.vertices), 1.0f, 1e-5f);
+
+    // 三角形太少時不產生層級
+    MeshLod::MeshData triangle;
+    triangle.vertices = {glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f)};
+    triangle.indices = {0, 1, 2};
+    EXPECT_TRUE(MeshLod::BuildChain(triangle).empty());
+    triangle.indices = {0, 1, 5};
+    EXPECT_TRUE(MeshLod::BuildChain(triangle).empty());
+}
+
+// 測試依螢幕大小選擇層級，且不超過可用層級數
+TEST(MeshLodTest, SelectLevelByScreenSize) {
+    EXPECT_EQ(MeshLod::SelectLevel(1.0f, 4), 0u);
+    EXPECT_EQ(MeshLod::SelectLevel(0.2f, 4), 1u);
+    EXPECT_EQ(MeshLod::SelectLevel(0.05f, 4), 2u);
+    EXPECT_EQ(MeshLod::SelectLevel(0.001f, 4), 3u);
+    EXPECT_EQ(MeshLod::SelectLevel(0.001f, 2), 1u);
+    EXPECT_EQ(MeshLod::SelectLevel(0.001f, 1), 0u);
+    EXPECT_EQ(MeshLod::SelectLevel(0.001f, 0), 0u);
+}
+
+// 主函數
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,168 @@
+/**
+ * @file test_mesh_optimizer.cpp
+ * @brief 碰撞網格最佳化單元測試
+ *
+ * 測試頂點焊接、退化三角形移除、QEM 簡化與體素凸分解。
+ * 使用 Google Test 框架進行單元測試。
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <map>
+
+#include "../cross_platform_runner/mesh_optimizer.h"
+
+using PhysicsScene::Vector3;
+
+class MeshOptimizerTest : public ::testing::Test {
+protected:
+    // 每個面各自擁有四個頂點的方塊（共 24 個頂點），模擬匯出工具的輸出
+    static MeshOptimizer::Mesh MakeUnweldedBox(const Vector3& minimum, const Vector3& maximum) {
+        static const int faces[6][4] = {
+            {0, 4, 6, 2}, {1, 3, 7, 5}, {0, 1, 5, 4}, {2, 6, 7, 3}, {0, 2, 3, 1}, {4, 5, 7, 6}
+        };
+        MeshOptimizer::Mesh mesh;
+        for (const auto& face : faces) {
+            const int base = static_cast<int>(mesh.vertices.size());
+            for (int corner : face) {
+                mesh.vertices.emplace_back((corner & 1) ? maximum.x : minimum.x,
+                                           (corner & 2) ? maximum.y : minimum.y,
+                                           (corner & 4) ? maximum.z : minimum.z);
+            }
+            mesh.triangles.push_back({base, base + 1, base + 2});
+            mesh.triangles.push_back({base, base + 2, base + 3});
+        }
+        return mesh;
+    }
+
+    // 經緯細分的球面
+    static MeshOptimizer::Mesh MakeSphere(int rings, int segments, float radius) {
+        MeshOptimizer::Mesh mesh;
+        const float pi = 3.14159265f;
+        mesh.vertices.emplace_back(0.0f, radius, 0.0f);
+        for (int r = 1; r < rings; ++r) {
+            const float theta = pi * r / rings;
+            for (int s = 0; s < segments; ++s) {
+                const float phi = 2.0f * pi * s / segments;
+                mesh.vertices.emplace_back(radius * std::sin(theta) * std::cos(phi), radius * std::cos(theta),
+                                           radius * std::sin(theta) * std::sin(phi));
+            }
+        }
+        mesh.vertices.emplace_back(0.0f, -radius, 0.0f);
+        const int south = static_cast<int>(mesh.vertices.size()) - 1;
+        auto ring = [&](int r, int s) { return 1 + (r - 1) * segments + (s % segments); };
+
+        for (int s = 0; s < segments; ++s) {
+            mesh.triangles.push_back({0, ring(1, s + 1), ring(1, s)});
+            mesh.triangles.push_back({south, ring(rings - 1, s), ring(rings - 1, s + 1)});
+            for (int r = 1; r < rings - 1; ++r) {
+                mesh.triangles.push_back({ring(r, s), ring(r, s + 1), ring(r + 1, s + 1)});
+                mesh.triangles.push_back({ring(r, s), ring(r + 1, s + 1), ring(r + 1, s)});
+            }
+        }
+        return mesh;
+    }
+
+    static void Append(MeshOptimizer::Mesh& mesh, const MeshOptimizer::Mesh& other) {
+        const int base = static_cast<int>(mesh.vertices.size());
+        mesh.vertices.insert(mesh.vertices.end(), other.vertices.begin(), other.vertices.end());
+        for (auto triangle : other.triangles) {
+            for (int& index : triangle) index += base;
+            mesh.triangles.push_back(triangle);
+        }
+    }
+};
+
+// 測試焊接後方塊只剩 8 個頂點，退化與重複三角形被移除
+TEST_F(MeshOptimizerTest, WeldAndRemoveDegenerates) {
+    MeshOptimizer::Mesh mesh = MakeUnweldedBox(Vector3(-1, -1, -1), Vector3(1, 1, 1));
+    mesh.vertices.emplace_back(1.0f + 1e-5f, 1.0f, 1.0f);
+    const int nearCorner = static_cast<int>(mesh.vertices.size()) - 1;
+    mesh.triangles.push_back({0, 0, 1});            // 索引重複
+    mesh.triangles.push_back({0, 1, nearCorner});   // 與正常三角形無關，焊接後仍有效
+    mesh.triangles.push_back(mesh.triangles[0]);    // 重複三角形
+
+    EXPECT_EQ(MeshOptimizer::WeldVertices(mesh, 1e-3f), 24u + 1u - 8u);
+    EXPECT_EQ(mesh.vertices.size(), 8u);
+
+    EXPECT_EQ(MeshOptimizer::RemoveDegenerateTriangles(mesh), 2u);
+    EXPECT_EQ(mesh.triangles.size(), 13u);
+    for (const auto& triangle : mesh.triangles) {
+        for (int index : triangle) {
+            EXPECT_GE(index, 0);
+            EXPECT_LT(index, 8);
+        }
+    }
+}
+
+// 測試簡化後達到三角形預算且形狀仍貼近原本的球面
+TEST_F(MeshOptimizerTest, DecimateSphere) {
+    MeshOptimizer::Mesh mesh = MakeSphere(24, 32, 1.0f);
+    const size_t original = mesh.triangles.size();
+
+    const size_t removed = MeshOptimizer::Decimate(mesh, 200);
+    EXPECT_EQ(original - removed, mesh.triangles.size());
+    EXPECT_LE(mesh.triangles.size(), 200u);
+    EXPECT_GE(mesh.triangles.size(), 150u);
+
+    for (const Vector3& vertex : mesh.vertices) {
+        const float radius = std::sqrt(vertex.x * vertex.x + vertex.y * vertex.y + vertex.z * vertex.z);
+        EXPECT_NEAR(radius, 1.0f, 0.1f);
+    }
+
+    // 封閉網格簡化後每條邊仍恰好被兩個三角形共用
+    std::map<std::pair<int, int>, int> edges;
+    for (const auto& triangle : mesh.triangles) {
+        for (int e = 0; e < 3; ++e) {
+            int a = triangle[e], b = triangle[(e + 1) % 3];
+            ++edges[{std::min(a, b), std::max(a, b)}];
+        }
+    }
+    for (const auto& [edge, count] : edges) {
+        EXPECT_EQ(count, 2);
+    }
+}
+
+// 測試凸形狀只產生一個凸包，L 形被分成兩塊以上且凸包頂點受上限約束
+TEST_F(MeshOptimizerTest, ConvexDecomposition) {
+    MeshOptimizer::DecompositionSettings settings;
+    settings.resolution = 24;
+    settings.maxHullVertices = 16;
+
+    MeshOptimizer::Mesh box = MakeUnweldedBox(Vector3(0, 0, 0), Vector3(2, 1, 1));
+    MeshOptimizer::WeldVertices(box, 1e-4f);
+    auto boxHulls = MeshOptimizer::DecomposeConvex(box, settings);
+    ASSERT_EQ(boxHulls.size(), 1u);
+    EXPECT_EQ(boxHulls[0].size(), 8u);
+
+    // L 形：兩個互相垂直的長條
+    MeshOptimizer::Mesh shape = MakeUnweldedBox(Vector3(0, 0, 0), Vector3(4, 1, 1));
+    Append(shape, MakeUnweldedBox(Vector3(0, 1, 0), Vector3(1, 4, 1)));
+    auto hulls = MeshOptimizer::DecomposeConvex(shape, settings);
+    ASSERT_GE(hulls.size(), 2u);
+    ASSERT_LE(hulls.size(), static_cast<size_t>(settings.maxHulls));
+
+    const float voxel = 4.0f / settings.resolution;
+    for (const auto& hull : hulls) {
+        EXPECT_GE(hull.size(), 4u);
+        EXPECT_LE(hull.size(), 16u);
+        for (const Vector3& vertex : hull) {
+            EXPECT_GE(vertex.x, -voxel - 1e-4f);
+            EXPECT_LE(vertex.x, 4.0f + voxel + 1e-4f);
+            EXPECT_GE(vertex.y, -voxel - 1e-4f);
+            EXPECT_LE(vertex.y, 4.0f + voxel + 1e-4f);
+            // L 形的凹角內不應有凸包頂點
+            EXPECT_FALSE(vertex.x > 1.0f + 2 * voxel && vertex.y > 1.0f + 2 * voxel);
+        }
+    }
+
+    // 共面點集沒有凸包
+    EXPECT_TRUE(MeshOptimizer::ComputeConvexHull({Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(0, 1, 0),
+                                                  Vector3(1, 1, 0)}).empty());
+}
+
+// 主函數
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
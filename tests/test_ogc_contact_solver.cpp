@@ -0,0 +1,176 @@
+/**
+ * @file test_ogc_contact_solver.cpp
+ * @brief OGC 接觸求解器單元測試
+ *
+ * 測試偏移接觸的速度約束、摩擦錐限制、批次著色與平行求解的確定性。
+ * 使用 Google Test 框架進行單元測試。
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "../ogc_integration/ogc_contact_solver.h"
+#include "../cross_platform_runner/worker_pool.h"
+
+using Eigen::Vector3f;
+
+class OGCContactSolverTest : public ::testing::Test {
+protected:
+    static constexpr float TIME_STEP = 1.0f / 60.0f;
+
+    static OGCContactSolver::BodyState MakeBox(const Vector3f& position, const Vector3f& velocity, float mass) {
+        OGCContactSolver::BodyState body;
+        body.position = position;
+        body.linearVelocity = velocity;
+        body.inverseMass = 1.0f / mass;
+        // 邊長 1 的立方體
+        body.inverseInertia = Eigen::Matrix3f::Identity() * (6.0f / mass);
+        return body;
+    }
+
+    static OGCContactSolver::BodyState MakeGround() {
+        return OGCContactSolver::BodyState();
+    }
+
+    // 箱子底面四角與地面（body 0）的接觸
+    static void AddBoxGroundContacts(std::vector<OGCContactSolver::ContactPoint>& contacts,
+                                     const std::vector<OGCContactSolver::BodyState>& bodies,
+                                     uint32_t box, float gap, float friction) {
+        for (float dx : {-0.5f, 0.5f}) {
+            for (float dz : {-0.5f, 0.5f}) {
+                OGCContactSolver::ContactPoint contact;
+                contact.bodyA = box;
+                contact.bodyB = 0;
+                contact.pointA = bodies[box].position + Vector3f(dx, -0.5f, dz);
+                contact.pointB = contact.pointA - Vector3f(0.0f, gap, 0.0f);
+                contact.normal = Vector3f::UnitY();
+                contact.distance = gap;
+                contact.friction = friction;
+                contacts.push_back(contact);
+            }
+        }
+    }
+
+    // 解出衝量後的剛體速度
+    static Vector3f ApplyLinear(const OGCContactSolver::BodyState& body,
+                                const std::vector<OGCContactSolver::ContactPoint>& contacts,
+                                const std::vector<OGCContactSolver::ContactImpulse>& impulses,
+                                uint32_t index) {
+        Vector3f velocity = body.linearVelocity;
+        for (size_t i = 0; i < contacts.size(); ++i) {
+            if (contacts[i].bodyA == index) velocity += impulses[i].impulse * body.inverseMass;
+            if (contacts[i].bodyB == index) velocity -= impulses[i].impulse * body.inverseMass;
+        }
+        return velocity;
+    }
+
+    OGCContactSolver solver;
+};
+
+// 測試間隙內的推測式接觸：下一步不會越過間隙，也不會被推離
+TEST_F(OGCContactSolverTest, SpeculativeContactStopsAtGap) {
+    const float gap = 0.005f;
+    std::vector<OGCContactSolver::BodyState> bodies = {
+        MakeGround(),
+        MakeBox(Vector3f(0.0f, 0.5f + gap, 0.0f), Vector3f(0.0f, -3.0f, 0.0f), 2.0f)
+    };
+    std::vector<OGCContactSolver::ContactPoint> contacts;
+    AddBoxGroundContacts(contacts, bodies, 1, gap, 0.5f);
+
+    std::vector<OGCContactSolver::ContactImpulse> impulses;
+    solver.Solve(bodies, contacts, TIME_STEP, impulses);
+
+    ASSERT_EQ(impulses.size(), contacts.size());
+    Vector3f velocity = ApplyLinear(bodies[1], contacts, impulses, 1);
+    EXPECT_NEAR(velocity.y(), -gap / TIME_STEP, 1e-3f);
+    for (const auto& impulse : impulses) {
+        EXPECT_GE(impulse.normalImpulse, 0.0f);
+    }
+
+    // 遠離中的物體不受影響
+    bodies[1].linearVelocity = Vector3f(0.0f, 1.0f, 0.0f);
+    solver.Solve(bodies, contacts, TIME_STEP, impulses);
+    for (const auto& impulse : impulses) {
+        EXPECT_FLOAT_EQ(impulse.normalImpulse, 0.0f);
+    }
+}
+
+// 測試摩擦衝量不超過摩擦錐
+TEST_F(OGCContactSolverTest, FrictionIsClamped) {
+    std::vector<OGCContactSolver::BodyState> bodies = {
+        MakeGround(),
+        MakeBox(Vector3f(0.0f, 0.49f, 0.0f), Vector3f(5.0f, -1.0f, 0.0f), 1.0f)
+    };
+    std::vector<OGCContactSolver::ContactPoint> contacts;
+    AddBoxGroundContacts(contacts, bodies, 1, -0.01f, 0.3f);
+
+    std::vector<OGCContactSolver::ContactImpulse> impulses;
+    solver.Solve(bodies, contacts, TIME_STEP, impulses);
+
+    for (size_t i = 0; i < impulses.size(); ++i) {
+        const Vector3f& impulse = impulses[i].impulse;
+        float normal = impulse.dot(contacts[i].normal);
+        float tangent = (impulse - contacts[i].normal * normal).norm();
+        EXPECT_NEAR(normal, impulses[i].normalImpulse, 1e-5f);
+        EXPECT_LE(tangent, 0.3f * std::sqrt(2.0f) * normal + 1e-5f);
+    }
+
+    // 滑動方向被減速但不反向
+    Vector3f velocity = ApplyLinear(bodies[1], contacts, impulses, 1);
+    EXPECT_LT(velocity.x(), 5.0f);
+    EXPECT_GT(velocity.x(), 0.0f);
+}
+
+// 測試共用剛體的接觸被分到不同批次，平行與單執行緒結果完全相同
+TEST_F(OGCContactSolverTest, ParallelBatchesAreDeterministic) {
+    // 多個箱子堆疊：每個箱子與下方箱子接觸，最底層與地面接觸
+    std::vector<OGCContactSolver::BodyState> bodies = {MakeGround()};
+    std::vector<OGCContactSolver::ContactPoint> contacts;
+    for (int stack = 0; stack < 200; ++stack) {
+        uint32_t below = 0;
+        for (int level = 0; level < 5; ++level) {
+            Vector3f position(stack * 2.0f, 0.5f + level, 0.0f);
+            bodies.push_back(MakeBox(position, Vector3f(0.1f * level, -1.0f, 0.0f), 1.0f + level));
+            uint32_t box = static_cast<uint32_t>(bodies.size() - 1);
+
+            for (float dx : {-0.5f, 0.5f}) {
+                OGCContactSolver::ContactPoint contact;
+                contact.bodyA = box;
+                contact.bodyB = below;
+                contact.pointA = position + Vector3f(dx, -0.5f, 0.0f);
+                contact.pointB = contact.pointA;
+                contact.normal = Vector3f::UnitY();
+                contact.distance = -0.001f;
+                contacts.push_back(contact);
+            }
+            below = box;
+        }
+    }
+
+    OGCContactSolver::Settings settings;
+    settings.parallelThreshold = 16;
+    solver.SetSettings(settings);
+
+    std::vector<OGCContactSolver::ContactImpulse> serial;
+    solver.Solve(bodies, contacts, TIME_STEP, serial);
+    EXPECT_GE(solver.GetStatistics().batchCount, 2);
+    EXPECT_EQ(solver.GetStatistics().serialContactCount, 0);
+
+    WorkerPool pool(4);
+    solver.SetWorkerPool(&pool);
+    std::vector<OGCContactSolver::ContactImpulse> parallel;
+    for (int run = 0; run < 3; ++run) {
+        solver.Solve(bodies, contacts, TIME_STEP, parallel);
+        ASSERT_EQ(parallel.size(), serial.size());
+        for (size_t i = 0; i < serial.size(); ++i) {
+            EXPECT_EQ(parallel[i].normalImpulse, serial[i].normalImpulse) << "contact " << i;
+            EXPECT_EQ(parallel[i].impulse, serial[i].impulse) << "contact " << i;
+        }
+    }
+}
+
+// 主函數
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
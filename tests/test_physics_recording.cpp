@@ -0,0 +1,191 @@
+/**
+ * @file test_physics_recording.cpp
+ * @brief 物理錄製與回放快取單元測試
+ *
+ * 測試量化差分編碼的往返精度、關鍵影格拖曳、剛體集合變更與檔案損毀處理。
+ * 使用 Google Test 框架進行單元測試。
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+#include "../cross_platform_runner/physics_recording.h"
+
+namespace fs = std::filesystem;
+
+class PhysicsRecordingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        testDir = fs::temp_directory_path() / "physics_recording_test";
+        fs::create_directories(testDir);
+        filename = (testDir / "recording.prec").string();
+    }
+
+    void TearDown() override {
+        if (fs::exists(testDir)) {
+            fs::remove_all(testDir);
+        }
+    }
+
+    // 建立第 frame 影格：剛體 0 落下並旋轉，剛體 1 靜止
+    static FrameSnapshot MakeFrame(int frame, std::shared_ptr<const std::vector<std::string>> names) {
+        FrameSnapshot snapshot;
+        snapshot.bodyNames = names;
+        snapshot.simulationTime = frame / 60.0;
+        snapshot.bodies.resize(names->size());
+
+        float angle = frame * 0.05f;
+        snapshot.bodies[0].transform.position = PhysicsScene::Vector3(1.0f, 10.0f - frame * 0.01f, -2.0f);
+        snapshot.bodies[0].transform.rotation = PhysicsScene::Quaternion(std::cos(angle * 0.5f), 0.0f, std::sin(angle * 0.5f), 0.0f);
+        snapshot.bodies[0].active = true;
+
+        for (size_t i = 1; i < names->size(); ++i) {
+            snapshot.bodies[i].transform.position = PhysicsScene::Vector3(static_cast<float>(i), 0.5f, 0.0f);
+            snapshot.bodies[i].active = false;
+        }
+        return snapshot;
+    }
+
+    fs::path testDir;
+    std::string filename;
+};
+
+// 測試錄製後逐格回放的精度
+TEST_F(PhysicsRecordingTest, RoundTrip) {
+    auto names = std::make_shared<const std::vector<std::string>>(std::vector<std::string>{"box", "ground"});
+
+    PhysicsRecorder recorder;
+    PhysicsRecorder::Options options;
+    options.keyFrameInterval = 10;
+    ASSERT_TRUE(recorder.Open(filename, options));
+    for (int frame = 0; frame < 100; ++frame) {
+        ASSERT_TRUE(recorder.RecordFrame(MakeFrame(frame, names)));
+    }
+    ASSERT_TRUE(recorder.Close());
+
+    PhysicsPlayback playback;
+    ASSERT_TRUE(playback.Open(filename));
+    EXPECT_EQ(playback.GetFrameCount(), 100u);
+    EXPECT_NEAR(playback.GetDuration(), 99 / 60.0, 1e-9);
+
+    for (int frame = 0; frame < 100; ++frame) {
+        if (frame > 0) {
+            ASSERT_TRUE(playback.NextFrame());
+        }
+        const FrameSnapshot& decoded = playback.GetCurrentFrame();
+        FrameSnapshot expected = MakeFrame(frame, names);
+
+        ASSERT_EQ(decoded.bodies.size(), 2u);
+        EXPECT_EQ(decoded.GetBodyName(0), "box");
+        EXPECT_NEAR(decoded.bodies[0].transform.position.y, expected.bodies[0].transform.position.y, 1e-4);
+        // q 與 -q 代表相同旋轉，比較內積絕對值
+        const auto& qa = decoded.bodies[0].transform.rotation;
+        const auto& qb = expected.bodies[0].transform.rotation;
+        float dot = qa.w * qb.w + qa.x * qb.x + qa.y * qb.y + qa.z * qb.z;
+        EXPECT_NEAR(std::fabs(dot), 1.0f, 1e-4);
+        EXPECT_TRUE(decoded.bodies[0].active);
+        EXPECT_FALSE(decoded.bodies[1].active);
+    }
+    EXPECT_FALSE(playback.NextFrame());
+}
+
+// 測試依影格與時間拖曳（向前與向後）
+TEST_F(PhysicsRecordingTest, SeekFrameAndTime) {
+    auto names = std::make_shared<const std::vector<std::string>>(std::vector<std::string>{"box", "ground"});
+
+    PhysicsRecorder recorder;
+    PhysicsRecorder::Options options;
+    options.keyFrameInterval = 16;
+    ASSERT_TRUE(recorder.Open(filename, options));
+    for (int frame = 0; frame < 200; ++frame) {
+        recorder.RecordFrame(MakeFrame(frame, names));
+    }
+    ASSERT_TRUE(recorder.Close());
+
+    PhysicsPlayback playback;
+    ASSERT_TRUE(playback.Open(filename));
+
+    for (int target : {150, 37, 38, 199, 0, 64}) {
+        ASSERT_TRUE(playback.SeekFrame(target));
+        EXPECT_EQ(playback.GetCurrentFrameNumber(), static_cast<uint64_t>(target));
+        EXPECT_NEAR(playback.GetCurrentFrame().bodies[0].transform.position.y, 10.0f - target * 0.01f, 1e-4);
+    }
+    EXPECT_FALSE(playback.SeekFrame(200));
+
+    ASSERT_TRUE(playback.SeekTime(1.0));
+    EXPECT_EQ(playback.GetCurrentFrameNumber(), 60u);
+}
+
+// 測試錄製途中剛體集合變更
+TEST_F(PhysicsRecordingTest, BodySetChange) {
+    auto twoBodies = std::make_shared<const std::vector<std::string>>(std::vector<std::string>{"box", "ground"});
+    auto threeBodies = std::make_shared<const std::vector<std::string>>(std::vector<std::string>{"box", "ground", "ball"});
+
+    PhysicsRecorder recorder;
+    ASSERT_TRUE(recorder.Open(filename));
+    for (int frame = 0; frame < 30; ++frame) {
+        recorder.RecordFrame(MakeFrame(frame, frame < 20 ? twoBodies : threeBodies));
+    }
+    ASSERT_TRUE(recorder.Close());
+
+    PhysicsPlayback playback;
+    ASSERT_TRUE(playback.Open(filename));
+
+    ASSERT_TRUE(playback.SeekFrame(25));
+    EXPECT_EQ(playback.GetCurrentFrame().bodies.size(), 3u);
+    EXPECT_EQ(playback.GetCurrentFrame().FindBody("ball"), 2);
+
+    ASSERT_TRUE(playback.SeekFrame(5));
+    EXPECT_EQ(playback.GetCurrentFrame().bodies.size(), 2u);
+
+    // 從名稱表變更前逐格播放跨越邊界
+    ASSERT_TRUE(playback.SeekFrame(19));
+    ASSERT_TRUE(playback.NextFrame());
+    EXPECT_EQ(playback.GetCurrentFrame().bodies.size(), 3u);
+}
+
+// 測試靜止剛體的差分影格壓縮
+TEST_F(PhysicsRecordingTest, StaticBodiesCompress) {
+    std::vector<std::string> bodyNames;
+    for (int i = 0; i < 1000; ++i) {
+        bodyNames.push_back("body_" + std::to_string(i));
+    }
+    auto names = std::make_shared<const std::vector<std::string>>(bodyNames);
+
+    PhysicsRecorder recorder;
+    ASSERT_TRUE(recorder.Open(filename));
+    for (int frame = 0; frame < 120; ++frame) {
+        recorder.RecordFrame(MakeFrame(frame, names));
+    }
+    ASSERT_TRUE(recorder.Close());
+
+    // 999 個靜止剛體在差分影格中每個只占兩個位元（活動與變更遮罩）
+    uint64_t rawSize = 120ull * 1000 * (sizeof(float) * 7);
+    EXPECT_LT(recorder.GetBytesWritten() * 20, rawSize);
+}
+
+// 測試缺少索引的檔案
+TEST_F(PhysicsRecordingTest, TruncatedFile) {
+    auto names = std::make_shared<const std::vector<std::string>>(std::vector<std::string>{"box"});
+
+    {
+        PhysicsRecorder recorder;
+        ASSERT_TRUE(recorder.Open(filename));
+        for (int frame = 0; frame < 10; ++frame) {
+            recorder.RecordFrame(MakeFrame(frame, names));
+        }
+    }
+    fs::resize_file(filename, fs::file_size(filename) - 4);
+
+    PhysicsPlayback playback;
+    EXPECT_FALSE(playback.Open(filename));
+    EXPECT_FALSE(playback.GetLastError().empty());
+}
+
+// 主函數
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,90 @@
+/**
+ * @file test_render_queue.cpp
+ * @brief 繪製佇列單元測試
+ *
+ * 測試排序鍵的順序（不透明依狀態、半透明由遠到近）與提交時省略重複的狀態切換。
+ * 使用 Google Test 框架進行單元測試。
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "../cross_platform_runner/render_queue.h"
+
+namespace {
+
+// 記錄提交過程的 Visitor
+struct RecordingVisitor {
+    std::vector<uint32_t> drawn;
+    int shaderBinds = 0;
+    int materialBinds = 0;
+    int textureBinds = 0;
+
+    void BindShader(uint16_t) { ++shaderBinds; }
+    void BindMaterial(uint16_t) { ++materialBinds; }
+    void BindTexture(uint16_t) { ++textureBinds; }
+    void Draw(const RenderQueue::Item& item) { drawn.push_back(item.object); }
+};
+
+} // namespace
+
+// 測試不透明項目依著色器、材質、紋理分組，半透明項目排在最後且由遠到近
+TEST(RenderQueueTest, SortOrder) {
+    using Pass = RenderQueue::Pass;
+    RenderQueue queue;
+    queue.Add(Pass::Transparent, 0, 1, 0, 0.2f, 0);
+    queue.Add(Pass::Opaque, 1, 2, 0, 0.5f, 1);
+    queue.Add(Pass::Opaque, 0, 3, 0, 0.9f, 2);
+    queue.Add(Pass::Transparent, 0, 1, 0, 0.8f, 3);
+    queue.Add(Pass::Opaque, 0, 3, 0, 0.1f, 4);
+    queue.Add(Pass::Opaque, 0, 2, 5, 0.3f, 5);
+    queue.Add(Pass::Opaque, 0, 2, 4, 0.3f, 6);
+    queue.Sort();
+
+    std::vector<uint32_t> order;
+    for (const auto& item : queue.GetItems()) {
+        order.push_back(item.object);
+    }
+    EXPECT_EQ(order, (std::vector<uint32_t>{6, 5, 4, 2, 1, 3, 0}));
+
+    // 深度超出範圍時截斷而不溢位到其他欄位
+    EXPECT_EQ(RenderQueue::MakeKey(Pass::Opaque, 1, 0, 0, 5.0f) >> 56,
+              RenderQueue::MakeKey(Pass::Opaque, 1, 0, 0, -1.0f) >> 56);
+    EXPECT_LT(RenderQueue::MakeKey(Pass::Opaque, 0, 0, 0, 0.0f), RenderQueue::MakeKey(Pass::Opaque, 0, 0, 0, 1.0f));
+}
+
+// 測試排序後只在狀態改變時呼叫綁定，切換著色器時重新設定材質與紋理
+TEST(RenderQueueTest, SubmitSkipsRedundantState) {
+    using Pass = RenderQueue::Pass;
+    RenderQueue queue;
+    for (uint32_t i = 0; i < 100; ++i) {
+        queue.Add(Pass::Opaque, i % 2, i % 4, 0, static_cast<float>(i) / 100.0f, i);
+    }
+    queue.Sort();
+
+    RecordingVisitor visitor;
+    const RenderQueue::SubmitStatistics statistics = queue.Submit(visitor);
+
+    EXPECT_EQ(statistics.items, 100);
+    EXPECT_EQ(visitor.drawn.size(), 100u);
+    EXPECT_EQ(visitor.shaderBinds, 2);
+    EXPECT_EQ(visitor.materialBinds, 4);
+    EXPECT_EQ(visitor.textureBinds, 2);
+    EXPECT_EQ(statistics.shaderChanges, visitor.shaderBinds);
+    EXPECT_EQ(statistics.materialChanges, visitor.materialBinds);
+    EXPECT_EQ(statistics.textureChanges, visitor.textureBinds);
+    EXPECT_EQ(statistics.skippedStateChanges, 3 * 100 - 2 - 4 - 2);
+
+    // 相同狀態內保持加入順序
+    for (size_t i = 1; i < visitor.drawn.size(); ++i) {
+        if (visitor.drawn[i] % 4 == visitor.drawn[i - 1] % 4) {
+            EXPECT_LT(visitor.drawn[i - 1], visitor.drawn[i]);
+        }
+    }
+}
+
+// 主函數
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
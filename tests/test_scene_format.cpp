@@ -184,6 +184,99 @@ TEST_F(SceneFormatTest, ValidateScene) {
     EXPECT_TRUE(result.isValid);
 }
 
+// 測試碰撞層矩陣：對稱設定與依群組合併遮罩
+TEST_F(SceneFormatTest, CollisionLayerMatrix) {
+    PhysicsScene::CollisionLayerMatrix layers;
+    EXPECT_FALSE(layers.isEnabled());
+    EXPECT_EQ(layers.getCollisionMask(1), 0xFFFFFFFFu);
+    
+    int world = layers.addLayer("World");
+    int debris = layers.addLayer("Debris");
+    int player = layers.addLayer("Player");
+    EXPECT_EQ(layers.addLayer("Debris"), debris);
+    EXPECT_EQ(layers.findLayer("Player"), player);
+    EXPECT_EQ(layers.findLayer("Missing"), -1);
+    
+    layers.setLayersCollide(debris, debris, false);
+    layers.setLayersCollide(debris, player, false);
+    EXPECT_TRUE(layers.layersCollide(world, debris));
+    EXPECT_FALSE(layers.layersCollide(debris, debris));
+    EXPECT_FALSE(layers.layersCollide(player, debris));
+    
+    // 同時屬於多層的剛體取各層遮罩的聯集
+    uint32_t debrisMask = layers.getCollisionMask(1 << debris);
+    EXPECT_EQ(debrisMask & (1u << debris), 0u);
+    EXPECT_NE(debrisMask & (1u << world), 0u);
+    uint32_t combinedMask = layers.getCollisionMask((1 << debris) | (1 << player));
+    EXPECT_NE(combinedMask & (1u << player), 0u);
+    EXPECT_EQ(combinedMask & (1u << debris), 0u);
+}
+
+// 測試碰撞層名稱在 JSON 中正確跳脫，並在載入後保留順序與遮罩
+TEST_F(SceneFormatTest, CollisionLayersRoundTrip) {
+    auto scene = CreateBasicTestScene();
+    PhysicsScene::CollisionLayerMatrix& layers = scene.simulationSettings.collisionLayers;
+    int world = layers.addLayer("World");
+    int quoted = layers.addLayer("Debris \"small\" \\ parts");
+    layers.setLayersCollide(quoted, quoted, false);
+
+    EXPECT_EQ(PhysicsScene::Utils::quoteJsonString("a\"b\\c\n"), "\"a\\\"b\\\\c\\n\"");
+    const std::string json = scene.toJSONString();
+    EXPECT_NE(json.find("\"Debris \\\"small\\\" \\\\ parts\""), std::string::npos);
+
+    std::string filename = (testDir / "layers.pscene").string();
+    ASSERT_TRUE(sceneLoader->SaveScene(filename, scene));
+    PhysicsScene::PhysicsScene loadedScene;
+    ASSERT_TRUE(sceneLoader->LoadScene(filename, loadedScene));
+
+    const PhysicsScene::CollisionLayerMatrix& loadedLayers = loadedScene.simulationSettings.collisionLayers;
+    ASSERT_EQ(loadedLayers.layerNames.size(), 2u);
+    EXPECT_EQ(loadedLayers.findLayer("World"), world);
+    EXPECT_EQ(loadedLayers.findLayer("Debris \"small\" \\ parts"), quoted);
+    EXPECT_EQ(loadedLayers.masks[quoted], layers.masks[quoted]);
+    EXPECT_FALSE(loadedLayers.layersCollide(quoted, quoted));
+}
+
+// 測試合併靜態剛體時，無法烘焙縮放的外部網格保留子形狀縮放，可烘焙的形狀則寫入參數
+TEST_F(SceneFormatTest, MergeStaticBodiesKeepsScale) {
+    PhysicsScene::PhysicsScene scene;
+
+    PhysicsScene::RigidBody mesh("Rock");
+    mesh.mass = 0.0f;
+    mesh.transform.position = {1.0f, 0.0f, 0.0f};
+    mesh.transform.scale = {2.0f, 3.0f, 4.0f};
+    mesh.collisionShape = PhysicsScene::GeometryShape(PhysicsScene::ShapeType::TriangleMesh);
+    mesh.collisionShape.meshFile = "rock.obj";
+    scene.rigidBodies.push_back(mesh);
+
+    PhysicsScene::RigidBody box("Crate");
+    box.mass = 0.0f;
+    box.transform.position = {3.0f, 0.0f, 0.0f};
+    box.transform.scale = {2.0f, 2.0f, 2.0f};
+    box.collisionShape = PhysicsScene::GeometryShape::createBox(1.0f, 1.0f, 1.0f);
+    scene.rigidBodies.push_back(box);
+
+    SceneLoader::OptimizationOptions options;
+    options.removeDuplicateMaterials = false;
+    options.removeUnusedMaterials = false;
+    options.mergeStaticBodies = true;
+    ASSERT_TRUE(sceneLoader->OptimizeScene(scene, options));
+
+    ASSERT_EQ(scene.rigidBodies.size(), 1u);
+    const PhysicsScene::RigidBody& merged = scene.rigidBodies[0];
+    ASSERT_EQ(merged.collisionShape.type, PhysicsScene::ShapeType::Compound);
+    ASSERT_EQ(merged.compoundChildren.size(), 2u);
+
+    const PhysicsScene::CompoundChild& meshChild = merged.compoundChildren[0];
+    EXPECT_EQ(meshChild.shape.meshFile, "rock.obj");
+    EXPECT_TRUE(meshChild.localTransform.scale == PhysicsScene::Vector3(2.0f, 3.0f, 4.0f));
+    EXPECT_TRUE(meshChild.localTransform.position == PhysicsScene::Vector3(-1.0f, 0.0f, 0.0f));
+
+    const PhysicsScene::CompoundChild& boxChild = merged.compoundChildren[1];
+    EXPECT_TRUE(boxChild.localTransform.scale == PhysicsScene::Vector3(1.0f, 1.0f, 1.0f));
+    EXPECT_FLOAT_EQ(boxChild.shape.parameters.at("width"), 2.0f);
+}
+
 // 測試不存在的檔案
 TEST_F(SceneFormatTest, LoadNonExistentFile) {
     PhysicsScene::PhysicsScene scene;
@@ -0,0 +1,138 @@
+/**
+ * @file test_scene_tile_format.cpp
+ * @brief 分塊場景格式單元測試
+ *
+ * 測試分塊切割、索引讀取、單一分塊解碼與損毀檔案的處理。
+ * 使用 Google Test 框架進行單元測試。
+ */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+
+#include "../scene_format/scene_tile_format.h"
+
+using namespace PhysicsScene;
+
+class SceneTileFormatTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_tileFile = ::testing::TempDir() + "test_scene_tiles.ptiles";
+    }
+
+    void TearDown() override {
+        std::remove(m_tileFile.c_str());
+    }
+
+    static RigidBody MakeStaticBox(const std::string& name, float x, float z) {
+        RigidBody rigidBody;
+        rigidBody.name = name;
+        rigidBody.mass = 0.0f;
+        rigidBody.transform.position = Vector3(x, 1.0f, z);
+        rigidBody.collisionShape = GeometryShape::createBox(2.0f, 2.0f, 2.0f);
+        rigidBody.physicsMaterial = "Rock";
+        return rigidBody;
+    }
+
+    std::string m_tileFile;
+};
+
+// 測試靜態剛體被切成分塊，動態與受約束剛體留在場景中
+TEST_F(SceneTileFormatTest, SplitAndReadTiles) {
+    PhysicsScene::PhysicsScene scene;
+    scene.rigidBodies.push_back(MakeStaticBox("RockA", 5.0f, 5.0f));
+    scene.rigidBodies.push_back(MakeStaticBox("RockB", 15.0f, 5.0f));
+    scene.rigidBodies.push_back(MakeStaticBox("RockC", -5.0f, 95.0f));
+    scene.rigidBodies.push_back(MakeStaticBox("Anchor", 0.0f, 0.0f));
+
+    RigidBody mesh = MakeStaticBox("Terrain", 60.0f, -60.0f);
+    mesh.collisionShape = GeometryShape(ShapeType::TriangleMesh);
+    mesh.collisionShape.vertices = {Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(0, 0, 1)};
+    mesh.collisionShape.triangles = {{0, 1, 2}};
+    mesh.collisionShape.meshFile = "terrain.obj";
+    mesh.visible = false;
+    mesh.collisionGroup = 4;
+    scene.rigidBodies.push_back(mesh);
+
+    RigidBody dynamicBody = MakeStaticBox("Crate", 5.0f, 5.0f);
+    dynamicBody.mass = 10.0f;
+    scene.rigidBodies.push_back(dynamicBody);
+
+    Constraint hinge;
+    hinge.bodyA = "Crate";
+    hinge.bodyB = "Anchor";
+    scene.constraints.push_back(hinge);
+
+    std::string error;
+    ASSERT_TRUE(writeTiledScene(scene, m_tileFile, 50.0f, &error)) << error;
+    ASSERT_EQ(scene.rigidBodies.size(), 2u);
+    EXPECT_EQ(scene.rigidBodies[0].name, "Anchor");
+    EXPECT_EQ(scene.rigidBodies[1].name, "Crate");
+
+    TiledSceneReader reader;
+    ASSERT_TRUE(reader.open(m_tileFile, &error)) << error;
+    EXPECT_FLOAT_EQ(reader.getTileSize(), 50.0f);
+    ASSERT_EQ(reader.getTiles().size(), 3u);
+
+    const TileEntry* origin = reader.findTile(TileCoord(0, 0));
+    ASSERT_NE(origin, nullptr);
+    EXPECT_EQ(origin->bodyCount, 2u);
+    EXPECT_FLOAT_EQ(origin->boundsMax.x, 15.0f);
+    EXPECT_EQ(reader.findTile(TileCoord(5, 5)), nullptr);
+
+    std::vector<RigidBody> bodies;
+    ASSERT_TRUE(reader.readTile(*origin, bodies, &error)) << error;
+    ASSERT_EQ(bodies.size(), 2u);
+    EXPECT_EQ(bodies[0].name, "RockA");
+    EXPECT_EQ(bodies[1].physicsMaterial, "Rock");
+    EXPECT_FLOAT_EQ(bodies[1].collisionShape.parameters.at("width"), 2.0f);
+    EXPECT_FLOAT_EQ(bodies[1].mass, 0.0f);
+
+    const TileEntry* terrainTile = reader.findTile(TileCoord(1, -2));
+    ASSERT_NE(terrainTile, nullptr);
+    bodies.clear();
+    ASSERT_TRUE(reader.readTile(*terrainTile, bodies, &error)) << error;
+    ASSERT_EQ(bodies.size(), 1u);
+    EXPECT_EQ(bodies[0].collisionShape.type, ShapeType::TriangleMesh);
+    EXPECT_EQ(bodies[0].collisionShape.meshFile, "terrain.obj");
+    EXPECT_EQ(bodies[0].collisionShape.triangles.size(), 1u);
+    EXPECT_EQ(bodies[0].collisionGroup, 4);
+    EXPECT_FALSE(bodies[0].visible);
+    EXPECT_TRUE(bodies[0].castShadows);
+}
+
+// 測試截斷與損毀的檔案會被拒絕
+TEST_F(SceneTileFormatTest, RejectsCorruptedFiles) {
+    std::vector<RigidBody> bodies = {MakeStaticBox("Rock", 1.0f, 1.0f)};
+    std::string error;
+    ASSERT_TRUE(writeTileFile(m_tileFile, bodies, 32.0f, &error)) << error;
+    EXPECT_FALSE(writeTileFile(m_tileFile, bodies, 0.0f, &error));
+
+    std::ifstream input(m_tileFile, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    input.close();
+
+    // 截斷檔尾
+    std::ofstream(m_tileFile, std::ios::binary | std::ios::trunc).write(data.data(), data.size() - 4);
+    TiledSceneReader reader;
+    EXPECT_FALSE(reader.open(m_tileFile, &error));
+    EXPECT_FALSE(reader.isOpen());
+
+    // 分塊內容損毀（第一個字串長度超出分塊）：索引仍可讀，解碼失敗
+    std::string damaged = data;
+    const size_t firstStringLength = sizeof(TILE_FILE_MAGIC) + 1 + 4 + 1;  // 標頭 + 字串數量
+    damaged[firstStringLength] = static_cast<char>(0xff);
+    damaged[firstStringLength + 1] = static_cast<char>(0xff);
+    damaged[firstStringLength + 2] = static_cast<char>(0x03);
+    std::ofstream(m_tileFile, std::ios::binary | std::ios::trunc).write(damaged.data(), damaged.size());
+    ASSERT_TRUE(reader.open(m_tileFile, &error)) << error;
+    std::vector<RigidBody> decoded;
+    EXPECT_FALSE(reader.readTile(reader.getTiles().front(), decoded, &error));
+    EXPECT_TRUE(decoded.empty());
+}
+
+// 主函數
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,111 @@
+/**
+ * @file test_shadow_cascades.cpp
+ * @brief 串聯陰影貼圖單元測試
+ *
+ * 測試切割距離、每段陰影貼圖涵蓋其視錐切片，以及相機小幅移動時投影矩陣保持不變。
+ * 使用 Google Test 框架進行單元測試。
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../cross_platform_runner/shadow_cascades.h"
+
+namespace {
+
+ShadowCascades::View MakeView(const glm::vec3& eye, const glm::vec3& target) {
+    ShadowCascades::View view;
+    view.viewMatrix = glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f));
+    view.fovY = glm::radians(45.0f);
+    view.aspectRatio = 16.0f / 9.0f;
+    view.nearPlane = 0.1f;
+    view.farPlane = 1000.0f;
+    return view;
+}
+
+// 切片的八個角點都必須落在該段陰影貼圖的裁剪空間內
+void ExpectSlicesCovered(const ShadowCascades& cascades, const ShadowCascades::View& view) {
+    const glm::mat4 inverseView = glm::inverse(view.viewMatrix);
+    const float tanHalfFov = std::tan(0.5f * view.fovY);
+    for (size_t i = 0; i < cascades.GetCascadeCount(); ++i) {
+        const ShadowCascades::Cascade& cascade = cascades.GetCascade(i);
+        for (float depth : {cascade.splitNear, cascade.splitFar}) {
+            const float halfHeight = depth * tanHalfFov;
+            const float halfWidth = halfHeight * view.aspectRatio;
+            for (float sx : {-1.0f, 1.0f}) {
+                for (float sy : {-1.0f, 1.0f}) {
+                    const glm::vec4 world = inverseView * glm::vec4(sx * halfWidth, sy * halfHeight, -depth, 1.0f);
+                    const glm::vec4 clip = cascade.lightSpaceMatrix * world;
+                    EXPECT_LE(std::fabs(clip.x / clip.w), 1.0f) << "cascade " << i;
+                    EXPECT_LE(std::fabs(clip.y / clip.w), 1.0f) << "cascade " << i;
+                    EXPECT_LE(std::fabs(clip.z / clip.w), 1.0f) << "cascade " << i;
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+// 測試切割距離遞增且最後一段到達遠端
+TEST(ShadowCascadesTest, ComputeSplits) {
+    float splits[4];
+    ShadowCascades::ComputeSplits(1.0f, 100.0f, 4, 0.0f, splits);
+    EXPECT_NEAR(splits[0], 25.75f, 1e-3f);
+    EXPECT_NEAR(splits[1], 50.5f, 1e-3f);
+    EXPECT_FLOAT_EQ(splits[3], 100.0f);
+
+    ShadowCascades::ComputeSplits(0.1f, 150.0f, 4, 0.75f, splits);
+    for (int i = 1; i < 4; ++i) {
+        EXPECT_GT(splits[i], splits[i - 1]);
+    }
+    // 對數切割讓第一段遠小於均勻切割
+    EXPECT_LT(splits[0], 150.0f / 4.0f * 0.5f);
+    EXPECT_FLOAT_EQ(splits[3], 150.0f);
+}
+
+// 測試每段涵蓋切片，且相機平移時矩陣只在跨過格點時改變
+TEST(ShadowCascadesTest, StableCascadesCoverSlices) {
+    ShadowCascades cascades;
+    const glm::vec3 lightDirection(-0.3f, -1.0f, -0.5f);
+
+    ShadowCascades::View view = MakeView(glm::vec3(0.0f, 5.0f, 10.0f), glm::vec3(0.0f, 0.0f, 0.0f));
+    EXPECT_EQ(cascades.Update(view, lightDirection), 0xFu);
+    EXPECT_EQ(cascades.GetCascadeCount(), 4u);
+    EXPECT_FLOAT_EQ(cascades.GetCascade(3).splitFar, 150.0f);
+    ExpectSlicesCovered(cascades, view);
+
+    // 相同輸入不改變
+    EXPECT_EQ(cascades.Update(view, lightDirection), 0u);
+
+    int changes[4] = {0, 0, 0, 0};
+    const int steps = 200;
+    for (int step = 1; step <= steps; ++step) {
+        const glm::vec3 offset(0.02f * static_cast<float>(step), 0.0f, -0.01f * static_cast<float>(step));
+        view = MakeView(glm::vec3(0.0f, 5.0f, 10.0f) + offset, offset);
+        const uint32_t changed = cascades.Update(view, lightDirection);
+        for (int i = 0; i < 4; ++i) {
+            if (changed & (1u << i)) ++changes[i];
+        }
+        ExpectSlicesCovered(cascades, view);
+    }
+    // 共移動約 4.5 個單位；越遠的段落格距越大，改變次數越少
+    EXPECT_LT(changes[0], steps / 2);
+    EXPECT_LE(changes[3], changes[0]);
+    EXPECT_LE(changes[3], 2);
+
+    // 光源方向改變時全部重新計算
+    EXPECT_EQ(cascades.Update(view, glm::vec3(0.3f, -1.0f, 0.2f)), 0xFu);
+    ExpectSlicesCovered(cascades, view);
+
+    cascades.Invalidate();
+    EXPECT_EQ(cascades.Update(view, glm::vec3(0.3f, -1.0f, 0.2f)), 0xFu);
+}
+
+// 主函數
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,134 @@
+/**
+ * @file test_snapshot_ring.cpp
+ * @brief 影格快照環形緩衝區單元測試
+ *
+ * 測試 SnapshotRing 的發佈、讀取、槽位釘住與多執行緒讀寫行為。
+ * 使用 Google Test 框架進行單元測試。
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../cross_platform_runner/frame_snapshot.h"
+
+class SnapshotRingTest : public ::testing::Test {
+protected:
+    // 發佈一個只含單一剛體的影格，位置 x 等於 value
+    static bool PublishFrame(SnapshotRing& ring, float value) {
+        FrameSnapshot* snapshot = ring.BeginWrite();
+        if (!snapshot) {
+            return false;
+        }
+        snapshot->bodies.resize(1);
+        snapshot->bodies[0].transform.position.x = value;
+        snapshot->simulationTime = value;
+        ring.EndWrite();
+        return true;
+    }
+};
+
+// 測試空緩衝區
+TEST_F(SnapshotRingTest, EmptyRing) {
+    SnapshotRing ring;
+
+    EXPECT_FALSE(ring.AcquireLatest());
+    EXPECT_EQ(ring.GetLatestFrameIndex(), 0u);
+    EXPECT_FALSE(ring.Acquire(1));
+}
+
+// 測試發佈與讀取最新影格
+TEST_F(SnapshotRingTest, PublishAndAcquireLatest) {
+    SnapshotRing ring(4);
+
+    ASSERT_TRUE(PublishFrame(ring, 1.0f));
+    ASSERT_TRUE(PublishFrame(ring, 2.0f));
+
+    auto handle = ring.AcquireLatest();
+    ASSERT_TRUE(handle);
+    EXPECT_EQ(handle->frameIndex, 2u);
+    EXPECT_FLOAT_EQ(handle->bodies[0].transform.position.x, 2.0f);
+
+    // 依序號讀取較舊影格
+    auto older = ring.Acquire(1);
+    ASSERT_TRUE(older);
+    EXPECT_FLOAT_EQ(older->bodies[0].transform.position.x, 1.0f);
+}
+
+// 測試被釘住的槽位不會被覆寫
+TEST_F(SnapshotRingTest, PinnedSlotIsNotOverwritten) {
+    SnapshotRing ring(2);
+
+    ASSERT_TRUE(PublishFrame(ring, 1.0f));
+    auto pinned = ring.AcquireLatest();
+    ASSERT_TRUE(pinned);
+
+    // 唯一的空閒槽位可寫入一次，之後最新影格與被釘住的影格占滿緩衝區
+    ASSERT_TRUE(PublishFrame(ring, 2.0f));
+    EXPECT_FALSE(PublishFrame(ring, 3.0f));
+    EXPECT_EQ(ring.GetDroppedFrameCount(), 1u);
+    EXPECT_FLOAT_EQ(pinned->bodies[0].transform.position.x, 1.0f);
+
+    // 釋放後生產者可以再次寫入
+    pinned.Release();
+    EXPECT_TRUE(PublishFrame(ring, 3.0f));
+    EXPECT_EQ(ring.AcquireLatest()->frameIndex, 3u);
+}
+
+// 測試取消寫入
+TEST_F(SnapshotRingTest, CancelWrite) {
+    SnapshotRing ring(3);
+
+    ASSERT_TRUE(PublishFrame(ring, 1.0f));
+    ASSERT_NE(ring.BeginWrite(), nullptr);
+    ring.CancelWrite();
+
+    EXPECT_EQ(ring.GetLatestFrameIndex(), 1u);
+    EXPECT_TRUE(PublishFrame(ring, 2.0f));
+    EXPECT_EQ(ring.GetLatestFrameIndex(), 2u);
+}
+
+// 測試單一生產者與多個消費者同時運作
+TEST_F(SnapshotRingTest, ConcurrentReaders) {
+    SnapshotRing ring(8);
+    std::atomic<bool> done{false};
+    std::atomic<int> inconsistentReads{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&]() {
+            uint64_t lastFrame = 0;
+            while (!done.load()) {
+                auto handle = ring.AcquireLatest();
+                if (!handle) {
+                    continue;
+                }
+                // 影格內容必須在 handle 存活期間保持一致
+                float x = handle->bodies[0].transform.position.x;
+                if (x != static_cast<float>(handle->simulationTime) || handle->frameIndex < lastFrame) {
+                    inconsistentReads++;
+                }
+                lastFrame = handle->frameIndex;
+            }
+        });
+    }
+
+    for (int i = 1; i <= 20000; ++i) {
+        PublishFrame(ring, static_cast<float>(i));
+    }
+    done = true;
+
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(inconsistentReads.load(), 0);
+    EXPECT_GT(ring.GetLatestFrameIndex(), 0u);
+}
+
+// 主函數
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}